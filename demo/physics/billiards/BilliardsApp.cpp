@@ -231,4 +231,6 @@ void BilliardsApp::setup_scene()
                  math::Vec3d(0.5, 1.0, 1.0));
     setup_balls(math::Vec3d(0.35, table_position.y() + billiard_ball_radius + 0.00001, 0));
     player_ball = load_ball(math::Vec3d(-0.5, table_position.y() + billiard_ball_radius + 0.00001, 0));
+    // the cue ball is fast enough to pass through other balls within a single step
+    m_engine->physics.lookup(player_ball.value().get().rigid_body.value()).enable_ccd();
 }
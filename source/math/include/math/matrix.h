@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <optional>
 #include <ostream>
 #include <span>
 
@@ -659,4 +660,91 @@ namespace yage::math
         };
         return inv / m_det;
     }
+
+    /**
+     * The LDL^T decomposition of a symmetric matrix A = L * D * L^T, where L is a lower triangular matrix with ones on
+     * its diagonal and D is a diagonal matrix.
+     */
+    template<typename T, std::size_t N>
+    struct LdltDecomposition
+    {
+        /**
+         * The factor L, whose diagonal and upper triangle are not used.
+         */
+        Matrix<T, N, N> lower{};
+
+        /**
+         * The diagonal elements of D.
+         */
+        Vector<T, N> diagonal{};
+    };
+
+    /**
+     * Decomposes a symmetric positive definite matrix into its LDL^T factors, which solve linear systems without
+     * square roots or pivoting. Only the lower triangle of the matrix is read.
+     *
+     * @param matrix The matrix to decompose.
+     * @param tolerance Each pivot must be greater than this fraction of the corresponding diagonal element of the
+     * matrix, which rejects singular and ill-conditioned matrices.
+     * @return The decomposition, or empty if the matrix is not positive definite within the tolerance.
+     */
+    template<typename T, std::size_t N>
+    [[nodiscard]]
+    constexpr std::optional<LdltDecomposition<T, N>> ldlt(const Matrix<T, N, N>& matrix, const T tolerance = 0)
+    {
+        LdltDecomposition<T, N> result;
+        for (std::size_t j = 0; j < N; ++j) {
+            T pivot = matrix(j, j);
+            for (std::size_t k = 0; k < j; ++k) {
+                pivot -= result.lower(j, k) * result.lower(j, k) * result.diagonal(k);
+            }
+            if (!(pivot > 0) || pivot <= tolerance * matrix(j, j)) {
+                return std::nullopt;
+            }
+            result.diagonal(j) = pivot;
+            result.lower(j, j) = 1;
+
+            for (std::size_t i = j + 1; i < N; ++i) {
+                T value = matrix(i, j);
+                for (std::size_t k = 0; k < j; ++k) {
+                    value -= result.lower(i, k) * result.lower(j, k) * result.diagonal(k);
+                }
+                result.lower(i, j) = value / pivot;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Solves the linear system A * x = b for x.
+     *
+     * @param decomposition The LDL^T decomposition of A.
+     * @param b The right-hand side of the system.
+     * @return The solution x.
+     */
+    template<typename T, std::size_t N>
+    [[nodiscard]]
+    constexpr Vector<T, N> solve(const LdltDecomposition<T, N>& decomposition, const Vector<T, N>& b)
+    {
+        const Matrix<T, N, N>& lower = decomposition.lower;
+
+        // forward substitution with L, then scaling with D^-1
+        Vector<T, N> x = b;
+        for (std::size_t i = 0; i < N; ++i) {
+            for (std::size_t k = 0; k < i; ++k) {
+                x(i) -= lower(i, k) * x(k);
+            }
+        }
+        for (std::size_t i = 0; i < N; ++i) {
+            x(i) /= decomposition.diagonal(i);
+        }
+
+        // backward substitution with L^T
+        for (std::size_t i = N; i-- > 0;) {
+            for (std::size_t k = i + 1; k < N; ++k) {
+                x(i) -= lower(k, i) * x(k);
+            }
+        }
+        return x;
+    }
 }
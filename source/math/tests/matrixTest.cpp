@@ -379,6 +379,58 @@ TEST_CASE("MatrixBase test")
 		}
 	}
 
+	SECTION("LDLT decomposition") {
+		SECTION("Ldlt_solve") {
+			const Matd<4, 4> mat{
+				4., 2., -2., 1.,
+				2., 5., 1., 0.,
+				-2., 1., 6., 2.,
+				1., 0., 2., 3. };
+			const Vector<double, 4> x(1., -2., 3., 0.5);
+
+			const std::optional<LdltDecomposition<double, 4>> decomposition = ldlt(mat);
+			REQUIRE(decomposition.has_value());
+			const Vector<double, 4> solution = solve(decomposition.value(), mat * x);
+			for (int i = 0; i < 4; ++i) {
+				CHECK(solution(i) == Catch::Approx(x(i)).epsilon(1e-12));
+			}
+		}
+
+		SECTION("Ldlt_factors") {
+			const Mat2d mat{
+				4., 2.,
+				2., 5. };
+
+			const std::optional<LdltDecomposition<double, 2>> decomposition = ldlt(mat);
+			REQUIRE(decomposition.has_value());
+			CHECK(decomposition->lower(0, 0) == 1);
+			CHECK(decomposition->lower(1, 0) == 0.5);
+			CHECK(decomposition->lower(1, 1) == 1);
+			CHECK(decomposition->diagonal == Vec2d(4, 4));
+		}
+
+		SECTION("Ldlt_notPositiveDefinite") {
+			const Mat2d indefinite{
+				1., 2.,
+				2., 1. };
+			CHECK(!ldlt(indefinite).has_value());
+
+			const Mat3d singular{
+				1., 1., 0.,
+				1., 1., 0.,
+				0., 0., 1. };
+			CHECK(!ldlt(singular).has_value());
+		}
+
+		SECTION("Ldlt_tolerance") {
+			const Mat2d almost_singular{
+				1., 1.,
+				1., 1.000001 };
+			CHECK(ldlt(almost_singular).has_value());
+			CHECK(!ldlt(almost_singular, 1e-4).has_value());
+		}
+	}
+
 	SECTION("extract scaling component") {
 		const Mat4d mat = Mat4d{
 			2., 0., 0., 5.,
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace yage::physics3d::benchmarks
+{
+    /**
+     * A named benchmark that measures and reports its own results.
+     */
+    struct Benchmark
+    {
+        std::string name;
+        std::function<void()> run;
+    };
+
+    /**
+     * @return All benchmarks registered at static initialization time.
+     */
+    std::vector<Benchmark>& registry();
+
+    /**
+     * The measurements of a standard scenario, which are tracked across commits through the JSON report.
+     */
+    struct ScenarioResult
+    {
+        std::string scenario{};
+        std::size_t bodies{};
+        int steps{};
+
+        double mean_step_ns{};
+        double max_step_ns{};
+
+        /**
+         * Candidate pairs and contacts per step on average, read from the step statistics.
+         */
+        double pairs{};
+        double contacts{};
+
+        /**
+         * What the stability value measures, e.g. how far resting bodies drift, where smaller is more stable.
+         */
+        std::string stability_metric{};
+        double stability{};
+    };
+
+    /**
+     * Adds the result of a scenario to the JSON report.
+     */
+    void report(ScenarioResult result);
+
+    /**
+     * Registers a benchmark when constructed as a static object.
+     */
+    struct Registration
+    {
+        Registration(std::string name, std::function<void()> run)
+        {
+            registry().push_back({std::move(name), std::move(run)});
+        }
+    };
+
+    /**
+     * Runs a function repeatedly and measures the average wall time of one run.
+     * @param function The function to measure.
+     * @param repetitions The number of runs to average over.
+     * @return The average time of one run in nanoseconds.
+     */
+    template<typename Function>
+    double measure_ns(Function&& function, const int repetitions)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repetitions; ++i) {
+            function();
+        }
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / repetitions;
+    }
+}
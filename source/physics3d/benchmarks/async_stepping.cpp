@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <physics3d/Simulation.h>
+#include <physics3d/StepThread.h>
+#include <physics3d/TransformBuffer.h>
+
+#include "Benchmark.h"
+
+using namespace yage;
+using namespace yage::physics3d;
+
+namespace
+{
+    /**
+     * Stands in for rendering a frame by interpolating all poses a number of times. The work is fixed rather than the
+     * time, such that the comparison stays fair when both threads have to share a core.
+     */
+    void render(const TransformBuffer<std::size_t>::Frame& frame, const int passes, std::vector<BodyPose>& poses)
+    {
+        for (int pass = 0; pass < passes; ++pass) {
+            poses.clear();
+            for (const TransformBuffer<std::size_t>::Transform& transform: frame.transforms) {
+                poses.push_back(TransformBuffer<std::size_t>::interpolate(transform.previous, transform.current,
+                                                                          frame.alpha));
+            }
+        }
+    }
+
+    /**
+     * A grid of box columns, which keeps colliding without falling asleep.
+     */
+    std::vector<RigidBodyHandle> create_scene(Simulation& simulation, const int columns)
+    {
+        simulation.enable_gravity();
+        simulation.disable_sleeping();
+        const Material material{.restitution = 0, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedPlane{.original_normal = {0, 1, 0}}, material, math::Vec3d(),
+                                     math::Quatd());
+        std::vector<RigidBodyHandle> bodies;
+        for (int i = 0; i < columns; ++i) {
+            for (int j = 0; j < columns; ++j) {
+                for (int k = 0; k < 4; ++k) {
+                    bodies.push_back(simulation.create_rigid_body(
+                            InertiaShape::cube(1, 1), colliders::OrientedBox{.half_size = math::Vec3d(0.5)}, material,
+                            math::Vec3d(1.5 * i, 0.5 + 1.01 * k, 1.5 * j), math::Quatd()));
+                }
+            }
+        }
+        return bodies;
+    }
+
+    /**
+     * Compares frames that step the physics and then render, with frames that render the previous poses while a
+     * worker thread steps the physics. Rendering takes as long as a physics step, such that overlapping both should
+     * halve the frame time.
+     */
+    void async_stepping()
+    {
+        std::cout << std::setw(10) << "bodies"
+                  << std::setw(14) << "step [us]"
+                  << std::setw(16) << "serial [us]"
+                  << std::setw(16) << "async [us]"
+                  << std::setw(12) << "speed-up" << std::endl;
+
+        const int frames = 120;
+        for (const int columns: {4, 8, 16}) {
+            Simulation simulation;
+            const std::vector<RigidBodyHandle> bodies = create_scene(simulation, columns);
+            TransformBuffer<std::size_t> transforms;
+            std::vector<BodyPose> rendered;
+
+            auto step = [&] {
+                TransformBuffer<std::size_t>::Frame& frame = transforms.back();
+                frame.transforms.resize(bodies.size());
+                for (std::size_t i = 0; i < bodies.size(); ++i) {
+                    const RigidBody& rb = simulation.lookup(bodies[i]);
+                    frame.transforms[i] = {.target = i, .previous = frame.transforms[i].current,
+                                           .current = {rb.position(), rb.orientation()}};
+                }
+                simulation.update(1. / 60.);
+                transforms.publish();
+            };
+            for (int i = 0; i < 30; ++i) {
+                step();
+            }
+            const double step_ns = benchmarks::measure_ns(step, frames);
+            const double pass_ns = benchmarks::measure_ns([&] { render(transforms.front(), 1, rendered); }, 100);
+            const int passes = std::max(1, static_cast<int>(step_ns / pass_ns));
+
+            const double serial_ns = benchmarks::measure_ns([&] {
+                step();
+                render(transforms.front(), passes, rendered);
+            }, frames);
+
+            StepThread thread;
+            const double async_ns = benchmarks::measure_ns([&] {
+                thread.start(step);
+                render(transforms.front(), passes, rendered);
+                thread.wait();
+            }, frames);
+
+            std::cout << std::setw(10) << bodies.size() << std::fixed << std::setprecision(1)
+                      << std::setw(14) << step_ns / 1000
+                      << std::setw(16) << serial_ns / 1000
+                      << std::setw(16) << async_ns / 1000
+                      << std::setw(12) << std::setprecision(2) << serial_ns / async_ns << std::endl;
+        }
+    }
+
+    const benchmarks::Registration registration("async_stepping", async_stepping);
+}
@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <physics3d/SimulationBatch.h>
+
+#include "Benchmark.h"
+
+using namespace yage;
+using namespace yage::physics3d;
+
+namespace
+{
+    constexpr double radius = 0.0286;
+    constexpr double mass = 0.17;
+
+    /**
+     * A small billiards table with a cue ball and three object balls, where the shot angle depends on the world.
+     */
+    std::vector<RigidBodyHandle> create_shot(Simulation& simulation, const std::size_t world, const std::size_t worlds)
+    {
+        simulation.enable_gravity();
+        const Material cloth{.restitution = 0.5, .kinetic_friction = 0.2, .rolling_friction = 0.01};
+        const Material cushion{.restitution = 0.8, .kinetic_friction = 0.2, .rolling_friction = 0};
+        const Material ball{.restitution = 0.95, .kinetic_friction = 0.05, .rolling_friction = 0.01};
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedPlane{.original_normal = {0, 1, 0}}, cloth, math::Vec3d(),
+                                     math::Quatd());
+        for (const double side: {-1, 1}) {
+            simulation.create_rigid_body(InertiaShape::static_shape(),
+                                         colliders::OrientedBox{.half_size = math::Vec3d(1.37, 0.05, 0.1)}, cushion,
+                                         math::Vec3d(0, 0.05, side * 0.735), math::Quatd());
+            simulation.create_rigid_body(InertiaShape::static_shape(),
+                                         colliders::OrientedBox{.half_size = math::Vec3d(0.1, 0.05, 0.735)}, cushion,
+                                         math::Vec3d(side * 1.37, 0.05, 0), math::Quatd());
+        }
+
+        std::vector<RigidBodyHandle> balls;
+        for (const math::Vec3d& position: {math::Vec3d(-0.635, radius, 0), math::Vec3d(0.3, radius, 0),
+                                           math::Vec3d(0.5, radius, 0.1), math::Vec3d(0.5, radius, -0.1)}) {
+            balls.push_back(simulation.create_rigid_body(InertiaShape::sphere(radius, mass),
+                                                         colliders::Sphere{.radius = radius}, ball, position,
+                                                         math::Quatd()));
+            simulation.lookup(balls.back()).enable_ccd();
+        }
+
+        // an impulse over a single step, with the angle swept over the worlds
+        const double angle = -0.2 + 0.4 * static_cast<double>(world) / static_cast<double>(worlds);
+        RigidBody& cue_ball = simulation.lookup(balls.front());
+        cue_ball.apply_force(math::Vec3d(std::cos(angle), 0, std::sin(angle)) * (mass * 6 * 60), cue_ball.position());
+        return balls;
+    }
+
+    /**
+     * Steps a sweep of billiards shots, once one simulation after the other and once as a batch on all hardware
+     * threads, and measures reading back the ball positions of all worlds.
+     */
+    void batch()
+    {
+        const std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        constexpr int steps = 300;
+
+        std::cout << std::setw(10) << "worlds"
+                  << std::setw(10) << "threads"
+                  << std::setw(16) << "serial [ms]"
+                  << std::setw(16) << "batch [ms]"
+                  << std::setw(16) << "read [us]"
+                  << std::setw(12) << "speedup" << std::endl;
+
+        for (const std::size_t worlds: {64, 256, 1024}) {
+            std::vector<std::unique_ptr<Simulation>> simulations;
+            SimulationBatch simulation_batch(worlds, threads);
+            std::vector<RigidBodyHandle> balls;
+            for (std::size_t world = 0; world < worlds; ++world) {
+                simulations.push_back(std::make_unique<Simulation>());
+                create_shot(*simulations.back(), world, worlds);
+                balls = create_shot(simulation_batch.world(world), world, worlds);
+            }
+
+            const double serial_ns = benchmarks::measure_ns([&] {
+                for (const std::unique_ptr<Simulation>& simulation: simulations) {
+                    simulation->update(1. / 60.);
+                }
+            }, steps);
+
+            const double batch_ns = benchmarks::measure_ns([&] { simulation_batch.update(1. / 60.); }, steps);
+
+            std::vector<math::Vec3d> positions(worlds * balls.size());
+            const double read_ns = benchmarks::measure_ns([&] {
+                simulation_batch.read_states(balls, BodyStateArrays{.positions = positions});
+            }, steps);
+
+            std::cout << std::setw(10) << worlds
+                      << std::setw(10) << threads
+                      << std::setw(16) << std::fixed << std::setprecision(2) << serial_ns * steps / 1e6
+                      << std::setw(16) << batch_ns * steps / 1e6
+                      << std::setw(16) << std::setprecision(1) << read_ns / 1000
+                      << std::setw(12) << std::setprecision(2) << serial_ns / batch_ns << std::endl;
+        }
+    }
+
+    const benchmarks::Registration registration("batch", batch);
+}
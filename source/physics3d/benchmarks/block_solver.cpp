@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+#include <physics3d/Simulation.h>
+
+#include "Benchmark.h"
+
+using namespace yage;
+using namespace yage::physics3d;
+
+namespace
+{
+    struct StackResult
+    {
+        /**
+         * How far the top box has sunk below its resting height.
+         */
+        double sink{};
+
+        /**
+         * Largest horizontal distance of any box from the stack's axis.
+         */
+        double drift{};
+
+        /**
+         * Largest angular velocity of any box during the last second, which shows how much the boxes rock.
+         */
+        double rocking{};
+
+        double step_ns{};
+    };
+
+    StackResult simulate_stack(const int height, const int iterations, const bool block_solver)
+    {
+        Simulation simulation;
+        simulation.enable_gravity();
+        simulation.disable_sleeping();
+        simulation.set_solver_iterations(iterations);
+        if (block_solver) {
+            simulation.enable_block_solver();
+        }
+
+        const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedPlane{.original_normal = {0, 1, 0}}, material,
+                                     math::Vec3d(), math::Quatd());
+        std::vector<RigidBodyHandle> boxes;
+        for (int i = 0; i < height; ++i) {
+            boxes.push_back(simulation.create_rigid_body(InertiaShape::cube(1, 0.5),
+                                                         colliders::OrientedBox{.half_size = math::Vec3d(0.5)},
+                                                         material, math::Vec3d(0, 0.5 + i * 1.05, 0),
+                                                         math::Quatd()));
+        }
+
+        StackResult result;
+        result.step_ns = benchmarks::measure_ns([&] { simulation.update(1. / 60.); }, 540);
+        for (int i = 0; i < 60; ++i) {
+            simulation.update(1. / 60.);
+            for (const RigidBodyHandle& box: boxes) {
+                result.rocking = std::max(result.rocking, length(simulation.lookup(box).angular_velocity()));
+            }
+        }
+
+        result.sink = (height - 0.5) - simulation.lookup(boxes.back()).position().y();
+        for (const RigidBodyHandle& box: boxes) {
+            const math::Vec3d position = simulation.lookup(box).position();
+            result.drift = std::max(result.drift, std::hypot(position.x(), position.z()));
+        }
+        return result;
+    }
+
+    /**
+     * Compares how stable a stack of boxes stays after 10 seconds for different solver iteration counts, when the
+     * penetration rows are solved one after the other and when the rows of each manifold are solved as a block.
+     * Sleeping is disabled, so that the solver keeps working on the stack.
+     */
+    void block_solver()
+    {
+        for (const int height: {1, 5, 10}) {
+            std::cout << "stack of " << height << std::endl;
+            std::cout << std::setw(12) << "iterations"
+                      << std::setw(12) << "sink [m]"
+                      << std::setw(12) << "drift [m]"
+                      << std::setw(14) << "rock [rad/s]"
+                      << std::setw(12) << "step [us]"
+                      << std::setw(18) << "block sink [m]"
+                      << std::setw(18) << "block drift [m]"
+                      << std::setw(20) << "block rock [rad/s]"
+                      << std::setw(18) << "block step [us]" << std::endl;
+
+            for (const int iterations: {1, 2, 4, 6, 10, 20}) {
+                const StackResult sequential = simulate_stack(height, iterations, false);
+                const StackResult block = simulate_stack(height, iterations, true);
+
+                std::cout << std::setw(12) << iterations << std::fixed << std::setprecision(4)
+                          << std::setw(12) << sequential.sink
+                          << std::setw(12) << sequential.drift
+                          << std::setw(14) << sequential.rocking
+                          << std::setw(12) << std::setprecision(1) << sequential.step_ns / 1000
+                          << std::setw(18) << std::setprecision(4) << block.sink
+                          << std::setw(18) << block.drift
+                          << std::setw(20) << block.rocking
+                          << std::setw(18) << std::setprecision(1) << block.step_ns / 1000 << std::endl;
+            }
+        }
+    }
+
+    const benchmarks::Registration registration("block_solver", block_solver);
+}
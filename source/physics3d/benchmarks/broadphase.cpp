@@ -0,0 +1,113 @@
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+#include <physics3d/Broadphase.h>
+#include <physics3d/Simulation.h>
+
+#include "Benchmark.h"
+
+using namespace yage;
+using namespace yage::physics3d;
+
+namespace
+{
+    /**
+     * A ground plane with boxes resting on it in a square grid.
+     */
+    std::vector<Collider> resting_boxes(const int n)
+    {
+        colliders::OrientedPlane ground{.original_normal = {0, 1, 0}};
+        ground.normal = ground.original_normal;
+
+        std::vector<Collider> scene{ground};
+        const int side = static_cast<int>(std::ceil(std::sqrt(n)));
+        for (int i = 0; i < n; ++i) {
+            colliders::OrientedBox box{
+                    .half_size = math::Vec3d(1),
+                    .center = math::Vec3d(2.5 * (i % side), 1, 2.5 * (i / side)),
+            };
+            box.update_computed_values();
+            scene.emplace_back(box);
+        }
+        return scene;
+    }
+
+    std::size_t narrow_phase(const std::vector<Collider>& colliders,
+                             const std::vector<Broadphase::CandidatePair>& pairs)
+    {
+        const CollisionVisitor visitor;
+        std::size_t hits = 0;
+        for (const auto& [a, b]: pairs) {
+            hits += std::visit(visitor, colliders[a], colliders[b]).has_value();
+        }
+        return hits;
+    }
+
+    void broadphase_scaling()
+    {
+        std::cout << std::setw(8) << "bodies"
+                  << std::setw(16) << "all pairs"
+                  << std::setw(16) << "candidates"
+                  << std::setw(20) << "brute force [us]"
+                  << std::setw(20) << "broadphase [us]"
+                  << std::setw(16) << "step [us]" << std::endl;
+
+        for (const int n: {250, 500, 1000, 2000, 4000}) {
+            const std::vector<Collider> scene = resting_boxes(n);
+
+            // reference: narrow phase on every pair, as without a broad phase
+            std::vector<Broadphase::CandidatePair> all_pairs;
+            if (n <= 2000) {
+                for (std::size_t i = 0; i < scene.size(); ++i) {
+                    for (std::size_t j = i + 1; j < scene.size(); ++j) {
+                        all_pairs.emplace_back(i, j);
+                    }
+                }
+            }
+            const double brute_force_ns = all_pairs.empty()
+                                          ? std::nan("")
+                                          : benchmarks::measure_ns([&] { narrow_phase(scene, all_pairs); }, 1);
+
+            // broad phase with idle bodies, followed by the narrow phase on the candidate pairs
+            Broadphase broadphase;
+            std::vector<std::uint32_t> proxies;
+            for (std::size_t i = 0; i < scene.size(); ++i) {
+                proxies.push_back(broadphase.create_proxy(scene[i], i));
+            }
+            std::size_t candidates = broadphase.update_pairs().size();
+            const double broadphase_ns = benchmarks::measure_ns([&] {
+                for (std::size_t i = 0; i < scene.size(); ++i) {
+                    broadphase.move_proxy(proxies[i], scene[i], math::Vec3d());
+                }
+                const std::vector<Broadphase::CandidatePair>& pairs = broadphase.update_pairs();
+                candidates = pairs.size();
+                narrow_phase(scene, pairs);
+            }, 20);
+
+            // full simulation step
+            Simulation simulation;
+            simulation.enable_gravity();
+            const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+            for (const Collider& collider: scene) {
+                if (const auto* box = std::get_if<colliders::OrientedBox>(&collider)) {
+                    simulation.create_rigid_body(InertiaShape::cube(2, 1), collider, material, box->center,
+                                                 math::Quatd());
+                } else {
+                    simulation.create_rigid_body(InertiaShape::static_shape(), collider, material, math::Vec3d(),
+                                                 math::Quatd());
+                }
+            }
+            const double step_ns = benchmarks::measure_ns([&] { simulation.update(1. / 60.); }, 20);
+
+            std::cout << std::setw(8) << n
+                      << std::setw(16) << scene.size() * (scene.size() - 1) / 2
+                      << std::setw(16) << candidates
+                      << std::setw(20) << std::fixed << std::setprecision(1) << brute_force_ns / 1000
+                      << std::setw(20) << broadphase_ns / 1000
+                      << std::setw(16) << step_ns / 1000 << std::endl;
+        }
+    }
+
+    const benchmarks::Registration registration("broadphase_scaling", broadphase_scaling);
+}
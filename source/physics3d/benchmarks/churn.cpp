@@ -0,0 +1,90 @@
+#include <deque>
+#include <iomanip>
+#include <iostream>
+
+#include <physics3d/Simulation.h>
+
+#include "Benchmark.h"
+
+using namespace yage;
+using namespace yage::physics3d;
+
+namespace
+{
+    struct ChurnResult
+    {
+        double step_ns{};
+        std::size_t destroyed_bodies{};
+        std::size_t live_bodies{};
+        std::size_t stored_bodies{};
+    };
+
+    /**
+     * Spawns a number of spheres every step, which fall onto a ground plane and are destroyed after a fixed lifetime,
+     * like debris of explosions or projectiles.
+     */
+    ChurnResult simulate_churn(const int spawns_per_step, const int lifetime)
+    {
+        Simulation simulation;
+        simulation.enable_gravity();
+
+        const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedPlane{.original_normal = {0, 1, 0}}, material, math::Vec3d(),
+                                     math::Quatd());
+
+        std::deque<RigidBodyHandle> debris;
+        int spawned = 0;
+        auto step = [&] {
+            for (int i = 0; i < spawns_per_step; ++i, ++spawned) {
+                const math::Vec3d position(spawned % 32, 5 + spawned % 3, spawned / 32 % 32);
+                debris.push_back(simulation.create_rigid_body(InertiaShape::sphere(0.25, 1),
+                                                              colliders::Sphere{.radius = 0.25}, material, position,
+                                                              math::Quatd()));
+            }
+            while (debris.size() > static_cast<std::size_t>(spawns_per_step * lifetime)) {
+                simulation.lookup(debris.front()).destroy();
+                debris.pop_front();
+            }
+            simulation.update(1. / 60.);
+        };
+
+        // reach the steady state where as many bodies are destroyed as spawned
+        for (int i = 0; i < 2 * lifetime; ++i) {
+            step();
+        }
+
+        ChurnResult result;
+        result.step_ns = benchmarks::measure_ns(step, 4 * lifetime);
+        result.live_bodies = debris.size();
+        result.destroyed_bodies = static_cast<std::size_t>(spawned) - debris.size();
+        result.stored_bodies = simulation.body_count();
+        return result;
+    }
+
+    /**
+     * Measures steps of a simulation that continuously creates and destroys bodies. The simulation only stores the
+     * live bodies, no matter how many have been destroyed before.
+     */
+    void churn()
+    {
+        std::cout << std::setw(16) << "spawns / step"
+                  << std::setw(14) << "destroyed"
+                  << std::setw(14) << "live bodies"
+                  << std::setw(16) << "stored bodies"
+                  << std::setw(14) << "step [us]" << std::endl;
+
+        const int lifetime = 120;
+        for (const int spawns_per_step: {4, 16, 64}) {
+            const ChurnResult result = simulate_churn(spawns_per_step, lifetime);
+
+            std::cout << std::setw(16) << spawns_per_step
+                      << std::setw(14) << result.destroyed_bodies
+                      << std::setw(14) << result.live_bodies
+                      << std::setw(16) << result.stored_bodies
+                      << std::setw(14) << std::fixed << std::setprecision(1) << result.step_ns / 1000 << std::endl;
+        }
+    }
+
+    const benchmarks::Registration registration("churn", churn);
+}
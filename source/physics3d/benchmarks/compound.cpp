@@ -0,0 +1,112 @@
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <physics3d/Simulation.h>
+
+#include "Benchmark.h"
+
+using namespace yage;
+using namespace yage::physics3d;
+
+namespace
+{
+    const math::Vec3d top_half_size(1, 0.1, 0.6);
+    const math::Vec3d leg_half_size(0.1, 0.4, 0.1);
+    const std::vector<math::Vec3d> leg_offsets{
+            math::Vec3d(-0.85, -0.05, -0.45), math::Vec3d(-0.85, -0.05, 0.45),
+            math::Vec3d(0.85, -0.05, -0.45), math::Vec3d(0.85, -0.05, 0.45),
+    };
+
+    struct PropResult
+    {
+        double step_ns{};
+        std::size_t bodies{};
+
+        /**
+         * Read from the step statistics.
+         */
+        std::size_t contacts{};
+    };
+
+    /**
+     * Places a grid of tables on the ground, either as one compound body per table, or as a top that rests on four
+     * separate legs.
+     */
+    PropResult simulate_tables(const int size, const bool compound)
+    {
+        Simulation simulation;
+        simulation.enable_gravity();
+        simulation.disable_sleeping();
+
+        const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedPlane{.original_normal = {0, 1, 0}}, material,
+                                     math::Vec3d(), math::Quatd());
+
+        std::vector<Collider> children{colliders::OrientedBox{.half_size = top_half_size,
+                                                              .center = math::Vec3d(0, 0.45, 0)}};
+        for (const math::Vec3d& offset: leg_offsets) {
+            children.emplace_back(colliders::OrientedBox{.half_size = leg_half_size, .center = offset});
+        }
+        const CompoundShape table(children);
+
+        PropResult result;
+        for (int i = 0; i < size; ++i) {
+            for (int j = 0; j < size; ++j) {
+                const math::Vec3d position(3 * i, 0.45, 2 * j);
+                if (compound) {
+                    simulation.create_rigid_body(InertiaShape::cuboid(2, 1, 1.2, 10),
+                                                 colliders::Compound{.shape = &table}, material, position,
+                                                 math::Quatd());
+                    ++result.bodies;
+                    continue;
+                }
+                simulation.create_rigid_body(InertiaShape::cuboid(2, 0.2, 1.2, 6),
+                                             colliders::OrientedBox{.half_size = top_half_size}, material,
+                                             position + math::Vec3d(0, 0.46, 0), math::Quatd());
+                for (const math::Vec3d& offset: leg_offsets) {
+                    simulation.create_rigid_body(InertiaShape::cuboid(0.2, 0.8, 0.2, 1),
+                                                 colliders::OrientedBox{.half_size = leg_half_size}, material,
+                                                 position + offset, math::Quatd());
+                }
+                result.bodies += 5;
+            }
+        }
+        for (int i = 0; i < 60; ++i) {
+            simulation.update(1. / 60.);
+        }
+
+        result.step_ns = benchmarks::measure_ns([&] { simulation.update(1. / 60.); }, 60);
+        result.contacts = simulation.statistics().contacts;
+        return result;
+    }
+
+    /**
+     * Compares tables that are modelled as a single compound body with tables that are assembled from separate
+     * boxes, which need contacts between the parts to hold together.
+     */
+    void compound_props()
+    {
+        std::cout << std::setw(10) << "tables"
+                  << std::setw(16) << "parts bodies"
+                  << std::setw(16) << "parts [us]"
+                  << std::setw(18) << "compound [us]"
+                  << std::setw(16) << "parts contacts"
+                  << std::setw(20) << "compound contacts" << std::endl;
+
+        for (const int size: {4, 8, 16}) {
+            const PropResult parts = simulate_tables(size, false);
+            const PropResult compound = simulate_tables(size, true);
+
+            std::cout << std::setw(10) << compound.bodies
+                      << std::setw(16) << parts.bodies
+                      << std::setw(16) << std::fixed << std::setprecision(1) << parts.step_ns / 1000
+                      << std::setw(18) << compound.step_ns / 1000
+                      << std::setw(16) << parts.contacts
+                      << std::setw(20) << compound.contacts << std::endl;
+        }
+    }
+
+    const benchmarks::Registration registration("compound_props", compound_props);
+}
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <numbers>
+#include <optional>
+#include <vector>
+
+#include <physics3d/Gjk.h>
+
+#include "Benchmark.h"
+
+using namespace yage;
+using namespace yage::physics3d;
+
+namespace
+{
+    /**
+     * Points on a sphere, spread by the golden angle, like a hull cooked from a smooth mesh.
+     */
+    std::vector<math::Vec3d> sphere_points(const int count)
+    {
+        std::vector<math::Vec3d> points;
+        for (int i = 0; i < count; ++i) {
+            const double y = 1 - 2 * (i + 0.5) / count;
+            const double r = std::sqrt(1 - y * y);
+            const double angle = i * std::numbers::pi * (3 - std::sqrt(5.));
+            points.emplace_back(r * std::cos(angle), y, r * std::sin(angle));
+        }
+        return points;
+    }
+
+    std::vector<math::Vec3d> transform(const std::vector<math::Vec3d>& points, const math::Vec3d& center,
+                                       const math::Quatd& orientation)
+    {
+        std::vector<math::Vec3d> transformed;
+        for (const math::Vec3d& point: points) {
+            transformed.push_back(center + orientation * point);
+        }
+        return transformed;
+    }
+
+    /**
+     * Reference: projects all vertices onto one axis per vertex of either hull, which stand in for the face normals
+     * that the SAT would test, like sat_3d does for boxes. Since the axes are only approximate face normals, the
+     * depth slightly overestimates the penetration.
+     */
+    double brute_force(const std::vector<math::Vec3d>& a, const std::vector<math::Vec3d>& b,
+                       const std::vector<math::Vec3d>& axes)
+    {
+        double min_overlap = std::numeric_limits<double>::infinity();
+        for (const math::Vec3d& axis: axes) {
+            double min_a = std::numeric_limits<double>::infinity();
+            double max_a = -std::numeric_limits<double>::infinity();
+            double min_b = min_a;
+            double max_b = max_a;
+            for (const math::Vec3d& vertex: a) {
+                min_a = std::min(min_a, dot(vertex, axis));
+                max_a = std::max(max_a, dot(vertex, axis));
+            }
+            for (const math::Vec3d& vertex: b) {
+                min_b = std::min(min_b, dot(vertex, axis));
+                max_b = std::max(max_b, dot(vertex, axis));
+            }
+            min_overlap = std::min(min_overlap, std::min(max_a - min_b, max_b - min_a));
+        }
+        return min_overlap;
+    }
+
+    void convex_scaling()
+    {
+        constexpr int frames = 100;
+        std::cout << "one pair of hulls over " << frames << " frames" << std::endl;
+        std::cout << std::setw(10) << "vertices"
+                  << std::setw(20) << "brute force [us]"
+                  << std::setw(16) << "gjk cold [us]"
+                  << std::setw(16) << "gjk warm [us]"
+                  << std::setw(16) << "epa [us]"
+                  << std::setw(16) << "brute depth"
+                  << std::setw(16) << "epa depth" << std::endl;
+
+        for (const int n: {16, 64, 128, 256, 512}) {
+            const ConvexHull hull(sphere_points(n));
+            const std::vector<math::Vec3d> points = sphere_points(n);
+
+            // hull B slowly orbits hull A, separated for GJK and intersecting for EPA
+            auto place = [&hull](const int frame, const double distance) {
+                const double angle = 0.01 * frame;
+                return colliders::Convex{
+                        .shape = shapes::Hull{.hull = &hull},
+                        .center = distance * math::Vec3d(std::cos(angle), 0.1, std::sin(angle)),
+                        .orientation = normalize(math::Quatd(1, 0.3, angle, 0)),
+                };
+            };
+            const colliders::Convex a{.shape = shapes::Hull{.hull = &hull}};
+
+            const std::vector<math::Vec3d> vertices_a = transform(points, a.center, a.orientation);
+            const colliders::Convex intersecting = place(0, 1.5);
+            const std::vector<math::Vec3d> vertices_b = transform(points, intersecting.center,
+                                                                  intersecting.orientation);
+            std::vector<math::Vec3d> axes = transform(points, math::Vec3d(), a.orientation);
+            const std::vector<math::Vec3d> axes_b = transform(points, math::Vec3d(), intersecting.orientation);
+            axes.insert(axes.end(), axes_b.begin(), axes_b.end());
+            double brute_force_depth = 0;
+            const double brute_force_ns = benchmarks::measure_ns([&] {
+                for (int i = 0; i < frames; ++i) {
+                    brute_force_depth = brute_force(vertices_a, vertices_b, axes);
+                }
+            }, 3);
+
+            const double cold_ns = benchmarks::measure_ns([&] {
+                for (int i = 0; i < frames; ++i) {
+                    distance(a, place(i, 3));
+                }
+            }, 10);
+            const double warm_ns = benchmarks::measure_ns([&] {
+                GjkCache cache;
+                for (int i = 0; i < frames; ++i) {
+                    distance(a, place(i, 3), &cache);
+                }
+            }, 10);
+            const double epa_ns = benchmarks::measure_ns([&] {
+                GjkCache cache;
+                for (int i = 0; i < frames; ++i) {
+                    penetration(a, place(i, 1.5), &cache);
+                }
+            }, 10);
+
+            std::cout << std::setw(10) << n
+                      << std::setw(20) << std::fixed << std::setprecision(1) << brute_force_ns / 1000
+                      << std::setw(16) << cold_ns / 1000
+                      << std::setw(16) << warm_ns / 1000
+                      << std::setw(16) << epa_ns / 1000
+                      << std::setw(16) << std::setprecision(4) << brute_force_depth
+                      << std::setw(16) << penetration(a, intersecting).value().depth << std::endl;
+        }
+    }
+
+    const benchmarks::Registration registration("convex_scaling", convex_scaling);
+}
@@ -0,0 +1,91 @@
+#include <iomanip>
+#include <iostream>
+
+#include <physics3d/Simulation.h>
+
+#include "Benchmark.h"
+
+using namespace yage;
+using namespace yage::physics3d;
+
+namespace
+{
+    struct DebrisResult
+    {
+        double step_ns{};
+
+        /**
+         * Read from the step statistics.
+         */
+        std::size_t candidate_pairs{};
+        std::size_t contacts{};
+    };
+
+    /**
+     * A weightless cloud of overlapping debris above a floor of static tiles, which all touch their neighbours.
+     */
+    DebrisResult simulate_debris(const int size, const bool filtered)
+    {
+        Simulation simulation;
+        simulation.disable_sleeping();
+
+        const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+        for (int i = 0; i < size; ++i) {
+            for (int j = 0; j < size; ++j) {
+                simulation.create_rigid_body(InertiaShape::static_shape(),
+                                             colliders::OrientedBox{.half_size = math::Vec3d(0.5, 0.1, 0.5)},
+                                             material, math::Vec3d(i, -0.1, j), math::Quatd());
+            }
+        }
+        const CollisionFilter debris{.layers = 0b10, .mask = 0b01};
+        for (int i = 0; i < 2 * size; ++i) {
+            for (int j = 0; j < 2 * size; ++j) {
+                for (int k = 0; k < 2; ++k) {
+                    const RigidBodyHandle piece = simulation.create_rigid_body(
+                            InertiaShape::cube(0.3, 0.1), colliders::OrientedBox{.half_size = math::Vec3d(0.15)},
+                            material, math::Vec3d(0.25 * i, 1 + 0.25 * k, 0.25 * j), math::Quatd());
+                    if (filtered) {
+                        simulation.lookup(piece).set_collision_filter(debris);
+                    }
+                }
+            }
+        }
+        DebrisResult result;
+        result.step_ns = benchmarks::measure_ns([&] { simulation.update(1. / 60.); }, 10);
+        result.candidate_pairs = simulation.statistics().candidate_pairs;
+        result.contacts = simulation.statistics().contacts;
+        return result;
+    }
+
+    /**
+     * Compares debris that collides with everything with debris that only collides with the world, such that the
+     * broad phase drops the pairs between pieces of debris. Pairs of static tiles are never reported.
+     */
+    void debris_filtering()
+    {
+        std::cout << std::setw(10) << "tiles"
+                  << std::setw(10) << "debris"
+                  << std::setw(16) << "all [us]"
+                  << std::setw(16) << "filtered [us]"
+                  << std::setw(16) << "all pairs"
+                  << std::setw(16) << "filtered pairs"
+                  << std::setw(16) << "all contacts"
+                  << std::setw(18) << "filtered contacts" << std::endl;
+
+        for (const int size: {4, 8, 16}) {
+            const DebrisResult all = simulate_debris(size, false);
+            const DebrisResult filtered = simulate_debris(size, true);
+
+            std::cout << std::setw(10) << size * size
+                      << std::setw(10) << 8 * size * size
+                      << std::setw(16) << std::fixed << std::setprecision(1) << all.step_ns / 1000
+                      << std::setw(16) << filtered.step_ns / 1000
+                      << std::setw(16) << all.candidate_pairs
+                      << std::setw(16) << filtered.candidate_pairs
+                      << std::setw(16) << all.contacts
+                      << std::setw(18) << filtered.contacts << std::endl;
+        }
+    }
+
+    const benchmarks::Registration registration("debris_filtering", debris_filtering);
+}
@@ -0,0 +1,111 @@
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <physics3d/BoundingShape.h>
+
+#include "Benchmark.h"
+
+using namespace yage;
+using namespace yage::physics3d;
+
+namespace
+{
+    std::vector<double> terrain_heights(const std::size_t samples)
+    {
+        std::vector<double> heights;
+        for (std::size_t row = 0; row < samples; ++row) {
+            for (std::size_t column = 0; column < samples; ++column) {
+                const auto x = static_cast<double>(column);
+                const auto z = static_cast<double>(row);
+                heights.push_back(4 * std::sin(0.05 * x) * std::cos(0.07 * z) + 0.5 * std::sin(0.9 * x + 0.4 * z));
+            }
+        }
+        return heights;
+    }
+
+    /**
+     * The same triangles as a mesh, like a terrain tile that was exported as a triangle soup.
+     */
+    TriangleMesh to_mesh(const Heightfield& heightfield)
+    {
+        std::vector<math::Vec3d> vertices;
+        std::vector<std::uint32_t> indices;
+        for (std::uint32_t i = 0; i < heightfield.size(); ++i) {
+            for (const math::Vec3d& vertex: heightfield.triangle(i)) {
+                indices.push_back(static_cast<std::uint32_t>(vertices.size()));
+                vertices.push_back(vertex);
+            }
+        }
+        return {vertices, indices};
+    }
+
+    /**
+     * Compares a terrain as a heightfield with the same terrain as a triangle mesh, for ray casts from above and
+     * for the contacts of boxes that rest on the terrain.
+     */
+    void heightfield_terrain()
+    {
+        constexpr int rays = 1000;
+        constexpr int boxes = 100;
+        std::cout << std::setw(10) << "samples"
+                  << std::setw(16) << "field [KiB]"
+                  << std::setw(16) << "mesh ray [us]"
+                  << std::setw(16) << "field ray [us]"
+                  << std::setw(18) << "mesh boxes [us]"
+                  << std::setw(18) << "field boxes [us]" << std::endl;
+
+        for (const std::size_t samples: {64, 256, 1024}) {
+            const Heightfield heightfield(samples, samples, terrain_heights(samples), 1);
+            const TriangleMesh mesh = to_mesh(heightfield);
+            const colliders::Heightfield field_collider{.heightfield = &heightfield};
+            const colliders::Mesh mesh_collider{.mesh = &mesh};
+
+            const double extent = static_cast<double>(samples - 1);
+            std::mt19937 random(1);
+            std::uniform_real_distribution<double> position(0, extent);
+            std::vector<std::pair<colliders::Sphere, math::Vec3d>> casts;
+            for (int i = 0; i < rays; ++i) {
+                // slanted rays that cross a few dozen cells
+                const math::Vec3d start(position(random), 10, position(random));
+                casts.emplace_back(colliders::Sphere{.center = start, .radius = 0},
+                                   math::Vec3d(position(random), -10, position(random)) * 0.05 +
+                                   math::Vec3d(0, -10, 0));
+            }
+            std::vector<Collider> bodies;
+            for (int i = 0; i < boxes; ++i) {
+                colliders::OrientedBox box{.half_size = math::Vec3d(0.5)};
+                box.center = math::Vec3d(position(random), 0, position(random));
+                box.update_computed_values();
+                bodies.emplace_back(box);
+            }
+
+            auto cast_all = [&casts](const Collider& collider) {
+                for (const auto& [sphere, displacement]: casts) {
+                    sweep(sphere, displacement, collider);
+                }
+            };
+            std::size_t manifolds = 0;
+            auto collide_all = [&bodies, &manifolds](const auto& collider) {
+                for (const Collider& body: bodies) {
+                    collide(collider, body, true, [&manifolds](const ContactManifold&) { ++manifolds; });
+                }
+            };
+            const double mesh_ray_ns = benchmarks::measure_ns([&] { cast_all(mesh_collider); }, 3);
+            const double field_ray_ns = benchmarks::measure_ns([&] { cast_all(field_collider); }, 3);
+            const double mesh_box_ns = benchmarks::measure_ns([&] { collide_all(mesh_collider); }, 3);
+            const double field_box_ns = benchmarks::measure_ns([&] { collide_all(field_collider); }, 3);
+
+            std::cout << std::setw(10) << samples * samples
+                      << std::setw(16) << samples * samples * sizeof(std::uint16_t) / 1024
+                      << std::setw(16) << std::fixed << std::setprecision(2) << mesh_ray_ns / rays / 1000
+                      << std::setw(16) << field_ray_ns / rays / 1000
+                      << std::setw(18) << mesh_box_ns / boxes / 1000
+                      << std::setw(18) << field_box_ns / boxes / 1000 << std::endl;
+        }
+    }
+
+    const benchmarks::Registration registration("heightfield_terrain", heightfield_terrain);
+}
@@ -0,0 +1,92 @@
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <physics3d/BodyStore.h>
+
+#include "Benchmark.h"
+
+using namespace yage;
+using namespace yage::physics3d;
+
+namespace
+{
+    /**
+     * Body state as stored before the body store, with all quantities of a body next to each other.
+     */
+    struct Body
+    {
+        math::Vec3d position{};
+        math::Quatd orientation{};
+        math::Vec3d velocity{};
+        math::Vec3d angular_velocity{};
+        math::Vec3d force{};
+        math::Vec3d torque{};
+        InertiaShape inertia_shape = InertiaShape::static_shape();
+        bool simulated = true;
+    };
+
+    void integrate(std::vector<Body>& bodies, const math::Vec3d& acceleration, const double dt)
+    {
+        for (Body& body: bodies) {
+            if (!body.simulated) {
+                continue;
+            }
+            if (body.inertia_shape.inverse_mass() > 0) {
+                body.velocity += acceleration * dt;
+            }
+            body.velocity += body.inertia_shape.inverse_mass() * body.force * dt;
+            body.angular_velocity += body.inertia_shape.inverse_inertia_tensor() * body.torque * dt;
+        }
+        for (Body& body: bodies) {
+            if (!body.simulated) {
+                continue;
+            }
+            body.position += body.velocity * dt;
+            body.orientation += 0.5 * math::Quatd(body.angular_velocity) * body.orientation * dt;
+            body.orientation.normalize();
+        }
+    }
+
+    /**
+     * Compares the integration of body states stored as an array of structures against the body store.
+     */
+    void integration()
+    {
+        std::cout << std::setw(10) << "bodies"
+                  << std::setw(16) << "aos [us]"
+                  << std::setw(16) << "soa [us]"
+                  << std::setw(12) << "speed-up" << std::endl;
+
+        const math::Vec3d gravity(0, -9.81, 0);
+        const double dt = 1. / 60.;
+        for (const std::size_t n: {1000, 10000, 100000}) {
+            std::vector<Body> bodies;
+            BodyStore store;
+            for (std::size_t i = 0; i < n; ++i) {
+                const InertiaShape shape = InertiaShape::cube(1, 1);
+                const math::Vec3d position(static_cast<double>(i), 0, 0);
+                const math::Vec3d angular_velocity(0.1, 0.2, 0.3);
+                bodies.push_back(Body{.position = position, .angular_velocity = angular_velocity,
+                                      .inertia_shape = shape, .simulated = i % 8 != 0});
+                store.reset(i, shape, position, math::Quatd());
+                store.set_angular_velocity(i, angular_velocity);
+                store.set_simulated(i, i % 8 != 0);
+            }
+
+            const int repetitions = static_cast<int>(10000000 / n);
+            const double aos_ns = benchmarks::measure_ns([&] { integrate(bodies, gravity, dt); }, repetitions);
+            const double soa_ns = benchmarks::measure_ns([&] {
+                store.integrate_forces(gravity, dt);
+                store.integrate_positions(dt);
+            }, repetitions);
+
+            std::cout << std::setw(10) << n << std::fixed << std::setprecision(1)
+                      << std::setw(16) << aos_ns / 1000
+                      << std::setw(16) << soa_ns / 1000
+                      << std::setw(12) << std::setprecision(2) << aos_ns / soa_ns << std::endl;
+        }
+    }
+
+    const benchmarks::Registration registration("integration", integration);
+}
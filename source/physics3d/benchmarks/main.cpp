@@ -0,0 +1,101 @@
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+
+#include <physics3d/Profiling.h>
+
+#include "Benchmark.h"
+
+namespace yage::physics3d::benchmarks
+{
+    std::vector<Benchmark>& registry()
+    {
+        static std::vector<Benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    namespace
+    {
+        std::vector<ScenarioResult>& results()
+        {
+            static std::vector<ScenarioResult> results;
+            return results;
+        }
+
+        /**
+         * Writes the results of all scenarios that ran, which only consist of names and numbers, so no strings need
+         * to be escaped.
+         */
+        void write_json(std::ostream& out)
+        {
+            out << std::setprecision(10);
+            out << "{\n";
+            out << "  \"profiling\": " << (profiling_enabled ? "true" : "false") << ",\n";
+            out << "  \"scenarios\": [";
+            for (std::size_t i = 0; i < results().size(); ++i) {
+                const ScenarioResult& result = results()[i];
+                out << (i == 0 ? "\n" : ",\n");
+                out << "    {\"name\": \"" << result.scenario << "\""
+                    << ", \"bodies\": " << result.bodies
+                    << ", \"steps\": " << result.steps
+                    << ", \"mean_step_ns\": " << result.mean_step_ns
+                    << ", \"max_step_ns\": " << result.max_step_ns
+                    << ", \"pairs\": " << result.pairs
+                    << ", \"contacts\": " << result.contacts
+                    << ", \"stability_metric\": \"" << result.stability_metric << "\""
+                    << ", \"stability\": " << result.stability << "}";
+            }
+            out << "\n  ]\n";
+            out << "}\n";
+        }
+    }
+
+    void report(ScenarioResult result)
+    {
+        results().push_back(std::move(result));
+    }
+}
+
+/**
+ * Runs all registered benchmarks, or only those whose name contains one of the given command line arguments. With
+ * --json <path>, the results of the standard scenarios are also written to a JSON file.
+ */
+int main(const int argc, char** argv)
+{
+    using namespace yage::physics3d::benchmarks;
+
+    std::vector<std::string_view> filters;
+    std::string_view json_path;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string_view(argv[i]) == "--json" && i + 1 < argc) {
+            json_path = argv[++i];
+        } else {
+            filters.emplace_back(argv[i]);
+        }
+    }
+
+    for (const Benchmark& benchmark: registry()) {
+        bool selected = filters.empty();
+        for (const std::string_view filter: filters) {
+            selected |= benchmark.name.find(filter) != std::string::npos;
+        }
+        if (!selected) {
+            continue;
+        }
+
+        std::cout << "== " << benchmark.name << " ==" << std::endl;
+        benchmark.run();
+        std::cout << std::endl;
+    }
+
+    if (!json_path.empty()) {
+        std::ofstream file{std::string(json_path)};
+        if (!file) {
+            std::cerr << "Could not open " << json_path << std::endl;
+            return 1;
+        }
+        write_json(file);
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <physics3d/Simulation.h>
+
+#include "Benchmark.h"
+
+using namespace yage;
+using namespace yage::physics3d;
+
+namespace
+{
+    struct FloorResult
+    {
+        double step_ns{};
+
+        /**
+         * Read from the step statistics.
+         */
+        std::size_t candidate_pairs{};
+        std::size_t contacts{};
+    };
+
+    /**
+     * A square grid of quads in the xz-plane, the same geometry as the box floor below.
+     */
+    TriangleMesh make_grid(const int cells)
+    {
+        std::vector<math::Vec3d> vertices;
+        for (int i = 0; i <= cells; ++i) {
+            for (int j = 0; j <= cells; ++j) {
+                vertices.emplace_back(i - cells / 2.0, 0, j - cells / 2.0);
+            }
+        }
+        std::vector<std::uint32_t> indices;
+        for (int i = 0; i < cells; ++i) {
+            for (int j = 0; j < cells; ++j) {
+                const auto vertex = static_cast<std::uint32_t>(i * (cells + 1) + j);
+                const auto next_row = static_cast<std::uint32_t>(vertex + cells + 1);
+                indices.insert(indices.end(), {vertex, vertex + 1, next_row, next_row, vertex + 1, next_row + 1});
+            }
+        }
+        return {vertices, indices};
+    }
+
+    /**
+     * Drops a layer of boxes onto a floor of unit tiles and measures the steps once they have settled.
+     * @param mesh The floor as a single mesh body, or nullptr for one static box body per tile.
+     */
+    FloorResult simulate_floor(const int cells, const TriangleMesh* mesh)
+    {
+        Simulation simulation;
+        simulation.enable_gravity();
+        simulation.disable_sleeping();
+
+        const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+        if (mesh != nullptr) {
+            simulation.create_rigid_body(InertiaShape::static_shape(), colliders::Mesh{.mesh = mesh}, material,
+                                         math::Vec3d(), math::Quatd());
+        } else {
+            for (int i = 0; i < cells; ++i) {
+                for (int j = 0; j < cells; ++j) {
+                    simulation.create_rigid_body(InertiaShape::static_shape(),
+                                                 colliders::OrientedBox{.half_size = math::Vec3d(0.5, 0.1, 0.5)},
+                                                 material,
+                                                 math::Vec3d(i + 0.5 - cells / 2.0, -0.1, j + 0.5 - cells / 2.0),
+                                                 math::Quatd());
+                }
+            }
+        }
+        for (int i = 0; i < cells; i += 2) {
+            for (int j = 0; j < cells; j += 2) {
+                simulation.create_rigid_body(InertiaShape::cube(0.8, 1),
+                                             colliders::OrientedBox{.half_size = math::Vec3d(0.4)}, material,
+                                             math::Vec3d(i + 1 - cells / 2.0, 0.45, j + 1 - cells / 2.0),
+                                             math::Quatd());
+            }
+        }
+        for (int i = 0; i < 60; ++i) {
+            simulation.update(1. / 60.);
+        }
+
+        FloorResult result;
+        result.step_ns = benchmarks::measure_ns([&] { simulation.update(1. / 60.); }, 60);
+        result.candidate_pairs = simulation.statistics().candidate_pairs;
+        result.contacts = simulation.statistics().contacts;
+        return result;
+    }
+
+    /**
+     * Compares a level floor made of one static box per tile with the same floor as a single triangle mesh. Each box
+     * rests on the corner of four tiles, which are four candidate pairs with tiles but a single pair with the mesh.
+     * The mesh still produces one manifold per touched triangle though.
+     */
+    void mesh_floor()
+    {
+        std::cout << std::setw(10) << "tiles"
+                  << std::setw(10) << "boxes"
+                  << std::setw(18) << "tile step [us]"
+                  << std::setw(18) << "mesh step [us]"
+                  << std::setw(16) << "tile pairs"
+                  << std::setw(16) << "mesh pairs"
+                  << std::setw(16) << "tile contacts"
+                  << std::setw(16) << "mesh contacts" << std::endl;
+
+        for (const int cells: {8, 16, 32}) {
+            const TriangleMesh mesh = make_grid(cells);
+            const FloorResult tiles = simulate_floor(cells, nullptr);
+            const FloorResult floor = simulate_floor(cells, &mesh);
+
+            std::cout << std::setw(10) << cells * cells
+                      << std::setw(10) << (cells / 2) * (cells / 2)
+                      << std::setw(18) << std::fixed << std::setprecision(1) << tiles.step_ns / 1000
+                      << std::setw(18) << floor.step_ns / 1000
+                      << std::setw(16) << tiles.candidate_pairs
+                      << std::setw(16) << floor.candidate_pairs
+                      << std::setw(16) << tiles.contacts
+                      << std::setw(16) << floor.contacts << std::endl;
+        }
+    }
+
+    const benchmarks::Registration registration("mesh_floor", mesh_floor);
+}
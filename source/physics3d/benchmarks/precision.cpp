@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <physics3d/Simulation.h>
+
+#include "Benchmark.h"
+
+using namespace yage;
+using namespace yage::physics3d;
+
+namespace
+{
+    /**
+     * A grid of columns of unit cubes on a ground plane, where the whole scene can be moved away from the origin.
+     */
+    struct StackScene
+    {
+        std::string name{};
+        int columns{};
+        int height{};
+        math::Vec3d offset{};
+    };
+
+    struct PrecisionResult
+    {
+        double step_ns{};
+        std::size_t bodies{};
+        std::vector<math::Vec3d> positions{};
+
+        /**
+         * The largest distance of a cube from where it would rest in an exact stack.
+         */
+        double rest_error{};
+    };
+
+    template<typename Scalar>
+    PrecisionResult simulate(const StackScene& scene)
+    {
+        BasicSimulation<Scalar> simulation;
+        simulation.enable_gravity();
+        simulation.disable_sleeping();
+
+        const Material material{.restitution = 0, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedPlane{.original_normal = {0, 1, 0}}, material,
+                                     scene.offset, math::Quatd());
+
+        std::vector<RigidBodyHandle> bodies;
+        std::vector<math::Vec3d> rest_positions;
+        for (int i = 0; i < scene.columns; ++i) {
+            for (int j = 0; j < scene.columns; ++j) {
+                for (int k = 0; k < scene.height; ++k) {
+                    const math::Vec3d rest_position = scene.offset + math::Vec3d(2 * i, 0.5 + k, 2 * j);
+                    bodies.push_back(simulation.create_rigid_body(
+                            InertiaShape::cube(1, 1), colliders::OrientedBox{.half_size = math::Vec3d(0.5)}, material,
+                            rest_position + math::Vec3d(0, 0.01 * k, 0), math::Quatd()));
+                    rest_positions.push_back(rest_position);
+                }
+            }
+        }
+        for (int i = 0; i < 240; ++i) {
+            simulation.update(1. / 60.);
+        }
+
+        PrecisionResult result{.bodies = bodies.size()};
+        result.step_ns = benchmarks::measure_ns([&] { simulation.update(1. / 60.); }, 60);
+        for (std::size_t i = 0; i < bodies.size(); ++i) {
+            result.positions.push_back(simulation.lookup(bodies[i]).position());
+            result.rest_error = std::max(result.rest_error, length(result.positions.back() - rest_positions[i]));
+        }
+        return result;
+    }
+
+    /**
+     * Compares the integration of single- and double-precision body stores, and how far the bodies of both stores end
+     * up from each other after falling and spinning for the same number of steps.
+     */
+    void compare_integration()
+    {
+        std::cout << std::setw(10) << "bodies"
+                  << std::setw(16) << "double [us]"
+                  << std::setw(16) << "float [us]"
+                  << std::setw(12) << "speed-up"
+                  << std::setw(16) << "deviation [m]" << std::endl;
+
+        const math::Vec3d gravity(0, -9.81, 0);
+        const double dt = 1. / 60.;
+        for (const std::size_t n: {1000, 10000, 100000}) {
+            BasicBodyStore<double> double_store;
+            BasicBodyStore<float> float_store;
+            for (std::size_t i = 0; i < n; ++i) {
+                const math::Vec3d position(static_cast<double>(i), 0, 0);
+                double_store.reset(i, InertiaShape::cube(1, 1), position, math::Quatd());
+                float_store.reset(i, InertiaShape::cube(1, 1), position, math::Quatd());
+                double_store.set_angular_velocity(i, math::Vec3d(0.1, 0.2, 0.3));
+                float_store.set_angular_velocity(i, math::Vec3d(0.1, 0.2, 0.3));
+            }
+
+            const int repetitions = static_cast<int>(10000000 / n);
+            const double double_ns = benchmarks::measure_ns([&] {
+                double_store.integrate_forces(gravity, dt);
+                double_store.integrate_positions(dt);
+            }, repetitions);
+            const double float_ns = benchmarks::measure_ns([&] {
+                float_store.integrate_forces(gravity, dt);
+                float_store.integrate_positions(dt);
+            }, repetitions);
+
+            double deviation = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                deviation = std::max(deviation, length(double_store.position(i) - float_store.position(i)));
+            }
+
+            std::cout << std::setw(10) << n << std::fixed << std::setprecision(1)
+                      << std::setw(16) << double_ns / 1000
+                      << std::setw(16) << float_ns / 1000
+                      << std::setw(12) << std::setprecision(2) << double_ns / float_ns
+                      << std::setw(16) << std::setprecision(5) << deviation << std::endl;
+        }
+    }
+
+    /**
+     * Compares the step time of single- and double-precision simulations of box stacks, and how far the resting boxes
+     * end up from an exact stack and from each other. Far from the origin, single precision can't resolve the small
+     * corrections of the solver anymore.
+     */
+    void compare_stacks()
+    {
+        std::cout << std::setw(14) << "scene"
+                  << std::setw(10) << "bodies"
+                  << std::setw(14) << "double [us]"
+                  << std::setw(14) << "float [us]"
+                  << std::setw(12) << "speed-up"
+                  << std::setw(18) << "double error [m]"
+                  << std::setw(18) << "float error [m]"
+                  << std::setw(16) << "deviation [m]" << std::endl;
+
+        const std::vector<StackScene> scenes{
+                {.name = "stacks", .columns = 6, .height = 5},
+                {.name = "stacks_far", .columns = 6, .height = 5, .offset = math::Vec3d(1000, 0, 1000)},
+                {.name = "columns", .columns = 16, .height = 3},
+        };
+        for (const StackScene& scene: scenes) {
+            const PrecisionResult double_result = simulate<double>(scene);
+            const PrecisionResult float_result = simulate<float>(scene);
+
+            double deviation = 0;
+            for (std::size_t i = 0; i < double_result.positions.size(); ++i) {
+                deviation = std::max(deviation, length(double_result.positions[i] - float_result.positions[i]));
+            }
+
+            std::cout << std::setw(14) << scene.name
+                      << std::setw(10) << double_result.bodies << std::fixed << std::setprecision(1)
+                      << std::setw(14) << double_result.step_ns / 1000
+                      << std::setw(14) << float_result.step_ns / 1000
+                      << std::setw(12) << std::setprecision(2) << double_result.step_ns / float_result.step_ns
+                      << std::setw(18) << std::setprecision(5) << double_result.rest_error
+                      << std::setw(18) << float_result.rest_error
+                      << std::setw(16) << deviation << std::endl;
+        }
+    }
+
+    void precision()
+    {
+        compare_integration();
+        std::cout << std::endl;
+        compare_stacks();
+    }
+
+    const benchmarks::Registration registration("precision", precision);
+}
@@ -0,0 +1,120 @@
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+
+#include <physics3d/Simulation.h>
+
+#include "Benchmark.h"
+
+using namespace yage;
+using namespace yage::physics3d;
+
+namespace
+{
+    const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+
+    /**
+     * Boxes scattered over a ground plane, along with their colliders for the brute force reference.
+     */
+    std::vector<Collider> create_scene(Simulation& simulation, const int n)
+    {
+        colliders::OrientedPlane ground{.original_normal = {0, 1, 0}};
+        ground.normal = ground.original_normal;
+        simulation.create_rigid_body(InertiaShape::static_shape(), ground, material, math::Vec3d(), math::Quatd());
+
+        std::vector<Collider> scene{ground};
+        const int side = static_cast<int>(std::ceil(std::sqrt(n)));
+        for (int i = 0; i < n; ++i) {
+            colliders::OrientedBox box{
+                    .half_size = math::Vec3d(1),
+                    .center = math::Vec3d(4.0 * (i % side), 1 + 3.0 * (i % 3), 4.0 * (i / side)),
+            };
+            box.update_computed_values();
+            scene.emplace_back(box);
+            simulation.create_rigid_body(InertiaShape::cube(2, 1), box, material, box.center, math::Quatd());
+        }
+        return scene;
+    }
+
+    /**
+     * Short rays in random directions, like line-of-sight checks between agents.
+     */
+    std::vector<Ray> create_rays(const int n, const int count)
+    {
+        const double extent = 4.0 * std::ceil(std::sqrt(n));
+        std::mt19937 random(7);
+        std::uniform_real_distribution<double> position(0, extent);
+        std::uniform_real_distribution<double> direction(-1, 1);
+        std::vector<Ray> rays;
+        for (int i = 0; i < count; ++i) {
+            rays.push_back({
+                    .origin = math::Vec3d(position(random), 1.5, position(random)),
+                    .direction = math::Vec3d(direction(random), direction(random) * 0.2, direction(random)),
+                    .max_distance = 30,
+            });
+        }
+        return rays;
+    }
+
+    /**
+     * Reference: casts a ray against every collider, as without an acceleration structure.
+     */
+    std::size_t brute_force(const std::vector<Collider>& scene, const std::vector<Ray>& rays)
+    {
+        std::size_t hits = 0;
+        for (const Ray& ray: rays) {
+            const math::Vec3d displacement = normalize(ray.direction) * ray.max_distance;
+            std::optional<double> closest;
+            for (const Collider& collider: scene) {
+                const std::optional<SweepHit> hit = sweep(colliders::Sphere{.center = ray.origin, .radius = 0},
+                                                          displacement, collider);
+                if (hit.has_value() && (!closest.has_value() || hit->fraction < closest.value())) {
+                    closest = hit->fraction;
+                }
+            }
+            hits += closest.has_value();
+        }
+        return hits;
+    }
+
+    void raycast_scaling()
+    {
+        constexpr int ray_count = 500;
+        std::cout << ray_count << " rays per batch" << std::endl;
+        std::cout << std::setw(8) << "bodies"
+                  << std::setw(16) << "hits"
+                  << std::setw(20) << "brute force [us]"
+                  << std::setw(20) << "batch 1 thr. [us]"
+                  << std::setw(20) << "batch 4 thr. [us]" << std::endl;
+
+        for (const int n: {100, 1000, 10000}) {
+            Simulation simulation;
+            const std::vector<Collider> scene = create_scene(simulation, n);
+            simulation.update(1. / 60.);
+            const std::vector<Ray> rays = create_rays(n, ray_count);
+            std::vector<std::optional<QueryHit>> hits(rays.size());
+
+            const double brute_force_ns = n <= 1000
+                                          ? benchmarks::measure_ns([&] { brute_force(scene, rays); }, 3)
+                                          : std::nan("");
+            const double single_ns = benchmarks::measure_ns([&] { simulation.raycast(rays, hits); }, 20);
+            simulation.set_thread_count(4);
+            const double batch_ns = benchmarks::measure_ns([&] { simulation.raycast(rays, hits); }, 20);
+
+            std::size_t hit_count = 0;
+            for (const std::optional<QueryHit>& hit: hits) {
+                hit_count += hit.has_value();
+            }
+
+            std::cout << std::setw(8) << n
+                      << std::setw(16) << hit_count
+                      << std::setw(20) << std::fixed << std::setprecision(1) << brute_force_ns / 1000
+                      << std::setw(20) << single_ns / 1000
+                      << std::setw(20) << batch_ns / 1000 << std::endl;
+        }
+    }
+
+    const benchmarks::Registration registration("raycast_scaling", raycast_scaling);
+}
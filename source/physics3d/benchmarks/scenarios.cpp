@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <physics3d/Simulation.h>
+
+#include "Benchmark.h"
+
+using namespace yage;
+using namespace yage::physics3d;
+
+namespace
+{
+    const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+
+    /**
+     * Steps a scenario and measures the time and the statistics of each step after a number of warm-up steps.
+     * @param observe Invoked after each measured step, outside of the measured time.
+     */
+    benchmarks::ScenarioResult run(const std::string& name, Simulation& simulation, const std::size_t bodies,
+                                   const int warmup_steps, const int steps,
+                                   const std::function<void()>& observe = [] {})
+    {
+        for (int i = 0; i < warmup_steps; ++i) {
+            simulation.update(1. / 60.);
+        }
+
+        benchmarks::ScenarioResult result{.scenario = name, .bodies = bodies, .steps = steps};
+        for (int i = 0; i < steps; ++i) {
+            const double step_ns = benchmarks::measure_ns([&] { simulation.update(1. / 60.); }, 1);
+            result.mean_step_ns += step_ns / steps;
+            result.max_step_ns = std::max(result.max_step_ns, step_ns);
+            result.pairs += static_cast<double>(simulation.statistics().candidate_pairs) / steps;
+            result.contacts += static_cast<double>(simulation.statistics().contacts) / steps;
+            observe();
+        }
+        return result;
+    }
+
+    void print(const benchmarks::ScenarioResult& result)
+    {
+        std::cout << std::setw(16) << result.scenario
+                  << std::setw(10) << result.bodies
+                  << std::setw(10) << result.steps
+                  << std::setw(14) << std::fixed << std::setprecision(1) << result.mean_step_ns / 1000
+                  << std::setw(14) << result.max_step_ns / 1000
+                  << std::setw(12) << std::setprecision(0) << result.pairs
+                  << std::setw(12) << result.contacts
+                  << std::setw(14) << std::setprecision(4) << result.stability
+                  << "  " << result.stability_metric << std::endl;
+    }
+
+    void create_ground(Simulation& simulation)
+    {
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedPlane{.original_normal = {0, 1, 0}}, material,
+                                     math::Vec3d(), math::Quatd());
+    }
+
+    std::vector<math::Vec3d> positions(Simulation& simulation, const std::vector<RigidBodyHandle>& bodies)
+    {
+        std::vector<math::Vec3d> result;
+        for (const RigidBodyHandle& body: bodies) {
+            result.push_back(simulation.lookup(body).position());
+        }
+        return result;
+    }
+
+    /**
+     * @return The largest distance of any body from where it was.
+     */
+    double max_drift(Simulation& simulation, const std::vector<RigidBodyHandle>& bodies,
+                     const std::vector<math::Vec3d>& previous_positions)
+    {
+        double drift = 0;
+        for (std::size_t i = 0; i < bodies.size(); ++i) {
+            drift = std::max(drift, length(simulation.lookup(bodies[i]).position() - previous_positions[i]));
+        }
+        return drift;
+    }
+
+    /**
+     * Steps a scenario of resting bodies and measures how far they drift after they have settled for a second.
+     */
+    benchmarks::ScenarioResult run_resting(const std::string& name, Simulation& simulation,
+                                           const std::vector<RigidBodyHandle>& bodies, const int steps)
+    {
+        for (int i = 0; i < 60; ++i) {
+            simulation.update(1. / 60.);
+        }
+        const std::vector<math::Vec3d> settled = positions(simulation, bodies);
+        benchmarks::ScenarioResult result = run(name, simulation, bodies.size(), 0, steps);
+        result.stability_metric = "max_drift_m";
+        result.stability = max_drift(simulation, bodies, settled);
+        return result;
+    }
+
+    /**
+     * A pyramid of 210 boxes with a base of 20, which should stand still once it has settled.
+     */
+    benchmarks::ScenarioResult pyramid()
+    {
+        constexpr int base = 20;
+        Simulation simulation;
+        simulation.enable_gravity();
+        simulation.disable_sleeping();
+        create_ground(simulation);
+
+        std::vector<RigidBodyHandle> boxes;
+        for (int row = 0; row < base; ++row) {
+            for (int i = 0; i < base - row; ++i) {
+                boxes.push_back(simulation.create_rigid_body(
+                        InertiaShape::cube(1, 1), colliders::OrientedBox{.half_size = math::Vec3d(0.5)}, material,
+                        math::Vec3d((i - (base - row - 1) / 2.0) * 1.05, 0.5 + row * 1.01, 0), math::Quatd()));
+            }
+        }
+        return run_resting("pyramid", simulation, boxes, 600);
+    }
+
+    /**
+     * A wall of 20 x 15 bricks in a running bond, which should stand still once it has settled.
+     */
+    benchmarks::ScenarioResult wall()
+    {
+        constexpr int width = 20;
+        constexpr int height = 15;
+        Simulation simulation;
+        simulation.enable_gravity();
+        simulation.disable_sleeping();
+        create_ground(simulation);
+
+        std::vector<RigidBodyHandle> bricks;
+        for (int row = 0; row < height; ++row) {
+            for (int i = 0; i < width; ++i) {
+                bricks.push_back(simulation.create_rigid_body(
+                        InertiaShape::cuboid(1, 0.5, 0.5, 1),
+                        colliders::OrientedBox{.half_size = math::Vec3d(0.5, 0.25, 0.25)}, material,
+                        math::Vec3d((i + 0.5 * (row % 2) - width / 2.0) * 1.02, 0.25 + row * 0.51, 0),
+                        math::Quatd()));
+            }
+        }
+        return run_resting("wall", simulation, bricks, 600);
+    }
+
+    /**
+     * 10000 spheres that are poured into a bin of 12 x 12 m, where they pile up to about 8 m.
+     */
+    benchmarks::ScenarioResult spheres_in_bin()
+    {
+        constexpr int columns = 20;
+        constexpr int layers = 25;
+        Simulation simulation;
+        simulation.enable_gravity();
+        simulation.disable_sleeping();
+        create_ground(simulation);
+        for (const double side: {-1, 1}) {
+            simulation.create_rigid_body(InertiaShape::static_shape(),
+                                         colliders::OrientedBox{.half_size = math::Vec3d(6.5, 8, 0.25)}, material,
+                                         math::Vec3d(0, 8, side * 6.25), math::Quatd());
+            simulation.create_rigid_body(InertiaShape::static_shape(),
+                                         colliders::OrientedBox{.half_size = math::Vec3d(0.25, 8, 6.5)}, material,
+                                         math::Vec3d(side * 6.25, 8, 0), math::Quatd());
+        }
+
+        std::vector<RigidBodyHandle> spheres;
+        for (int layer = 0; layer < layers; ++layer) {
+            for (int i = 0; i < columns; ++i) {
+                for (int j = 0; j < columns; ++j) {
+                    // offset every other layer, such that the spheres don't stack in columns
+                    const double offset = layer % 2 == 0 ? 0 : 0.2;
+                    const math::Vec3d position((i - columns / 2.0) * 0.55 + offset, 0.3 + layer * 0.55,
+                                               (j - columns / 2.0) * 0.55 + offset);
+                    spheres.push_back(simulation.create_rigid_body(InertiaShape::sphere(0.25, 1),
+                                                                   colliders::Sphere{.radius = 0.25}, material,
+                                                                   position, math::Quatd()));
+                }
+            }
+        }
+
+        benchmarks::ScenarioResult result = run("spheres_in_bin", simulation, spheres.size(), 0, 240);
+        result.stability_metric = "max_speed_m_per_s";
+        for (const RigidBodyHandle& sphere: spheres) {
+            result.stability = std::max(result.stability, length(simulation.lookup(sphere).velocity()));
+        }
+        return result;
+    }
+
+    /**
+     * The break shot of a game of pool on a table of 2.54 x 1.27 m, where a cue ball at 8 m/s hits a rack of 15
+     * balls. The balls use continuous collision detection, since the cue ball moves farther than its radius in a step.
+     */
+    benchmarks::ScenarioResult billiards()
+    {
+        constexpr double radius = 0.0286;
+        constexpr double mass = 0.17;
+        constexpr double speed = 8;
+        Simulation simulation;
+        simulation.enable_gravity();
+        simulation.disable_sleeping();
+        const Material cloth{.restitution = 0.5, .kinetic_friction = 0.2, .rolling_friction = 0.01};
+        const Material cushion{.restitution = 0.8, .kinetic_friction = 0.2, .rolling_friction = 0};
+        const Material ball{.restitution = 0.95, .kinetic_friction = 0.05, .rolling_friction = 0.01};
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedPlane{.original_normal = {0, 1, 0}}, cloth, math::Vec3d(),
+                                     math::Quatd());
+        for (const double side: {-1, 1}) {
+            simulation.create_rigid_body(InertiaShape::static_shape(),
+                                         colliders::OrientedBox{.half_size = math::Vec3d(1.37, 0.05, 0.1)}, cushion,
+                                         math::Vec3d(0, 0.05, side * 0.735), math::Quatd());
+            simulation.create_rigid_body(InertiaShape::static_shape(),
+                                         colliders::OrientedBox{.half_size = math::Vec3d(0.1, 0.05, 0.735)}, cushion,
+                                         math::Vec3d(side * 1.37, 0.05, 0), math::Quatd());
+        }
+
+        std::vector<RigidBodyHandle> balls;
+        auto create_ball = [&](const math::Vec3d& position) {
+            balls.push_back(simulation.create_rigid_body(InertiaShape::sphere(radius, mass),
+                                                         colliders::Sphere{.radius = radius}, ball, position,
+                                                         math::Quatd()));
+            simulation.lookup(balls.back()).enable_ccd();
+        };
+        const double spacing = 2 * radius + 0.0005;
+        for (int row = 0; row < 5; ++row) {
+            for (int i = 0; i <= row; ++i) {
+                create_ball(math::Vec3d(0.635 + row * spacing * 0.866, radius, (i - row / 2.0) * spacing));
+            }
+        }
+        create_ball(math::Vec3d(-0.635, radius, 0));
+        // an impulse over a single step
+        RigidBody& cue_ball = simulation.lookup(balls.back());
+        cue_ball.apply_force(math::Vec3d(mass * speed * 60, 0, 0), cue_ball.position());
+
+        // the kinetic energy of the balls may only decrease after the shot, any gain is added by the solver
+        double max_energy = 0;
+        auto measure_energy = [&] {
+            double energy = 0;
+            for (const RigidBodyHandle& handle: balls) {
+                energy += 0.5 * mass * length_sqr(simulation.lookup(handle).velocity());
+            }
+            max_energy = std::max(max_energy, energy);
+        };
+        benchmarks::ScenarioResult result = run("billiards", simulation, balls.size(), 0, 600, measure_energy);
+        result.stability_metric = "max_energy_ratio";
+        result.stability = max_energy / (0.5 * mass * speed * speed);
+        return result;
+    }
+
+    /**
+     * 1024 boxes that rest on the ground without touching each other. Once they are asleep, a step should cost
+     * almost nothing.
+     */
+    benchmarks::ScenarioResult idle()
+    {
+        constexpr int size = 32;
+        Simulation simulation;
+        simulation.enable_gravity();
+        create_ground(simulation);
+
+        std::vector<RigidBodyHandle> boxes;
+        for (int i = 0; i < size; ++i) {
+            for (int j = 0; j < size; ++j) {
+                boxes.push_back(simulation.create_rigid_body(InertiaShape::cube(1, 1),
+                                                             colliders::OrientedBox{.half_size = math::Vec3d(0.5)},
+                                                             material, math::Vec3d(2 * i, 0.5, 2 * j),
+                                                             math::Quatd()));
+            }
+        }
+
+        benchmarks::ScenarioResult result = run("idle", simulation, boxes.size(), 120, 300);
+        result.stability_metric = "awake_fraction";
+        const auto awake = std::ranges::count_if(boxes, [&simulation](const RigidBodyHandle& box) {
+            return !simulation.lookup(box).is_sleeping();
+        });
+        result.stability = static_cast<double>(awake) / static_cast<double>(boxes.size());
+        return result;
+    }
+
+    /**
+     * Standard scenarios that are tracked across commits.
+     */
+    void scenarios()
+    {
+        std::cout << std::setw(16) << "scenario"
+                  << std::setw(10) << "bodies"
+                  << std::setw(10) << "steps"
+                  << std::setw(14) << "mean [us]"
+                  << std::setw(14) << "max [us]"
+                  << std::setw(12) << "pairs"
+                  << std::setw(12) << "contacts"
+                  << std::setw(14) << "stability" << std::endl;
+
+        for (auto* scenario: {pyramid, wall, spheres_in_bin, billiards, idle}) {
+            const benchmarks::ScenarioResult result = scenario();
+            print(result);
+            benchmarks::report(result);
+        }
+    }
+
+    const benchmarks::Registration registration("scenarios", scenarios);
+}
@@ -0,0 +1,77 @@
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+#include <physics3d/Simulation.h>
+
+#include "Benchmark.h"
+
+using namespace yage;
+using namespace yage::physics3d;
+
+namespace
+{
+    const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+
+    /**
+     * A ground plane with stacks of two boxes in a square grid.
+     */
+    void create_scene(Simulation& simulation, const int n)
+    {
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedPlane{.original_normal = {0, 1, 0}}, material,
+                                     math::Vec3d(), math::Quatd());
+        const int side = static_cast<int>(std::ceil(std::sqrt(n / 2.)));
+        for (int i = 0; i < n; ++i) {
+            const int stack = i / 2;
+            simulation.create_rigid_body(InertiaShape::cube(2, 1), colliders::OrientedBox{.half_size = math::Vec3d(1)},
+                                         material,
+                                         math::Vec3d(2.5 * (stack % side), 1 + 2.01 * (i % 2), 2.5 * (stack / side)),
+                                         math::Quatd());
+        }
+    }
+
+    void snapshot_restore()
+    {
+        std::cout << std::setw(8) << "bodies"
+                  << std::setw(16) << "size [kB]"
+                  << std::setw(16) << "save [us]"
+                  << std::setw(16) << "restore [us]"
+                  << std::setw(16) << "rebuild [us]"
+                  << std::setw(16) << "step [us]" << std::endl;
+
+        for (const int n: {1000, 10000}) {
+            Simulation simulation;
+            simulation.enable_gravity();
+            simulation.disable_sleeping();
+            create_scene(simulation, n);
+            for (int i = 0; i < 30; ++i) {
+                simulation.update(1. / 60.);
+            }
+
+            Snapshot snapshot;
+            simulation.save(snapshot);
+            const double save_ns = benchmarks::measure_ns([&] { simulation.save(snapshot); }, 20);
+            const double restore_ns = benchmarks::measure_ns([&] { simulation.restore(snapshot); }, 20);
+
+            // reference: recreating the bodies in a new simulation, which doesn't even restore velocities or contacts
+            const double rebuild_ns = benchmarks::measure_ns([&] {
+                Simulation rebuilt;
+                rebuilt.enable_gravity();
+                create_scene(rebuilt, n);
+            }, 5);
+
+            const double step_ns = benchmarks::measure_ns([&] { simulation.update(1. / 60.); }, 10);
+
+            std::cout << std::setw(8) << n
+                      << std::setw(16) << std::fixed << std::setprecision(1)
+                      << static_cast<double>(snapshot.size()) / 1024
+                      << std::setw(16) << save_ns / 1000
+                      << std::setw(16) << restore_ns / 1000
+                      << std::setw(16) << rebuild_ns / 1000
+                      << std::setw(16) << step_ns / 1000 << std::endl;
+        }
+    }
+
+    const benchmarks::Registration registration("snapshot_restore", snapshot_restore);
+}
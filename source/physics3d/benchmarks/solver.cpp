@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#include <physics3d/Simulation.h>
+
+#include "Benchmark.h"
+
+using namespace yage;
+using namespace yage::physics3d;
+
+namespace
+{
+    /**
+     * Measures the step time of a grid of box stacks, which is dominated by the constraint solver.
+     */
+    double step_ns(const std::size_t threads)
+    {
+        Simulation simulation;
+        simulation.enable_gravity();
+        simulation.disable_sleeping();
+        simulation.set_thread_count(threads);
+
+        const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedPlane{.original_normal = {0, 1, 0}}, material,
+                                     math::Vec3d(), math::Quatd());
+        for (int x = 0; x < 20; ++x) {
+            for (int z = 0; z < 20; ++z) {
+                for (int y = 0; y < 5; ++y) {
+                    simulation.create_rigid_body(InertiaShape::cube(1, 1),
+                                                 colliders::OrientedBox{.half_size = math::Vec3d(0.5)}, material,
+                                                 math::Vec3d(1.5 * x, 0.5 + 1.05 * y, 1.5 * z), math::Quatd());
+                }
+            }
+        }
+
+        // let the stacks settle, so that all contacts exist
+        for (int i = 0; i < 60; ++i) {
+            simulation.update(1. / 60.);
+        }
+        return benchmarks::measure_ns([&] { simulation.update(1. / 60.); }, 60);
+    }
+
+    /**
+     * Compares the step time of the parallel constraint solver for increasing thread counts against the
+     * single-threaded solver.
+     */
+    void parallel_solver()
+    {
+        std::cout << std::setw(10) << "threads"
+                  << std::setw(16) << "step [us]"
+                  << std::setw(12) << "speed-up" << std::endl;
+
+        const std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+        const double serial_ns = step_ns(1);
+        for (std::size_t threads = 1; threads <= cores; threads *= 2) {
+            const double ns = threads == 1 ? serial_ns : step_ns(threads);
+            std::cout << std::setw(10) << threads << std::fixed << std::setprecision(1)
+                      << std::setw(16) << ns / 1000
+                      << std::setw(12) << std::setprecision(2) << serial_ns / ns << std::endl;
+        }
+    }
+
+    const benchmarks::Registration registration("parallel_solver", parallel_solver);
+}
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+#include <physics3d/Simulation.h>
+
+#include "Benchmark.h"
+
+using namespace yage;
+using namespace yage::physics3d;
+
+namespace
+{
+    struct StackResult
+    {
+        /**
+         * How far the top box has sunk below its resting height.
+         */
+        double sink{};
+
+        /**
+         * Largest horizontal distance of any box from the stack's axis.
+         */
+        double drift{};
+
+        double step_ns{};
+    };
+
+    StackResult simulate_stack(const int height, const int iterations, const bool warm_starting)
+    {
+        Simulation simulation;
+        simulation.enable_gravity();
+        simulation.set_solver_iterations(iterations);
+        if (!warm_starting) {
+            simulation.disable_warm_starting();
+        }
+
+        const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedPlane{.original_normal = {0, 1, 0}}, material,
+                                     math::Vec3d(), math::Quatd());
+        std::vector<RigidBodyHandle> boxes;
+        for (int i = 0; i < height; ++i) {
+            boxes.push_back(simulation.create_rigid_body(InertiaShape::cube(1, 0.5),
+                                                         colliders::OrientedBox{.half_size = math::Vec3d(0.5)},
+                                                         material, math::Vec3d(0, 0.5 + i * 1.05, 0),
+                                                         math::Quatd()));
+        }
+
+        StackResult result;
+        result.step_ns = benchmarks::measure_ns([&] { simulation.update(1. / 60.); }, 600);
+
+        result.sink = (height - 0.5) - simulation.lookup(boxes.back()).position().y();
+        for (const RigidBodyHandle& box: boxes) {
+            const math::Vec3d position = simulation.lookup(box).position();
+            result.drift = std::max(result.drift, std::hypot(position.x(), position.z()));
+        }
+        return result;
+    }
+
+    /**
+     * Compares how stable a stack of boxes stays after 10 seconds for different solver iteration counts, with and
+     * without warm starting.
+     */
+    void stacking()
+    {
+        constexpr int height = 10;
+        std::cout << std::setw(12) << "iterations"
+                  << std::setw(16) << "cold sink [m]"
+                  << std::setw(16) << "cold drift [m]"
+                  << std::setw(16) << "warm sink [m]"
+                  << std::setw(16) << "warm drift [m]"
+                  << std::setw(16) << "warm step [us]" << std::endl;
+
+        for (const int iterations: {1, 2, 3, 4, 6, 10, 20}) {
+            const StackResult cold = simulate_stack(height, iterations, false);
+            const StackResult warm = simulate_stack(height, iterations, true);
+
+            std::cout << std::setw(12) << iterations << std::fixed << std::setprecision(4)
+                      << std::setw(16) << cold.sink
+                      << std::setw(16) << cold.drift
+                      << std::setw(16) << warm.sink
+                      << std::setw(16) << warm.drift
+                      << std::setw(16) << std::setprecision(1) << warm.step_ns / 1000 << std::endl;
+        }
+    }
+
+    const benchmarks::Registration registration("stacking", stacking);
+}
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <physics3d/Simulation.h>
+
+#include "Benchmark.h"
+
+using namespace yage;
+using namespace yage::physics3d;
+
+namespace
+{
+    struct SolverMode
+    {
+        std::string name;
+        int iterations{};
+        int substeps{};
+    };
+
+    struct StackSample
+    {
+        /**
+         * How far the top box has sunk below its resting height.
+         */
+        double sink{};
+
+        /**
+         * Largest horizontal distance of any box from the stack's axis.
+         */
+        double drift{};
+    };
+
+    /**
+     * Builds the scene of the boxes demo, where boxes are dropped onto a stack with a small gap in between. The top box
+     * can be made heavier to test large mass ratios.
+     */
+    std::vector<RigidBodyHandle> box_demo_scene(Simulation& simulation, const int height, const double top_mass)
+    {
+        const Material ground_material{.restitution = 0.0, .kinetic_friction = 1.0};
+        const Material cube_material{.restitution = 0.0, .kinetic_friction = 0.5};
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedPlane{.original_normal = {0, -1, 0}}, ground_material,
+                                     math::Vec3d(0), math::Quatd());
+
+        std::vector<RigidBodyHandle> boxes;
+        for (int i = 0; i < height; ++i) {
+            const double mass = i == height - 1 ? top_mass : 1;
+            boxes.push_back(simulation.create_rigid_body(InertiaShape::cube(2, mass),
+                                                         colliders::OrientedBox{.half_size = math::Vec3d(1)},
+                                                         cube_material, math::Vec3d(0, 1.2 + i * 2.5, 0),
+                                                         math::Quatd()));
+        }
+        return boxes;
+    }
+
+    StackSample sample(Simulation& simulation, const std::vector<RigidBodyHandle>& boxes)
+    {
+        StackSample result;
+        result.sink = (2. * static_cast<double>(boxes.size()) - 1) - simulation.lookup(boxes.back()).position().y();
+        for (const RigidBodyHandle& box: boxes) {
+            const math::Vec3d position = simulation.lookup(box).position();
+            result.drift = std::max(result.drift, std::hypot(position.x(), position.z()));
+        }
+        return result;
+    }
+
+    /**
+     * Compares how stable the stacks of the boxes demo stay over time with many solver iterations per step and with
+     * sub-stepping, along with the cost of a step.
+     */
+    void substepping()
+    {
+        const std::vector<SolverMode> modes{
+                {"10 iterations", 10, 1},
+                {"20 iterations", 20, 1},
+                {"40 iterations", 40, 1},
+                {"2 substeps", 1, 2},
+                {"4 substeps", 1, 4},
+                {"8 substeps", 1, 8},
+        };
+        constexpr std::array sample_seconds{2, 5, 10, 20};
+
+        for (const auto& [height, top_mass]: {std::pair{4, 1.}, std::pair{12, 1.}, std::pair{8, 20.}}) {
+            std::cout << std::defaultfloat << height << " boxes, top box mass ratio " << top_mass << std::endl;
+            std::cout << std::setw(16) << "mode" << std::setw(12) << "step [us]";
+            for (const int seconds: sample_seconds) {
+                std::cout << std::setw(14) << "sink " + std::to_string(seconds) + "s"
+                          << std::setw(14) << "drift " + std::to_string(seconds) + "s";
+            }
+            std::cout << std::endl;
+
+            for (const SolverMode& mode: modes) {
+                Simulation simulation;
+                simulation.enable_gravity();
+                simulation.disable_sleeping();
+                simulation.set_solver_iterations(mode.iterations);
+                if (mode.substeps > 1) {
+                    simulation.enable_substepping(mode.substeps);
+                }
+                const std::vector<RigidBodyHandle> boxes = box_demo_scene(simulation, height, top_mass);
+
+                std::vector<StackSample> samples;
+                double step_ns = 0;
+                int step = 0;
+                for (const int seconds: sample_seconds) {
+                    const int steps = seconds * 60 - step;
+                    step_ns += steps * benchmarks::measure_ns([&] { simulation.update(1. / 60.); }, steps);
+                    step += steps;
+                    samples.push_back(sample(simulation, boxes));
+                }
+
+                std::cout << std::setw(16) << mode.name << std::fixed
+                          << std::setw(12) << std::setprecision(1) << step_ns / step / 1000 << std::setprecision(4);
+                for (const StackSample& s: samples) {
+                    std::cout << std::setw(14) << s.sink << std::setw(14) << s.drift;
+                }
+                std::cout << std::endl;
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    const benchmarks::Registration registration("substepping", substepping);
+}
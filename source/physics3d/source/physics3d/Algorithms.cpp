@@ -1,47 +1,36 @@
-#include <vector>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <limits>
+
 #include "Algorithms.h"
 
 namespace yage::physics3d
 {
     std::optional<math::Vec3d>
     sat_3d(std::span<const math::Vec3d> vertices_a, std::span<const math::Vec3d> vertices_b,
-                      std::span<const math::Vec3d> normals_a, std::span<const math::Vec3d> normals_b)
+                      std::span<const math::Vec3d> normals_a, std::span<const math::Vec3d> normals_b,
+                      math::Vec3d* axis_hint)
     {
-        std::vector<math::Vec3d> axes;
-        axes.reserve(normals_a.size() + normals_b.size() + normals_a.size() * normals_b.size());
-        axes.insert(axes.end(), normals_a.begin(), normals_a.end());
-        axes.insert(axes.end(), normals_b.begin(), normals_b.end());
-        // for 3D SAT we must additionally check the cross products of each normal from A and each normal from B
-        for (const math::Vec3d& n_a: normals_a) {
-            for (const math::Vec3d& n_b: normals_b) {
-                // if the cross product is zero, the normals are parallel, so we can skip this combination
-                if (math::Vec3d cross = math::cross(n_a, n_b);
-                    cross != math::Vec3d(0)) {
-                    axes.push_back(math::normalize(cross));
-                }
-            }
-        }
-
         double min_penetration = std::numeric_limits<double>::max();
         math::Vec3d min_penetration_axis;
 
-        for (const math::Vec3d& axis: axes) {
-            double a_min = std::numeric_limits<double>::max();
-            double a_max = std::numeric_limits<double>::min();
-            double b_min = std::numeric_limits<double>::max();
-            double b_max = std::numeric_limits<double>::min();
-
-            // find the upper and lower bounds of the vertices projected onto the test axis
-            for (const math::Vec3d& vertex: vertices_a) {
-                double projection = dot(vertex, axis);
-                a_min = std::min(a_min, projection);
-                a_max = std::max(a_max, projection);
-            }
-            for (const math::Vec3d& vertex: vertices_b) {
-                double projection = dot(vertex, axis);
-                b_min = std::min(b_min, projection);
-                b_max = std::max(b_max, projection);
+        // finds the upper and lower bounds of the vertices projected onto an axis
+        const auto project = [](std::span<const math::Vec3d> vertices, const math::Vec3d& axis) {
+            double min = std::numeric_limits<double>::max();
+            double max = std::numeric_limits<double>::lowest();
+            for (const math::Vec3d& vertex: vertices) {
+                const double projection = dot(vertex, axis);
+                min = std::min(min, projection);
+                max = std::max(max, projection);
             }
+            return std::pair(min, max);
+        };
+
+        // tests a single axis and returns false if it is a separating axis
+        const auto test_axis = [&](const math::Vec3d& axis) {
+            const auto [a_min, a_max] = project(vertices_a, axis);
+            const auto [b_min, b_max] = project(vertices_b, axis);
 
             // test whether the projected ranges overlap
             if (a_min <= b_min && b_min <= a_max) {
@@ -62,10 +51,48 @@ namespace yage::physics3d
                 }
             } else {
                 // no overlap, we found a separating axis
+                if (axis_hint != nullptr) {
+                    *axis_hint = axis;
+                }
+                return false;
+            }
+            return true;
+        };
+
+        // the shapes move only slightly between steps, so an axis that separated them before likely still does
+        if (axis_hint != nullptr && length_sqr(*axis_hint) > 0) {
+            const auto [a_min, a_max] = project(vertices_a, *axis_hint);
+            const auto [b_min, b_max] = project(vertices_b, *axis_hint);
+            if (a_max < b_min || b_max < a_min) {
+                return {};
+            }
+        }
+
+        // the axes are generated on the fly instead of being collected first, so that no memory is allocated
+        for (const math::Vec3d& axis: normals_a) {
+            if (!test_axis(axis)) {
                 return {};
             }
         }
+        for (const math::Vec3d& axis: normals_b) {
+            if (!test_axis(axis)) {
+                return {};
+            }
+        }
+        // for 3D SAT we must additionally check the cross products of each normal from A and each normal from B
+        for (const math::Vec3d& n_a: normals_a) {
+            for (const math::Vec3d& n_b: normals_b) {
+                // if the cross product is zero, the normals are parallel, so we can skip this combination
+                if (math::Vec3d cross = math::cross(n_a, n_b);
+                    cross != math::Vec3d(0) && !test_axis(math::normalize(cross))) {
+                    return {};
+                }
+            }
+        }
 
+        if (axis_hint != nullptr) {
+            *axis_hint = normalize(min_penetration_axis);
+        }
         // adjust the length to be equal to the penetration distance
         return {min_penetration * normalize(min_penetration_axis)};
     }
@@ -79,31 +106,47 @@ namespace yage::physics3d
         return l0 + line_direction * d;
     }
 
-    std::vector<math::Vec3d>
-    clip_sutherland_hodgman(std::span<geometry::Plane> clipping_planes, std::span<const math::Vec3d> polygon)
+    geometry::ClipPolygon
+    clip_sutherland_hodgman(std::span<const geometry::Plane> clipping_planes,
+                            std::span<const std::uint8_t> clipping_plane_ids,
+                            std::span<const geometry::ClipVertex> polygon)
     {
-        std::vector<math::Vec3d> output;
-        output.insert(output.end(), polygon.begin(), polygon.end());
-        std::vector<math::Vec3d> input;
-        input.reserve(output.size());
-
-        for (const auto& [support, normal]: clipping_planes) {
-            input.clear();
-            input.insert(input.end(), output.begin(), output.end());
+        // each plane adds at most one vertex to a convex polygon
+        assert(polygon.size() + clipping_planes.size() <= geometry::ClipPolygon::capacity());
+
+        geometry::ClipPolygon output;
+        for (const geometry::ClipVertex& vertex: polygon) {
+            output.push_back(vertex);
+        }
+        geometry::ClipPolygon input;
+
+        for (std::size_t p = 0; p < clipping_planes.size(); ++p) {
+            const auto& [support, normal] = clipping_planes[p];
+            const std::uint8_t plane_id = clipping_plane_ids[p];
+
+            input = output;
             output.clear();
             for (std::size_t i = 0; i < input.size(); ++i) {
-                math::Vec3d current = input[i];
-                math::Vec3d previous = input[(i - 1) % input.size()];
-                if (dot(current - support, normal) >= 0) {
+                const geometry::ClipVertex& current = input[i];
+                const geometry::ClipVertex& previous = input[(i + input.size() - 1) % input.size()];
+                if (dot(current.point - support, normal) >= 0) {
                     // current is inside
-                    if (dot(previous - support, normal) < 0) {
-                        // previous is outside
-                        output.push_back(intersection(support, normal, previous, current));
+                    if (dot(previous.point - support, normal) < 0) {
+                        // previous is outside, so we enter the clipping plane on the edge leading to current
+                        output.push_back({
+                                .point = intersection(support, normal, previous.point, current.point),
+                                .edge_in = plane_id,
+                                .edge_out = previous.edge_out,
+                        });
                     }
                     output.push_back(current);
-                } else if (dot(previous - support, normal) >= 0) {
-                    // current is outside && previous is inside
-                    output.push_back(intersection(support, normal, previous, current));
+                } else if (dot(previous.point - support, normal) >= 0) {
+                    // current is outside && previous is inside, so we leave along the clipping plane
+                    output.push_back({
+                            .point = intersection(support, normal, previous.point, current.point),
+                            .edge_in = previous.edge_out,
+                            .edge_out = plane_id,
+                    });
                 }
             }
         }
@@ -111,13 +154,14 @@ namespace yage::physics3d
         return output;
     }
 
-    std::vector<std::tuple<math::Vec3d, double> >
-    clip_discard(const geometry::Plane& clipping_plane, std::span<const math::Vec3d> points)
+    geometry::ClipResult
+    clip_discard(const geometry::Plane& clipping_plane, std::span<const geometry::ClipVertex> points)
     {
-        std::vector<std::tuple<math::Vec3d, double> > result;
-        result.reserve(points.size());
-        for (math::Vec3d vertex: points) {
-            double dist = dot(vertex - clipping_plane.support, clipping_plane.normal);
+        assert(points.size() <= geometry::ClipResult::capacity());
+
+        geometry::ClipResult result;
+        for (const geometry::ClipVertex& vertex: points) {
+            double dist = dot(vertex.point - clipping_plane.support, clipping_plane.normal);
             if (dist >= 0) {
                 // point is inside
                 result.emplace_back(vertex, dist);
@@ -126,7 +170,7 @@ namespace yage::physics3d
         return result;
     }
 
-    std::tuple<geometry::Rectangle, math::Vec3d>
+    std::tuple<geometry::Rectangle, math::Vec3d, std::array<std::uint8_t, 4>>
     most_perpendicular_cube_face(const math::Vec3d& n, const std::span<const math::Vec3d> vertices)
     {
         // encodes the 3 adjacent faces (4 vertex indices and one normal index) for each vertex
@@ -196,33 +240,77 @@ namespace yage::physics3d
 
         // find the faces that the farthest vertex (v0) is part of
         const math::Vec3d v0 = vertices[max_i];
-        geometry::Rectangle face_x = {
-            vertices[encoding[max_i][0]], vertices[encoding[max_i][1]],
-            vertices[encoding[max_i][2]], vertices[encoding[max_i][3]]
+        auto face = [&](const std::size_t offset) {
+            const auto& e = encoding[max_i];
+            return std::tuple{
+                geometry::Rectangle{
+                    vertices[e[offset]], vertices[e[offset + 1]], vertices[e[offset + 2]], vertices[e[offset + 3]]
+                },
+                normalize(v0 - vertices[e[offset + 4]]),
+                std::array{
+                    static_cast<std::uint8_t>(e[offset]), static_cast<std::uint8_t>(e[offset + 1]),
+                    static_cast<std::uint8_t>(e[offset + 2]), static_cast<std::uint8_t>(e[offset + 3])
+                },
+            };
         };
-        math::Vec3d normal_x = normalize(v0 - vertices[encoding[max_i][4]]);
-
-        geometry::Rectangle face_y = {
-            vertices[encoding[max_i][5]], vertices[encoding[max_i][6]],
-            vertices[encoding[max_i][7]], vertices[encoding[max_i][8]]
-        };
-        math::Vec3d normal_y = normalize(v0 - vertices[encoding[max_i][9]]);
-
-        geometry::Rectangle face_z = {
-            vertices[encoding[max_i][10]], vertices[encoding[max_i][11]],
-            vertices[encoding[max_i][12]], vertices[encoding[max_i][13]]
-        };
-        math::Vec3d normal_z = normalize(v0 - vertices[encoding[max_i][14]]);
+        const auto face_x = face(0);
+        const auto face_y = face(5);
+        const auto face_z = face(10);
+        const math::Vec3d& normal_x = std::get<1>(face_x);
+        const math::Vec3d& normal_y = std::get<1>(face_y);
+        const math::Vec3d& normal_z = std::get<1>(face_z);
 
         // find the face that is most perpendicular to the target vector n
         if (dot(normal_x, n) > dot(normal_y, n) &&
             dot(normal_x, n) > dot(normal_z, n)) {
-            return {face_x, normal_x};
+            return face_x;
         }
         if (dot(normal_y, n) > dot(normal_x, n) &&
             dot(normal_y, n) > dot(normal_z, n)) {
-            return {face_y, normal_y};
+            return face_y;
+        }
+        return face_z;
+    }
+
+    void add_reduced_contacts(ContactManifold& manifold, std::span<const ContactPoint> candidates)
+    {
+        if (candidates.size() <= 4) {
+            for (const ContactPoint& contact: candidates) {
+                manifold.contacts.push_back(contact);
+            }
+            return;
+        }
+
+        std::array<std::size_t, 4> chosen{};
+        auto select = [&candidates](auto score) {
+            std::size_t best = 0;
+            for (std::size_t i = 1; i < candidates.size(); ++i) {
+                if (score(candidates[i]) > score(candidates[best])) {
+                    best = i;
+                }
+            }
+            return best;
+        };
+        chosen[0] = select([](const ContactPoint& contact) { return contact.depth; });
+        const math::Vec3d p0 = candidates[chosen[0]].p_b;
+        chosen[1] = select([&p0](const ContactPoint& contact) { return length_sqr(contact.p_b - p0); });
+        const math::Vec3d p1 = candidates[chosen[1]].p_b;
+        chosen[2] = select([&](const ContactPoint& contact) {
+            return length_sqr(cross(p1 - p0, contact.p_b - p0));
+        });
+        const math::Vec3d p2 = candidates[chosen[2]].p_b;
+        // the fourth point lies farthest outside of an edge of the triangle, against its winding
+        const math::Vec3d n = cross(p1 - p0, p2 - p0);
+        chosen[3] = select([&](const ContactPoint& contact) {
+            const math::Vec3d& p = contact.p_b;
+            return -std::min({dot(cross(p1 - p0, p - p0), n), dot(cross(p2 - p1, p - p1), n),
+                              dot(cross(p0 - p2, p - p2), n)});
+        });
+
+        for (std::size_t i = 0; i < chosen.size(); ++i) {
+            if (std::find(chosen.begin(), chosen.begin() + i, chosen[i]) == chosen.begin() + i) {
+                manifold.contacts.push_back(candidates[chosen[i]]);
+            }
         }
-        return {face_z, normal_z};
     }
 }
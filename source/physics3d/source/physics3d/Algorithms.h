@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cmath>
+#include <cstdint>
 #include <span>
 #include <vector>
 #include <optional>
@@ -7,6 +9,9 @@
 
 #include <math/vector.h>
 
+#include "Collision.h"
+#include "FixedVector.h"
+
 namespace yage::physics3d
 {
     namespace geometry
@@ -27,6 +32,138 @@ namespace yage::physics3d
         };
 
         using Rectangle = std::array<math::Vec3d, 4>;
+
+        /**
+         * Vertex of a polygon that is being clipped. Each vertex remembers the two polygon edges or clipping planes
+         * that meet in it, which identifies the vertex across frames. For single points, both ids are the point's id.
+         */
+        struct ClipVertex
+        {
+            math::Vec3d point;
+            std::uint8_t edge_in{};
+            std::uint8_t edge_out{};
+        };
+
+        /**
+         * @return An id of the geometric feature that a clip vertex originates from.
+         */
+        inline std::uint32_t feature_id(const ClipVertex& vertex)
+        {
+            return static_cast<std::uint32_t>(vertex.edge_in) << 8 | vertex.edge_out;
+        }
+
+        /**
+         * A clipped polygon. Clipping a box face against the four adjacent faces of another box yields at most eight
+         * vertices, clipping the contact features of convex shapes at most sixteen.
+         */
+        using ClipPolygon = FixedVector<ClipVertex, 16>;
+
+        /**
+         * Clip vertices that remain after clipping against a plane, along with their penetration depths.
+         */
+        using ClipResult = FixedVector<std::tuple<ClipVertex, double>, 8>;
+
+        /**
+         * Represents an axis-aligned bounding box in 3D. Infinite bounds are expressed by infinite components.
+         */
+        struct AABB
+        {
+            math::Vec3d min;
+            math::Vec3d max;
+        };
+
+        /**
+         * @return Whether the two boxes overlap. Touching boxes are considered overlapping.
+         */
+        inline bool overlaps(const AABB& a, const AABB& b)
+        {
+            return a.min.x() <= b.max.x() && b.min.x() <= a.max.x() &&
+                   a.min.y() <= b.max.y() && b.min.y() <= a.max.y() &&
+                   a.min.z() <= b.max.z() && b.min.z() <= a.max.z();
+        }
+
+        /**
+         * @return Whether the outer box fully contains the inner box.
+         */
+        inline bool contains(const AABB& outer, const AABB& inner)
+        {
+            return outer.min.x() <= inner.min.x() && inner.max.x() <= outer.max.x() &&
+                   outer.min.y() <= inner.min.y() && inner.max.y() <= outer.max.y() &&
+                   outer.min.z() <= inner.min.z() && inner.max.z() <= outer.max.z();
+        }
+
+        /**
+         * @return The smallest box enclosing both given boxes.
+         */
+        inline AABB merge(const AABB& a, const AABB& b)
+        {
+            return {
+                    .min = {std::min(a.min.x(), b.min.x()), std::min(a.min.y(), b.min.y()),
+                            std::min(a.min.z(), b.min.z())},
+                    .max = {std::max(a.max.x(), b.max.x()), std::max(a.max.y(), b.max.y()),
+                            std::max(a.max.z(), b.max.z())},
+            };
+        }
+
+        /**
+         * @return The surface area of the box, used as the cost metric for bounding volume hierarchies.
+         */
+        inline double surface_area(const AABB& aabb)
+        {
+            const math::Vec3d extent = aabb.max - aabb.min;
+            return 2.0 * (extent.x() * extent.y() + extent.y() * extent.z() + extent.z() * extent.x());
+        }
+
+        /**
+         * @return Whether any of the box's bounds lies at infinity.
+         */
+        inline bool is_infinite(const AABB& aabb)
+        {
+            return std::isinf(aabb.min.x()) || std::isinf(aabb.min.y()) || std::isinf(aabb.min.z()) ||
+                   std::isinf(aabb.max.x()) || std::isinf(aabb.max.y()) || std::isinf(aabb.max.z());
+        }
+
+        /**
+         * @return Whether the box intersects the plane, i.e. has vertices on both sides or touching it.
+         */
+        inline bool intersects(const AABB& aabb, const Plane& plane)
+        {
+            const math::Vec3d center = 0.5 * (aabb.min + aabb.max);
+            const math::Vec3d half_extent = 0.5 * (aabb.max - aabb.min);
+            // projection radius of the box onto the plane normal
+            const double radius = half_extent.x() * std::abs(plane.normal.x()) +
+                                  half_extent.y() * std::abs(plane.normal.y()) +
+                                  half_extent.z() * std::abs(plane.normal.z());
+            return std::abs(dot(center - plane.support, plane.normal)) <= radius;
+        }
+
+        /**
+         * @return Whether a line segment intersects the box, including segments that start within the box.
+         * @param start The start of the segment.
+         * @param displacement The vector from the start to the end of the segment.
+         */
+        inline bool intersects(const AABB& aabb, const math::Vec3d& start, const math::Vec3d& displacement)
+        {
+            // clip the segment against the slabs of the box
+            double t_enter = 0;
+            double t_exit = 1;
+            for (std::size_t i = 0; i < 3; ++i) {
+                if (displacement(i) == 0) {
+                    if (start(i) < aabb.min(i) || start(i) > aabb.max(i)) {
+                        return false;
+                    }
+                    continue;
+                }
+                const double t_0 = (aabb.min(i) - start(i)) / displacement(i);
+                const double t_1 = (aabb.max(i) - start(i)) / displacement(i);
+                t_enter = std::max(t_enter, std::min(t_0, t_1));
+                t_exit = std::min(t_exit, std::max(t_0, t_1));
+                if (t_enter > t_exit) {
+                    return false;
+                }
+            }
+            return true;
+        }
     }
 
     /**
@@ -35,13 +172,16 @@ namespace yage::physics3d
      * @param vertices_b Vertices of body B in world space.
      * @param normals_a Face normals of body A in world space. Parallel normals are redundant and can be omitted.
      * @param normals_b Face normals of body B in world space. Parallel normals are redundant and can be omitted.
+     * @param axis_hint An axis that is tested for separation first, such as the axis of the previous step, or zero.
+     * It is set to the separating axis that is found, or to the direction of the MTV. May be null.
      * @return The minimum translation vector (MTV) between bodies A and B or empty if a separating axis is found.
      * The MTV's magnitude is equal to the overlap between bodies A and B. The MTV points away from A.
      */
     std::optional<math::Vec3d> sat_3d(std::span<const math::Vec3d> vertices_a,
                                      std::span<const math::Vec3d> vertices_b,
                                      std::span<const math::Vec3d> normals_a,
-                                     std::span<const math::Vec3d> normals_b);
+                                     std::span<const math::Vec3d> normals_b,
+                                     math::Vec3d* axis_hint = nullptr);
 
     /**
      * Returns the intersection of a non-parallel line and plane. Crashes if the line is parallel to the plane.
@@ -57,20 +197,26 @@ namespace yage::physics3d
     /**
      * Performs Sutherland-Hodgman clipping of a polygon against a clipping plane.
      * @param clipping_planes Clipping planes with normals pointing inwards.
-     * @param polygon Vertices of the polygon to clip, in line-strip order.
-     * @return Vertices of the clipped polygon in line-strip order.
+     * @param clipping_plane_ids Ids of the clipping planes, which are assigned to the edges of the clipped polygon that
+     * lie on the respective plane. Must be distinct from the ids of the polygon's edges.
+     * @param polygon Vertices of the polygon to clip, in line-strip order. The outgoing edge id of each vertex must
+     * equal the incoming edge id of the next vertex.
+     * @return Vertices of the clipped polygon in line-strip order. The polygon size plus the number of clipping planes
+     * must not exceed the capacity of the result.
      */
-    std::vector<math::Vec3d>
-    clip_sutherland_hodgman(std::span<geometry::Plane> clipping_planes, std::span<const math::Vec3d> polygon);
+    geometry::ClipPolygon
+    clip_sutherland_hodgman(std::span<const geometry::Plane> clipping_planes,
+                            std::span<const std::uint8_t> clipping_plane_ids,
+                            std::span<const geometry::ClipVertex> polygon);
 
     /**
      * Clips a set of points against a plane by discarding clipped points without intersection replacement.
      * @param clipping_plane Clipping plane with the normal pointing inwards.
-     * @param points Points to clip in any order.
+     * @param points Points to clip in any order, at most as many as the result can hold.
      * @return Pairs of remaining points and their (positive) penetration depths w.r.t. to the clipping plane.
      */
-    std::vector<std::tuple<math::Vec3d, double>>
-    clip_discard(const geometry::Plane& clipping_plane, std::span<const math::Vec3d> points);
+    geometry::ClipResult
+    clip_discard(const geometry::Plane& clipping_plane, std::span<const geometry::ClipVertex> points);
 
     /**
      * Finds the face of a cube such that the face normal is the most perpendicular to a given vector.
@@ -86,8 +232,16 @@ namespace yage::physics3d
      * |/            |/       /
      * 4-------------5       z
      *
-     * @return The most perpendicular face along with its face normal, pointing outwards.
+     * @return The most perpendicular face along with its face normal, pointing outwards, and the indices of the face's
+     * vertices.
      */
-    std::tuple<geometry::Rectangle, math::Vec3d>
+    std::tuple<geometry::Rectangle, math::Vec3d, std::array<std::uint8_t, 4>>
     most_perpendicular_cube_face(const math::Vec3d& n, std::span<const math::Vec3d> vertices);
+
+    /**
+     * Adds the contact points that span the largest area to a manifold, which are at most four: the deepest point,
+     * the point farthest from it, the point that spans the largest triangle with both, and the point farthest
+     * outside that triangle. Fewer contacts support a resting body just as well, with fewer constraint rows.
+     */
+    void add_reduced_contacts(ContactManifold& manifold, std::span<const ContactPoint> candidates);
 }
@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <cmath>
+
+#include "BodyStore.h"
+
+namespace yage::physics3d
+{
+    // The integration loops take restrict-qualified pointers to the arrays of one vector component at a time, so that
+    // the compiler can vectorize them without runtime alias checks. Bodies that are not simulated are masked out by
+    // multiplying with their simulation flag.
+
+    template<typename Scalar>
+    void integrate_linear_velocity(const std::size_t n, Scalar* __restrict v, const Scalar* __restrict f,
+                                   const Scalar* __restrict inverse_mass, const Scalar* __restrict simulated,
+                                   const Scalar acceleration, const Scalar dt)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            // external forces
+            v[i] += (inverse_mass[i] > 0 ? simulated[i] : 0) * acceleration;
+            // linear component
+            v[i] += simulated[i] * (inverse_mass[i] * f[i] * dt);
+        }
+    }
+
+    /**
+     * Integrates one component of the angular velocity, using the corresponding row of the inverse inertia tensors.
+     */
+    template<typename Scalar>
+    void integrate_angular_velocity(const std::size_t n, Scalar* __restrict w, const Scalar* __restrict t_x,
+                                    const Scalar* __restrict t_y, const Scalar* __restrict t_z,
+                                    const Scalar* __restrict i_x, const Scalar* __restrict i_y,
+                                    const Scalar* __restrict i_z, const Scalar* __restrict simulated, const Scalar dt)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            w[i] += simulated[i] * ((i_x[i] * t_x[i] + i_y[i] * t_y[i] + i_z[i] * t_z[i]) * dt);
+        }
+    }
+
+    template<typename Scalar>
+    void integrate_position(const std::size_t n, Scalar* __restrict p, const Scalar* __restrict v,
+                            const Scalar* __restrict simulated, const Scalar dt)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            p[i] += simulated[i] * (v[i] * dt);
+        }
+    }
+
+    template<typename Scalar>
+    void integrate_orientation(const std::size_t n, Scalar* __restrict q_w, Scalar* __restrict q_x,
+                               Scalar* __restrict q_y, Scalar* __restrict q_z, const Scalar* __restrict w_x,
+                               const Scalar* __restrict w_y, const Scalar* __restrict w_z,
+                               const Scalar* __restrict simulated, const Scalar dt)
+    {
+        for (std::size_t i = 0; i < n; ++i) {
+            // q += 0.5 * (0, w) * q * dt
+            const Scalar h_x = Scalar(0.5) * w_x[i];
+            const Scalar h_y = Scalar(0.5) * w_y[i];
+            const Scalar h_z = Scalar(0.5) * w_z[i];
+            const Scalar w = q_w[i] + (-(h_x * q_x[i] + h_y * q_y[i] + h_z * q_z[i])) * dt;
+            const Scalar x = q_x[i] + (q_w[i] * h_x + (h_y * q_z[i] - h_z * q_y[i])) * dt;
+            const Scalar y = q_y[i] + (q_w[i] * h_y + (h_z * q_x[i] - h_x * q_z[i])) * dt;
+            const Scalar z = q_z[i] + (q_w[i] * h_z + (h_x * q_y[i] - h_y * q_x[i])) * dt;
+
+            // normalize, but leave bodies that are not simulated untouched; blending with the mask instead of
+            // selecting keeps the loop free of branches
+            const Scalar s = simulated[i];
+            const Scalar inverse_length = 1 / std::sqrt(x * x + y * y + z * z + w * w);
+            q_w[i] = s * (w * inverse_length) + (1 - s) * q_w[i];
+            q_x[i] = s * (x * inverse_length) + (1 - s) * q_x[i];
+            q_y[i] = s * (y * inverse_length) + (1 - s) * q_y[i];
+            q_z[i] = s * (z * inverse_length) + (1 - s) * q_z[i];
+        }
+    }
+
+    template<typename Scalar>
+    void BasicBodyStore<Scalar>::reset(const std::size_t id, const InertiaShape& inertia_shape,
+                                       const math::Vec3d& position, const math::Quatd& orientation)
+    {
+        if (id == size()) {
+            const std::size_t new_size = id + 1;
+            m_position.resize(new_size);
+            m_velocity.resize(new_size);
+            m_angular_velocity.resize(new_size);
+            m_force.resize(new_size);
+            m_torque.resize(new_size);
+            m_orientation_w.resize(new_size);
+            m_orientation_x.resize(new_size);
+            m_orientation_y.resize(new_size);
+            m_orientation_z.resize(new_size);
+            m_inverse_mass.resize(new_size);
+            for (std::vector<Scalar>& element: m_inverse_inertia) {
+                element.resize(new_size);
+            }
+            m_simulated.resize(new_size);
+        }
+
+        m_position.set(id, position);
+        m_velocity.set(id, math::Vec3d());
+        m_angular_velocity.set(id, math::Vec3d());
+        m_force.set(id, math::Vec3d());
+        m_torque.set(id, math::Vec3d());
+        m_orientation_w[id] = orientation.w();
+        m_orientation_x[id] = orientation.x();
+        m_orientation_y[id] = orientation.y();
+        m_orientation_z[id] = orientation.z();
+        m_inverse_mass[id] = inertia_shape.inverse_mass();
+        const math::Mat3d inverse_inertia = inertia_shape.inverse_inertia_tensor();
+        for (std::size_t i = 0; i < 9; ++i) {
+            m_inverse_inertia[i][id] = inverse_inertia(i / 3, i % 3);
+        }
+        m_simulated[id] = 1;
+    }
+
+    template<typename Scalar>
+    void BasicBodyStore<Scalar>::remove(const std::size_t id)
+    {
+        auto swap_remove = [id](std::vector<Scalar>& elements) {
+            elements[id] = elements.back();
+            elements.pop_back();
+        };
+        for (Vec3Array* array: {&m_position, &m_velocity, &m_angular_velocity, &m_force, &m_torque}) {
+            swap_remove(array->x);
+            swap_remove(array->y);
+            swap_remove(array->z);
+        }
+        swap_remove(m_orientation_w);
+        swap_remove(m_orientation_x);
+        swap_remove(m_orientation_y);
+        swap_remove(m_orientation_z);
+        swap_remove(m_inverse_mass);
+        for (std::vector<Scalar>& elements: m_inverse_inertia) {
+            swap_remove(elements);
+        }
+        swap_remove(m_simulated);
+    }
+
+    template<typename Scalar>
+    std::size_t BasicBodyStore<Scalar>::size() const
+    {
+        return m_inverse_mass.size();
+    }
+
+    template<typename Scalar>
+    void BasicBodyStore<Scalar>::set_simulated(const std::size_t id, const bool simulated)
+    {
+        m_simulated[id] = simulated ? 1 : 0;
+    }
+
+    template<typename Scalar>
+    math::Mat3d BasicBodyStore<Scalar>::inverse_inertia_tensor(const std::size_t id) const
+    {
+        math::Mat3d result;
+        for (std::size_t i = 0; i < 9; ++i) {
+            result(i / 3, i % 3) = m_inverse_inertia[i][id];
+        }
+        return result;
+    }
+
+    template<typename Scalar>
+    void BasicBodyStore<Scalar>::integrate_forces(const math::Vec3d& acceleration, const double dt)
+    {
+        const std::size_t n = size();
+        const Scalar step = static_cast<Scalar>(dt);
+        integrate_linear_velocity(n, m_velocity.x.data(), m_force.x.data(), m_inverse_mass.data(), m_simulated.data(),
+                                  static_cast<Scalar>(acceleration.x() * dt), step);
+        integrate_linear_velocity(n, m_velocity.y.data(), m_force.y.data(), m_inverse_mass.data(), m_simulated.data(),
+                                  static_cast<Scalar>(acceleration.y() * dt), step);
+        integrate_linear_velocity(n, m_velocity.z.data(), m_force.z.data(), m_inverse_mass.data(), m_simulated.data(),
+                                  static_cast<Scalar>(acceleration.z() * dt), step);
+
+        Vec3Array& w = m_angular_velocity;
+        const Vec3Array& t = m_torque;
+        const std::array<std::vector<Scalar>, 9>& i = m_inverse_inertia;
+        integrate_angular_velocity(n, w.x.data(), t.x.data(), t.y.data(), t.z.data(),
+                                   i[0].data(), i[1].data(), i[2].data(), m_simulated.data(), step);
+        integrate_angular_velocity(n, w.y.data(), t.x.data(), t.y.data(), t.z.data(),
+                                   i[3].data(), i[4].data(), i[5].data(), m_simulated.data(), step);
+        integrate_angular_velocity(n, w.z.data(), t.x.data(), t.y.data(), t.z.data(),
+                                   i[6].data(), i[7].data(), i[8].data(), m_simulated.data(), step);
+    }
+
+    template<typename Scalar>
+    void BasicBodyStore<Scalar>::integrate_positions(const double dt)
+    {
+        const std::size_t n = size();
+        const Scalar step = static_cast<Scalar>(dt);
+        integrate_position(n, m_position.x.data(), m_velocity.x.data(), m_simulated.data(), step);
+        integrate_position(n, m_position.y.data(), m_velocity.y.data(), m_simulated.data(), step);
+        integrate_position(n, m_position.z.data(), m_velocity.z.data(), m_simulated.data(), step);
+
+        integrate_orientation(n, m_orientation_w.data(), m_orientation_x.data(), m_orientation_y.data(),
+                              m_orientation_z.data(), m_angular_velocity.x.data(), m_angular_velocity.y.data(),
+                              m_angular_velocity.z.data(), m_simulated.data(), step);
+    }
+
+    template<typename Scalar>
+    void BasicBodyStore<Scalar>::clear_forces()
+    {
+        std::ranges::fill(m_force.x, 0);
+        std::ranges::fill(m_force.y, 0);
+        std::ranges::fill(m_force.z, 0);
+        std::ranges::fill(m_torque.x, 0);
+        std::ranges::fill(m_torque.y, 0);
+        std::ranges::fill(m_torque.z, 0);
+    }
+
+    template<typename Scalar>
+    void BasicBodyStore<Scalar>::save(SnapshotWriter& writer) const
+    {
+        for (const Vec3Array* array: {&m_position, &m_velocity, &m_angular_velocity, &m_force, &m_torque}) {
+            writer.write(array->x);
+            writer.write(array->y);
+            writer.write(array->z);
+        }
+        writer.write(m_orientation_w);
+        writer.write(m_orientation_x);
+        writer.write(m_orientation_y);
+        writer.write(m_orientation_z);
+        writer.write(m_inverse_mass);
+        for (const std::vector<Scalar>& elements: m_inverse_inertia) {
+            writer.write(elements);
+        }
+        writer.write(m_simulated);
+    }
+
+    template<typename Scalar>
+    void BasicBodyStore<Scalar>::restore(SnapshotReader& reader)
+    {
+        for (Vec3Array* array: {&m_position, &m_velocity, &m_angular_velocity, &m_force, &m_torque}) {
+            reader.read(array->x);
+            reader.read(array->y);
+            reader.read(array->z);
+        }
+        reader.read(m_orientation_w);
+        reader.read(m_orientation_x);
+        reader.read(m_orientation_y);
+        reader.read(m_orientation_z);
+        reader.read(m_inverse_mass);
+        for (std::vector<Scalar>& elements: m_inverse_inertia) {
+            reader.read(elements);
+        }
+        reader.read(m_simulated);
+    }
+
+    template class BasicBodyStore<float>;
+    template class BasicBodyStore<double>;
+}
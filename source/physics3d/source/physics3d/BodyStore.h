@@ -0,0 +1,239 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <math/matrix.h>
+#include <math/quaternion.h>
+#include <math/vector.h>
+
+#include "InertiaShape.h"
+#include "Snapshot.h"
+
+namespace yage::physics3d
+{
+    /**
+     * Stores the hot kinematic state of rigid bodies (position, orientation, velocities, accumulated forces, and the
+     * inverse mass properties) as a structure of arrays, with a separate array for each vector component. This keeps
+     * cold data like colliders and materials out of the integration loops, which are written such that the compiler
+     * can vectorize them. Bodies are identified by the same ids as in the simulation.
+     *
+     * The state is stored with the given scalar type, which is float or double. Single precision halves the memory
+     * traffic and doubles the lanes of the vectorized loops, at the cost of accuracy. The accessors convert from and
+     * to double, which is the precision of the rest of the simulation, except for the velocity accessors that the
+     * constraint solver uses, which work in the precision of the store.
+     */
+    template<typename Scalar>
+    class BasicBodyStore
+    {
+    public:
+        using Vector = math::Vec3<Scalar>;
+
+        /**
+         * Initializes the state of a body at rest. Ids must be added in order, but may be reset at any time.
+         * @param id The id of the body, at most the current number of bodies.
+         */
+        void reset(std::size_t id, const InertiaShape& inertia_shape, const math::Vec3d& position,
+                   const math::Quatd& orientation);
+
+        /**
+         * Removes a body in constant time by moving the state of the last body into its place, such that the last
+         * body takes over the id of the removed body.
+         */
+        void remove(std::size_t id);
+
+        [[nodiscard]]
+        std::size_t size() const;
+
+        /**
+         * Includes or excludes a body from integration, e.g. because it is sleeping or destroyed.
+         */
+        void set_simulated(std::size_t id, bool simulated);
+
+        // the accessors are defined inline, since the solver uses them for every constraint row
+
+        [[nodiscard]]
+        math::Vec3d position(const std::size_t id) const
+        {
+            return m_position.get(id);
+        }
+
+        void set_position(const std::size_t id, const math::Vec3d& position)
+        {
+            m_position.set(id, position);
+        }
+
+        [[nodiscard]]
+        math::Quatd orientation(const std::size_t id) const
+        {
+            return {m_orientation_w[id], m_orientation_x[id], m_orientation_y[id], m_orientation_z[id]};
+        }
+
+        [[nodiscard]]
+        math::Vec3d velocity(const std::size_t id) const
+        {
+            return m_velocity.get(id);
+        }
+
+        void set_velocity(const std::size_t id, const math::Vec3d& velocity)
+        {
+            m_velocity.set(id, velocity);
+        }
+
+        /**
+         * @return The velocity in the precision of the store.
+         */
+        [[nodiscard]]
+        Vector stored_velocity(const std::size_t id) const
+        {
+            return {m_velocity.x[id], m_velocity.y[id], m_velocity.z[id]};
+        }
+
+        void add_velocity(const std::size_t id, const Vector& delta)
+        {
+            m_velocity.x[id] += delta.x();
+            m_velocity.y[id] += delta.y();
+            m_velocity.z[id] += delta.z();
+        }
+
+        [[nodiscard]]
+        math::Vec3d angular_velocity(const std::size_t id) const
+        {
+            return m_angular_velocity.get(id);
+        }
+
+        void set_angular_velocity(const std::size_t id, const math::Vec3d& angular_velocity)
+        {
+            m_angular_velocity.set(id, angular_velocity);
+        }
+
+        /**
+         * @return The angular velocity in the precision of the store.
+         */
+        [[nodiscard]]
+        Vector stored_angular_velocity(const std::size_t id) const
+        {
+            return {m_angular_velocity.x[id], m_angular_velocity.y[id], m_angular_velocity.z[id]};
+        }
+
+        void add_angular_velocity(const std::size_t id, const Vector& delta)
+        {
+            m_angular_velocity.x[id] += delta.x();
+            m_angular_velocity.y[id] += delta.y();
+            m_angular_velocity.z[id] += delta.z();
+        }
+
+        [[nodiscard]]
+        math::Vec3d force(const std::size_t id) const
+        {
+            return m_force.get(id);
+        }
+
+        [[nodiscard]]
+        math::Vec3d torque(const std::size_t id) const
+        {
+            return m_torque.get(id);
+        }
+
+        /**
+         * Accumulates a force and torque until the forces are cleared.
+         */
+        void apply_force(const std::size_t id, const math::Vec3d& force, const math::Vec3d& torque)
+        {
+            m_force.x[id] += force.x();
+            m_force.y[id] += force.y();
+            m_force.z[id] += force.z();
+            m_torque.x[id] += torque.x();
+            m_torque.y[id] += torque.y();
+            m_torque.z[id] += torque.z();
+        }
+
+        [[nodiscard]]
+        double inverse_mass(const std::size_t id) const
+        {
+            return m_inverse_mass[id];
+        }
+
+        [[nodiscard]]
+        math::Mat3d inverse_inertia_tensor(std::size_t id) const;
+
+        /**
+         * Integrates the accumulated forces and an external acceleration into the velocities of all simulated bodies.
+         * The external acceleration only affects bodies with finite mass.
+         */
+        void integrate_forces(const math::Vec3d& acceleration, double dt);
+
+        /**
+         * Integrates the velocities into the positions and orientations of all simulated bodies.
+         */
+        void integrate_positions(double dt);
+
+        void clear_forces();
+
+        /**
+         * Appends the state of all bodies to a snapshot.
+         */
+        void save(SnapshotWriter& writer) const;
+
+        /**
+         * Restores the state that was saved to a snapshot.
+         */
+        void restore(SnapshotReader& reader);
+
+    private:
+        struct Vec3Array
+        {
+            std::vector<Scalar> x;
+            std::vector<Scalar> y;
+            std::vector<Scalar> z;
+
+            [[nodiscard]]
+            math::Vec3d get(const std::size_t i) const
+            {
+                return {x[i], y[i], z[i]};
+            }
+
+            void set(const std::size_t i, const math::Vec3d& v)
+            {
+                x[i] = v.x();
+                y[i] = v.y();
+                z[i] = v.z();
+            }
+
+            void resize(const std::size_t size)
+            {
+                x.resize(size);
+                y.resize(size);
+                z.resize(size);
+            }
+        };
+
+        Vec3Array m_position;
+        Vec3Array m_velocity;
+        Vec3Array m_angular_velocity;
+        Vec3Array m_force;
+        Vec3Array m_torque;
+
+        std::vector<Scalar> m_orientation_w;
+        std::vector<Scalar> m_orientation_x;
+        std::vector<Scalar> m_orientation_y;
+        std::vector<Scalar> m_orientation_z;
+
+        std::vector<Scalar> m_inverse_mass;
+        /**
+         * Row-major elements of the inverse inertia tensors.
+         */
+        std::array<std::vector<Scalar>, 9> m_inverse_inertia;
+
+        /**
+         * 1 for bodies that are integrated, 0 otherwise. Stored as a floating point factor, so that the integration
+         * loops don't need to branch.
+         */
+        std::vector<Scalar> m_simulated;
+    };
+
+    extern template class BasicBodyStore<float>;
+    extern template class BasicBodyStore<double>;
+
+    using BodyStore = BasicBodyStore<double>;
+}
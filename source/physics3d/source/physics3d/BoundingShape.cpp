@@ -1,7 +1,15 @@
 #include <algorithm>
+#include <cmath>
+#include <limits>
+#include <tuple>
+
+#include <utils/utils.h>
+
 #include "BoundingShape.h"
 #include "Collision.h"
+#include "CompoundShape.h"
 #include "Algorithms.h"
+#include "Gjk.h"
 
 namespace yage::physics3d
 {
@@ -15,6 +23,700 @@ namespace yage::physics3d
         return dot(p_b - p_a, -n);
     }
 
+    /**
+     * @return The vertices of a box as clip vertices that are identified by their vertex index.
+     */
+    std::array<geometry::ClipVertex, 8> box_vertices(const std::array<math::Vec3d, 8>& vertices)
+    {
+        std::array<geometry::ClipVertex, 8> result;
+        for (std::uint8_t i = 0; i < 8; ++i) {
+            result[i] = {.point = vertices[i], .edge_in = i, .edge_out = i};
+        }
+        return result;
+    }
+
+    /**
+     * @param local_point A point in the local space of the box.
+     * @return Whether the point lies within the box or on its surface.
+     */
+    bool point_inside(const colliders::OrientedBox& box, const math::Vec3d& local_point)
+    {
+        return std::abs(local_point.x()) <= box.half_size.x() && std::abs(local_point.y()) <= box.half_size.y() &&
+               std::abs(local_point.z()) <= box.half_size.z();
+    }
+
+    /**
+     * Finds the face of a box that is closest to a point inside the box, which is needed where the closest point on the
+     * box coincides with the point itself.
+     * @param local_point The point in the local space of the box.
+     * @return The projection of the point onto the face in world space, the outward normal of the face, and the
+     * distance of the point to the face.
+     */
+    std::tuple<math::Vec3d, math::Vec3d, double> closest_face(const colliders::OrientedBox& box,
+                                                              const math::Vec3d& local_point)
+    {
+        int axis = 0;
+        double side = 1;
+        double distance = std::numeric_limits<double>::infinity();
+        for (int i = 0; i < 3; ++i) {
+            for (const double s: {-1.0, 1.0}) {
+                const double d = box.half_size(i) - s * local_point(i);
+                if (d < distance) {
+                    axis = i;
+                    side = s;
+                    distance = d;
+                }
+            }
+        }
+        math::Vec3d normal;
+        normal(axis) = side;
+        math::Vec3d point = local_point;
+        point(axis) = side * box.half_size(axis);
+        return {box.orientation * point + box.center, box.orientation * normal, distance};
+    }
+
+    /**
+     * @return The bounds of a box that is rotated and moved from local to world space.
+     */
+    geometry::AABB transform_bounds(const geometry::AABB& local, const math::Vec3d& position,
+                                    const math::Quatd& orientation)
+    {
+        // project the rotated half axes onto the world axes
+        const math::Vec3d half_size = 0.5 * (local.max - local.min);
+        const math::Vec3d center = position + orientation * (0.5 * (local.max + local.min));
+        const math::Vec3d axis_x = orientation * math::Vec3d(half_size.x(), 0, 0);
+        const math::Vec3d axis_y = orientation * math::Vec3d(0, half_size.y(), 0);
+        const math::Vec3d axis_z = orientation * math::Vec3d(0, 0, half_size.z());
+        const math::Vec3d extent{
+                std::abs(axis_x.x()) + std::abs(axis_y.x()) + std::abs(axis_z.x()),
+                std::abs(axis_x.y()) + std::abs(axis_y.y()) + std::abs(axis_z.y()),
+                std::abs(axis_x.z()) + std::abs(axis_y.z()) + std::abs(axis_z.z()),
+        };
+        return {
+                .min = center - extent,
+                .max = center + extent,
+        };
+    }
+
+    /**
+     * Conservative advancement: the sphere can safely move by the distance to the shape along the direction in which
+     * it approaches the shape's closest point.
+     */
+    std::optional<SweepHit> advance(const colliders::Sphere& sphere, const math::Vec3d& displacement,
+                                    const SupportMapping& shape)
+    {
+        constexpr int max_iterations = 32;
+        constexpr double tolerance = 1e-6;
+        GjkCache cache;
+        colliders::Sphere moved = sphere;
+        double t = 0;
+        math::Vec3d normal;
+        for (int i = 0; i < max_iterations; ++i) {
+            const std::optional<ClosestPoints> closest = distance(moved, shape, &cache);
+            if (!closest.has_value() || closest->distance <= tolerance) {
+                // touching at the start doesn't count as a hit, like for the other colliders
+                return i == 0 ? std::optional<SweepHit>() : SweepHit{.fraction = t, .normal = normal};
+            }
+            normal = normalize(closest->point_a - closest->point_b);
+            const double approach = -dot(displacement, normal);
+            if (approach <= 0) {
+                return {};
+            }
+            t += closest->distance / approach;
+            if (t > 1) {
+                return {};
+            }
+            moved.center = sphere.center + t * displacement;
+        }
+        return {};
+    }
+
+    /**
+     * @return The support mapping of a collider, or empty for planes, meshes, heightfields and compounds.
+     */
+    std::optional<SupportMapping> support_mapping(const Collider& collider)
+    {
+        return std::visit(utils::overload{
+                [](const colliders::OrientedPlane&) -> std::optional<SupportMapping> {
+                    return {};
+                },
+                [](const colliders::Mesh&) -> std::optional<SupportMapping> {
+                    return {};
+                },
+                [](const colliders::Heightfield&) -> std::optional<SupportMapping> {
+                    return {};
+                },
+                [](const colliders::Compound&) -> std::optional<SupportMapping> {
+                    return {};
+                },
+                [](const auto& convex) -> std::optional<SupportMapping> {
+                    return SupportMapping(convex);
+                },
+        }, collider);
+    }
+
+    /**
+     * Swaps the roles of the two objects of a manifold.
+     */
+    void flip(ContactManifold& manifold)
+    {
+        manifold.normal = -manifold.normal;
+        for (ContactPoint& contact: manifold.contacts) {
+            std::swap(contact.p_a, contact.p_b);
+            std::swap(contact.r_a, contact.r_b);
+        }
+    }
+
+    /**
+     * @return The normal of a triangle that points towards a point, or empty for degenerate triangles.
+     */
+    std::optional<math::Vec3d> face_normal(const TriangleMesh::Triangle& triangle, const math::Vec3d& towards)
+    {
+        const math::Vec3d face = cross(triangle[1] - triangle[0], triangle[2] - triangle[0]);
+        if (length_sqr(face) == 0) {
+            return {};
+        }
+        const math::Vec3d normal = normalize(face);
+        return dot(towards - triangle[0], normal) >= 0 ? normal : -normal;
+    }
+
+    /**
+     * @return Whether a point on a triangle of a mesh or heightfield lies on one of its active edges.
+     */
+    template<typename Triangles>
+    bool on_active_edge(const TriangleMesh::Triangle& triangle, const math::Vec3d& point, const Triangles& triangles,
+                        const std::uint32_t index)
+    {
+        constexpr double edge_tolerance = 1e-3;
+
+        // the barycentric weight of the vertex opposite of an edge vanishes on the edge
+        const math::Vec3d face = cross(triangle[1] - triangle[0], triangle[2] - triangle[0]);
+        for (int edge = 0; edge < 3; ++edge) {
+            const math::Vec3d& start = triangle[edge];
+            const math::Vec3d& end = triangle[(edge + 1) % 3];
+            const double weight = std::abs(dot(cross(end - start, point - start), face)) / length_sqr(face);
+            if (weight <= edge_tolerance && triangles.is_active_edge(index, edge)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Collides a convex shape A with a triangle B of a mesh or heightfield. Contacts whose normal points through an
+     * inactive edge of the triangle are generated along the normal of the triangle instead.
+     */
+    template<typename Triangles>
+    std::optional<ContactManifold> collide(const SupportMapping& shape, const TriangleMesh::Triangle& triangle,
+                                           const Triangles& triangles, const std::uint32_t index)
+    {
+        const SupportMapping triangle_shape(triangle);
+        std::optional<ContactManifold> manifold = collide(shape, triangle_shape);
+        const std::optional<math::Vec3d> face = face_normal(triangle, shape.center());
+        if (!manifold.has_value() || !face.has_value()) {
+            return manifold;
+        }
+        // the normal from the shape into the triangle
+        const math::Vec3d normal = -face.value();
+        if (dot(manifold->normal, normal) >= 1 - 1e-9) {
+            return manifold;
+        }
+        const ContactPoint& deepest = *std::ranges::max_element(manifold->contacts, {}, &ContactPoint::depth);
+        if (on_active_edge(triangle, deepest.p_b, triangles, index)) {
+            return manifold;
+        }
+
+        const math::Vec3d point_a = shape.support(normal) + shape.margin() * normal;
+        const double depth = dot(point_a - triangle[0], normal);
+        if (depth < 0) {
+            return {};
+        }
+        return collide(shape, triangle_shape, Penetration{
+                .normal = normal,
+                .point_a = point_a,
+                .point_b = point_a - depth * normal,
+                .depth = depth,
+        });
+    }
+
+    /**
+     * Intersects a ray with a triangle from either side (Möller-Trumbore).
+     * @return The fraction of the ray's displacement at the intersection.
+     */
+    std::optional<double> intersect(const math::Vec3d& origin, const math::Vec3d& displacement,
+                                    const TriangleMesh::Triangle& triangle)
+    {
+        const math::Vec3d edge_1 = triangle[1] - triangle[0];
+        const math::Vec3d edge_2 = triangle[2] - triangle[0];
+        const math::Vec3d p = cross(displacement, edge_2);
+        const double determinant = dot(edge_1, p);
+        if (determinant == 0) {
+            // parallel to the triangle
+            return {};
+        }
+        const math::Vec3d s = origin - triangle[0];
+        const double u = dot(s, p) / determinant;
+        const math::Vec3d q = cross(s, edge_1);
+        const double v = dot(displacement, q) / determinant;
+        const double t = dot(edge_2, q) / determinant;
+        if (u < 0 || v < 0 || u + v > 1 || t <= 0 || t > 1) {
+            return {};
+        }
+        return t;
+    }
+
+    /**
+     * Sweeps a sphere against the triangles of a mesh or heightfield, which are found by sweeping through them in
+     * their local space. Rays are intersected with the triangles directly.
+     */
+    template<typename Triangles>
+    std::optional<SweepHit> sweep(const colliders::Sphere& sphere, const math::Vec3d& displacement,
+                                  const Triangles& triangles, const math::Vec3d& center,
+                                  const math::Quatd& orientation)
+    {
+        const math::Quatd inverse = conjugate(orientation);
+        const colliders::Sphere local{
+                .center = inverse * (sphere.center - center),
+                .radius = sphere.radius,
+        };
+        const math::Vec3d local_displacement = inverse * displacement;
+        std::optional<SweepHit> closest;
+        auto sweep_triangle = [&](const std::uint32_t index) {
+            const TriangleMesh::Triangle triangle = triangles.triangle(index);
+            const std::optional<math::Vec3d> face = face_normal(triangle, local.center);
+            std::optional<SweepHit> hit;
+            if (local.radius == 0) {
+                const std::optional<double> fraction = intersect(local.center, local_displacement, triangle);
+                if (fraction.has_value() && face.has_value()) {
+                    hit = SweepHit{.fraction = fraction.value(), .normal = face.value()};
+                }
+            } else {
+                hit = advance(local, local_displacement, SupportMapping(triangle));
+            }
+            if (!hit.has_value() || (closest.has_value() && hit->fraction >= closest->fraction)) {
+                return closest.has_value() ? closest->fraction : 1.0;
+            }
+
+            // hits on inactive edges use the normal of the triangle, like contacts
+            const math::Vec3d point = local.center + hit->fraction * local_displacement - local.radius * hit->normal;
+            if (face.has_value() && !on_active_edge(triangle, point, triangles, index)) {
+                hit->normal = face.value();
+            }
+            closest = hit;
+            return closest->fraction;
+        };
+        triangles.sweep(local.center, local_displacement, local.radius, 1, sweep_triangle);
+        if (closest.has_value()) {
+            closest->normal = orientation * closest->normal;
+        }
+        return closest;
+    }
+
+    /**
+     * Collides a collider with the triangles of a mesh or heightfield, like collide for colliders::Mesh.
+     */
+    template<typename Triangles>
+    void collide(const Triangles& triangles, const math::Vec3d& center, const math::Quatd& orientation,
+                 const Collider& other, const bool triangles_are_a,
+                 const std::function<void(const ContactManifold&)>& callback)
+    {
+        const std::optional<SupportMapping> shape = support_mapping(other);
+        if (!shape.has_value()) {
+            return;
+        }
+
+        // query the triangles with the bounds of the other collider in local space
+        const geometry::AABB bounds = world_bounds(other);
+        const geometry::AABB local_bounds = transform_bounds(
+                {.min = bounds.min - center, .max = bounds.max - center}, math::Vec3d(), conjugate(orientation));
+        triangles.query(local_bounds, [&](const std::uint32_t index) {
+            TriangleMesh::Triangle triangle = triangles.triangle(index);
+            for (math::Vec3d& vertex: triangle) {
+                vertex = center + orientation * vertex;
+            }
+
+            std::optional<ContactManifold> manifold = collide(shape.value(), triangle, triangles, index);
+            if (!manifold.has_value()) {
+                return;
+            }
+
+            for (ContactPoint& contact: manifold->contacts) {
+                contact.r_b = contact.p_b - center;
+                contact.feature_id |= static_cast<std::uint64_t>(index) << 32;
+            }
+            if (triangles_are_a) {
+                flip(manifold.value());
+            }
+            callback(manifold.value());
+        });
+    }
+
+    geometry::AABB world_bounds(const Collider& collider)
+    {
+        return std::visit(utils::overload{
+                [](const colliders::Sphere& sphere) {
+                    return geometry::AABB{
+                            .min = sphere.center - math::Vec3d(sphere.radius),
+                            .max = sphere.center + math::Vec3d(sphere.radius),
+                    };
+                },
+                [](const colliders::OrientedPlane&) {
+                    constexpr double inf = std::numeric_limits<double>::infinity();
+                    return geometry::AABB{
+                            .min = math::Vec3d(-inf),
+                            .max = math::Vec3d(inf),
+                    };
+                },
+                [](const colliders::OrientedBox& box) {
+                    // project the rotated half axes onto the world axes
+                    const math::Vec3d axis_x = box.orientation * math::Vec3d(box.half_size.x(), 0, 0);
+                    const math::Vec3d axis_y = box.orientation * math::Vec3d(0, box.half_size.y(), 0);
+                    const math::Vec3d axis_z = box.orientation * math::Vec3d(0, 0, box.half_size.z());
+                    const math::Vec3d extent{
+                            std::abs(axis_x.x()) + std::abs(axis_y.x()) + std::abs(axis_z.x()),
+                            std::abs(axis_x.y()) + std::abs(axis_y.y()) + std::abs(axis_z.y()),
+                            std::abs(axis_x.z()) + std::abs(axis_y.z()) + std::abs(axis_z.z()),
+                    };
+                    return geometry::AABB{
+                            .min = box.center - extent,
+                            .max = box.center + extent,
+                    };
+                },
+                [](const colliders::Convex& convex) {
+                    const math::Vec3d up = convex.orientation * math::Vec3d(0, 1, 0);
+                    return std::visit(utils::overload{
+                            [&convex, &up](const shapes::Capsule& capsule) {
+                                const math::Vec3d extent{
+                                        capsule.half_height * std::abs(up.x()) + capsule.radius,
+                                        capsule.half_height * std::abs(up.y()) + capsule.radius,
+                                        capsule.half_height * std::abs(up.z()) + capsule.radius,
+                                };
+                                return geometry::AABB{
+                                        .min = convex.center - extent,
+                                        .max = convex.center + extent,
+                                };
+                            },
+                            [&convex, &up](const shapes::Cylinder& cylinder) {
+                                // the caps are disks, which extend along each axis by their radius times the sine of
+                                // the angle between the axis and the cylinder axis
+                                auto extent = [&cylinder](const double cosine) {
+                                    return cylinder.half_height * std::abs(cosine) +
+                                           cylinder.radius * std::sqrt(std::max(0.0, 1 - cosine * cosine));
+                                };
+                                const math::Vec3d half_size{extent(up.x()), extent(up.y()), extent(up.z())};
+                                return geometry::AABB{
+                                        .min = convex.center - half_size,
+                                        .max = convex.center + half_size,
+                                };
+                            },
+                            [&convex](const shapes::Hull& hull) {
+                                return transform_bounds(hull.hull->bounds(), convex.center, convex.orientation);
+                            },
+                    }, convex.shape);
+                },
+                [](const colliders::Mesh& mesh) {
+                    return transform_bounds(mesh.mesh->bounds(), mesh.center, mesh.orientation);
+                },
+                [](const colliders::Heightfield& heightfield) {
+                    return transform_bounds(heightfield.heightfield->bounds(), heightfield.center,
+                                            heightfield.orientation);
+                },
+                [](const colliders::Compound& compound) {
+                    return transform_bounds(compound.shape->bounds(), compound.center, compound.orientation);
+                },
+        }, collider);
+    }
+
+    std::optional<geometry::Plane> unbounded_plane(const Collider& collider)
+    {
+        if (const auto* plane = std::get_if<colliders::OrientedPlane>(&collider)) {
+            return geometry::Plane{.support = plane->support, .normal = plane->normal};
+        }
+        return {};
+    }
+
+    std::optional<colliders::Sphere> inner_sphere(const Collider& collider)
+    {
+        return std::visit(utils::overload{
+                [](const colliders::Sphere& sphere) -> std::optional<colliders::Sphere> {
+                    return sphere;
+                },
+                [](const colliders::OrientedPlane&) -> std::optional<colliders::Sphere> {
+                    return {};
+                },
+                [](const colliders::OrientedBox& box) -> std::optional<colliders::Sphere> {
+                    return colliders::Sphere{
+                            .center = box.center,
+                            .radius = std::min({box.half_size.x(), box.half_size.y(), box.half_size.z()}),
+                    };
+                },
+                [](const colliders::Convex& convex) -> std::optional<colliders::Sphere> {
+                    return colliders::Sphere{
+                            .center = convex.center,
+                            .radius = std::visit(utils::overload{
+                                    [](const shapes::Capsule& capsule) {
+                                        return capsule.radius;
+                                    },
+                                    [](const shapes::Cylinder& cylinder) {
+                                        return std::min(cylinder.radius, cylinder.half_height);
+                                    },
+                                    [](const shapes::Hull& hull) {
+                                        return hull.hull->inner_radius();
+                                    },
+                            }, convex.shape),
+                    };
+                },
+                [](const colliders::Mesh&) -> std::optional<colliders::Sphere> {
+                    return {};
+                },
+                [](const colliders::Heightfield&) -> std::optional<colliders::Sphere> {
+                    return {};
+                },
+                [](const colliders::Compound& compound) -> std::optional<colliders::Sphere> {
+                    std::optional<colliders::Sphere> largest;
+                    for (std::size_t i = 0; i < compound.shape->size(); ++i) {
+                        const std::optional<colliders::Sphere> sphere =
+                                inner_sphere(compound.shape->child(i, compound.center, compound.orientation));
+                        if (!largest.has_value() || sphere->radius > largest->radius) {
+                            largest = sphere;
+                        }
+                    }
+                    return largest;
+                },
+        }, collider);
+    }
+
+    std::optional<double> time_of_impact(const colliders::Sphere& sphere, const math::Vec3d& displacement,
+                                         const Collider& collider)
+    {
+        const std::optional<SweepHit> hit = sweep(sphere, displacement, collider);
+        if (!hit.has_value()) {
+            return {};
+        }
+        return hit->fraction;
+    }
+
+    std::optional<SweepHit> sweep(const colliders::Sphere& sphere, const math::Vec3d& displacement,
+                                  const Collider& collider)
+    {
+        return std::visit(utils::overload{
+                [&](const colliders::Sphere& other) -> std::optional<SweepHit> {
+                    // solve |m + t * d| = r for the first root t
+                    const math::Vec3d m = sphere.center - other.center;
+                    const double r = sphere.radius + other.radius;
+                    const double c = dot(m, m) - r * r;
+                    const double b = dot(m, displacement);
+                    if (c <= 0 || b >= 0) {
+                        // already touching or moving apart
+                        return {};
+                    }
+                    const double a = dot(displacement, displacement);
+                    const double discriminant = b * b - a * c;
+                    if (discriminant < 0) {
+                        return {};
+                    }
+                    const double t = (-b - std::sqrt(discriminant)) / a;
+                    if (t > 1) {
+                        return {};
+                    }
+                    return SweepHit{.fraction = t, .normal = normalize(m + t * displacement)};
+                },
+                [&](const colliders::OrientedPlane& plane) -> std::optional<SweepHit> {
+                    // the sphere can only hit the plane from the side that its center starts on
+                    const double dist = dot(sphere.center - plane.support, plane.normal);
+                    const double gap = std::abs(dist) - sphere.radius;
+                    const double approach = dist > 0
+                                            ? -dot(displacement, plane.normal)
+                                            : dot(displacement, plane.normal);
+                    if (gap <= 0 || approach <= gap) {
+                        return {};
+                    }
+                    return SweepHit{.fraction = gap / approach, .normal = dist > 0 ? plane.normal : -plane.normal};
+                },
+                [&](const colliders::OrientedBox& box) -> std::optional<SweepHit> {
+                    // intersect the path of the center with the inflated box in the local space of the box
+                    const math::Quatd inverse = conjugate(box.orientation);
+                    const math::Vec3d start = inverse * (sphere.center - box.center);
+                    const math::Vec3d direction = inverse * displacement;
+                    const math::Vec3d extent = box.half_size + math::Vec3d(sphere.radius);
+
+                    if (std::abs(start.x()) <= extent.x() && std::abs(start.y()) <= extent.y() &&
+                        std::abs(start.z()) <= extent.z()) {
+                        return {};
+                    }
+
+                    double t_enter = 0;
+                    double t_exit = 1;
+                    // the face of the inflated box through which the path enters
+                    math::Vec3d normal;
+                    for (int i = 0; i < 3; ++i) {
+                        if (direction(i) == 0) {
+                            if (std::abs(start(i)) > extent(i)) {
+                                return {};
+                            }
+                            continue;
+                        }
+                        const double t_0 = (-extent(i) - start(i)) / direction(i);
+                        const double t_1 = (extent(i) - start(i)) / direction(i);
+                        const double t_near = std::min(t_0, t_1);
+                        if (t_near > t_enter) {
+                            t_enter = t_near;
+                            normal = math::Vec3d();
+                            normal(i) = direction(i) > 0 ? -1 : 1;
+                        }
+                        t_exit = std::min(t_exit, std::max(t_0, t_1));
+                        if (t_enter > t_exit) {
+                            return {};
+                        }
+                    }
+                    return SweepHit{.fraction = t_enter, .normal = box.orientation * normal};
+                },
+                [&](const colliders::Convex& convex) -> std::optional<SweepHit> {
+                    return advance(sphere, displacement, convex);
+                },
+                [&](const colliders::Mesh& mesh) -> std::optional<SweepHit> {
+                    return physics3d::sweep(sphere, displacement, *mesh.mesh, mesh.center, mesh.orientation);
+                },
+                [&](const colliders::Heightfield& heightfield) -> std::optional<SweepHit> {
+                    return physics3d::sweep(sphere, displacement, *heightfield.heightfield, heightfield.center,
+                                            heightfield.orientation);
+                },
+                [&](const colliders::Compound& compound) -> std::optional<SweepHit> {
+                    // find the children near the path in local space, but sweep against them in world space
+                    const math::Quatd inverse = conjugate(compound.orientation);
+                    std::optional<SweepHit> closest;
+                    auto sweep_child = [&](const std::uint32_t index) {
+                        const std::optional<SweepHit> hit = physics3d::sweep(
+                                sphere, displacement, compound.shape->child(index, compound.center,
+                                                                            compound.orientation));
+                        if (hit.has_value() && (!closest.has_value() || hit->fraction < closest->fraction)) {
+                            closest = hit;
+                        }
+                        return closest.has_value() ? closest->fraction : 1.0;
+                    };
+                    compound.shape->sweep(inverse * (sphere.center - compound.center), inverse * displacement,
+                                          sphere.radius, 1, sweep_child);
+                    return closest;
+                },
+        }, collider);
+    }
+
+    void collide(const colliders::Mesh& mesh, const Collider& other, const bool mesh_is_a,
+                 const std::function<void(const ContactManifold&)>& callback)
+    {
+        collide(*mesh.mesh, mesh.center, mesh.orientation, other, mesh_is_a, callback);
+    }
+
+    void collide(const colliders::Heightfield& heightfield, const Collider& other, const bool heightfield_is_a,
+                 const std::function<void(const ContactManifold&)>& callback)
+    {
+        collide(*heightfield.heightfield, heightfield.center, heightfield.orientation, other, heightfield_is_a,
+                callback);
+    }
+
+    /**
+     * The contacts of a child of a compound, which are moved into the frame of the compound and tagged with the index
+     * of the child.
+     */
+    struct ChildContacts
+    {
+        const colliders::Compound* compound{};
+        bool compound_is_a{};
+        std::uint32_t index{};
+        int shift{};
+        const std::function<void(const ContactManifold&)>* callback{};
+
+        void operator()(ContactManifold manifold) const
+        {
+            for (ContactPoint& contact: manifold.contacts) {
+                if (compound_is_a) {
+                    contact.r_a = contact.p_a - compound->center;
+                } else {
+                    contact.r_b = contact.p_b - compound->center;
+                }
+                contact.feature_id |= static_cast<std::uint64_t>(index) << shift;
+            }
+            (*callback)(manifold);
+        }
+    };
+
+    void collide(const colliders::Compound& compound, const Collider& other, const bool compound_is_a,
+                 const std::function<void(const ContactManifold&)>& callback)
+    {
+        const auto* other_compound = std::get_if<colliders::Compound>(&other);
+        const auto* mesh = std::get_if<colliders::Mesh>(&other);
+        const auto* heightfield = std::get_if<colliders::Heightfield>(&other);
+        ChildContacts contacts{
+                .compound = &compound,
+                .compound_is_a = compound_is_a,
+                // the child of the other compound takes the bits below
+                .shift = other_compound != nullptr ? 32 : 17,
+                .callback = &callback,
+        };
+        // captures a single reference, which fits into std::function without allocating
+        const std::function<void(const ContactManifold&)> add = [&contacts](const ContactManifold& manifold) {
+            contacts(manifold);
+        };
+
+        auto collide_child = [&](const std::uint32_t index) {
+            const Collider child = compound.shape->child(index, compound.center, compound.orientation);
+            contacts.index = index;
+            if (other_compound != nullptr) {
+                collide(*other_compound, child, !compound_is_a, add);
+            } else if (mesh != nullptr) {
+                collide(*mesh, child, !compound_is_a, add);
+            } else if (heightfield != nullptr) {
+                collide(*heightfield, child, !compound_is_a, add);
+            } else {
+                const CollisionVisitor visitor;
+                const std::optional<ContactManifold> manifold = compound_is_a
+                                                                ? std::visit(visitor, child, other)
+                                                                : std::visit(visitor, other, child);
+                if (manifold.has_value()) {
+                    contacts(manifold.value());
+                }
+            }
+        };
+
+        if (unbounded_plane(other).has_value()) {
+            for (std::uint32_t i = 0; i < compound.shape->size(); ++i) {
+                collide_child(i);
+            }
+            return;
+        }
+        // query the children with the bounds of the other collider in local space
+        const geometry::AABB bounds = world_bounds(other);
+        const geometry::AABB local_bounds = transform_bounds(
+                {.min = bounds.min - compound.center, .max = bounds.max - compound.center}, math::Vec3d(),
+                conjugate(compound.orientation));
+        compound.shape->query(local_bounds, collide_child);
+    }
+
+    /**
+     * @return The manifold of the triangle of a mesh or heightfield, or of the child of a compound, that the other
+     * collider penetrates the deepest.
+     */
+    template<typename CompositeCollider>
+    std::optional<ContactManifold> deepest_manifold(const CompositeCollider& composite, const Collider& other,
+                                                    const bool composite_is_a)
+    {
+        std::optional<ContactManifold> deepest;
+        double deepest_depth = -std::numeric_limits<double>::infinity();
+        collide(composite, other, composite_is_a, [&deepest, &deepest_depth](const ContactManifold& manifold) {
+            const double depth = std::ranges::max(manifold.contacts, {}, &ContactPoint::depth).depth;
+            if (depth > deepest_depth) {
+                deepest = manifold;
+                deepest_depth = depth;
+            }
+        });
+        return deepest;
+    }
+
+    CollisionVisitor::CollisionVisitor(GjkCache* cache)
+        : m_cache(cache)
+    {
+    }
+
     std::optional<ContactManifold> CollisionVisitor::operator()(const colliders::Sphere& a, const colliders::Sphere& b) const
     {
         const math::Vec3d ab = b.center - a.center;
@@ -23,7 +725,8 @@ namespace yage::physics3d
         }
 
         ContactManifold manifold;
-        manifold.normal = normalize(b.center - a.center);
+        // concentric spheres can be pushed apart in any direction
+        manifold.normal = length_sqr(ab) > 0 ? normalize(ab) : math::Vec3d(0, 1, 0);
 
         ContactPoint contact;
         contact.r_a = manifold.normal * a.radius;
@@ -40,7 +743,8 @@ namespace yage::physics3d
     {
         // The direction of the collision is determined by which side of the plane has more overlap with the sphere,
         // which means that if the sphere's center overshoots the plane, the direction is the wrong way around.
-        // This can be solved by continuous collision detection or by incorporating the relative velocity here.
+        // Bodies with continuous collision detection enabled stop before their center overshoots, otherwise this could
+        // be solved by incorporating the relative velocity here.
 
         // dist is positive if the circle collides on the outer side and negative otherwise (b.normal points outward)
         const double dist = dot(a.center - b.support, b.normal);
@@ -83,10 +787,17 @@ namespace yage::physics3d
         }
 
         ContactManifold manifold;
-        manifold.normal = normalize(offset);
-
         ContactPoint contact;
-        contact.depth = a.radius - offset_length;
+        if (point_inside(b, center)) {
+            // the center lies within the box, so the sphere is pushed out through the closest face
+            const auto [face_point, face_normal, face_distance] = closest_face(b, center);
+            point = face_point;
+            manifold.normal = -face_normal;
+            contact.depth = a.radius + face_distance;
+        } else {
+            manifold.normal = normalize(offset);
+            contact.depth = a.radius - offset_length;
+        }
         contact.p_a = a.center + a.radius * manifold.normal;
         contact.p_b = point;
         contact.r_a = contact.p_a - a.center;
@@ -100,7 +811,8 @@ namespace yage::physics3d
     {
         // The direction of the collision is determined by which side of the plane has more overlap with the sphere,
         // which means that if the sphere's center overshoots the plane, the direction is the wrong way around.
-        // This can be solved by continuous collision detection or by incorporating the relative velocity here.
+        // Bodies with continuous collision detection enabled stop before their center overshoots, otherwise this could
+        // be solved by incorporating the relative velocity here.
 
         // dist is positive if the circle collides on the outer side and negative otherwise (b.normal points outward)
         const double dist = dot(b.center - a.support, a.normal);
@@ -133,7 +845,8 @@ namespace yage::physics3d
     {
         // The direction of the collision is determined by which side of the plane has more overlap with the box,
         // which means that if the sphere's center overshoots the plane, the direction is the wrong way around.
-        // This can be solved by continuous collision detection or by incorporating the relative velocity here.
+        // Bodies with continuous collision detection enabled stop before their center overshoots, otherwise this could
+        // be solved by incorporating the relative velocity here.
 
         /*             ___      ^                          ^
          *            | b |     |                  ___     |
@@ -146,14 +859,17 @@ namespace yage::physics3d
         ContactManifold manifold;
         manifold.normal = dist > 0 ? a.normal : -a.normal;
 
-        std::vector<std::tuple<math::Vec3d, double>> contacts_with_depth =
-                clip_discard(geometry::Plane{.support = a.support, .normal = -manifold.normal}, b.oriented_vertices);
+        geometry::ClipResult contacts_with_depth =
+                clip_discard(geometry::Plane{.support = a.support, .normal = -manifold.normal},
+                             box_vertices(b.oriented_vertices));
 
         if (contacts_with_depth.empty())
             return {};
 
-        for (const auto& [point, depth]: contacts_with_depth) {
+        for (const auto& [vertex, depth]: contacts_with_depth) {
+            const math::Vec3d& point = vertex.point;
             ContactPoint contact;
+            contact.feature_id = geometry::feature_id(vertex);
             contact.depth = depth;
             contact.p_a = point + manifold.normal * depth;
             contact.p_b = point;
@@ -186,10 +902,17 @@ namespace yage::physics3d
         }
 
         ContactManifold manifold;
-        manifold.normal = -normalize(offset);
-
         ContactPoint contact;
-        contact.depth = b.radius - offset_length;
+        if (point_inside(a, center)) {
+            // the center lies within the box, so the sphere is pushed out through the closest face
+            const auto [face_point, face_normal, face_distance] = closest_face(a, center);
+            point = face_point;
+            manifold.normal = face_normal;
+            contact.depth = b.radius + face_distance;
+        } else {
+            manifold.normal = -normalize(offset);
+            contact.depth = b.radius - offset_length;
+        }
         contact.p_a = point;
         contact.p_b = b.center - b.radius * manifold.normal;
         contact.r_a = contact.p_a - a.center;
@@ -204,7 +927,8 @@ namespace yage::physics3d
     {
         // The direction of the collision is determined by which side of the plane has more overlap with the box,
         // which means that if the sphere's center overshoots the plane, the direction is the wrong way around.
-        // This can be solved by continuous collision detection or by incorporating the relative velocity here.
+        // Bodies with continuous collision detection enabled stop before their center overshoots, otherwise this could
+        // be solved by incorporating the relative velocity here.
 
         /*             ___      ^                          ^
          *            | a |     |                  ___     |
@@ -217,14 +941,17 @@ namespace yage::physics3d
         ContactManifold manifold;
         manifold.normal = dist > 0 ? -b.normal : b.normal;
 
-        std::vector<std::tuple<math::Vec3d, double>> contacts_with_depth =
-                clip_discard(geometry::Plane{.support = b.support, .normal = manifold.normal}, a.oriented_vertices);
+        geometry::ClipResult contacts_with_depth =
+                clip_discard(geometry::Plane{.support = b.support, .normal = manifold.normal},
+                             box_vertices(a.oriented_vertices));
 
         if (contacts_with_depth.empty())
             return {};
 
-        for (const auto& [point, depth]: contacts_with_depth) {
+        for (const auto& [vertex, depth]: contacts_with_depth) {
+            const math::Vec3d& point = vertex.point;
             ContactPoint contact;
+            contact.feature_id = geometry::feature_id(vertex);
             contact.depth = depth;
             contact.p_a = point;
             contact.p_b = point - manifold.normal * depth;
@@ -252,33 +979,57 @@ namespace yage::physics3d
          * 4-------------5       z
          */
 
-        // get the minimum translation vector with the SAT
+        // get the minimum translation vector with the SAT, starting from the axis of the previous step
+        math::Vec3d axis = m_cache != nullptr ? m_cache->axis : math::Vec3d();
         const std::optional<math::Vec3d> maybe_mtv = sat_3d(a.oriented_vertices, b.oriented_vertices,
-                                                            a.oriented_face_normals, b.oriented_face_normals);
+                                                            a.oriented_face_normals, b.oriented_face_normals, &axis);
+        if (m_cache != nullptr) {
+            m_cache->axis = axis;
+        }
         if (!maybe_mtv.has_value()) {
             return {};
         }
 
         ContactManifold manifold;
-        manifold.normal = normalize(maybe_mtv.value());
+        // the axis is the direction of the MTV, which is also defined for boxes that touch without overlap
+        manifold.normal = axis;
 
-        const auto [face_a, face_a_normal] =
+        const auto [face_a, face_a_normal, face_a_vertices] =
                 most_perpendicular_cube_face(manifold.normal, a.oriented_vertices);
-        const auto [face_b, face_b_normal] =
+        const auto [face_b, face_b_normal, face_b_vertices] =
                 most_perpendicular_cube_face(-manifold.normal, b.oriented_vertices);
 
         geometry::Rectangle reference, incident;
+        std::array<std::uint8_t, 4> reference_vertices{}, incident_vertices{};
         bool flipped = false;
         // choose the more perpendicular face as the reference face
         if (dot(face_a_normal, manifold.normal) > dot(face_b_normal, -manifold.normal)) {
             reference = face_a;
             incident = face_b;
+            reference_vertices = face_a_vertices;
+            incident_vertices = face_b_vertices;
         } else {
             reference = face_b;
             incident = face_a;
+            reference_vertices = face_b_vertices;
+            incident_vertices = face_a_vertices;
             flipped = true;
         }
-        std::vector<math::Vec3d> contact_points = {incident[0], incident[1], incident[2], incident[3]};
+
+        // Edges are identified by the box vertices they connect, so that contact features stay the same regardless
+        // of which vertex the faces start with. Edges of the reference face are offset to be distinct from incident
+        // edges.
+        auto edge_id = [](const std::uint8_t from, const std::uint8_t to, const std::uint8_t offset) {
+            return static_cast<std::uint8_t>(offset + std::min(from, to) * 8 + std::max(from, to));
+        };
+        std::array<geometry::ClipVertex, 4> contact_points;
+        for (std::size_t i = 0; i < 4; ++i) {
+            contact_points[i] = {
+                    .point = incident[i],
+                    .edge_in = edge_id(incident_vertices[(i + 3) % 4], incident_vertices[i], 0),
+                    .edge_out = edge_id(incident_vertices[i], incident_vertices[(i + 1) % 4], 0),
+            };
+        }
         // Sutherland-Hodgman clip against the 4 adjacent faces
         std::array<geometry::Plane, 4> clipping_planes = {
                 geometry::Plane{.support = reference[0], .normal = normalize(reference[1] - reference[0])},
@@ -286,26 +1037,173 @@ namespace yage::physics3d
                 geometry::Plane{.support = reference[2], .normal = normalize(reference[3] - reference[2])},
                 geometry::Plane{.support = reference[3], .normal = normalize(reference[0] - reference[3])},
         };
-        contact_points = clip_sutherland_hodgman(clipping_planes, contact_points);
+        std::array<std::uint8_t, 4> clipping_plane_ids{};
+        for (std::size_t i = 0; i < 4; ++i) {
+            // each plane contains the reference edge that ends in its support point
+            clipping_plane_ids[i] = edge_id(reference_vertices[(i + 3) % 4], reference_vertices[i], 64);
+        }
+        const geometry::ClipPolygon clipped =
+                clip_sutherland_hodgman(clipping_planes, clipping_plane_ids, contact_points);
         // clip and discard against reference face
-        std::vector<std::tuple<math::Vec3d, double>> contacts_with_depth = clip_discard(
+        geometry::ClipResult contacts_with_depth = clip_discard(
                 geometry::Plane{
                         .support = reference[0],
                         .normal = flipped ? manifold.normal : -manifold.normal
                 },
-                contact_points);
+                clipped);
 
-        for (const auto& [point, depth]: contacts_with_depth) {
+        FixedVector<ContactPoint, 8> candidates;
+        for (const auto& [vertex, depth]: contacts_with_depth) {
+            const math::Vec3d& point = vertex.point;
             ContactPoint contact;
+            contact.feature_id = geometry::feature_id(vertex) | (flipped ? 1u << 16 : 0u);
             contact.depth = depth;
             contact.p_a = flipped ? point : point + manifold.normal * depth;
             contact.p_b = flipped ? point - manifold.normal * depth : point;
             contact.r_a = contact.p_a - a.center;
             contact.r_b = contact.p_b - b.center;
 
-            manifold.contacts.push_back(contact);
+            candidates.push_back(contact);
         }
+        // rotated faces overlap in up to eight points, of which four support the boxes just as well
+        add_reduced_contacts(manifold, candidates);
 
         return {manifold};
     }
-}
\ No newline at end of file
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::Sphere& a, const colliders::Convex& b) const
+    {
+        return collide(a, b, m_cache);
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::OrientedPlane& a, const colliders::Convex& b) const
+    {
+        return collide(a, b);
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::OrientedBox& a, const colliders::Convex& b) const
+    {
+        return collide(a, b, m_cache);
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::Convex& a, const colliders::Sphere& b) const
+    {
+        return collide(a, b, m_cache);
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::Convex& a, const colliders::OrientedPlane& b) const
+    {
+        std::optional<ContactManifold> manifold = collide(b, a);
+        if (manifold.has_value()) {
+            flip(manifold.value());
+        }
+        return manifold;
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::Convex& a, const colliders::OrientedBox& b) const
+    {
+        return collide(a, b, m_cache);
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::Convex& a, const colliders::Convex& b) const
+    {
+        return collide(a, b, m_cache);
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::Mesh& a, const Collider& b) const
+    {
+        return deepest_manifold(a, b, true);
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const Collider& a, const colliders::Mesh& b) const
+    {
+        return deepest_manifold(b, a, false);
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::Mesh&, const colliders::Mesh&) const
+    {
+        return {};
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::Heightfield& a, const Collider& b) const
+    {
+        return deepest_manifold(a, b, true);
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const Collider& a, const colliders::Heightfield& b) const
+    {
+        return deepest_manifold(b, a, false);
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::Heightfield&, const colliders::Heightfield&) const
+    {
+        return {};
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::Mesh&, const colliders::Heightfield&) const
+    {
+        return {};
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::Heightfield&, const colliders::Mesh&) const
+    {
+        return {};
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::Compound& a, const Collider& b) const
+    {
+        return deepest_manifold(a, b, true);
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const Collider& a, const colliders::Compound& b) const
+    {
+        return deepest_manifold(b, a, false);
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::Compound& a, const colliders::Compound& b) const
+    {
+        return deepest_manifold(a, b, true);
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::Compound& a, const colliders::Mesh& b) const
+    {
+        return deepest_manifold(a, b, true);
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::Mesh& a, const colliders::Compound& b) const
+    {
+        return deepest_manifold(b, a, false);
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::Compound& a, const colliders::Heightfield& b) const
+    {
+        return deepest_manifold(a, b, true);
+    }
+
+    std::optional<ContactManifold>
+    CollisionVisitor::operator()(const colliders::Heightfield& a, const colliders::Compound& b) const
+    {
+        return deepest_manifold(b, a, false);
+    }
+}
@@ -1,14 +1,62 @@
 #pragma once
 
+#include <functional>
 #include <optional>
 #include <variant>
 
 #include <math/vector.h>
+#include <math/quaternion.h>
 
 #include "Collision.h"
+#include "Algorithms.h"
+#include "ConvexHull.h"
+#include "Heightfield.h"
+#include "TriangleMesh.h"
 
 namespace yage::physics3d
 {
+    class CompoundShape;
+
+    namespace shapes
+    {
+        /**
+         * A cylinder along the local y-axis that is capped by hemispheres.
+         */
+        struct Capsule
+        {
+            double radius{0.5};
+
+            /**
+             * Half the height of the cylindrical part, i.e. the distance from the center to the centers of the caps.
+             */
+            double half_height{0.5};
+        };
+
+        /**
+         * A cylinder along the local y-axis.
+         */
+        struct Cylinder
+        {
+            double radius{0.5};
+            double half_height{0.5};
+        };
+
+        /**
+         * Refers to a convex hull, which must outlive all colliders that refer to it.
+         */
+        struct Hull
+        {
+            const ConvexHull* hull{};
+        };
+    }
+
+    /**
+     * Convex shapes that are described by their support mapping. They collide with each other, with spheres, and with
+     * boxes through GJK and EPA, so that a new shape only needs a support function instead of collision routines for
+     * every other shape.
+     */
+    using ConvexShape = std::variant<shapes::Capsule, shapes::Cylinder, shapes::Hull>;
+
     namespace colliders
     {
         /**
@@ -83,9 +131,142 @@ namespace yage::physics3d
                         oriented_vertices[1] - oriented_vertices[0]));
             }
         };
+
+        /**
+         * Represents an oriented convex shape.
+         */
+        struct Convex
+        {
+            ConvexShape shape;
+            math::Vec3d center{};
+            math::Quatd orientation{};
+        };
+
+        /**
+         * Represents the triangle mesh of a static body. Meshes collide with spheres, boxes and convex colliders, but
+         * not with planes, other meshes, or heightfields.
+         */
+        struct Mesh
+        {
+            /**
+             * Refers to the triangles, which must outlive all colliders that refer to them.
+             */
+            const TriangleMesh* mesh{};
+            math::Vec3d center{};
+            math::Quatd orientation{};
+        };
+
+        /**
+         * Represents the terrain of a static body as a grid of heights. Heightfields collide like meshes.
+         */
+        struct Heightfield
+        {
+            /**
+             * Refers to the samples, which must outlive all colliders that refer to them.
+             */
+            const physics3d::Heightfield* heightfield{};
+            math::Vec3d center{};
+            math::Quatd orientation{};
+        };
+
+        /**
+         * Represents several child colliders that move together as one body.
+         */
+        struct Compound
+        {
+            /**
+             * Refers to the children, which must outlive all colliders that refer to them.
+             */
+            const CompoundShape* shape{};
+            math::Vec3d center{};
+            math::Quatd orientation{};
+        };
     }
 
-    using Collider = std::variant<colliders::Sphere, colliders::OrientedPlane, colliders::OrientedBox>;
+    using Collider = std::variant<colliders::Sphere, colliders::OrientedPlane, colliders::OrientedBox,
+            colliders::Convex, colliders::Mesh, colliders::Heightfield, colliders::Compound>;
+
+    /**
+     * Computes the world-space axis-aligned bounds of a collider. Planes are unbounded and yield infinite bounds.
+     */
+    geometry::AABB world_bounds(const Collider& collider);
+
+    /**
+     * Returns the plane that an unbounded collider extends along, or empty for bounded colliders.
+     */
+    std::optional<geometry::Plane> unbounded_plane(const Collider& collider);
+
+    /**
+     * Returns the largest sphere around the center of a collider that lies within the collider, which is swept for
+     * continuous collision detection. Unbounded colliders, meshes and heightfields yield empty. Compounds yield the
+     * largest inner sphere of their children.
+     */
+    std::optional<colliders::Sphere> inner_sphere(const Collider& collider);
+
+    /**
+     * Computes the time of impact of a sphere that moves along a straight line against a stationary collider. Boxes
+     * are inflated by the sphere radius, which makes the time of impact conservative around their edges. Convex
+     * colliders are approached iteratively by their distance.
+     * @param sphere The sphere at the start of the motion.
+     * @param displacement The displacement of the sphere over the whole motion.
+     * @param collider The collider in world space.
+     * @return The fraction of the motion in [0, 1] at which the sphere first touches the collider, or empty if the
+     * sphere misses the collider or already touches it at the start of the motion.
+     */
+    std::optional<double> time_of_impact(const colliders::Sphere& sphere, const math::Vec3d& displacement,
+                                         const Collider& collider);
+
+    /**
+     * The first contact of a sphere that moves along a straight line with a collider.
+     */
+    struct SweepHit
+    {
+        /**
+         * The fraction of the motion in [0, 1] at which the sphere first touches the collider.
+         */
+        double fraction{};
+
+        /**
+         * The surface normal of the collider at the contact, pointing towards the sphere.
+         */
+        math::Vec3d normal{};
+    };
+
+    /**
+     * Sweeps a sphere along a straight line against a stationary collider, like time_of_impact, but also yields the
+     * normal at the contact. Spheres with zero radius cast rays.
+     */
+    std::optional<SweepHit> sweep(const colliders::Sphere& sphere, const math::Vec3d& displacement,
+                                  const Collider& collider);
+
+    struct GjkCache;
+
+    /**
+     * Collides a collider with the triangles of a mesh that lie within its bounds. Since the triangles of a mesh may
+     * face in different directions, each touching triangle yields a manifold of its own. The triangle index is stored
+     * in the upper half of the feature ids of its contacts, which makes them unique within the pair of bodies.
+     * @param mesh_is_a Whether the mesh is object A of the pair, which determines the direction of the normals.
+     * @param callback Invoked with the manifold of each touching triangle.
+     */
+    void collide(const colliders::Mesh& mesh, const Collider& other, bool mesh_is_a,
+                 const std::function<void(const ContactManifold&)>& callback);
+
+    /**
+     * Collides a collider with the triangles of the cells of a heightfield below its bounds, like a mesh.
+     */
+    void collide(const colliders::Heightfield& heightfield, const Collider& other, bool heightfield_is_a,
+                 const std::function<void(const ContactManifold&)>& callback);
+
+    /**
+     * Collides a collider with the children of a compound that lie within its bounds. Each touching child yields a
+     * manifold of its own, like the triangles of a mesh. The child index is stored in bits 17 to 31 of the feature
+     * ids of its contacts, below the triangle index of meshes and heightfields. For pairs of compounds, the child of
+     * the given compound is stored in the upper half instead.
+     * @param compound_is_a Whether the compound is object A of the pair, which determines the direction of the normals.
+     * @param callback Invoked with the manifold of each touching child.
+     */
+    void collide(const colliders::Compound& compound, const Collider& other, bool compound_is_a,
+                 const std::function<void(const ContactManifold&)>& callback);
 
     /**
      * Implements collision detection between the various bounding volume types.
@@ -93,6 +274,12 @@ namespace yage::physics3d
     class CollisionVisitor
     {
     public:
+        /**
+         * @param cache Separating axis of the pair from the previous step, which speeds up collisions with convex
+         * colliders and between boxes, and is updated by them. May be null.
+         */
+        explicit CollisionVisitor(GjkCache* cache = nullptr);
+
         std::optional<ContactManifold> operator()(const colliders::Sphere& a, const colliders::Sphere& b) const;
 
         std::optional<ContactManifold> operator()(const colliders::Sphere& a, const colliders::OrientedPlane& b) const;
@@ -110,5 +297,60 @@ namespace yage::physics3d
         std::optional<ContactManifold> operator()(const colliders::OrientedBox&, const colliders::OrientedPlane&) const;
 
         std::optional<ContactManifold> operator()(const colliders::OrientedBox& a, const colliders::OrientedBox& b) const;
+
+        std::optional<ContactManifold> operator()(const colliders::Sphere& a, const colliders::Convex& b) const;
+
+        std::optional<ContactManifold> operator()(const colliders::OrientedPlane& a, const colliders::Convex& b) const;
+
+        std::optional<ContactManifold> operator()(const colliders::OrientedBox& a, const colliders::Convex& b) const;
+
+        std::optional<ContactManifold> operator()(const colliders::Convex& a, const colliders::Sphere& b) const;
+
+        std::optional<ContactManifold> operator()(const colliders::Convex& a, const colliders::OrientedPlane& b) const;
+
+        std::optional<ContactManifold> operator()(const colliders::Convex& a, const colliders::OrientedBox& b) const;
+
+        std::optional<ContactManifold> operator()(const colliders::Convex& a, const colliders::Convex& b) const;
+
+        /**
+         * Meshes and heightfields yield the manifold of the deepest triangle, which is only meant for overlap tests.
+         * The narrow phase collides them with all touching triangles instead.
+         */
+        std::optional<ContactManifold> operator()(const colliders::Mesh& a, const Collider& b) const;
+
+        std::optional<ContactManifold> operator()(const Collider& a, const colliders::Mesh& b) const;
+
+        std::optional<ContactManifold> operator()(const colliders::Mesh& a, const colliders::Mesh& b) const;
+
+        std::optional<ContactManifold> operator()(const colliders::Heightfield& a, const Collider& b) const;
+
+        std::optional<ContactManifold> operator()(const Collider& a, const colliders::Heightfield& b) const;
+
+        std::optional<ContactManifold> operator()(const colliders::Heightfield& a,
+                                                  const colliders::Heightfield& b) const;
+
+        std::optional<ContactManifold> operator()(const colliders::Mesh& a, const colliders::Heightfield& b) const;
+
+        std::optional<ContactManifold> operator()(const colliders::Heightfield& a, const colliders::Mesh& b) const;
+
+        /**
+         * Compounds yield the manifold of the deepest child, like meshes.
+         */
+        std::optional<ContactManifold> operator()(const colliders::Compound& a, const Collider& b) const;
+
+        std::optional<ContactManifold> operator()(const Collider& a, const colliders::Compound& b) const;
+
+        std::optional<ContactManifold> operator()(const colliders::Compound& a, const colliders::Compound& b) const;
+
+        std::optional<ContactManifold> operator()(const colliders::Compound& a, const colliders::Mesh& b) const;
+
+        std::optional<ContactManifold> operator()(const colliders::Mesh& a, const colliders::Compound& b) const;
+
+        std::optional<ContactManifold> operator()(const colliders::Compound& a, const colliders::Heightfield& b) const;
+
+        std::optional<ContactManifold> operator()(const colliders::Heightfield& a, const colliders::Compound& b) const;
+
+    private:
+        GjkCache* m_cache;
     };
 }
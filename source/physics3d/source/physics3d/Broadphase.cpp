@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+#include "Broadphase.h"
+
+namespace yage::physics3d
+{
+    std::uint32_t Broadphase::create_proxy(const Collider& collider, const std::size_t user_id,
+                                           const CollisionFilter& filter, const bool frozen)
+    {
+        const std::uint32_t id = allocate_proxy();
+        Proxy& proxy = m_proxies[id];
+        proxy.user_id = user_id;
+        proxy.filter = filter;
+        proxy.frozen = frozen;
+
+        if (std::optional<geometry::Plane> plane = unbounded_plane(collider); plane.has_value()) {
+            proxy.plane = plane;
+            m_unbounded_proxies.push_back(id);
+        } else {
+            proxy.tree_node = m_tree.create_proxy(world_bounds(collider), id);
+        }
+        m_move_buffer.push_back(id);
+
+        return id;
+    }
+
+    void Broadphase::destroy_proxy(const std::uint32_t id)
+    {
+        assert(id < m_proxies.size() && !m_proxies[id].destroyed);
+        Proxy& proxy = m_proxies[id];
+
+        if (proxy.plane.has_value()) {
+            std::erase(m_unbounded_proxies, id);
+        } else {
+            m_tree.destroy_proxy(proxy.tree_node);
+            proxy.tree_node = DynamicAabbTree::null_node;
+        }
+
+        proxy.destroyed = true;
+        m_destroyed_proxies.push_back(id);
+    }
+
+    void Broadphase::set_user_id(const std::uint32_t id, const std::size_t user_id)
+    {
+        assert(id < m_proxies.size() && !m_proxies[id].destroyed);
+        m_proxies[id].user_id = user_id;
+    }
+
+    void Broadphase::move_proxy(const std::uint32_t id, const Collider& collider, const math::Vec3d& displacement)
+    {
+        assert(id < m_proxies.size() && !m_proxies[id].destroyed);
+        Proxy& proxy = m_proxies[id];
+
+        if (proxy.plane.has_value()) {
+            const geometry::Plane plane = unbounded_plane(collider).value();
+            if (plane.support != proxy.plane->support || plane.normal != proxy.plane->normal) {
+                proxy.plane = plane;
+                m_move_buffer.push_back(id);
+            }
+            return;
+        }
+
+        if (m_tree.move_proxy(proxy.tree_node, world_bounds(collider), displacement)) {
+            m_move_buffer.push_back(id);
+        }
+    }
+
+    void Broadphase::set_filter(const std::uint32_t id, const CollisionFilter& filter)
+    {
+        assert(id < m_proxies.size() && !m_proxies[id].destroyed);
+        Proxy& proxy = m_proxies[id];
+        proxy.filter = filter;
+        // look for pairs that the previous filter rejected
+        m_move_buffer.push_back(id);
+    }
+
+    void Broadphase::set_frozen(const std::uint32_t id, const bool frozen)
+    {
+        assert(id < m_proxies.size() && !m_proxies[id].destroyed);
+        Proxy& proxy = m_proxies[id];
+        if (proxy.frozen == frozen) {
+            return;
+        }
+        proxy.frozen = frozen;
+        if (!frozen) {
+            // pairs with other frozen proxies were dropped while this proxy was frozen
+            m_move_buffer.push_back(id);
+        }
+    }
+
+    const std::vector<Broadphase::CandidatePair>& Broadphase::update_pairs()
+    {
+        // drop pairs that no longer overlap, which can only happen if one of the proxies was re-inserted or a plane
+        // has moved, and pairs whose proxies have been frozen or filtered since
+        std::erase_if(m_proxy_pairs, [this](const std::pair<std::uint32_t, std::uint32_t>& pair) {
+            const Proxy& a = m_proxies[pair.first];
+            const Proxy& b = m_proxies[pair.second];
+            return a.destroyed || b.destroyed || !should_pair(a, b) || !overlaps(a, b);
+        });
+
+        // only proxies that were re-inserted can have gained new overlaps
+        m_new_proxy_pairs.clear();
+        auto add_pair = [this](const std::uint32_t id, const std::uint32_t other) {
+            m_new_proxy_pairs.emplace_back(std::min(id, other), std::max(id, other));
+        };
+        for (const std::uint32_t id: m_move_buffer) {
+            const Proxy& proxy = m_proxies[id];
+            if (proxy.destroyed) {
+                continue;
+            }
+
+            if (proxy.plane.has_value()) {
+                // planes are only tested against all bounded proxies when they are created or changed
+                for (std::uint32_t other = 0; other < m_proxies.size(); ++other) {
+                    const Proxy& other_proxy = m_proxies[other];
+                    if (!other_proxy.destroyed && other_proxy.tree_node != DynamicAabbTree::null_node &&
+                        should_pair(proxy, other_proxy) && overlaps(proxy, other_proxy)) {
+                        add_pair(id, other);
+                    }
+                }
+                continue;
+            }
+
+            m_tree.query(m_tree.fat_aabb(proxy.tree_node), [this, id, &proxy, &add_pair](const std::uint32_t node) {
+                const std::uint32_t other = m_tree.user_data(node);
+                if (other != id && should_pair(proxy, m_proxies[other])) {
+                    add_pair(id, other);
+                }
+                return true;
+            });
+            // unbounded proxies are not paired with each other
+            for (const std::uint32_t unbounded: m_unbounded_proxies) {
+                const Proxy& unbounded_proxy = m_proxies[unbounded];
+                if (should_pair(proxy, unbounded_proxy) && overlaps(proxy, unbounded_proxy)) {
+                    add_pair(id, unbounded);
+                }
+            }
+        }
+        m_move_buffer.clear();
+
+        std::ranges::sort(m_new_proxy_pairs);
+        const auto duplicates = std::ranges::unique(m_new_proxy_pairs);
+        m_new_proxy_pairs.erase(duplicates.begin(), duplicates.end());
+
+        m_merged_proxy_pairs.clear();
+        std::ranges::set_union(m_proxy_pairs, m_new_proxy_pairs, std::back_inserter(m_merged_proxy_pairs));
+        std::swap(m_proxy_pairs, m_merged_proxy_pairs);
+
+        // no pair refers to destroyed proxies anymore, so their ids can be reused
+        m_free_proxies.insert(m_free_proxies.end(), m_destroyed_proxies.begin(), m_destroyed_proxies.end());
+        m_destroyed_proxies.clear();
+
+        m_pairs.clear();
+        for (const auto& [a, b]: m_proxy_pairs) {
+            m_pairs.push_back(make_pair(a, b));
+        }
+        std::ranges::sort(m_pairs);
+        return m_pairs;
+    }
+
+    const DynamicAabbTree& Broadphase::tree() const
+    {
+        return m_tree;
+    }
+
+    void Broadphase::save(SnapshotWriter& writer) const
+    {
+        // the candidate pairs are recomputed in the next update, while the persistent pairs are needed to report
+        // the same pairs as without restoring
+        m_tree.save(writer);
+        writer.write(m_proxies);
+        writer.write(m_free_proxies);
+        writer.write(m_destroyed_proxies);
+        writer.write(m_unbounded_proxies);
+        writer.write(m_move_buffer);
+        writer.write(m_proxy_pairs);
+    }
+
+    void Broadphase::restore(SnapshotReader& reader)
+    {
+        m_tree.restore(reader);
+        reader.read(m_proxies);
+        reader.read(m_free_proxies);
+        reader.read(m_destroyed_proxies);
+        reader.read(m_unbounded_proxies);
+        reader.read(m_move_buffer);
+        reader.read(m_proxy_pairs);
+        m_pairs.clear();
+    }
+
+    std::uint32_t Broadphase::allocate_proxy()
+    {
+        if (m_free_proxies.empty()) {
+            m_proxies.emplace_back();
+            return static_cast<std::uint32_t>(m_proxies.size() - 1);
+        }
+
+        const std::uint32_t id = m_free_proxies.back();
+        m_free_proxies.pop_back();
+        m_proxies[id] = Proxy{};
+        return id;
+    }
+
+    Broadphase::CandidatePair Broadphase::make_pair(const std::uint32_t proxy_a, const std::uint32_t proxy_b) const
+    {
+        const std::size_t a = m_proxies[proxy_a].user_id;
+        const std::size_t b = m_proxies[proxy_b].user_id;
+        return {std::min(a, b), std::max(a, b)};
+    }
+
+    bool Broadphase::overlaps(const Proxy& a, const Proxy& b) const
+    {
+        if (a.plane.has_value()) {
+            return geometry::intersects(m_tree.fat_aabb(b.tree_node), a.plane.value());
+        }
+        if (b.plane.has_value()) {
+            return geometry::intersects(m_tree.fat_aabb(a.tree_node), b.plane.value());
+        }
+        return geometry::overlaps(m_tree.fat_aabb(a.tree_node), m_tree.fat_aabb(b.tree_node));
+    }
+
+    bool Broadphase::should_pair(const Proxy& a, const Proxy& b)
+    {
+        return !(a.frozen && b.frozen) && a.filter.collides_with(b.filter);
+    }
+}
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "Algorithms.h"
+#include "BoundingShape.h"
+#include "DynamicAabbTree.h"
+#include "Snapshot.h"
+
+namespace yage::physics3d
+{
+    /**
+     * Decides which bodies collide, by the layers that each body belongs to and the layers that it collides with. Two
+     * bodies only collide if each of them belongs to a layer that the other one collides with. By default, all bodies
+     * belong to the first layer and collide with all layers.
+     */
+    struct CollisionFilter
+    {
+        /**
+         * The layers of the body, one bit per layer.
+         */
+        std::uint32_t layers = 1;
+
+        /**
+         * The layers that the body collides with.
+         */
+        std::uint32_t mask = std::numeric_limits<std::uint32_t>::max();
+
+        [[nodiscard]]
+        bool collides_with(const CollisionFilter& other) const
+        {
+            return (layers & other.mask) != 0 && (other.layers & mask) != 0;
+        }
+    };
+
+    /**
+     * Finds pairs of colliders whose bounds overlap, such that the narrow phase only needs to look at candidate pairs.
+     * Bounded colliders are stored in a dynamic AABB tree, while unbounded colliders (planes) are kept in a separate
+     * list.
+     *
+     * Overlapping pairs persist between updates, so that only colliders that have left their fattened bounds need to
+     * query the tree and the planes for new pairs. Planes are only tested against all other colliders when they are
+     * created or moved.
+     *
+     * Pairs whose collision filters reject each other are never reported, and neither are pairs of frozen colliders,
+     * whose bodies are static or asleep and therefore can't need any collision response. Both are decided from flags
+     * of the proxies before any bounds are compared, so filtered pairs cost next to nothing.
+     */
+    class Broadphase
+    {
+    public:
+        /**
+         * A pair of user ids, where the first id is always smaller than the second.
+         */
+        using CandidatePair = std::pair<std::size_t, std::size_t>;
+
+        static constexpr std::uint32_t null_proxy = std::numeric_limits<std::uint32_t>::max();
+
+        /**
+         * Adds a collider to the broad phase.
+         * @param collider The collider in world space.
+         * @param user_id Id that is reported in candidate pairs for this collider.
+         * @param filter Decides with which other colliders pairs are reported.
+         * @param frozen Whether the collider can't move, see set_frozen.
+         * @return The id of the created proxy.
+         */
+        std::uint32_t create_proxy(const Collider& collider, std::size_t user_id, const CollisionFilter& filter = {},
+                                   bool frozen = false);
+
+        /**
+         * Removes a collider from the broad phase.
+         */
+        void destroy_proxy(std::uint32_t proxy);
+
+        /**
+         * Changes the id that is reported in candidate pairs and queries for a collider, which takes effect
+         * immediately.
+         */
+        void set_user_id(std::uint32_t proxy, std::size_t user_id);
+
+        /**
+         * Updates the bounds of a collider after it has moved.
+         * @param proxy The id of the proxy.
+         * @param collider The collider in world space.
+         * @param displacement The predicted displacement of the collider until the next update.
+         */
+        void move_proxy(std::uint32_t proxy, const Collider& collider, const math::Vec3d& displacement);
+
+        /**
+         * Changes the collision filter of a collider, which takes effect in the next update.
+         */
+        void set_filter(std::uint32_t proxy, const CollisionFilter& filter);
+
+        /**
+         * Marks a collider as frozen, because its body is static or has fallen asleep, or as movable again. Pairs of
+         * two frozen colliders are not reported, since neither body moves in response to a collision.
+         */
+        void set_frozen(std::uint32_t proxy, bool frozen);
+
+        /**
+         * Updates the candidate pairs from all proxies that have been created or moved since the last update.
+         * @return All pairs with overlapping bounds, in lexicographic order of their user ids.
+         */
+        const std::vector<CandidatePair>& update_pairs();
+
+        /**
+         * Reports the user ids of all bounded colliders whose fattened bounds overlap a box. Unbounded colliders are
+         * not reported.
+         * @param aabb The box to test in world space.
+         * @param callback Called with the user id of each overlapping collider.
+         */
+        template<typename Callback>
+        void query(const geometry::AABB& aabb, Callback&& callback) const
+        {
+            m_tree.query(aabb, [this, &callback](const std::uint32_t node) {
+                callback(m_proxies[m_tree.user_data(node)].user_id);
+                return true;
+            });
+        }
+
+        /**
+         * Reports the user ids of all unbounded colliders whose plane intersects a box.
+         * @param aabb The box to test in world space.
+         * @param callback Called with the user id of each intersecting collider.
+         */
+        template<typename Callback>
+        void query_unbounded(const geometry::AABB& aabb, Callback&& callback) const
+        {
+            for (const std::uint32_t id: m_unbounded_proxies) {
+                if (geometry::intersects(aabb, m_proxies[id].plane.value())) {
+                    callback(m_proxies[id].user_id);
+                }
+            }
+        }
+
+        /**
+         * Reports the user ids of all colliders that a sphere moving along a line segment may hit. These are all
+         * unbounded colliders, which are reported first, and the bounded colliders whose fattened bounds are hit.
+         * @param start The center of the sphere at the start of the motion.
+         * @param displacement The displacement of the sphere over the whole motion.
+         * @param radius The radius of the sphere, or zero for rays.
+         * @param callback Called with the user id of each collider. Returns the fraction of the motion that is
+         * searched further, such that a hit can shorten the motion.
+         */
+        template<typename Callback>
+        void sweep(const math::Vec3d& start, const math::Vec3d& displacement, const double radius,
+                   Callback&& callback) const
+        {
+            double max_fraction = 1;
+            for (const std::uint32_t id: m_unbounded_proxies) {
+                max_fraction = std::min(max_fraction, callback(m_proxies[id].user_id));
+            }
+            m_tree.sweep(start, displacement, radius, max_fraction, [this, &callback](const std::uint32_t node) {
+                return callback(m_proxies[m_tree.user_data(node)].user_id);
+            });
+        }
+
+        [[nodiscard]]
+        const DynamicAabbTree& tree() const;
+
+        /**
+         * Appends the state of the proxies and pairs to a snapshot.
+         */
+        void save(SnapshotWriter& writer) const;
+
+        /**
+         * Restores the state that was saved to a snapshot.
+         */
+        void restore(SnapshotReader& reader);
+
+    private:
+        struct Proxy
+        {
+            std::size_t user_id{};
+
+            /**
+             * Leaf in the tree for bounded colliders.
+             */
+            std::uint32_t tree_node = DynamicAabbTree::null_node;
+
+            /**
+             * Plane for unbounded colliders.
+             */
+            std::optional<geometry::Plane> plane;
+
+            CollisionFilter filter;
+            bool frozen = false;
+            bool destroyed = false;
+        };
+
+        DynamicAabbTree m_tree;
+
+        std::vector<Proxy> m_proxies;
+        std::vector<std::uint32_t> m_free_proxies;
+        /**
+         * Proxies that were destroyed since the last update. They are only freed after pairs have been pruned, so that
+         * no stale pair refers to a reused proxy id.
+         */
+        std::vector<std::uint32_t> m_destroyed_proxies;
+        std::vector<std::uint32_t> m_unbounded_proxies;
+
+        /**
+         * Proxies that were created, re-inserted into the tree, or whose plane has moved since the last update.
+         */
+        std::vector<std::uint32_t> m_move_buffer;
+
+        /**
+         * Overlapping pairs of proxies, of which at most one is unbounded, sorted by proxy id.
+         */
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> m_proxy_pairs;
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> m_new_proxy_pairs;
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> m_merged_proxy_pairs;
+
+        std::vector<CandidatePair> m_pairs;
+
+        std::uint32_t allocate_proxy();
+
+        [[nodiscard]]
+        CandidatePair make_pair(std::uint32_t proxy_a, std::uint32_t proxy_b) const;
+
+        /**
+         * @return Whether the fattened bounds or planes of two proxies overlap.
+         */
+        [[nodiscard]]
+        bool overlaps(const Proxy& a, const Proxy& b) const;
+
+        /**
+         * @return Whether a pair of proxies passes the filters and flags, regardless of their bounds.
+         */
+        [[nodiscard]]
+        static bool should_pair(const Proxy& a, const Proxy& b);
+    };
+}
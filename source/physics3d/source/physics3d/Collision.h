@@ -1,15 +1,14 @@
 #pragma once
 
-#include <vector>
+#include <cstdint>
 #include <optional>
 
 #include <math/vector.h>
-#include <math/matrix.h>
+
+#include "FixedVector.h"
 
 namespace yage::physics3d
 {
-    class RigidBody;
-
     /**
      * Represents a point of contact between two colliding bodies.
      */
@@ -49,6 +48,13 @@ namespace yage::physics3d
          * Relative velocity from object A to B at the contact point along the contact normal.
          */
         double rel_v_n{};
+
+        /**
+         * Identifies the pair of geometric features that generated this contact, such that the same contact can be
+         * recognized in subsequent frames. Only unique within a manifold, except for meshes, whose manifolds are told
+         * apart by the triangle index in the upper half.
+         */
+        std::uint64_t feature_id{};
     };
 
     /**
@@ -57,9 +63,10 @@ namespace yage::physics3d
     struct ContactManifold
     {
         /**
-         * Points of contact for this collision. Must contain at east one contact point.
+         * Points of contact for this collision. Must contain at east one contact point. Two boxes touch in at most
+         * eight points, which are stored inline so that collision detection doesn't allocate.
          */
-        std::vector<ContactPoint> contacts;
+        FixedVector<ContactPoint, 8> contacts;
 
         /**
          * Normalized contact normal vector from object A to B.
@@ -76,37 +83,4 @@ namespace yage::physics3d
          */
         math::Vec3d tangent_2;
     };
-
-    /**
-     * Represent a singular constraint between two bodies to be solved by the constraint solver.
-     */
-    struct Constraint
-    {
-        /**
-         * The inverted mass matrix.
-         */
-        const math::Matd<12, 12> m_inv;
-
-        /**
-         * The Jacobian.
-         */
-        const math::Matd<1, 12> j;
-
-        /**
-         * The transpose of the Jacobian.
-         */
-        const math::Matd<12, 1> j_t;
-
-        const double bias{};
-
-        RigidBody& rb_a;
-        RigidBody& rb_b;
-
-        double accumulated_lambda{};
-
-        /**
-         * An optional constraint that this constraint depends on.
-         */
-        std::optional<const Constraint *> dependent_constraint{};
-    };
 }
@@ -0,0 +1,66 @@
+#include <cassert>
+
+#include <utils/utils.h>
+
+#include "CompoundShape.h"
+
+namespace yage::physics3d
+{
+    CompoundShape::CompoundShape(const std::span<const Collider> children)
+        : m_children(children.begin(), children.end())
+    {
+        assert(!children.empty() && children.size() <= max_children);
+
+        m_child_bounds.reserve(m_children.size());
+        for (const Collider& child: m_children) {
+            assert((std::holds_alternative<colliders::Sphere>(child) ||
+                    std::holds_alternative<colliders::OrientedBox>(child) ||
+                    std::holds_alternative<colliders::Convex>(child)));
+            // the body's local space is the world space of the children
+            m_child_bounds.push_back(world_bounds(child));
+        }
+
+        m_bounds = m_child_bounds.front();
+        for (const geometry::AABB& bounds: m_child_bounds) {
+            m_bounds = geometry::merge(m_bounds, bounds);
+        }
+    }
+
+    std::size_t CompoundShape::size() const
+    {
+        return m_children.size();
+    }
+
+    const Collider& CompoundShape::child(const std::size_t index) const
+    {
+        return m_children[index];
+    }
+
+    Collider CompoundShape::child(const std::size_t index, const math::Vec3d& position,
+                                  const math::Quatd& orientation) const
+    {
+        Collider child = m_children[index];
+        std::visit(utils::overload{
+                [&position, &orientation](colliders::Sphere& sphere) {
+                    sphere.center = position + orientation * sphere.center;
+                },
+                [&position, &orientation](colliders::OrientedBox& box) {
+                    box.center = position + orientation * box.center;
+                    box.orientation = orientation * box.orientation;
+                    box.update_computed_values();
+                },
+                [&position, &orientation](colliders::Convex& convex) {
+                    convex.center = position + orientation * convex.center;
+                    convex.orientation = orientation * convex.orientation;
+                },
+                [](auto&) {
+                },
+        }, child);
+        return child;
+    }
+
+    const geometry::AABB& CompoundShape::bounds() const
+    {
+        return m_bounds;
+    }
+}
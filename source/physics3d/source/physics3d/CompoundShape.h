@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <math/vector.h>
+#include <math/quaternion.h>
+
+#include "Algorithms.h"
+#include "BoundingShape.h"
+
+namespace yage::physics3d
+{
+    /**
+     * A rigid arrangement of spheres, boxes and convex colliders in the local space of a body, such as the top and legs
+     * of a table. Each child keeps its own bounds, such that collisions only test the children near the other body
+     * instead of all of them.
+     *
+     * Compound shapes are immutable and meant to be shared by all colliders with the same children, which refer to
+     * the shape and must not outlive it.
+     */
+    class CompoundShape
+    {
+    public:
+        /**
+         * The largest number of children, since child indices are stored in 15 bits of the feature ids of contacts.
+         */
+        static constexpr std::size_t max_children = 1u << 15;
+
+        /**
+         * @param children Spheres, boxes and convex colliders, which are placed in the local space of the body by their
+         * center and orientation. The origin is the center of mass of the body, so the inertia shape of the body
+         * should be chosen for the whole arrangement.
+         */
+        explicit CompoundShape(std::span<const Collider> children);
+
+        [[nodiscard]]
+        std::size_t size() const;
+
+        /**
+         * @return A child in the local space of the body.
+         */
+        [[nodiscard]]
+        const Collider& child(std::size_t index) const;
+
+        /**
+         * @return A child that is moved from the local space of the body into world space.
+         */
+        [[nodiscard]]
+        Collider child(std::size_t index, const math::Vec3d& position, const math::Quatd& orientation) const;
+
+        /**
+         * @return The local-space bounds of all children.
+         */
+        [[nodiscard]]
+        const geometry::AABB& bounds() const;
+
+        /**
+         * Finds all children whose bounds overlap a local-space box.
+         * @param callback Invoked with the index of each overlapping child.
+         */
+        template<typename Callback>
+        void query(const geometry::AABB& aabb, Callback&& callback) const
+        {
+            if (!geometry::overlaps(m_bounds, aabb)) {
+                return;
+            }
+            for (std::uint32_t i = 0; i < m_child_bounds.size(); ++i) {
+                if (geometry::overlaps(m_child_bounds[i], aabb)) {
+                    callback(i);
+                }
+            }
+        }
+
+        /**
+         * Reports all children whose bounds, grown by a radius, are hit by a local-space line segment, like
+         * TriangleMesh::sweep.
+         * @param callback Invoked with the index of each hit child. Returns the fraction of the segment that is
+         * searched further.
+         */
+        template<typename Callback>
+        void sweep(const math::Vec3d& start, const math::Vec3d& displacement, const double radius,
+                   double max_fraction, Callback&& callback) const
+        {
+            auto hits = [&](const geometry::AABB& aabb) {
+                const geometry::AABB bounds{
+                        .min = aabb.min - math::Vec3d(radius),
+                        .max = aabb.max + math::Vec3d(radius),
+                };
+                return geometry::intersects(bounds, start, max_fraction * displacement);
+            };
+
+            if (!hits(m_bounds)) {
+                return;
+            }
+            for (std::uint32_t i = 0; i < m_child_bounds.size() && max_fraction > 0; ++i) {
+                if (hits(m_child_bounds[i])) {
+                    max_fraction = std::min(max_fraction, callback(i));
+                }
+            }
+        }
+
+    private:
+        std::vector<Collider> m_children;
+        std::vector<geometry::AABB> m_child_bounds;
+        geometry::AABB m_bounds;
+    };
+}
@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <bit>
+
+#include "ConstraintBatches.h"
+
+namespace yage::physics3d
+{
+    void ConstraintBatches::build(std::span<const std::pair<std::size_t, std::size_t>> bodies,
+                                  const std::size_t body_count)
+    {
+        m_body_colors.assign(body_count, 0);
+        m_contact_colors.resize(bodies.size());
+
+        auto colors_of = [this](const std::size_t body) -> std::uint64_t {
+            return body == no_body ? 0 : m_body_colors[body];
+        };
+
+        // greedily choose the first color that is not yet used by either body
+        std::size_t color_count = 0;
+        m_has_conflicting_batch = false;
+        for (std::size_t i = 0; i < bodies.size(); ++i) {
+            const auto [a, b] = bodies[i];
+            const std::uint64_t used = colors_of(a) | colors_of(b);
+            const auto color = static_cast<std::size_t>(std::countr_one(used));
+            m_contact_colors[i] = static_cast<std::uint8_t>(color);
+
+            if (color == max_colors) {
+                m_has_conflicting_batch = true;
+                continue;
+            }
+            if (a != no_body) {
+                m_body_colors[a] |= std::uint64_t{1} << color;
+            }
+            if (b != no_body) {
+                m_body_colors[b] |= std::uint64_t{1} << color;
+            }
+            color_count = std::max(color_count, color + 1);
+        }
+        if (m_has_conflicting_batch) {
+            color_count = max_colors + 1;
+        }
+
+        // counting sort of the contacts by color, which keeps them in ascending order within each batch
+        m_offsets.assign(color_count + 1, 0);
+        for (std::size_t i = 0; i < bodies.size(); ++i) {
+            ++m_offsets[m_contact_colors[i] + 1];
+        }
+        for (std::size_t color = 0; color < color_count; ++color) {
+            m_offsets[color + 1] += m_offsets[color];
+        }
+        m_contacts.resize(bodies.size());
+        for (std::size_t i = 0; i < bodies.size(); ++i) {
+            m_contacts[m_offsets[m_contact_colors[i]]++] = i;
+        }
+        // the insertion above advanced each offset to the end of its batch
+        std::shift_right(m_offsets.begin(), m_offsets.end(), 1);
+        m_offsets[0] = 0;
+    }
+
+    std::size_t ConstraintBatches::size() const
+    {
+        return m_offsets.empty() ? 0 : m_offsets.size() - 1;
+    }
+
+    std::span<const std::size_t> ConstraintBatches::batch(const std::size_t index) const
+    {
+        return std::span(m_contacts).subspan(m_offsets[index], m_offsets[index + 1] - m_offsets[index]);
+    }
+
+    bool ConstraintBatches::is_conflicting(const std::size_t index) const
+    {
+        return m_has_conflicting_batch && index == max_colors;
+    }
+}
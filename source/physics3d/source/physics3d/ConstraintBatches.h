@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace yage::physics3d
+{
+    /**
+     * Partitions contacts into batches, such that no two contacts in a batch act on the same movable body (graph
+     * coloring). Contacts within a batch can then be solved in parallel without synchronization. Static bodies may be
+     * shared, since their velocities are never written.
+     *
+     * The partition only depends on the order of the contacts, so solving the batches is deterministic regardless of
+     * how many threads process each batch.
+     */
+    class ConstraintBatches
+    {
+    public:
+        /**
+         * A body id that does not take part in the coloring, e.g. for static bodies.
+         */
+        static constexpr std::size_t no_body = static_cast<std::size_t>(-1);
+
+        /**
+         * Assigns contacts to batches greedily in the given order.
+         * @param bodies The ids of the two bodies of each contact, or no_body for bodies that are never written.
+         * @param body_count An upper bound for the body ids.
+         */
+        void build(std::span<const std::pair<std::size_t, std::size_t>> bodies, std::size_t body_count);
+
+        [[nodiscard]]
+        std::size_t size() const;
+
+        /**
+         * @return The indices of the contacts in a batch, in ascending order.
+         */
+        [[nodiscard]]
+        std::span<const std::size_t> batch(std::size_t index) const;
+
+        /**
+         * @return Whether the contacts of a batch may share bodies, in which case the batch must be solved serially.
+         * This is only the case for the last batch of highly connected contact graphs.
+         */
+        [[nodiscard]]
+        bool is_conflicting(std::size_t index) const;
+
+    private:
+        /**
+         * The number of batches that can be tracked per body. Contacts that don't fit are put into an additional
+         * conflicting batch.
+         */
+        static constexpr std::size_t max_colors = 64;
+
+        /**
+         * Bitmask of the batches that contain a contact of each body.
+         */
+        std::vector<std::uint64_t> m_body_colors;
+        std::vector<std::uint8_t> m_contact_colors;
+
+        std::vector<std::size_t> m_offsets;
+        std::vector<std::size_t> m_contacts;
+        bool m_has_conflicting_batch = false;
+    };
+}
@@ -0,0 +1,222 @@
+#include <cassert>
+
+#include "ConstraintRows.h"
+
+namespace yage::physics3d
+{
+    template<typename Scalar>
+    std::size_t BasicConstraintRows<Scalar>::add(const BasicBodyStore<Scalar>& bodies, const std::size_t body_a,
+                                                  const std::size_t body_b, const Jacobian& jacobian, const double bias)
+    {
+        const double inverse_mass_a = bodies.inverse_mass(body_a);
+        const double inverse_mass_b = bodies.inverse_mass(body_b);
+        const math::Vec3d inertia_angular_a = bodies.inverse_inertia_tensor(body_a) * jacobian.angular_a;
+        const math::Vec3d inertia_angular_b = bodies.inverse_inertia_tensor(body_b) * jacobian.angular_b;
+
+        // J * M^-1 * J^T, where M^-1 is block-diagonal
+        const double mass = inverse_mass_a * dot(jacobian.linear_a, jacobian.linear_a) +
+                            inverse_mass_b * dot(jacobian.linear_b, jacobian.linear_b) +
+                            dot(jacobian.angular_a, inertia_angular_a) +
+                            dot(jacobian.angular_b, inertia_angular_b);
+
+        m_body_a.push_back(body_a);
+        m_body_b.push_back(body_b);
+        m_linear_a.push_back(static_cast<math::Vec3<Scalar>>(jacobian.linear_a));
+        m_linear_b.push_back(static_cast<math::Vec3<Scalar>>(jacobian.linear_b));
+        m_angular_a.push_back(static_cast<math::Vec3<Scalar>>(jacobian.angular_a));
+        m_angular_b.push_back(static_cast<math::Vec3<Scalar>>(jacobian.angular_b));
+        m_inertia_angular_a.push_back(static_cast<math::Vec3<Scalar>>(inertia_angular_a));
+        m_inertia_angular_b.push_back(static_cast<math::Vec3<Scalar>>(inertia_angular_b));
+        m_inverse_mass_a.push_back(inverse_mass_a);
+        m_inverse_mass_b.push_back(inverse_mass_b);
+        m_effective_mass.push_back(mass > 0 ? 1 / mass : 0);
+        m_bias.push_back(bias);
+        m_accumulated_lambda.push_back(0);
+
+        return m_bias.size() - 1;
+    }
+
+    template<typename Scalar>
+    void BasicConstraintRows<Scalar>::clear()
+    {
+        m_body_a.clear();
+        m_body_b.clear();
+        m_linear_a.clear();
+        m_linear_b.clear();
+        m_angular_a.clear();
+        m_angular_b.clear();
+        m_inertia_angular_a.clear();
+        m_inertia_angular_b.clear();
+        m_inverse_mass_a.clear();
+        m_inverse_mass_b.clear();
+        m_effective_mass.clear();
+        m_bias.clear();
+        m_accumulated_lambda.clear();
+    }
+
+    template<typename Scalar>
+    void BasicConstraintRows<Scalar>::reserve(const std::size_t rows)
+    {
+        m_body_a.reserve(rows);
+        m_body_b.reserve(rows);
+        m_linear_a.reserve(rows);
+        m_linear_b.reserve(rows);
+        m_angular_a.reserve(rows);
+        m_angular_b.reserve(rows);
+        m_inertia_angular_a.reserve(rows);
+        m_inertia_angular_b.reserve(rows);
+        m_inverse_mass_a.reserve(rows);
+        m_inverse_mass_b.reserve(rows);
+        m_effective_mass.reserve(rows);
+        m_bias.reserve(rows);
+        m_accumulated_lambda.reserve(rows);
+    }
+
+    template<typename Scalar>
+    std::size_t BasicConstraintRows<Scalar>::size() const
+    {
+        return m_bias.size();
+    }
+
+    template<typename Scalar>
+    void BasicConstraintRows<Scalar>::save(SnapshotWriter& writer) const
+    {
+        writer.write(m_body_a);
+        writer.write(m_body_b);
+        writer.write(m_linear_a);
+        writer.write(m_linear_b);
+        writer.write(m_angular_a);
+        writer.write(m_angular_b);
+        writer.write(m_inertia_angular_a);
+        writer.write(m_inertia_angular_b);
+        writer.write(m_inverse_mass_a);
+        writer.write(m_inverse_mass_b);
+        writer.write(m_effective_mass);
+        writer.write(m_bias);
+        writer.write(m_accumulated_lambda);
+    }
+
+    template<typename Scalar>
+    void BasicConstraintRows<Scalar>::restore(SnapshotReader& reader)
+    {
+        reader.read(m_body_a);
+        reader.read(m_body_b);
+        reader.read(m_linear_a);
+        reader.read(m_linear_b);
+        reader.read(m_angular_a);
+        reader.read(m_angular_b);
+        reader.read(m_inertia_angular_a);
+        reader.read(m_inertia_angular_b);
+        reader.read(m_inverse_mass_a);
+        reader.read(m_inverse_mass_b);
+        reader.read(m_effective_mass);
+        reader.read(m_bias);
+        reader.read(m_accumulated_lambda);
+    }
+
+    template<typename Scalar>
+    Scalar BasicConstraintRows<Scalar>::solve(const BasicBodyStore<Scalar>& bodies, const std::size_t row) const
+    {
+        return -velocity_error(bodies, row) * m_effective_mass[row];
+    }
+
+    template<typename Scalar>
+    Scalar BasicConstraintRows<Scalar>::velocity_error(const BasicBodyStore<Scalar>& bodies,
+                                                        const std::size_t row) const
+    {
+        const std::size_t a = m_body_a[row];
+        const std::size_t b = m_body_b[row];
+
+        const Scalar j_v = dot(m_linear_a[row], bodies.stored_velocity(a)) +
+                           dot(m_linear_b[row], bodies.stored_velocity(b)) +
+                           dot(m_angular_a[row], bodies.stored_angular_velocity(a)) +
+                           dot(m_angular_b[row], bodies.stored_angular_velocity(b));
+        return j_v + m_bias[row];
+    }
+
+    template<typename Scalar>
+    Scalar BasicConstraintRows<Scalar>::coupling(const std::size_t row_i, const std::size_t row_j) const
+    {
+        assert(m_body_a[row_i] == m_body_a[row_j] && m_body_b[row_i] == m_body_b[row_j]);
+
+        // J_i * M^-1 * J_j^T, where M^-1 is block-diagonal
+        return m_inverse_mass_a[row_i] * dot(m_linear_a[row_i], m_linear_a[row_j]) +
+               m_inverse_mass_b[row_i] * dot(m_linear_b[row_i], m_linear_b[row_j]) +
+               dot(m_angular_a[row_i], m_inertia_angular_a[row_j]) +
+               dot(m_angular_b[row_i], m_inertia_angular_b[row_j]);
+    }
+
+    template<typename Scalar>
+    void BasicConstraintRows<Scalar>::apply_impulse(BasicBodyStore<Scalar>& bodies, const std::size_t row,
+                                                    const Scalar lambda)
+    {
+        const std::size_t a = m_body_a[row];
+        const std::size_t b = m_body_b[row];
+
+        // static bodies are never written, so that they can be shared between rows that are solved in parallel
+        if (m_inverse_mass_a[row] > 0) {
+            bodies.add_velocity(a, lambda * m_inverse_mass_a[row] * m_linear_a[row]);
+            bodies.add_angular_velocity(a, lambda * m_inertia_angular_a[row]);
+        }
+        if (m_inverse_mass_b[row] > 0) {
+            bodies.add_velocity(b, lambda * m_inverse_mass_b[row] * m_linear_b[row]);
+            bodies.add_angular_velocity(b, lambda * m_inertia_angular_b[row]);
+        }
+    }
+
+    template<typename Scalar>
+    Scalar& BasicConstraintRows<Scalar>::accumulated_lambda(const std::size_t row)
+    {
+        return m_accumulated_lambda[row];
+    }
+
+    template<typename Scalar>
+    Scalar BasicConstraintRows<Scalar>::accumulated_lambda(const std::size_t row) const
+    {
+        return m_accumulated_lambda[row];
+    }
+
+    template<typename Scalar>
+    Scalar& BasicConstraintRows<Scalar>::bias(const std::size_t row)
+    {
+        return m_bias[row];
+    }
+
+    template<typename Scalar>
+    Scalar BasicConstraintRows<Scalar>::bias(const std::size_t row) const
+    {
+        return m_bias[row];
+    }
+
+    template<typename Scalar>
+    Jacobian BasicConstraintRows<Scalar>::jacobian(const std::size_t row) const
+    {
+        return {
+                .linear_a = static_cast<math::Vec3d>(m_linear_a[row]),
+                .linear_b = static_cast<math::Vec3d>(m_linear_b[row]),
+                .angular_a = static_cast<math::Vec3d>(m_angular_a[row]),
+                .angular_b = static_cast<math::Vec3d>(m_angular_b[row]),
+        };
+    }
+
+    template<typename Scalar>
+    Scalar BasicConstraintRows<Scalar>::effective_mass(const std::size_t row) const
+    {
+        return m_effective_mass[row];
+    }
+
+    template<typename Scalar>
+    std::size_t BasicConstraintRows<Scalar>::body_a(const std::size_t row) const
+    {
+        return m_body_a[row];
+    }
+
+    template<typename Scalar>
+    std::size_t BasicConstraintRows<Scalar>::body_b(const std::size_t row) const
+    {
+        return m_body_b[row];
+    }
+
+    template class BasicConstraintRows<float>;
+    template class BasicConstraintRows<double>;
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <vector>
+
+#include <math/vector.h>
+
+#include "BodyStore.h"
+#include "Snapshot.h"
+
+namespace yage::physics3d
+{
+    /**
+     * The Jacobian of a constraint between two bodies, split into its linear and angular parts for each body.
+     */
+    struct Jacobian
+    {
+        math::Vec3d linear_a;
+        math::Vec3d linear_b;
+        math::Vec3d angular_a;
+        math::Vec3d angular_b;
+    };
+
+    /**
+     * Stores singular constraints between two bodies (rows of the constraint system) to be solved by the constraint
+     * solver. Rows are stored as a structure of arrays.
+     *
+     * Since the inverse mass matrix of two bodies is block-diagonal, each row only keeps the Jacobian vectors, the
+     * products of the inverse inertia tensors with the angular Jacobian vectors, and the resulting scalar effective
+     * mass. Solving a row and applying its impulse then only needs a few dot products instead of dense 12x12 matrix
+     * products.
+     *
+     * Bodies are referred to by their ids in a body store, which has to be passed to all operations that read or write
+     * body velocities. Rows are solved in the precision of the body store, while Jacobians are passed in double
+     * precision.
+     */
+    template<typename Scalar>
+    class BasicConstraintRows
+    {
+    public:
+        /**
+         * Adds a constraint row. The masses of the bodies are read once when the row is added.
+         * @return The index of the new row.
+         */
+        std::size_t add(const BasicBodyStore<Scalar>& bodies, std::size_t body_a, std::size_t body_b,
+                        const Jacobian& jacobian, double bias);
+
+        void clear();
+
+        void reserve(std::size_t rows);
+
+        [[nodiscard]]
+        std::size_t size() const;
+
+        /**
+         * Appends the rows to a snapshot.
+         */
+        void save(SnapshotWriter& writer) const;
+
+        /**
+         * Restores the rows that were saved to a snapshot.
+         */
+        void restore(SnapshotReader& reader);
+
+        /**
+         * Computes the change of the impulse magnitude that satisfies a row for the current body velocities.
+         */
+        [[nodiscard]]
+        Scalar solve(const BasicBodyStore<Scalar>& bodies, std::size_t row) const;
+
+        /**
+         * @return The velocity of the bodies along a row plus the row's bias, i.e. J * v + b, which the solver drives
+         * towards zero.
+         */
+        [[nodiscard]]
+        Scalar velocity_error(const BasicBodyStore<Scalar>& bodies, std::size_t row) const;
+
+        /**
+         * @return J_i * M^-1 * J_j^T for two rows between the same bodies, i.e. how much the velocity along the first
+         * row changes per unit impulse along the second row. For equal rows, this is the inverse of the effective mass.
+         */
+        [[nodiscard]]
+        Scalar coupling(std::size_t row_i, std::size_t row_j) const;
+
+        /**
+         * Applies an impulse of the given magnitude along the row's Jacobian to both bodies. Static bodies with zero
+         * inverse mass are not written.
+         */
+        void apply_impulse(BasicBodyStore<Scalar>& bodies, std::size_t row, Scalar lambda);
+
+        [[nodiscard]]
+        Scalar& accumulated_lambda(std::size_t row);
+
+        [[nodiscard]]
+        Scalar accumulated_lambda(std::size_t row) const;
+
+        /**
+         * The velocity bias of a row, which can be updated between solver iterations, e.g. when the separation of the
+         * bodies changes during sub-stepping.
+         */
+        [[nodiscard]]
+        Scalar& bias(std::size_t row);
+
+        [[nodiscard]]
+        Scalar bias(std::size_t row) const;
+
+        [[nodiscard]]
+        Jacobian jacobian(std::size_t row) const;
+
+        /**
+         * @return The inverse of the row's constraint space mass, i.e. 1 / (J * M^-1 * J^T), or zero if neither body can
+         * move along the row.
+         */
+        [[nodiscard]]
+        Scalar effective_mass(std::size_t row) const;
+
+        [[nodiscard]]
+        std::size_t body_a(std::size_t row) const;
+
+        [[nodiscard]]
+        std::size_t body_b(std::size_t row) const;
+
+    private:
+        std::vector<std::size_t> m_body_a;
+        std::vector<std::size_t> m_body_b;
+
+        std::vector<math::Vec3<Scalar>> m_linear_a;
+        std::vector<math::Vec3<Scalar>> m_linear_b;
+        std::vector<math::Vec3<Scalar>> m_angular_a;
+        std::vector<math::Vec3<Scalar>> m_angular_b;
+
+        /**
+         * Inverse inertia tensors multiplied with the angular Jacobian vectors, i.e. the change in angular velocity per
+         * unit impulse.
+         */
+        std::vector<math::Vec3<Scalar>> m_inertia_angular_a;
+        std::vector<math::Vec3<Scalar>> m_inertia_angular_b;
+
+        std::vector<Scalar> m_inverse_mass_a;
+        std::vector<Scalar> m_inverse_mass_b;
+
+        std::vector<Scalar> m_effective_mass;
+        std::vector<Scalar> m_bias;
+        std::vector<Scalar> m_accumulated_lambda;
+    };
+
+    extern template class BasicConstraintRows<float>;
+    extern template class BasicConstraintRows<double>;
+
+    using ConstraintRows = BasicConstraintRows<double>;
+}
@@ -0,0 +1,53 @@
+#include <algorithm>
+
+#include "ContactCache.h"
+
+namespace yage::physics3d
+{
+    ContactCache::Impulse ContactCache::find(const Key& key) const
+    {
+        const auto it = std::ranges::lower_bound(m_previous, key, {}, &Entry::key);
+        if (it == m_previous.end() || it->key != key) {
+            return {};
+        }
+        return it->impulse;
+    }
+
+    void ContactCache::insert(const Key& key, const Impulse& impulse)
+    {
+        m_current.push_back({key, impulse});
+    }
+
+    void ContactCache::advance()
+    {
+        // contacts are mostly inserted in order already, since pairs are visited in order
+        if (!std::ranges::is_sorted(m_current, {}, &Entry::key)) {
+            std::ranges::sort(m_current, {}, &Entry::key);
+        }
+        std::swap(m_previous, m_current);
+        m_current.clear();
+    }
+
+    void ContactCache::clear()
+    {
+        m_previous.clear();
+        m_current.clear();
+    }
+
+    std::size_t ContactCache::size() const
+    {
+        return m_previous.size();
+    }
+
+    void ContactCache::save(SnapshotWriter& writer) const
+    {
+        writer.write(m_previous);
+        writer.write(m_current);
+    }
+
+    void ContactCache::restore(SnapshotReader& reader)
+    {
+        reader.read(m_previous);
+        reader.read(m_current);
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <vector>
+
+#include <math/vector.h>
+
+#include "Snapshot.h"
+
+namespace yage::physics3d
+{
+    /**
+     * Remembers the impulses that the constraint solver applied to each contact, so that the solver can start from
+     * the previous solution if the same contact persists into the next step (warm starting). Contacts are identified
+     * by the ids of the two bodies and the feature id of the contact point.
+     *
+     * Entries are kept in two sorted buffers, one for the previous and one for the current step, which are swapped at
+     * the end of each step. This way, contacts that disappeared are forgotten and no memory needs to be allocated once
+     * the number of contacts has settled.
+     */
+    class ContactCache
+    {
+    public:
+        struct Key
+        {
+            std::size_t body_a{};
+            std::size_t body_b{};
+            std::uint64_t feature_id{};
+
+            auto operator<=>(const Key&) const = default;
+        };
+
+        /**
+         * Accumulated impulses of a contact, stored as world-space vectors such that they can be projected onto the
+         * contact frame of the next step.
+         */
+        struct Impulse
+        {
+            /**
+             * Impulse magnitude along the contact normal.
+             */
+            double normal{};
+
+            /**
+             * Linear friction impulse in the contact plane.
+             */
+            math::Vec3d friction{};
+
+            /**
+             * Angular rolling friction impulse.
+             */
+            math::Vec3d rolling_friction{};
+        };
+
+        /**
+         * @return The impulses applied to a matching contact in the previous step, or zero impulses for new contacts.
+         */
+        [[nodiscard]]
+        Impulse find(const Key& key) const;
+
+        /**
+         * Records the impulses of a contact in the current step.
+         */
+        void insert(const Key& key, const Impulse& impulse);
+
+        /**
+         * Finishes the current step, such that its contacts are found in the next step. Contacts of the previous step
+         * that were not inserted again are forgotten.
+         */
+        void advance();
+
+        void clear();
+
+        [[nodiscard]]
+        std::size_t size() const;
+
+        /**
+         * Appends the state of the cached contacts to a snapshot.
+         */
+        void save(SnapshotWriter& writer) const;
+
+        /**
+         * Restores the state that was saved to a snapshot.
+         */
+        void restore(SnapshotReader& reader);
+
+    private:
+        struct Entry
+        {
+            Key key;
+            Impulse impulse;
+        };
+
+        std::vector<Entry> m_previous;
+        std::vector<Entry> m_current;
+    };
+}
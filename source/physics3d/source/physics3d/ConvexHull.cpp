@@ -0,0 +1,55 @@
+#include <cassert>
+#include <optional>
+
+#include "ConvexHull.h"
+#include "Gjk.h"
+
+namespace yage::physics3d
+{
+    ConvexHull::ConvexHull(const std::span<const math::Vec3d> points)
+        : m_vertices(points.begin(), points.end())
+    {
+        assert(!m_vertices.empty());
+
+        m_bounds = {.min = m_vertices.front(), .max = m_vertices.front()};
+        for (const math::Vec3d& vertex: m_vertices) {
+            m_bounds = geometry::merge(m_bounds, {.min = vertex, .max = vertex});
+        }
+
+        // the penetration of the origin into the hull is its distance to the surface
+        const std::optional<Penetration> penetration = physics3d::penetration(
+                colliders::Sphere{.radius = 0}, colliders::Convex{.shape = shapes::Hull{.hull = this}});
+        if (penetration.has_value()) {
+            m_inner_radius = penetration->depth;
+        }
+    }
+
+    const std::vector<math::Vec3d>& ConvexHull::vertices() const
+    {
+        return m_vertices;
+    }
+
+    std::size_t ConvexHull::support(const math::Vec3d& direction) const
+    {
+        std::size_t farthest = 0;
+        double farthest_distance = dot(m_vertices[0], direction);
+        for (std::size_t i = 1; i < m_vertices.size(); ++i) {
+            const double distance = dot(m_vertices[i], direction);
+            if (distance > farthest_distance) {
+                farthest = i;
+                farthest_distance = distance;
+            }
+        }
+        return farthest;
+    }
+
+    const geometry::AABB& ConvexHull::bounds() const
+    {
+        return m_bounds;
+    }
+
+    double ConvexHull::inner_radius() const
+    {
+        return m_inner_radius;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include <math/vector.h>
+
+#include "Algorithms.h"
+
+namespace yage::physics3d
+{
+    /**
+     * The convex hull of a point cloud in the local space of a body, such as the vertices of a render mesh. Collisions
+     * only use the support mapping of the points, so the hull's faces are never constructed. Points inside the hull
+     * may be included, although they make support queries slower.
+     *
+     * Hulls are immutable and meant to be shared by all colliders with the same shape, which refer to the hull and
+     * must not outlive it.
+     */
+    class ConvexHull
+    {
+    public:
+        /**
+         * @param points Points in the local space of the body, which must not be empty. The origin, i.e. the center of
+         * the body, should lie inside the hull.
+         */
+        explicit ConvexHull(std::span<const math::Vec3d> points);
+
+        [[nodiscard]]
+        const std::vector<math::Vec3d>& vertices() const;
+
+        /**
+         * @return The index of the vertex that lies farthest along a direction in local space.
+         */
+        [[nodiscard]]
+        std::size_t support(const math::Vec3d& direction) const;
+
+        /**
+         * @return The local-space bounds of the vertices.
+         */
+        [[nodiscard]]
+        const geometry::AABB& bounds() const;
+
+        /**
+         * @return The distance from the origin to the closest point on the surface of the hull, or zero if the origin
+         * lies outside the hull.
+         */
+        [[nodiscard]]
+        double inner_radius() const;
+
+    private:
+        std::vector<math::Vec3d> m_vertices;
+        geometry::AABB m_bounds;
+        double m_inner_radius{};
+    };
+}
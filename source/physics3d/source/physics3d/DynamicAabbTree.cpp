@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <cassert>
+
+#include "DynamicAabbTree.h"
+
+namespace yage::physics3d
+{
+    DynamicAabbTree::DynamicAabbTree(const double margin, const double displacement_factor)
+        : m_margin(margin), m_displacement_factor(displacement_factor)
+    {
+    }
+
+    std::uint32_t DynamicAabbTree::create_proxy(const geometry::AABB& aabb, const std::uint32_t user_data)
+    {
+        const std::uint32_t proxy = allocate_node();
+        m_nodes[proxy].aabb = fatten(aabb, math::Vec3d());
+        m_nodes[proxy].user_data = user_data;
+        m_nodes[proxy].height = 0;
+        insert_leaf(proxy);
+        return proxy;
+    }
+
+    void DynamicAabbTree::destroy_proxy(const std::uint32_t proxy)
+    {
+        assert(proxy < m_nodes.size() && m_nodes[proxy].is_leaf());
+        remove_leaf(proxy);
+        free_node(proxy);
+    }
+
+    bool DynamicAabbTree::move_proxy(const std::uint32_t proxy, const geometry::AABB& aabb,
+                                     const math::Vec3d& displacement)
+    {
+        assert(proxy < m_nodes.size() && m_nodes[proxy].is_leaf());
+
+        const geometry::AABB fat = fatten(aabb, displacement);
+        const geometry::AABB& current = m_nodes[proxy].aabb;
+        if (geometry::contains(current, aabb)) {
+            // the fattened box still encloses the object, but if the object slowed down after moving fast, the box may
+            // have become unnecessarily large, which would produce many false positives
+            const geometry::AABB huge{
+                    .min = fat.min - math::Vec3d(4.0 * m_margin),
+                    .max = fat.max + math::Vec3d(4.0 * m_margin),
+            };
+            if (geometry::contains(huge, current)) {
+                return false;
+            }
+        }
+
+        remove_leaf(proxy);
+        m_nodes[proxy].aabb = fat;
+        insert_leaf(proxy);
+        return true;
+    }
+
+    const geometry::AABB& DynamicAabbTree::fat_aabb(const std::uint32_t proxy) const
+    {
+        assert(proxy < m_nodes.size());
+        return m_nodes[proxy].aabb;
+    }
+
+    std::uint32_t DynamicAabbTree::user_data(const std::uint32_t proxy) const
+    {
+        assert(proxy < m_nodes.size());
+        return m_nodes[proxy].user_data;
+    }
+
+    int DynamicAabbTree::height() const
+    {
+        return m_root == null_node ? 0 : m_nodes[m_root].height;
+    }
+
+    void DynamicAabbTree::save(SnapshotWriter& writer) const
+    {
+        writer.write(m_root);
+        writer.write(m_free_list);
+        writer.write(m_nodes);
+    }
+
+    void DynamicAabbTree::restore(SnapshotReader& reader)
+    {
+        reader.read(m_root);
+        reader.read(m_free_list);
+        reader.read(m_nodes);
+    }
+
+    std::uint32_t DynamicAabbTree::allocate_node()
+    {
+        if (m_free_list == null_node) {
+            m_nodes.emplace_back();
+            return static_cast<std::uint32_t>(m_nodes.size() - 1);
+        }
+
+        const std::uint32_t node = m_free_list;
+        m_free_list = m_nodes[node].parent;
+        m_nodes[node] = Node{};
+        return node;
+    }
+
+    void DynamicAabbTree::free_node(const std::uint32_t node)
+    {
+        m_nodes[node].parent = m_free_list;
+        m_nodes[node].height = -1;
+        m_free_list = node;
+    }
+
+    void DynamicAabbTree::insert_leaf(const std::uint32_t leaf)
+    {
+        if (m_root == null_node) {
+            m_root = leaf;
+            m_nodes[leaf].parent = null_node;
+            return;
+        }
+
+        // descend the tree along the cheapest path according to the surface area heuristic
+        const geometry::AABB leaf_aabb = m_nodes[leaf].aabb;
+        std::uint32_t index = m_root;
+        while (!m_nodes[index].is_leaf()) {
+            const Node& node = m_nodes[index];
+
+            const double area = geometry::surface_area(node.aabb);
+            const double combined_area = geometry::surface_area(geometry::merge(node.aabb, leaf_aabb));
+
+            // cost of creating a new parent for this node and the new leaf
+            const double cost = 2.0 * combined_area;
+            // minimum cost of pushing the leaf further down the tree
+            const double inheritance_cost = 2.0 * (combined_area - area);
+
+            auto descend_cost = [&](const std::uint32_t child) {
+                const Node& child_node = m_nodes[child];
+                const double merged_area = geometry::surface_area(geometry::merge(child_node.aabb, leaf_aabb));
+                if (child_node.is_leaf()) {
+                    return merged_area + inheritance_cost;
+                }
+                return merged_area - geometry::surface_area(child_node.aabb) + inheritance_cost;
+            };
+            const double cost_1 = descend_cost(node.child_1);
+            const double cost_2 = descend_cost(node.child_2);
+
+            if (cost < cost_1 && cost < cost_2) {
+                break;
+            }
+            index = cost_1 < cost_2 ? node.child_1 : node.child_2;
+        }
+        const std::uint32_t sibling = index;
+
+        // create a new parent for the sibling and the leaf
+        const std::uint32_t old_parent = m_nodes[sibling].parent;
+        const std::uint32_t new_parent = allocate_node();
+        m_nodes[new_parent].parent = old_parent;
+        m_nodes[new_parent].aabb = geometry::merge(leaf_aabb, m_nodes[sibling].aabb);
+        m_nodes[new_parent].height = m_nodes[sibling].height + 1;
+        m_nodes[new_parent].child_1 = sibling;
+        m_nodes[new_parent].child_2 = leaf;
+        m_nodes[sibling].parent = new_parent;
+        m_nodes[leaf].parent = new_parent;
+
+        if (old_parent == null_node) {
+            m_root = new_parent;
+        } else if (m_nodes[old_parent].child_1 == sibling) {
+            m_nodes[old_parent].child_1 = new_parent;
+        } else {
+            m_nodes[old_parent].child_2 = new_parent;
+        }
+
+        refit_ancestors(m_nodes[leaf].parent);
+    }
+
+    void DynamicAabbTree::remove_leaf(const std::uint32_t leaf)
+    {
+        if (leaf == m_root) {
+            m_root = null_node;
+            return;
+        }
+
+        const std::uint32_t parent = m_nodes[leaf].parent;
+        const std::uint32_t grand_parent = m_nodes[parent].parent;
+        const std::uint32_t sibling = m_nodes[parent].child_1 == leaf
+                                      ? m_nodes[parent].child_2
+                                      : m_nodes[parent].child_1;
+
+        // the sibling takes the place of the parent
+        if (grand_parent == null_node) {
+            m_root = sibling;
+            m_nodes[sibling].parent = null_node;
+            free_node(parent);
+            return;
+        }
+
+        if (m_nodes[grand_parent].child_1 == parent) {
+            m_nodes[grand_parent].child_1 = sibling;
+        } else {
+            m_nodes[grand_parent].child_2 = sibling;
+        }
+        m_nodes[sibling].parent = grand_parent;
+        free_node(parent);
+
+        refit_ancestors(grand_parent);
+    }
+
+    void DynamicAabbTree::refit_ancestors(std::uint32_t node)
+    {
+        while (node != null_node) {
+            node = balance(node);
+
+            Node& current = m_nodes[node];
+            const Node& child_1 = m_nodes[current.child_1];
+            const Node& child_2 = m_nodes[current.child_2];
+            current.height = 1 + std::max(child_1.height, child_2.height);
+            current.aabb = geometry::merge(child_1.aabb, child_2.aabb);
+
+            node = current.parent;
+        }
+    }
+
+    std::uint32_t DynamicAabbTree::balance(const std::uint32_t i_a)
+    {
+        Node& a = m_nodes[i_a];
+        if (a.is_leaf() || a.height < 2) {
+            return i_a;
+        }
+
+        const std::uint32_t i_b = a.child_1;
+        const std::uint32_t i_c = a.child_2;
+        Node& b = m_nodes[i_b];
+        Node& c = m_nodes[i_c];
+
+        /*       a              c
+         *      / \            / \
+         *     b   c    ->    a   f|g
+         *        / \        / \
+         *       f   g      b   g|f
+         */
+        auto rotate_up = [this, i_a, &a](const std::uint32_t i_up, Node& up, const std::uint32_t i_other,
+                                         const bool up_is_child_2) {
+            const std::uint32_t i_f = up.child_1;
+            const std::uint32_t i_g = up.child_2;
+            Node& f = m_nodes[i_f];
+            Node& g = m_nodes[i_g];
+            const Node& other = m_nodes[i_other];
+
+            // swap a and up
+            up.child_1 = i_a;
+            up.parent = a.parent;
+            a.parent = i_up;
+
+            if (up.parent == null_node) {
+                m_root = i_up;
+            } else if (m_nodes[up.parent].child_1 == i_a) {
+                m_nodes[up.parent].child_1 = i_up;
+            } else {
+                m_nodes[up.parent].child_2 = i_up;
+            }
+
+            // the higher grandchild stays with up, the lower one moves to a
+            const bool keep_f = f.height > g.height;
+            const std::uint32_t i_keep = keep_f ? i_f : i_g;
+            const std::uint32_t i_move = keep_f ? i_g : i_f;
+            Node& keep = m_nodes[i_keep];
+            Node& move = m_nodes[i_move];
+
+            up.child_2 = i_keep;
+            if (up_is_child_2) {
+                a.child_2 = i_move;
+            } else {
+                a.child_1 = i_move;
+            }
+            move.parent = i_a;
+
+            a.aabb = geometry::merge(other.aabb, move.aabb);
+            up.aabb = geometry::merge(a.aabb, keep.aabb);
+            a.height = 1 + std::max(other.height, move.height);
+            up.height = 1 + std::max(a.height, keep.height);
+        };
+
+        const std::int32_t imbalance = c.height - b.height;
+        if (imbalance > 1) {
+            rotate_up(i_c, c, i_b, true);
+            return i_c;
+        }
+        if (imbalance < -1) {
+            rotate_up(i_b, b, i_c, false);
+            return i_b;
+        }
+        return i_a;
+    }
+
+    geometry::AABB DynamicAabbTree::fatten(const geometry::AABB& aabb, const math::Vec3d& displacement) const
+    {
+        geometry::AABB fat{
+                .min = aabb.min - math::Vec3d(m_margin),
+                .max = aabb.max + math::Vec3d(m_margin),
+        };
+
+        // extend the box only in the direction of movement
+        const math::Vec3d d = m_displacement_factor * displacement;
+        for (int i = 0; i < 3; ++i) {
+            if (d(i) < 0) {
+                fat.min(i) += d(i);
+            } else {
+                fat.max(i) += d(i);
+            }
+        }
+        return fat;
+    }
+}
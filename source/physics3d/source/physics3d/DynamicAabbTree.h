@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <math/vector.h>
+
+#include "Algorithms.h"
+#include "Snapshot.h"
+
+namespace yage::physics3d
+{
+    /**
+     * A bounding volume hierarchy of axis-aligned boxes that supports incremental insertion, removal, and movement of
+     * leaves. Leaves store fattened boxes, such that small movements of the enclosed objects don't require an update of
+     * the tree. The tree is kept balanced with AVL rotations.
+     */
+    class DynamicAabbTree
+    {
+    public:
+        static constexpr std::uint32_t null_node = std::numeric_limits<std::uint32_t>::max();
+
+        /**
+         * @param margin Distance in meters by which leaf boxes are enlarged in each direction.
+         * @param displacement_factor Factor by which leaf boxes are enlarged in the direction of the predicted
+         * displacement.
+         */
+        explicit DynamicAabbTree(double margin = 0.1, double displacement_factor = 2.0);
+
+        /**
+         * Inserts a new leaf into the tree.
+         * @param aabb The tight bounds of the object.
+         * @param user_data Arbitrary data to associate with the leaf.
+         * @return The id of the new leaf.
+         */
+        std::uint32_t create_proxy(const geometry::AABB& aabb, std::uint32_t user_data);
+
+        /**
+         * Removes a leaf from the tree. The id may be reused by subsequently created leaves.
+         */
+        void destroy_proxy(std::uint32_t proxy);
+
+        /**
+         * Updates the bounds of a leaf. The tree is only modified if the new bounds are no longer contained in the
+         * leaf's fattened bounds.
+         * @param proxy The id of the leaf.
+         * @param aabb The new tight bounds of the object.
+         * @param displacement The predicted displacement of the object until the next update.
+         * @return Whether the leaf was re-inserted into the tree.
+         */
+        bool move_proxy(std::uint32_t proxy, const geometry::AABB& aabb, const math::Vec3d& displacement);
+
+        /**
+         * @return The fattened bounds of a leaf.
+         */
+        [[nodiscard]]
+        const geometry::AABB& fat_aabb(std::uint32_t proxy) const;
+
+        [[nodiscard]]
+        std::uint32_t user_data(std::uint32_t proxy) const;
+
+        /**
+         * @return The height of the tree, where a single leaf has height zero.
+         */
+        [[nodiscard]]
+        int height() const;
+
+        /**
+         * Finds all leaves whose fattened bounds overlap the given box.
+         * @param aabb The box to test against.
+         * @param callback Invoked with the id of each overlapping leaf. Returning false terminates the query.
+         */
+        template<typename Callback>
+        void query(const geometry::AABB& aabb, Callback&& callback) const
+        {
+            NodeStack stack;
+            stack.push(m_root);
+            while (!stack.empty()) {
+                const std::uint32_t index = stack.pop();
+                if (index == null_node) {
+                    continue;
+                }
+
+                const Node& node = m_nodes[index];
+                if (!geometry::overlaps(node.aabb, aabb)) {
+                    continue;
+                }
+
+                if (node.is_leaf()) {
+                    if (!callback(index)) {
+                        return;
+                    }
+                } else {
+                    stack.push(node.child_1);
+                    stack.push(node.child_2);
+                }
+            }
+        }
+
+        /**
+         * Reports all leaves whose fattened bounds, grown by a radius, are hit by a line segment, which allows to cast
+         * rays or spheres through the tree.
+         * @param start The start of the segment.
+         * @param displacement The vector from the start to the end of the segment.
+         * @param radius The radius of the swept sphere, or zero for rays.
+         * @param max_fraction The fraction of the segment that is searched.
+         * @param callback Invoked with the id of each hit leaf. Returns the fraction of the segment that is searched
+         * further, such that a hit can shorten the segment.
+         */
+        template<typename Callback>
+        void sweep(const math::Vec3d& start, const math::Vec3d& displacement, const double radius,
+                   double max_fraction, Callback&& callback) const
+        {
+            NodeStack stack;
+            stack.push(m_root);
+            while (!stack.empty() && max_fraction > 0) {
+                const std::uint32_t index = stack.pop();
+                if (index == null_node) {
+                    continue;
+                }
+
+                const Node& node = m_nodes[index];
+                const geometry::AABB bounds{
+                        .min = node.aabb.min - math::Vec3d(radius),
+                        .max = node.aabb.max + math::Vec3d(radius),
+                };
+                if (!geometry::intersects(bounds, start, max_fraction * displacement)) {
+                    continue;
+                }
+
+                if (node.is_leaf()) {
+                    max_fraction = std::min(max_fraction, callback(index));
+                } else {
+                    stack.push(node.child_1);
+                    stack.push(node.child_2);
+                }
+            }
+        }
+
+        /**
+         * Appends the state of the tree to a snapshot.
+         */
+        void save(SnapshotWriter& writer) const;
+
+        /**
+         * Restores the state that was saved to a snapshot.
+         */
+        void restore(SnapshotReader& reader);
+
+    private:
+        struct Node
+        {
+            geometry::AABB aabb;
+
+            /**
+             * Parent node for nodes in the tree, next free node for nodes in the free list.
+             */
+            std::uint32_t parent = null_node;
+            std::uint32_t child_1 = null_node;
+            std::uint32_t child_2 = null_node;
+
+            /**
+             * Leaves have height zero, free nodes have height -1.
+             */
+            std::int32_t height = -1;
+
+            std::uint32_t user_data{};
+
+            [[nodiscard]]
+            bool is_leaf() const
+            {
+                return child_1 == null_node;
+            }
+        };
+
+        /**
+         * Traversal stack that only allocates for unusually deep trees.
+         */
+        class NodeStack
+        {
+        public:
+            void push(const std::uint32_t node)
+            {
+                if (m_size < m_inline.size()) {
+                    m_inline[m_size] = node;
+                } else {
+                    m_overflow.push_back(node);
+                }
+                ++m_size;
+            }
+
+            std::uint32_t pop()
+            {
+                --m_size;
+                if (m_size < m_inline.size()) {
+                    return m_inline[m_size];
+                }
+                const std::uint32_t node = m_overflow.back();
+                m_overflow.pop_back();
+                return node;
+            }
+
+            [[nodiscard]]
+            bool empty() const
+            {
+                return m_size == 0;
+            }
+
+        private:
+            std::array<std::uint32_t, 64> m_inline{};
+            std::vector<std::uint32_t> m_overflow;
+            std::size_t m_size = 0;
+        };
+
+        double m_margin;
+        double m_displacement_factor;
+
+        std::uint32_t m_root = null_node;
+        std::uint32_t m_free_list = null_node;
+        std::vector<Node> m_nodes;
+
+        std::uint32_t allocate_node();
+
+        void free_node(std::uint32_t node);
+
+        void insert_leaf(std::uint32_t leaf);
+
+        void remove_leaf(std::uint32_t leaf);
+
+        /**
+         * Performs a left or right rotation if the subtree at the given node is imbalanced.
+         * @return The new root of the subtree.
+         */
+        std::uint32_t balance(std::uint32_t node);
+
+        /**
+         * Walks from the given node up to the root, re-balancing and refitting the bounds of each ancestor.
+         */
+        void refit_ancestors(std::uint32_t node);
+
+        [[nodiscard]]
+        geometry::AABB fatten(const geometry::AABB& aabb, const math::Vec3d& displacement) const;
+    };
+}
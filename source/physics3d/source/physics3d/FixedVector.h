@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+
+namespace yage::physics3d
+{
+    /**
+     * A vector with inline storage for a fixed maximum number of elements, which never allocates heap memory. Used for
+     * small intermediate results of collision detection whose size is bounded by the geometry.
+     */
+    template<typename T, std::size_t Capacity>
+    class FixedVector
+    {
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        void push_back(const T& value)
+        {
+            assert(m_size < Capacity);
+            m_elements[m_size++] = value;
+        }
+
+        template<typename... Args>
+        T& emplace_back(Args&&... args)
+        {
+            assert(m_size < Capacity);
+            m_elements[m_size] = T(std::forward<Args>(args)...);
+            return m_elements[m_size++];
+        }
+
+        void pop_back()
+        {
+            assert(m_size > 0);
+            --m_size;
+        }
+
+        void clear()
+        {
+            m_size = 0;
+        }
+
+        [[nodiscard]]
+        std::size_t size() const
+        {
+            return m_size;
+        }
+
+        [[nodiscard]]
+        static constexpr std::size_t capacity()
+        {
+            return Capacity;
+        }
+
+        [[nodiscard]]
+        bool empty() const
+        {
+            return m_size == 0;
+        }
+
+        T& operator[](const std::size_t i)
+        {
+            assert(i < m_size);
+            return m_elements[i];
+        }
+
+        const T& operator[](const std::size_t i) const
+        {
+            assert(i < m_size);
+            return m_elements[i];
+        }
+
+        T* data()
+        {
+            return m_elements.data();
+        }
+
+        const T* data() const
+        {
+            return m_elements.data();
+        }
+
+        iterator begin()
+        {
+            return m_elements.data();
+        }
+
+        iterator end()
+        {
+            return m_elements.data() + m_size;
+        }
+
+        const_iterator begin() const
+        {
+            return m_elements.data();
+        }
+
+        const_iterator end() const
+        {
+            return m_elements.data() + m_size;
+        }
+
+    private:
+        std::array<T, Capacity> m_elements{};
+        std::size_t m_size = 0;
+    };
+}
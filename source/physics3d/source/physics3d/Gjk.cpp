@@ -0,0 +1,1044 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+#include <utils/utils.h>
+
+#include "Gjk.h"
+#include "Algorithms.h"
+
+namespace yage::physics3d
+{
+    namespace
+    {
+        /**
+         * Surface points within this distance of the farthest point along a direction are part of the contact feature,
+         * such that faces that are slightly tilted against the contact normal still yield multiple contact points.
+         */
+        constexpr double feature_tolerance = 0.005;
+
+        /**
+         * GJK stops once an iteration reduces the squared distance by less than this fraction.
+         */
+        constexpr double gjk_relative_tolerance = 1e-10;
+
+        /**
+         * Shapes whose cores are closer than this are considered intersecting.
+         */
+        constexpr double gjk_intersection_tolerance = 1e-10;
+
+        constexpr int gjk_max_iterations = 64;
+
+        /**
+         * EPA stops once the polytope's closest face lies within this distance of the boundary of the Minkowski
+         * difference.
+         */
+        constexpr double epa_tolerance = 1e-6;
+
+        constexpr std::size_t epa_max_vertices = 64;
+
+        /**
+         * Contact points from clipping two contact features, which consist of at most eight points each.
+         */
+        using ContactCandidates = FixedVector<ContactPoint, 16>;
+
+        /**
+         * A vertex of the Minkowski difference A - B.
+         */
+        struct SimplexVertex
+        {
+            math::Vec3d w;
+            math::Vec3d a;
+            math::Vec3d b;
+        };
+
+        struct Simplex
+        {
+            std::array<SimplexVertex, 4> vertices;
+            /**
+             * Barycentric coordinates of the point of the simplex that lies closest to the origin.
+             */
+            std::array<double, 4> weights{};
+            std::size_t size{};
+        };
+
+        /**
+         * The closest point of a sub-simplex to the origin, given by the indices of its vertices and their weights.
+         */
+        struct Closest
+        {
+            std::array<std::uint8_t, 4> indices{};
+            std::array<double, 4> weights{};
+            std::size_t size{};
+            math::Vec3d point;
+        };
+
+        SimplexVertex support(const SupportMapping& a, const SupportMapping& b, const math::Vec3d& direction)
+        {
+            const math::Vec3d point_a = a.support(direction);
+            const math::Vec3d point_b = b.support(-direction);
+            return {.w = point_a - point_b, .a = point_a, .b = point_b};
+        }
+
+        /**
+         * @return The support vertex of the Minkowski difference of the shapes including their margins.
+         */
+        SimplexVertex inflated_support(const SupportMapping& a, const SupportMapping& b, const math::Vec3d& direction)
+        {
+            const math::Vec3d n = normalize(direction);
+            const math::Vec3d point_a = a.support(direction) + a.margin() * n;
+            const math::Vec3d point_b = b.support(-direction) - b.margin() * n;
+            return {.w = point_a - point_b, .a = point_a, .b = point_b};
+        }
+
+        Closest closest_on_vertex(const Simplex& simplex, const std::uint8_t i)
+        {
+            return {.indices = {i}, .weights = {1}, .size = 1, .point = simplex.vertices[i].w};
+        }
+
+        Closest closest_on_segment(const Simplex& simplex, const std::uint8_t i, const std::uint8_t j)
+        {
+            const math::Vec3d& a = simplex.vertices[i].w;
+            const math::Vec3d ab = simplex.vertices[j].w - a;
+            const double length = length_sqr(ab);
+            const double t = length > 0 ? -dot(a, ab) / length : 0;
+            if (t <= 0) {
+                return closest_on_vertex(simplex, i);
+            }
+            if (t >= 1) {
+                return closest_on_vertex(simplex, j);
+            }
+            return {.indices = {i, j}, .weights = {1 - t, t}, .size = 2, .point = a + t * ab};
+        }
+
+        /**
+         * Finds the closest point of a triangle to the origin by its Voronoi regions, see Ericson, Real-Time Collision
+         * Detection, section 5.1.5.
+         */
+        Closest closest_on_triangle(const Simplex& simplex, const std::uint8_t i, const std::uint8_t j,
+                                    const std::uint8_t k)
+        {
+            const math::Vec3d& a = simplex.vertices[i].w;
+            const math::Vec3d& b = simplex.vertices[j].w;
+            const math::Vec3d& c = simplex.vertices[k].w;
+            const math::Vec3d ab = b - a;
+            const math::Vec3d ac = c - a;
+
+            if (length_sqr(cross(ab, ac)) <= 1e-24 * length_sqr(ab) * length_sqr(ac)) {
+                // degenerate triangles are as close as their closest edge
+                Closest closest = closest_on_segment(simplex, i, j);
+                for (const Closest& edge: {closest_on_segment(simplex, i, k), closest_on_segment(simplex, j, k)}) {
+                    if (length_sqr(edge.point) < length_sqr(closest.point)) {
+                        closest = edge;
+                    }
+                }
+                return closest;
+            }
+
+            const double d1 = -dot(ab, a);
+            const double d2 = -dot(ac, a);
+            if (d1 <= 0 && d2 <= 0) {
+                return closest_on_vertex(simplex, i);
+            }
+
+            const double d3 = -dot(ab, b);
+            const double d4 = -dot(ac, b);
+            if (d3 >= 0 && d4 <= d3) {
+                return closest_on_vertex(simplex, j);
+            }
+
+            const double vc = d1 * d4 - d3 * d2;
+            if (vc <= 0 && d1 >= 0 && d3 <= 0) {
+                const double t = d1 / (d1 - d3);
+                return {.indices = {i, j}, .weights = {1 - t, t}, .size = 2, .point = a + t * ab};
+            }
+
+            const double d5 = -dot(ab, c);
+            const double d6 = -dot(ac, c);
+            if (d6 >= 0 && d5 <= d6) {
+                return closest_on_vertex(simplex, k);
+            }
+
+            const double vb = d5 * d2 - d1 * d6;
+            if (vb <= 0 && d2 >= 0 && d6 <= 0) {
+                const double t = d2 / (d2 - d6);
+                return {.indices = {i, k}, .weights = {1 - t, t}, .size = 2, .point = a + t * ac};
+            }
+
+            const double va = d3 * d6 - d5 * d4;
+            if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0) {
+                const double t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+                return {.indices = {j, k}, .weights = {1 - t, t}, .size = 2, .point = b + t * (c - b)};
+            }
+
+            const double denominator = 1 / (va + vb + vc);
+            const double v = vb * denominator;
+            const double w = vc * denominator;
+            return {.indices = {i, j, k}, .weights = {1 - v - w, v, w}, .size = 3, .point = a + v * ab + w * ac};
+        }
+
+        /**
+         * Finds the closest point of a tetrahedron to the origin, which is the closest point of the faces that the
+         * origin lies in front of. The full tetrahedron is returned if it contains the origin.
+         */
+        Closest closest_on_tetrahedron(const Simplex& simplex)
+        {
+            // each face along with the opposite vertex
+            constexpr std::array<std::array<std::uint8_t, 4>, 4> faces{{{0, 1, 2, 3}, {0, 2, 3, 1}, {0, 3, 1, 2},
+                                                                         {1, 3, 2, 0}}};
+            Closest closest{.indices = {0, 1, 2, 3}, .size = 4, .point = math::Vec3d()};
+            double closest_distance = std::numeric_limits<double>::infinity();
+            for (const auto& [i, j, k, opposite]: faces) {
+                const math::Vec3d& a = simplex.vertices[i].w;
+                const math::Vec3d n = cross(simplex.vertices[j].w - a, simplex.vertices[k].w - a);
+                const double origin_side = -dot(a, n);
+                const double opposite_side = dot(simplex.vertices[opposite].w - a, n);
+                if (origin_side * opposite_side > 0) {
+                    continue;
+                }
+
+                const Closest face = closest_on_triangle(simplex, i, j, k);
+                if (length_sqr(face.point) < closest_distance) {
+                    closest = face;
+                    closest_distance = length_sqr(face.point);
+                }
+            }
+            return closest;
+        }
+
+        Closest closest_on_simplex(const Simplex& simplex)
+        {
+            switch (simplex.size) {
+                case 1:
+                    return closest_on_vertex(simplex, 0);
+                case 2:
+                    return closest_on_segment(simplex, 0, 1);
+                case 3:
+                    return closest_on_triangle(simplex, 0, 1, 2);
+                default:
+                    return closest_on_tetrahedron(simplex);
+            }
+        }
+
+        /**
+         * Reduces a simplex to the vertices that span its closest point to the origin.
+         */
+        void reduce(Simplex& simplex, const Closest& closest)
+        {
+            Simplex reduced;
+            for (std::size_t i = 0; i < closest.size; ++i) {
+                reduced.vertices[i] = simplex.vertices[closest.indices[i]];
+                reduced.weights[i] = closest.weights[i];
+            }
+            reduced.size = closest.size;
+            simplex = reduced;
+        }
+
+        /**
+         * @return The closest points of the shapes, interpolated from the simplex with its weights.
+         */
+        std::tuple<math::Vec3d, math::Vec3d> closest_points(const Simplex& simplex)
+        {
+            math::Vec3d point_a;
+            math::Vec3d point_b;
+            for (std::size_t i = 0; i < simplex.size; ++i) {
+                point_a += simplex.weights[i] * simplex.vertices[i].a;
+                point_b += simplex.weights[i] * simplex.vertices[i].b;
+            }
+            return {point_a, point_b};
+        }
+
+        struct GjkResult
+        {
+            Simplex simplex;
+
+            /**
+             * The point of the Minkowski difference of the cores that lies closest to the origin.
+             */
+            math::Vec3d closest;
+
+            bool intersecting{};
+        };
+
+        /**
+         * Runs GJK on the cores of two shapes, see van den Bergen, Collision Detection in Interactive 3D Environments.
+         */
+        GjkResult gjk(const SupportMapping& a, const SupportMapping& b, const GjkCache* cache)
+        {
+            math::Vec3d axis = cache != nullptr ? cache->axis : math::Vec3d();
+            if (length_sqr(axis) == 0) {
+                axis = a.center() - b.center();
+            }
+            if (length_sqr(axis) == 0) {
+                axis = math::Vec3d(1, 0, 0);
+            }
+
+            GjkResult result;
+            Simplex& simplex = result.simplex;
+            simplex.vertices[0] = support(a, b, -axis);
+            simplex.weights[0] = 1;
+            simplex.size = 1;
+            math::Vec3d& v = result.closest;
+            v = simplex.vertices[0].w;
+
+            for (int iteration = 0; iteration < gjk_max_iterations; ++iteration) {
+                const double v_sqr = length_sqr(v);
+                if (v_sqr <= gjk_intersection_tolerance * gjk_intersection_tolerance) {
+                    result.intersecting = true;
+                    break;
+                }
+
+                const SimplexVertex w = support(a, b, -v);
+                // stop once the support point doesn't get closer to the origin than the current simplex
+                if (v_sqr - dot(v, w.w) <= gjk_relative_tolerance * v_sqr) {
+                    break;
+                }
+                if (std::any_of(simplex.vertices.begin(), simplex.vertices.begin() + simplex.size,
+                                [&w](const SimplexVertex& vertex) { return vertex.w == w.w; })) {
+                    break;
+                }
+
+                simplex.vertices[simplex.size++] = w;
+                const Closest closest = closest_on_simplex(simplex);
+                reduce(simplex, closest);
+                if (closest.size == 4) {
+                    result.intersecting = true;
+                    break;
+                }
+
+                // rounding errors can prevent progress close to the solution
+                const bool progress = length_sqr(closest.point) < v_sqr;
+                v = closest.point;
+                if (!progress) {
+                    break;
+                }
+            }
+            return result;
+        }
+
+        struct EpaFace
+        {
+            std::array<std::uint8_t, 3> vertices{};
+            math::Vec3d normal;
+            double distance{};
+        };
+
+        /**
+         * Completes a simplex that contains the origin to a tetrahedron, using support points of the inflated shapes
+         * that lie as far as possible from the simplex.
+         */
+        void complete_tetrahedron(const SupportMapping& a, const SupportMapping& b, Simplex& simplex)
+        {
+            const std::array<math::Vec3d, 3> axes{math::Vec3d(1, 0, 0), math::Vec3d(0, 1, 0), math::Vec3d(0, 0, 1)};
+            while (simplex.size < 4) {
+                const math::Vec3d& origin = simplex.vertices[0].w;
+                std::array<math::Vec3d, 6> directions;
+                if (simplex.size == 1) {
+                    directions = {axes[0], -axes[0], axes[1], -axes[1], axes[2], -axes[2]};
+                } else if (simplex.size == 2) {
+                    const math::Vec3d edge = simplex.vertices[1].w - origin;
+                    const math::Vec3d& axis = *std::ranges::min_element(axes, {}, [&edge](const math::Vec3d& axis) {
+                        return std::abs(dot(axis, edge));
+                    });
+                    const math::Vec3d u = cross(edge, axis);
+                    const math::Vec3d v = cross(edge, u);
+                    directions = {u, -u, v, -v, u + v, -u - v};
+                } else {
+                    const math::Vec3d n = cross(simplex.vertices[1].w - origin, simplex.vertices[2].w - origin);
+                    directions = {n, -n, n, -n, n, -n};
+                }
+
+                // pick the support point that spans the largest simplex
+                SimplexVertex best;
+                double best_extent = -1;
+                for (const math::Vec3d& direction: directions) {
+                    if (length_sqr(direction) == 0) {
+                        continue;
+                    }
+                    const SimplexVertex w = inflated_support(a, b, direction);
+                    const math::Vec3d offset = w.w - origin;
+                    double extent = length_sqr(offset);
+                    if (simplex.size == 2) {
+                        extent = length_sqr(cross(simplex.vertices[1].w - origin, offset));
+                    } else if (simplex.size == 3) {
+                        extent = std::abs(dot(cross(simplex.vertices[1].w - origin,
+                                                    simplex.vertices[2].w - origin), offset));
+                    }
+                    if (extent > best_extent) {
+                        best = w;
+                        best_extent = extent;
+                    }
+                }
+                if (best_extent <= 0) {
+                    // the Minkowski difference is flat
+                    return;
+                }
+                simplex.vertices[simplex.size++] = best;
+            }
+        }
+
+        /**
+         * Expands a simplex that contains the origin within the Minkowski difference of the inflated shapes until its
+         * closest face to the origin lies on the boundary of the difference, see van den Bergen, Proximity Queries and
+         * Penetration Depth Computation on 3D Game Objects.
+         */
+        Penetration epa(const SupportMapping& a, const SupportMapping& b, Simplex simplex)
+        {
+            complete_tetrahedron(a, b, simplex);
+            if (simplex.size < 4) {
+                // flat shapes only touch
+                const auto [point_a, point_b] = closest_points(simplex);
+                const math::Vec3d offset = b.center() - a.center();
+                return Penetration{
+                        .normal = length_sqr(offset) > 0 ? normalize(offset) : math::Vec3d(0, 1, 0),
+                        .point_a = point_a,
+                        .point_b = point_b,
+                };
+            }
+
+            FixedVector<SimplexVertex, epa_max_vertices> vertices;
+            for (const SimplexVertex& vertex: simplex.vertices) {
+                vertices.push_back(vertex);
+            }
+            // faces are oriented away from a point within the polytope, which stays inside as the polytope grows
+            const math::Vec3d inside = 0.25 * (vertices[0].w + vertices[1].w + vertices[2].w + vertices[3].w);
+
+            // a closed polytope with n vertices has 2n - 4 faces
+            FixedVector<EpaFace, 2 * epa_max_vertices> faces;
+            auto add_face = [&vertices, &faces, &inside](std::uint8_t i, std::uint8_t j, std::uint8_t k) {
+                const math::Vec3d& p = vertices[i].w;
+                math::Vec3d n = cross(vertices[j].w - p, vertices[k].w - p);
+                const double n_length = length(n);
+                if (n_length <= 1e-12) {
+                    // degenerate faces are never closest and never visible
+                    faces.push_back({
+                            .vertices = {i, j, k},
+                            .normal = math::Vec3d(),
+                            .distance = std::numeric_limits<double>::infinity(),
+                    });
+                    return;
+                }
+                n = n / n_length;
+                if (dot(n, p - inside) < 0) {
+                    n = -n;
+                    std::swap(j, k);
+                }
+                faces.push_back({.vertices = {i, j, k}, .normal = n, .distance = dot(n, p)});
+            };
+            add_face(0, 1, 2);
+            add_face(0, 3, 1);
+            add_face(0, 2, 3);
+            add_face(1, 3, 2);
+
+            std::size_t closest = 0;
+            while (true) {
+                closest = 0;
+                for (std::size_t i = 1; i < faces.size(); ++i) {
+                    if (faces[i].distance < faces[closest].distance) {
+                        closest = i;
+                    }
+                }
+                const EpaFace& face = faces[closest];
+                if (std::isinf(face.distance) || vertices.size() == vertices.capacity()) {
+                    break;
+                }
+
+                const SimplexVertex w = inflated_support(a, b, face.normal);
+                if (dot(w.w, face.normal) - face.distance <= epa_tolerance) {
+                    break;
+                }
+                // collect the faces that the new vertex sees and the edges of the hole they leave
+                FixedVector<std::uint8_t, 2 * epa_max_vertices> visible;
+                // each visible face adds at most three edges
+                FixedVector<std::pair<std::uint8_t, std::uint8_t>, 3 * 2 * epa_max_vertices> horizon;
+                for (std::size_t i = faces.size(); i-- > 0;) {
+                    const EpaFace& candidate = faces[i];
+                    if (std::isinf(candidate.distance) ||
+                        dot(candidate.normal, w.w - vertices[candidate.vertices[0]].w) <= 0) {
+                        continue;
+                    }
+                    visible.push_back(static_cast<std::uint8_t>(i));
+                    for (std::size_t e = 0; e < 3; ++e) {
+                        const std::uint8_t from = candidate.vertices[e];
+                        const std::uint8_t to = candidate.vertices[(e + 1) % 3];
+                        // edges between two visible faces are interior to the hole
+                        auto* reverse = std::find(horizon.begin(), horizon.end(), std::pair(to, from));
+                        if (reverse != horizon.end()) {
+                            *reverse = horizon[horizon.size() - 1];
+                            horizon.pop_back();
+                        } else {
+                            horizon.push_back({from, to});
+                        }
+                    }
+                }
+                // degenerate faces are kept and rounding can lengthen the horizon, so the polytope can have more faces
+                // than a closed polytope with as many vertices
+                if (faces.size() - visible.size() + horizon.size() > faces.capacity()) {
+                    break;
+                }
+
+                const auto index = static_cast<std::uint8_t>(vertices.size());
+                vertices.push_back(w);
+                // the visible faces are in descending order, so swapping in the last face never moves a visible one
+                for (const std::uint8_t i: visible) {
+                    faces[i] = faces[faces.size() - 1];
+                    faces.pop_back();
+                }
+                for (const auto& [from, to]: horizon) {
+                    add_face(from, to, index);
+                }
+            }
+
+            // interpolate the closest points from the projection of the origin onto the closest face
+            const EpaFace& face = faces[closest];
+            Simplex triangle;
+            for (std::size_t i = 0; i < 3; ++i) {
+                triangle.vertices[i] = vertices[face.vertices[i]];
+                triangle.vertices[i].w -= face.distance * face.normal;
+            }
+            triangle.size = 3;
+            reduce(triangle, closest_on_triangle(triangle, 0, 1, 2));
+            const auto [point_a, point_b] = closest_points(triangle);
+
+            return Penetration{
+                    .normal = face.normal,
+                    .point_a = point_a,
+                    .point_b = point_b,
+                    .depth = std::max(face.distance, 0.0),
+            };
+        }
+
+        std::tuple<math::Vec3d, math::Vec3d> orthonormal_basis(const math::Vec3d& n)
+        {
+            const math::Vec3d t = std::abs(n.x()) > 0.57
+                                  ? normalize(math::Vec3d(n.y(), -n.x(), 0))
+                                  : normalize(math::Vec3d(0, n.z(), -n.y()));
+            return {t, cross(n, t)};
+        }
+
+        /**
+         * Orders the points of a feature along their convex hull in the plane orthogonal to the direction of the
+         * feature, dropping interior points. Starts with the point of the smallest id, such that the same feature
+         * yields the same polygon in each frame.
+         */
+        template<std::size_t Capacity>
+        Feature make_polygon(FixedVector<FeaturePoint, Capacity>& points, const math::Vec3d& direction)
+        {
+            Feature feature;
+            if (points.size() <= 2) {
+                for (const FeaturePoint& point: points) {
+                    feature.push_back(point);
+                }
+                return feature;
+            }
+
+            // Andrew's monotone chain in the plane of the feature
+            const auto [t1, t2] = orthonormal_basis(direction);
+            auto planar = [&t1, &t2](const FeaturePoint& point) {
+                return std::pair(dot(point.point, t1), dot(point.point, t2));
+            };
+            std::sort(points.begin(), points.end(), [&planar](const FeaturePoint& lhs, const FeaturePoint& rhs) {
+                return planar(lhs) < planar(rhs);
+            });
+            auto turn = [&planar](const FeaturePoint& o, const FeaturePoint& a, const FeaturePoint& b) {
+                const auto [ox, oy] = planar(o);
+                const auto [ax, ay] = planar(a);
+                const auto [bx, by] = planar(b);
+                return (ax - ox) * (by - oy) - (ay - oy) * (bx - ox);
+            };
+            FixedVector<FeaturePoint, 2 * Capacity> hull;
+            for (std::size_t pass = 0; pass < 2; ++pass) {
+                const std::size_t start = hull.size();
+                for (std::size_t i = 0; i < points.size(); ++i) {
+                    const FeaturePoint& point = points[pass == 0 ? i : points.size() - 1 - i];
+                    while (hull.size() >= start + 2 && turn(hull[hull.size() - 2], hull[hull.size() - 1], point) <= 1e-12) {
+                        hull.pop_back();
+                    }
+                    hull.push_back(point);
+                }
+                // the last point of each chain is the first point of the other one
+                hull.pop_back();
+            }
+
+            if (hull.size() < 3) {
+                // collinear points form a segment between the extreme points
+                feature.push_back(points[0]);
+                feature.push_back(points[points.size() - 1]);
+                return feature;
+            }
+
+            const std::size_t count = std::min(hull.size(), Feature::capacity());
+            std::size_t first = 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                // larger polygons are subsampled evenly
+                if (hull[i * hull.size() / count].id < hull[first * hull.size() / count].id) {
+                    first = i;
+                }
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                feature.push_back(hull[(first + i) % count * hull.size() / count]);
+            }
+            return feature;
+        }
+
+        /**
+         * Clips a segment against planes, keeping the parts on the inner sides.
+         * @return Whether any part of the segment remains.
+         */
+        bool clip_segment(std::span<const geometry::Plane> planes, std::span<const std::uint8_t> plane_ids,
+                          geometry::ClipVertex& from, geometry::ClipVertex& to)
+        {
+            for (std::size_t i = 0; i < planes.size(); ++i) {
+                const double d_from = dot(from.point - planes[i].support, planes[i].normal);
+                const double d_to = dot(to.point - planes[i].support, planes[i].normal);
+                if (d_from < 0 && d_to < 0) {
+                    return false;
+                }
+                if (d_from < 0 || d_to < 0) {
+                    const geometry::ClipVertex clipped{
+                            .point = from.point + d_from / (d_from - d_to) * (to.point - from.point),
+                            .edge_in = plane_ids[i],
+                            .edge_out = plane_ids[i],
+                    };
+                    (d_from < 0 ? from : to) = clipped;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @return The normal of a polygon, scaled by twice its area.
+         */
+        math::Vec3d polygon_normal(const Feature& polygon)
+        {
+            math::Vec3d normal;
+            for (std::size_t i = 0; i < polygon.size(); ++i) {
+                normal += cross(polygon[i].point, polygon[(i + 1) % polygon.size()].point);
+            }
+            return normal;
+        }
+
+        /**
+         * Clips the contact feature of the incident shape against the side planes of the feature of the reference
+         * shape, like the faces of two boxes, and keeps the clipped points that lie below the reference feature.
+         * @param normal Normalized direction from the reference to the incident shape.
+         * @return Contact points on the incident feature along with their penetration depths.
+         */
+        FixedVector<std::tuple<geometry::ClipVertex, double>, 16>
+        clip_features(const Feature& reference, const Feature& incident, const math::Vec3d& normal)
+        {
+            FixedVector<std::tuple<geometry::ClipVertex, double>, 16> result;
+
+            FixedVector<geometry::Plane, 8> planes;
+            FixedVector<std::uint8_t, 8> plane_ids;
+            if (reference.size() == 2) {
+                // segments only touch along a line if they are about parallel
+                const math::Vec3d edge = normalize(reference[1].point - reference[0].point);
+                if (std::abs(dot(edge, normalize(incident[1].point - incident[0].point))) < 0.99) {
+                    return result;
+                }
+                planes.push_back({.support = reference[0].point, .normal = edge});
+                planes.push_back({.support = reference[1].point, .normal = -edge});
+            } else {
+                math::Vec3d centroid;
+                for (const FeaturePoint& point: reference) {
+                    centroid += point.point;
+                }
+                centroid = centroid / static_cast<double>(reference.size());
+                for (std::size_t i = 0; i < reference.size(); ++i) {
+                    const math::Vec3d& support = reference[i].point;
+                    math::Vec3d inward = cross(normal, reference[(i + 1) % reference.size()].point - support);
+                    if (dot(inward, centroid - support) < 0) {
+                        inward = -inward;
+                    }
+                    planes.push_back({.support = support, .normal = normalize(inward)});
+                }
+            }
+            for (std::size_t i = 0; i < planes.size(); ++i) {
+                // incident edges are identified by their local index, which can't exceed 8
+                plane_ids.push_back(static_cast<std::uint8_t>(8 + i));
+            }
+
+            geometry::ClipPolygon clipped;
+            if (incident.size() == 2) {
+                geometry::ClipVertex from{.point = incident[0].point, .edge_in = 0, .edge_out = 0};
+                geometry::ClipVertex to{.point = incident[1].point, .edge_in = 1, .edge_out = 1};
+                if (clip_segment(std::span(planes.data(), planes.size()), std::span(plane_ids.data(), plane_ids.size()),
+                                 from, to)) {
+                    clipped.push_back(from);
+                    clipped.push_back(to);
+                }
+            } else {
+                FixedVector<geometry::ClipVertex, 8> polygon;
+                for (std::size_t i = 0; i < incident.size(); ++i) {
+                    polygon.push_back({
+                            .point = incident[i].point,
+                            .edge_in = static_cast<std::uint8_t>((i + incident.size() - 1) % incident.size()),
+                            .edge_out = static_cast<std::uint8_t>(i),
+                    });
+                }
+                clipped = clip_sutherland_hodgman(std::span(planes.data(), planes.size()),
+                                                  std::span(plane_ids.data(), plane_ids.size()),
+                                                  std::span(polygon.data(), polygon.size()));
+            }
+
+            // the deepest point of the reference feature lies on the surface of the reference shape
+            double surface = -std::numeric_limits<double>::infinity();
+            for (const FeaturePoint& point: reference) {
+                surface = std::max(surface, dot(point.point, normal));
+            }
+            for (const geometry::ClipVertex& vertex: clipped) {
+                const double depth = surface - dot(vertex.point, normal);
+                if (depth >= 0) {
+                    result.push_back({vertex, depth});
+                }
+            }
+            return result;
+        }
+
+    }
+
+    SupportMapping::SupportMapping(const colliders::Sphere& sphere)
+        : m_type(Type::sphere), m_center(sphere.center), m_size(sphere.radius, 0, 0)
+    {
+    }
+
+    SupportMapping::SupportMapping(const colliders::OrientedBox& box)
+        : m_type(Type::box), m_center(box.center), m_orientation(box.orientation), m_size(box.half_size),
+          m_box(&box)
+    {
+    }
+
+    SupportMapping::SupportMapping(const colliders::Convex& convex)
+        : m_center(convex.center), m_orientation(convex.orientation)
+    {
+        std::visit(utils::overload{
+                [this](const shapes::Capsule& capsule) {
+                    m_type = Type::capsule;
+                    m_size = math::Vec3d(capsule.radius, capsule.half_height, 0);
+                },
+                [this](const shapes::Cylinder& cylinder) {
+                    m_type = Type::cylinder;
+                    m_size = math::Vec3d(cylinder.radius, cylinder.half_height, 0);
+                },
+                [this](const shapes::Hull& hull) {
+                    m_type = Type::hull;
+                    m_hull = hull.hull;
+                },
+        }, convex.shape);
+    }
+
+    SupportMapping::SupportMapping(const TriangleMesh::Triangle& triangle)
+        : m_type(Type::triangle), m_center((triangle[0] + triangle[1] + triangle[2]) / 3.0), m_triangle(&triangle)
+    {
+    }
+
+    math::Vec3d SupportMapping::support(const math::Vec3d& direction) const
+    {
+        switch (m_type) {
+            case Type::sphere:
+                return m_center;
+            case Type::box: {
+                const math::Vec3d local = to_local(direction);
+                return to_world(math::Vec3d(local.x() >= 0 ? m_size.x() : -m_size.x(),
+                                            local.y() >= 0 ? m_size.y() : -m_size.y(),
+                                            local.z() >= 0 ? m_size.z() : -m_size.z()));
+            }
+            case Type::capsule:
+                return to_world(math::Vec3d(0, to_local(direction).y() >= 0 ? m_size.y() : -m_size.y(), 0));
+            case Type::cylinder: {
+                const math::Vec3d local = to_local(direction);
+                const double radial = std::sqrt(local.x() * local.x() + local.z() * local.z());
+                const double scale = radial > 0 ? m_size.x() / radial : 0;
+                return to_world(math::Vec3d(local.x() * scale, local.y() >= 0 ? m_size.y() : -m_size.y(),
+                                            local.z() * scale));
+            }
+            case Type::hull:
+                return to_world(m_hull->vertices()[m_hull->support(to_local(direction))]);
+            case Type::triangle:
+                return *std::ranges::max_element(*m_triangle, {}, [&direction](const math::Vec3d& vertex) {
+                    return dot(vertex, direction);
+                });
+        }
+        return m_center;
+    }
+
+    double SupportMapping::margin() const
+    {
+        return m_type == Type::sphere || m_type == Type::capsule ? m_size.x() : 0;
+    }
+
+    const math::Vec3d& SupportMapping::center() const
+    {
+        return m_center;
+    }
+
+    Feature SupportMapping::feature(const math::Vec3d& direction, const double tolerance) const
+    {
+        Feature feature;
+        switch (m_type) {
+            case Type::sphere:
+                feature.push_back({.point = m_center + m_size.x() * direction});
+                break;
+            case Type::box: {
+                FixedVector<FeaturePoint, 8> points;
+                double farthest = -std::numeric_limits<double>::infinity();
+                for (const math::Vec3d& vertex: m_box->oriented_vertices) {
+                    farthest = std::max(farthest, dot(vertex, direction));
+                }
+                for (std::uint32_t i = 0; i < 8; ++i) {
+                    if (dot(m_box->oriented_vertices[i], direction) >= farthest - tolerance) {
+                        points.push_back({.point = m_box->oriented_vertices[i], .id = i});
+                    }
+                }
+                feature = make_polygon(points, direction);
+                break;
+            }
+            case Type::capsule: {
+                // the axis from the center to the center of the upper cap
+                const math::Vec3d axis = m_orientation * math::Vec3d(0, m_size.y(), 0);
+                const double extent = dot(axis, direction);
+                const math::Vec3d offset = m_size.x() * direction;
+                if (2 * std::abs(extent) <= tolerance) {
+                    feature.push_back({.point = m_center - axis + offset, .id = 0});
+                    feature.push_back({.point = m_center + axis + offset, .id = 1});
+                } else {
+                    feature.push_back({.point = m_center + (extent > 0 ? axis : -axis) + offset, .id = extent > 0 ? 1u : 0u});
+                }
+                break;
+            }
+            case Type::cylinder: {
+                const math::Vec3d axis = m_orientation * math::Vec3d(0, 1, 0);
+                const double along = dot(axis, direction);
+                const math::Vec3d radial = direction - along * axis;
+                const double radial_length = length(radial);
+                const double radius = m_size.x();
+                const double half_height = m_size.y();
+                if (2 * radius * radial_length <= tolerance) {
+                    // a cap faces the direction, whose rim is sampled as an octagon
+                    const math::Vec3d cap = m_center + (along > 0 ? half_height : -half_height) * axis;
+                    const math::Vec3d u = m_orientation * math::Vec3d(radius, 0, 0);
+                    const math::Vec3d v = m_orientation * math::Vec3d(0, 0, radius);
+                    for (std::uint32_t i = 0; i < 8; ++i) {
+                        const double angle = static_cast<double>(i) * std::numbers::pi / 4;
+                        feature.push_back({
+                                .point = cap + std::cos(angle) * u + std::sin(angle) * v,
+                                .id = (along > 0 ? 0 : 8) + i,
+                        });
+                    }
+                } else if (2 * half_height * std::abs(along) <= tolerance) {
+                    // the side faces the direction
+                    const math::Vec3d side = m_center + radius / radial_length * radial;
+                    feature.push_back({.point = side - half_height * axis, .id = 16});
+                    feature.push_back({.point = side + half_height * axis, .id = 17});
+                } else {
+                    feature.push_back({.point = support(direction), .id = along > 0 ? 18u : 19u});
+                }
+                break;
+            }
+            case Type::hull: {
+                const std::vector<math::Vec3d>& vertices = m_hull->vertices();
+                const math::Vec3d local = to_local(direction);
+                const double farthest = dot(vertices[m_hull->support(local)], local);
+                // Flat hulls may have many vertices on a face, of which the first ones are collected. The polygon of
+                // the face is then subsampled anyway.
+                FixedVector<FeaturePoint, 32> points;
+                for (std::size_t i = 0; i < vertices.size() && points.size() < points.capacity(); ++i) {
+                    if (dot(vertices[i], local) >= farthest - tolerance) {
+                        points.push_back({.point = to_world(vertices[i]), .id = static_cast<std::uint32_t>(i)});
+                    }
+                }
+                feature = make_polygon(points, direction);
+                break;
+            }
+            case Type::triangle: {
+                FixedVector<FeaturePoint, 8> points;
+                const double farthest = dot(support(direction), direction);
+                for (std::uint32_t i = 0; i < 3; ++i) {
+                    if (dot((*m_triangle)[i], direction) >= farthest - tolerance) {
+                        points.push_back({.point = (*m_triangle)[i], .id = i});
+                    }
+                }
+                feature = make_polygon(points, direction);
+                break;
+            }
+        }
+        return feature;
+    }
+
+    math::Vec3d SupportMapping::to_world(const math::Vec3d& local) const
+    {
+        return m_orientation * local + m_center;
+    }
+
+    math::Vec3d SupportMapping::to_local(const math::Vec3d& direction) const
+    {
+        return conjugate(m_orientation) * direction;
+    }
+
+    std::optional<ClosestPoints> distance(const SupportMapping& a, const SupportMapping& b, GjkCache* cache)
+    {
+        const GjkResult result = gjk(a, b, cache);
+        if (result.intersecting) {
+            return {};
+        }
+        if (cache != nullptr) {
+            cache->axis = result.closest;
+        }
+
+        const double core_distance = length(result.closest);
+        const double margin = a.margin() + b.margin();
+        if (core_distance <= margin) {
+            return {};
+        }
+        const math::Vec3d n = -result.closest / core_distance;
+        const auto [point_a, point_b] = closest_points(result.simplex);
+        return ClosestPoints{
+                .point_a = point_a + a.margin() * n,
+                .point_b = point_b - b.margin() * n,
+                .distance = core_distance - margin,
+        };
+    }
+
+    bool intersects(const SupportMapping& a, const SupportMapping& b, GjkCache* cache)
+    {
+        return !distance(a, b, cache).has_value();
+    }
+
+    std::optional<Penetration> penetration(const SupportMapping& a, const SupportMapping& b, GjkCache* cache)
+    {
+        const GjkResult result = gjk(a, b, cache);
+        const double margin = a.margin() + b.margin();
+        if (!result.intersecting) {
+            const double core_distance = length(result.closest);
+            if (cache != nullptr) {
+                cache->axis = result.closest;
+            }
+            if (core_distance > margin) {
+                return {};
+            }
+            if (core_distance > gjk_intersection_tolerance) {
+                // only the margins overlap, such that the closest points of the cores yield the penetration
+                const math::Vec3d n = -result.closest / core_distance;
+                const auto [point_a, point_b] = closest_points(result.simplex);
+                return Penetration{
+                        .normal = n,
+                        .point_a = point_a + a.margin() * n,
+                        .point_b = point_b - b.margin() * n,
+                        .depth = margin - core_distance,
+                };
+            }
+        }
+
+        const Penetration penetration = epa(a, b, result.simplex);
+        if (cache != nullptr) {
+            cache->axis = -penetration.normal;
+        }
+        return penetration;
+    }
+
+    std::optional<ContactManifold> collide(const SupportMapping& a, const SupportMapping& b, GjkCache* cache)
+    {
+        const std::optional<Penetration> penetration = physics3d::penetration(a, b, cache);
+        if (!penetration.has_value()) {
+            return {};
+        }
+        return collide(a, b, penetration.value());
+    }
+
+    ContactManifold collide(const SupportMapping& a, const SupportMapping& b, const Penetration& penetration)
+    {
+        ContactManifold manifold;
+        manifold.normal = penetration.normal;
+        const double tolerance = std::max(feature_tolerance, penetration.depth);
+        const Feature feature_a = a.feature(manifold.normal, tolerance);
+        const Feature feature_b = b.feature(-manifold.normal, tolerance);
+
+        ContactCandidates candidates;
+        if (feature_a.size() >= 2 && feature_b.size() >= 2) {
+            // choose the polygon as the reference feature, or the one that is more perpendicular to the normal
+            bool flipped = feature_b.size() > 2 && feature_a.size() == 2;
+            if (feature_a.size() > 2 && feature_b.size() > 2) {
+                const math::Vec3d normal_a = polygon_normal(feature_a);
+                const math::Vec3d normal_b = polygon_normal(feature_b);
+                flipped = std::abs(dot(normal_b, manifold.normal)) * length(normal_a) >
+                          std::abs(dot(normal_a, manifold.normal)) * length(normal_b);
+            }
+
+            const auto clipped = flipped
+                                 ? clip_features(feature_b, feature_a, -manifold.normal)
+                                 : clip_features(feature_a, feature_b, manifold.normal);
+            for (const auto& [vertex, depth]: clipped) {
+                const math::Vec3d& point = vertex.point;
+                ContactPoint contact;
+                contact.feature_id = geometry::feature_id(vertex) | (flipped ? 1u << 16 : 0u);
+                contact.depth = depth;
+                contact.p_a = flipped ? point : point + manifold.normal * depth;
+                contact.p_b = flipped ? point - manifold.normal * depth : point;
+                contact.r_a = contact.p_a - a.center();
+                contact.r_b = contact.p_b - b.center();
+                candidates.push_back(contact);
+            }
+        }
+
+        if (candidates.empty()) {
+            // vertices and curved surfaces touch in a single point
+            ContactPoint contact;
+            contact.depth = penetration.depth;
+            contact.p_a = penetration.point_a;
+            contact.p_b = penetration.point_b;
+            contact.r_a = contact.p_a - a.center();
+            contact.r_b = contact.p_b - b.center();
+            candidates.push_back(contact);
+        }
+
+        add_reduced_contacts(manifold, candidates);
+        return manifold;
+    }
+
+    std::optional<ContactManifold> collide(const colliders::OrientedPlane& a, const SupportMapping& b)
+    {
+        // like for boxes, the direction of the collision is determined by the side of the plane that the center of
+        // the shape lies on
+        const double dist = dot(b.center() - a.support, a.normal);
+        ContactManifold manifold;
+        manifold.normal = dist > 0 ? a.normal : -a.normal;
+
+        const math::Vec3d deepest = b.support(-manifold.normal) - b.margin() * manifold.normal;
+        const double max_depth = dot(a.support - deepest, manifold.normal);
+        if (max_depth < 0) {
+            return {};
+        }
+
+        ContactCandidates candidates;
+        for (const FeaturePoint& point: b.feature(-manifold.normal, std::max(feature_tolerance, max_depth))) {
+            const double depth = dot(a.support - point.point, manifold.normal);
+            if (depth < 0) {
+                continue;
+            }
+            ContactPoint contact;
+            contact.feature_id = point.id;
+            contact.depth = depth;
+            contact.p_a = point.point + manifold.normal * depth;
+            contact.p_b = point.point;
+            contact.r_a = contact.p_a - a.support;
+            contact.r_b = contact.p_b - b.center();
+            candidates.push_back(contact);
+        }
+        if (candidates.empty()) {
+            // the deepest point was dropped with the sampling of a round feature
+            ContactPoint contact;
+            contact.depth = max_depth;
+            contact.p_a = deepest + manifold.normal * max_depth;
+            contact.p_b = deepest;
+            contact.r_a = contact.p_a - a.support;
+            contact.r_b = contact.p_b - b.center();
+            candidates.push_back(contact);
+        }
+
+        add_reduced_contacts(manifold, candidates);
+        return manifold;
+    }
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+
+#include <math/vector.h>
+#include <math/quaternion.h>
+
+#include "BoundingShape.h"
+#include "Collision.h"
+#include "FixedVector.h"
+
+namespace yage::physics3d
+{
+    /**
+     * Remembers the separating axis that GJK found for a pair of colliders. When the pair is tested again in the next
+     * step, GJK starts from the previous axis and typically converges within one or two iterations, since the bodies
+     * have barely moved. Pairs of boxes remember the axis of the SAT instead, which is tested first in the next step.
+     */
+    struct GjkCache
+    {
+        /**
+         * Direction from the closest point of B to the closest point of A, or from B into A for intersecting pairs.
+         * For pairs of boxes, the separating axis or the direction of the minimum translation vector. Zero if the pair
+         * wasn't tested yet.
+         */
+        math::Vec3d axis{};
+    };
+
+    /**
+     * A surface point of a convex shape, identified by the vertex or sample of the shape that it originates from.
+     */
+    struct FeaturePoint
+    {
+        math::Vec3d point;
+        std::uint32_t id{};
+    };
+
+    /**
+     * The points of a convex shape that lie farthest along a direction, which are the contact feature of the shape.
+     * Features of more than two points form a convex polygon in winding order.
+     */
+    using Feature = FixedVector<FeaturePoint, 8>;
+
+    /**
+     * The support mapping of a convex collider in world space. Shapes are split into a core and a margin, such as the
+     * segment and radius of a capsule: GJK runs on the cores, so that rounded shapes in shallow contact are resolved
+     * without EPA.
+     */
+    class SupportMapping
+    {
+    public:
+        // implicit, such that colliders can be passed to the queries directly
+        SupportMapping(const colliders::Sphere& sphere); // NOLINT(*-explicit-constructor)
+
+        SupportMapping(const colliders::OrientedBox& box); // NOLINT(*-explicit-constructor)
+
+        SupportMapping(const colliders::Convex& convex); // NOLINT(*-explicit-constructor)
+
+        /**
+         * @param triangle The world-space vertices of a triangle, which must outlive the mapping.
+         */
+        explicit SupportMapping(const TriangleMesh::Triangle& triangle);
+
+        /**
+         * @return The point of the core that lies farthest along a direction.
+         */
+        [[nodiscard]]
+        math::Vec3d support(const math::Vec3d& direction) const;
+
+        /**
+         * @return The distance by which the core is inflated in all directions.
+         */
+        [[nodiscard]]
+        double margin() const;
+
+        [[nodiscard]]
+        const math::Vec3d& center() const;
+
+        /**
+         * @return The surface points that lie farthest along a normalized direction, within a tolerance.
+         */
+        [[nodiscard]]
+        Feature feature(const math::Vec3d& direction, double tolerance) const;
+
+    private:
+        enum class Type
+        {
+            sphere,
+            box,
+            capsule,
+            cylinder,
+            hull,
+            triangle,
+        };
+
+        Type m_type;
+        math::Vec3d m_center;
+        math::Quatd m_orientation;
+        /**
+         * Half size of boxes; radius and half height of capsules and cylinders in the x and y components.
+         */
+        math::Vec3d m_size;
+        const colliders::OrientedBox* m_box{};
+        const ConvexHull* m_hull{};
+        const TriangleMesh::Triangle* m_triangle{};
+
+        [[nodiscard]]
+        math::Vec3d to_world(const math::Vec3d& local) const;
+
+        [[nodiscard]]
+        math::Vec3d to_local(const math::Vec3d& direction) const;
+    };
+
+    /**
+     * The closest points on the surfaces of two separated convex shapes.
+     */
+    struct ClosestPoints
+    {
+        math::Vec3d point_a;
+        math::Vec3d point_b;
+        double distance{};
+    };
+
+    /**
+     * The minimum translation that separates two intersecting convex shapes.
+     */
+    struct Penetration
+    {
+        /**
+         * Normalized direction from A to B, along which B has to move by the depth to separate the shapes.
+         */
+        math::Vec3d normal;
+
+        /**
+         * The point of A that lies deepest within B.
+         */
+        math::Vec3d point_a;
+
+        /**
+         * The point of B that lies deepest within A.
+         */
+        math::Vec3d point_b;
+
+        double depth{};
+    };
+
+    /**
+     * Computes the distance of two convex shapes with GJK.
+     * @param cache The separating axis of a previous query of the same pair, which is updated. May be null.
+     * @return The closest points, or empty if the shapes intersect or touch.
+     */
+    std::optional<ClosestPoints> distance(const SupportMapping& a, const SupportMapping& b, GjkCache* cache = nullptr);
+
+    /**
+     * @return Whether two convex shapes intersect or touch.
+     */
+    bool intersects(const SupportMapping& a, const SupportMapping& b, GjkCache* cache = nullptr);
+
+    /**
+     * Computes the penetration of two convex shapes. Shapes whose cores are separated are resolved by GJK, otherwise
+     * EPA expands the GJK simplex to find the minimum translation.
+     * @return The penetration, or empty if the shapes don't intersect.
+     */
+    std::optional<Penetration> penetration(const SupportMapping& a, const SupportMapping& b, GjkCache* cache = nullptr);
+
+    /**
+     * Computes the contact manifold of two convex shapes. The contact features of both shapes are clipped against
+     * each other like the faces of two boxes, which yields up to four contact points for resting contacts.
+     */
+    std::optional<ContactManifold> collide(const SupportMapping& a, const SupportMapping& b, GjkCache* cache = nullptr);
+
+    /**
+     * Computes the contact manifold of two convex shapes that penetrate each other as given, such as along a normal
+     * that was chosen by the caller.
+     */
+    ContactManifold collide(const SupportMapping& a, const SupportMapping& b, const Penetration& penetration);
+
+    /**
+     * Computes the contact manifold of a plane and a convex shape from the contact feature of the shape.
+     */
+    std::optional<ContactManifold> collide(const colliders::OrientedPlane& a, const SupportMapping& b);
+}
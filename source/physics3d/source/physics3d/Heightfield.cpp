@@ -0,0 +1,138 @@
+#include <cassert>
+
+#include "Heightfield.h"
+
+namespace yage::physics3d
+{
+    Heightfield::Heightfield(const std::size_t rows, const std::size_t columns, const std::span<const double> heights,
+                             const double spacing)
+        : m_rows(rows), m_columns(columns), m_spacing(spacing)
+    {
+        assert(rows >= 2 && columns >= 2 && heights.size() == rows * columns && spacing > 0);
+        assert(size() <= std::numeric_limits<std::uint32_t>::max());
+
+        const auto [min, max] = std::ranges::minmax(heights);
+        m_height_offset = min;
+        m_height_scale = (max - min) / std::numeric_limits<std::uint16_t>::max();
+        m_samples.reserve(heights.size());
+        for (const double height: heights) {
+            const double step = m_height_scale > 0 ? std::round((height - min) / m_height_scale) : 0;
+            m_samples.push_back(static_cast<std::uint16_t>(step));
+        }
+
+        m_bounds = {
+                .min = math::Vec3d(0, min, 0),
+                .max = math::Vec3d(static_cast<double>(columns - 1) * spacing, max,
+                                   static_cast<double>(rows - 1) * spacing),
+        };
+    }
+
+    std::size_t Heightfield::rows() const
+    {
+        return m_rows;
+    }
+
+    std::size_t Heightfield::columns() const
+    {
+        return m_columns;
+    }
+
+    double Heightfield::height(const std::size_t row, const std::size_t column) const
+    {
+        return dequantize(m_samples[row * m_columns + column]);
+    }
+
+    std::size_t Heightfield::size() const
+    {
+        return 2 * (m_rows - 1) * (m_columns - 1);
+    }
+
+    Heightfield::Triangle Heightfield::triangle(const std::uint32_t index) const
+    {
+        Triangle triangle;
+        const std::array<std::array<std::size_t, 2>, 3> vertices = triangle_vertices(index);
+        for (std::size_t i = 0; i < 3; ++i) {
+            const auto [column, row] = vertices[i];
+            triangle[i] = math::Vec3d(static_cast<double>(column) * m_spacing, height(row, column),
+                                      static_cast<double>(row) * m_spacing);
+        }
+        return triangle;
+    }
+
+    bool Heightfield::is_active_edge(const std::uint32_t index, const int edge) const
+    {
+        // The vertex opposite of each edge in the neighbouring triangle, relative to the lower corner of the cell.
+        // The first triangle of a cell borders the previous column, the second triangle, and the previous row, the
+        // second triangle borders the first triangle, the next row, and the next column.
+        constexpr std::array<std::array<std::array<std::ptrdiff_t, 2>, 3>, 2> opposite_offsets{{
+                {{{-1, 1}, {1, 1}, {1, -1}}},
+                {{{0, 0}, {0, 2}, {2, 0}}},
+        }};
+
+        const std::size_t cell = index / 2;
+        const auto column = static_cast<std::ptrdiff_t>(cell % (m_columns - 1));
+        const auto row = static_cast<std::ptrdiff_t>(cell / (m_columns - 1));
+        const auto [offset_column, offset_row] = opposite_offsets[index % 2][edge];
+        const std::ptrdiff_t opposite_column = column + offset_column;
+        const std::ptrdiff_t opposite_row = row + offset_row;
+        if (opposite_column < 0 || opposite_row < 0 || opposite_column >= static_cast<std::ptrdiff_t>(m_columns) ||
+            opposite_row >= static_cast<std::ptrdiff_t>(m_rows)) {
+            // boundary edges
+            return true;
+        }
+
+        const Triangle vertices = triangle(index);
+        const math::Vec3d& start = vertices[edge];
+        const math::Vec3d& end = vertices[(edge + 1) % 3];
+        const math::Vec3d opposite(static_cast<double>(opposite_column) * m_spacing,
+                                   height(static_cast<std::size_t>(opposite_row),
+                                          static_cast<std::size_t>(opposite_column)),
+                                   static_cast<double>(opposite_row) * m_spacing);
+        // the neighbour shares the edge in the opposite direction, since all triangles have the same winding
+        return physics3d::is_active_edge(cross(end - start, vertices[(edge + 2) % 3] - start), start,
+                                         cross(start - end, opposite - end), opposite);
+    }
+
+    const geometry::AABB& Heightfield::bounds() const
+    {
+        return m_bounds;
+    }
+
+    double Heightfield::dequantize(const std::uint16_t sample) const
+    {
+        return m_height_offset + m_height_scale * sample;
+    }
+
+    std::uint32_t Heightfield::cell_id(const std::size_t row, const std::size_t column) const
+    {
+        return static_cast<std::uint32_t>(row * (m_columns - 1) + column);
+    }
+
+    std::size_t Heightfield::cell_index(const double coordinate, const std::size_t last) const
+    {
+        return static_cast<std::size_t>(std::clamp(std::floor(coordinate / m_spacing), 0.0,
+                                                   static_cast<double>(last)));
+    }
+
+    std::array<std::array<std::size_t, 2>, 3> Heightfield::triangle_vertices(const std::uint32_t index) const
+    {
+        const std::size_t cell = index / 2;
+        const std::size_t column = cell % (m_columns - 1);
+        const std::size_t row = cell / (m_columns - 1);
+        // both triangles of a cell share the diagonal from the next row to the next column
+        if (index % 2 == 0) {
+            return {{{column, row}, {column, row + 1}, {column + 1, row}}};
+        }
+        return {{{column + 1, row}, {column, row + 1}, {column + 1, row + 1}}};
+    }
+
+    std::array<std::uint16_t, 3> Heightfield::triangle_samples(const std::uint32_t index) const
+    {
+        std::array<std::uint16_t, 3> samples{};
+        const std::array<std::array<std::size_t, 2>, 3> vertices = triangle_vertices(index);
+        for (std::size_t i = 0; i < 3; ++i) {
+            samples[i] = m_samples[vertices[i][1] * m_columns + vertices[i][0]];
+        }
+        return samples;
+    }
+}
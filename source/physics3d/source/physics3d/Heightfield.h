@@ -0,0 +1,233 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <math/vector.h>
+
+#include "Algorithms.h"
+#include "TriangleMesh.h"
+
+namespace yage::physics3d
+{
+    /**
+     * A regular grid of height samples in the local space of a static body, such as a tile of streamed terrain. Each
+     * cell between four samples is split into two triangles, which collide like the triangles of a TriangleMesh, but
+     * are found directly from the grid instead of a hierarchy. Heights are quantized to 16 bits, which keeps large
+     * terrains at two bytes per sample.
+     *
+     * Samples lie in the xz-plane, with columns along the x-axis and rows along the z-axis, starting at the origin.
+     * Triangles are numbered by cell in row-major order, with two consecutive indices per cell.
+     *
+     * Heightfields are immutable and meant to be shared by all colliders with the same samples, which refer to the
+     * heightfield and must not outlive it.
+     */
+    class Heightfield
+    {
+    public:
+        using Triangle = TriangleMesh::Triangle;
+
+        /**
+         * @param rows The number of samples along the z-axis, at least two.
+         * @param columns The number of samples along the x-axis, at least two.
+         * @param heights The heights of all samples in row-major order.
+         * @param spacing The distance between neighbouring samples along both axes.
+         */
+        Heightfield(std::size_t rows, std::size_t columns, std::span<const double> heights, double spacing);
+
+        [[nodiscard]]
+        std::size_t rows() const;
+
+        [[nodiscard]]
+        std::size_t columns() const;
+
+        /**
+         * @return The height of a sample after quantization.
+         */
+        [[nodiscard]]
+        double height(std::size_t row, std::size_t column) const;
+
+        /**
+         * @return The number of triangles, which is twice the number of cells.
+         */
+        [[nodiscard]]
+        std::size_t size() const;
+
+        /**
+         * @return The vertices of a triangle in local space, in counter-clockwise winding order seen from above.
+         */
+        [[nodiscard]]
+        Triangle triangle(std::uint32_t index) const;
+
+        /**
+         * @return Whether contacts may use the normal of an edge of a triangle, like TriangleMesh::is_active_edge.
+         * Since the neighbours of a triangle are known from the grid, this is computed on demand instead of stored.
+         */
+        [[nodiscard]]
+        bool is_active_edge(std::uint32_t index, int edge) const;
+
+        /**
+         * @return The local-space bounds of all samples.
+         */
+        [[nodiscard]]
+        const geometry::AABB& bounds() const;
+
+        /**
+         * Finds all triangles whose bounds overlap a local-space box, which only visits the cells below the box.
+         * @param callback Invoked with the index of each overlapping triangle.
+         */
+        template<typename Callback>
+        void query(const geometry::AABB& aabb, Callback&& callback) const
+        {
+            if (!geometry::overlaps(m_bounds, aabb)) {
+                return;
+            }
+            const std::size_t last_column = m_columns - 2;
+            const std::size_t last_row = m_rows - 2;
+            const std::size_t column_min = cell_index(aabb.min.x(), last_column);
+            const std::size_t column_max = cell_index(aabb.max.x(), last_column);
+            const std::size_t row_min = cell_index(aabb.min.z(), last_row);
+            const std::size_t row_max = cell_index(aabb.max.z(), last_row);
+            for (std::size_t row = row_min; row <= row_max; ++row) {
+                for (std::size_t column = column_min; column <= column_max; ++column) {
+                    const std::uint32_t cell = cell_id(row, column);
+                    for (const std::uint32_t index: {2 * cell, 2 * cell + 1}) {
+                        const std::array<std::uint16_t, 3> samples = triangle_samples(index);
+                        const auto [min, max] = std::ranges::minmax(samples);
+                        if (dequantize(min) <= aabb.max.y() && dequantize(max) >= aabb.min.y()) {
+                            callback(index);
+                        }
+                    }
+                }
+            }
+        }
+
+        /**
+         * Reports the triangles of all cells that a local-space line segment passes within a radius of, like
+         * DynamicAabbTree::sweep. The cells are walked in the order in which the segment crosses them (2D DDA), so
+         * the walk stops at the first cell beyond the closest hit.
+         * @param callback Invoked with the index of each triangle. Returns the fraction of the segment that is
+         * searched further.
+         */
+        template<typename Callback>
+        void sweep(const math::Vec3d& start, const math::Vec3d& displacement, const double radius,
+                   double max_fraction, Callback&& callback) const
+        {
+            constexpr double inf = std::numeric_limits<double>::infinity();
+
+            // the segment in units of cells, clipped to the grid grown by the radius
+            const double reach = radius / m_spacing;
+            const math::Vec3d cell_start = start / m_spacing;
+            const math::Vec3d cell_displacement = displacement / m_spacing;
+            double t_enter = 0;
+            double t_exit = max_fraction;
+            for (const auto& [axis, cells]: {std::pair{0, m_columns - 1}, std::pair{2, m_rows - 1}}) {
+                if (cell_displacement(axis) == 0) {
+                    if (cell_start(axis) < -reach || cell_start(axis) > static_cast<double>(cells) + reach) {
+                        return;
+                    }
+                    continue;
+                }
+                const double t_0 = (-reach - cell_start(axis)) / cell_displacement(axis);
+                const double t_1 = (static_cast<double>(cells) + reach - cell_start(axis)) / cell_displacement(axis);
+                t_enter = std::max(t_enter, std::min(t_0, t_1));
+                t_exit = std::min(t_exit, std::max(t_0, t_1));
+            }
+            if (t_enter > t_exit) {
+                return;
+            }
+
+            const math::Vec3d entry = cell_start + t_enter * cell_displacement;
+            std::array<std::ptrdiff_t, 3> cell{static_cast<std::ptrdiff_t>(std::floor(entry.x())), 0,
+                                               static_cast<std::ptrdiff_t>(std::floor(entry.z()))};
+            std::array<std::ptrdiff_t, 3> step{};
+            // the fraction at which the segment crosses the next cell boundary along each axis
+            math::Vec3d t_next(inf);
+            math::Vec3d t_delta(inf);
+            for (const int axis: {0, 2}) {
+                if (cell_displacement(axis) > 0) {
+                    step[axis] = 1;
+                    t_next(axis) = (static_cast<double>(cell[axis] + 1) - cell_start(axis)) / cell_displacement(axis);
+                    t_delta(axis) = 1 / cell_displacement(axis);
+                } else if (cell_displacement(axis) < 0) {
+                    step[axis] = -1;
+                    t_next(axis) = (static_cast<double>(cell[axis]) - cell_start(axis)) / cell_displacement(axis);
+                    t_delta(axis) = -1 / cell_displacement(axis);
+                }
+            }
+
+            // cells within the radius of the segment's cell may be hit as well
+            const auto margin = static_cast<std::ptrdiff_t>(std::ceil(reach));
+            double t = t_enter;
+            while (t <= std::min(t_exit, max_fraction)) {
+                const double t_leave = std::min({t_next.x(), t_next.z(), t_exit});
+                const double y_0 = start.y() + t * displacement.y();
+                const double y_1 = start.y() + std::min(t_leave, max_fraction) * displacement.y();
+                const double y_min = std::min(y_0, y_1) - radius;
+                const double y_max = std::max(y_0, y_1) + radius;
+
+                for (std::ptrdiff_t row = cell[2] - margin; row <= cell[2] + margin; ++row) {
+                    for (std::ptrdiff_t column = cell[0] - margin; column <= cell[0] + margin; ++column) {
+                        if (row < 0 || column < 0 || row >= static_cast<std::ptrdiff_t>(m_rows - 1) ||
+                            column >= static_cast<std::ptrdiff_t>(m_columns - 1)) {
+                            continue;
+                        }
+                        const std::uint32_t id = cell_id(static_cast<std::size_t>(row),
+                                                         static_cast<std::size_t>(column));
+                        for (const std::uint32_t index: {2 * id, 2 * id + 1}) {
+                            const std::array<std::uint16_t, 3> samples = triangle_samples(index);
+                            const auto [min, max] = std::ranges::minmax(samples);
+                            if (dequantize(min) <= y_max && dequantize(max) >= y_min) {
+                                max_fraction = std::min(max_fraction, callback(index));
+                            }
+                        }
+                    }
+                }
+
+                const int axis = t_next.x() <= t_next.z() ? 0 : 2;
+                t = t_next(axis);
+                t_next(axis) += t_delta(axis);
+                cell[axis] += step[axis];
+            }
+        }
+
+    private:
+        std::size_t m_rows;
+        std::size_t m_columns;
+        double m_spacing;
+        double m_height_offset{};
+        /**
+         * The height difference per quantization step.
+         */
+        double m_height_scale{};
+        std::vector<std::uint16_t> m_samples;
+        geometry::AABB m_bounds;
+
+        [[nodiscard]]
+        double dequantize(std::uint16_t sample) const;
+
+        [[nodiscard]]
+        std::uint32_t cell_id(std::size_t row, std::size_t column) const;
+
+        /**
+         * @return The cell that contains a local coordinate along the x- or z-axis, clamped to the grid.
+         */
+        [[nodiscard]]
+        std::size_t cell_index(double coordinate, std::size_t last) const;
+
+        /**
+         * @return The grid coordinates (column, row) of the vertices of a triangle.
+         */
+        [[nodiscard]]
+        std::array<std::array<std::size_t, 2>, 3> triangle_vertices(std::uint32_t index) const;
+
+        [[nodiscard]]
+        std::array<std::uint16_t, 3> triangle_samples(std::uint32_t index) const;
+    };
+}
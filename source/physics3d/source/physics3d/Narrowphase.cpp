@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <iterator>
+
+#include "Narrowphase.h"
+
+namespace yage::physics3d
+{
+    std::vector<Narrowphase::PairManifold>&
+    Narrowphase::update(const std::span<const Broadphase::CandidatePair> pairs,
+                        const std::function<const Collider&(std::size_t)>& collider, ThreadPool* thread_pool)
+    {
+        m_manifolds.clear();
+        m_axes.clear();
+        if (thread_pool == nullptr) {
+            collide(pairs, collider, m_manifolds, m_axes);
+            std::swap(m_previous_axes, m_axes);
+            return m_manifolds;
+        }
+
+        m_thread_manifolds.resize(thread_pool->size());
+        m_thread_axes.resize(thread_pool->size());
+        thread_pool->run([this, pairs, &collider, thread_pool](const std::size_t thread) {
+            m_thread_manifolds[thread].clear();
+            m_thread_axes[thread].clear();
+            const auto [begin, end] = thread_pool->chunk(pairs.size(), thread);
+            collide(pairs.subspan(begin, end - begin), collider, m_thread_manifolds[thread], m_thread_axes[thread]);
+        });
+
+        // chunks are assigned in order, so concatenating them restores the order of the pairs
+        for (std::vector<PairManifold>& manifolds: m_thread_manifolds) {
+            m_manifolds.insert(m_manifolds.end(),
+                               std::make_move_iterator(manifolds.begin()), std::make_move_iterator(manifolds.end()));
+        }
+        for (const std::vector<CachedAxis>& axes: m_thread_axes) {
+            m_axes.insert(m_axes.end(), axes.begin(), axes.end());
+        }
+        std::swap(m_previous_axes, m_axes);
+        return m_manifolds;
+    }
+
+    void Narrowphase::save(SnapshotWriter& writer) const
+    {
+        writer.write(m_previous_axes);
+    }
+
+    void Narrowphase::restore(SnapshotReader& reader)
+    {
+        reader.read(m_previous_axes);
+    }
+
+    void Narrowphase::collide(const std::span<const Broadphase::CandidatePair> pairs,
+                              const std::function<const Collider&(std::size_t)>& collider,
+                              std::vector<PairManifold>& manifolds, std::vector<CachedAxis>& axes) const
+    {
+        // the pairs and the previous axes are both sorted, so the previous axes are found by a merging walk
+        auto previous = m_previous_axes.begin();
+        if (!pairs.empty()) {
+            previous = std::ranges::lower_bound(m_previous_axes, pairs.front(), {}, [](const CachedAxis& axis) {
+                return Broadphase::CandidatePair(axis.body_a, axis.body_b);
+            });
+        }
+        for (const auto& [id_a, id_b]: pairs) {
+            while (previous != m_previous_axes.end() &&
+                   std::pair(previous->body_a, previous->body_b) < std::pair(id_a, id_b)) {
+                ++previous;
+            }
+            GjkCache cache;
+            if (previous != m_previous_axes.end() && previous->body_a == id_a && previous->body_b == id_b) {
+                cache = previous->cache;
+            }
+
+            const Collider& collider_a = collider(id_a);
+            const Collider& collider_b = collider(id_b);
+            const auto* compound_a = std::get_if<colliders::Compound>(&collider_a);
+            const auto* compound_b = std::get_if<colliders::Compound>(&collider_b);
+            const auto* mesh_a = std::get_if<colliders::Mesh>(&collider_a);
+            const auto* mesh_b = std::get_if<colliders::Mesh>(&collider_b);
+            const auto* heightfield_a = std::get_if<colliders::Heightfield>(&collider_a);
+            const auto* heightfield_b = std::get_if<colliders::Heightfield>(&collider_b);
+            if (compound_a != nullptr || compound_b != nullptr || mesh_a != nullptr || mesh_b != nullptr ||
+                heightfield_a != nullptr || heightfield_b != nullptr) {
+                // Each touching child or triangle yields a manifold. The callback only captures two references, which
+                // fit into std::function without allocating.
+                const Broadphase::CandidatePair pair(id_a, id_b);
+                auto add = [&manifolds, &pair](const ContactManifold& manifold) {
+                    manifolds.push_back({.body_a = pair.first, .body_b = pair.second, .manifold = manifold});
+                };
+                // compounds collide their children with meshes and heightfields, so they are dispatched first
+                if (compound_a != nullptr) {
+                    physics3d::collide(*compound_a, collider_b, true, add);
+                } else if (compound_b != nullptr) {
+                    physics3d::collide(*compound_b, collider_a, false, add);
+                } else if (mesh_a != nullptr) {
+                    physics3d::collide(*mesh_a, collider_b, true, add);
+                } else if (mesh_b != nullptr) {
+                    physics3d::collide(*mesh_b, collider_a, false, add);
+                } else if (heightfield_a != nullptr) {
+                    physics3d::collide(*heightfield_a, collider_b, true, add);
+                } else {
+                    physics3d::collide(*heightfield_b, collider_a, false, add);
+                }
+                continue;
+            }
+
+            const CollisionVisitor collision_visitor(&cache);
+            std::optional<ContactManifold> result = std::visit(collision_visitor, collider_a, collider_b);
+            if (result.has_value()) {
+                manifolds.push_back({.body_a = id_a, .body_b = id_b, .manifold = std::move(result.value())});
+            }
+            if (length_sqr(cache.axis) > 0) {
+                axes.push_back({.body_a = id_a, .body_b = id_b, .cache = cache});
+            }
+        }
+    }
+}
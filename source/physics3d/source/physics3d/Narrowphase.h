@@ -0,0 +1,87 @@
+#pragma once
+
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "BoundingShape.h"
+#include "Broadphase.h"
+#include "Collision.h"
+#include "Gjk.h"
+#include "Snapshot.h"
+#include "ThreadPool.h"
+
+namespace yage::physics3d
+{
+    /**
+     * Computes contact manifolds for candidate pairs from the broad phase. With a thread pool, the pairs are split into
+     * contiguous chunks that are collided in parallel into separate buffers per thread, which are then concatenated in
+     * thread order. The resulting manifolds are therefore always in the order of the candidate pairs, independent of
+     * the number of threads.
+     *
+     * The separating axes that GJK finds for pairs with convex colliders are kept until the next update, such that GJK
+     * starts from the previous axis of a pair that is still a candidate. Pairs of boxes keep the axis of the SAT.
+     * Pairs with a triangle mesh or a heightfield yield a manifold for each touching triangle, pairs with a compound a
+     * manifold for each touching child.
+     */
+    class Narrowphase
+    {
+    public:
+        /**
+         * The contact manifold of a colliding pair of bodies.
+         */
+        struct PairManifold
+        {
+            std::size_t body_a{};
+            std::size_t body_b{};
+            ContactManifold manifold;
+        };
+
+        /**
+         * Collides all candidate pairs.
+         * @param pairs The pairs to collide.
+         * @param collider Returns the collider of a body id in world space. Called concurrently with a thread pool.
+         * @param thread_pool Threads to distribute the pairs over, or null to collide all pairs on the calling thread.
+         * @return The manifolds of all colliding pairs, in the order of the given pairs. They may be modified until the
+         * next update.
+         */
+        std::vector<PairManifold>& update(std::span<const Broadphase::CandidatePair> pairs,
+                                                const std::function<const Collider&(std::size_t)>& collider,
+                                                ThreadPool* thread_pool);
+
+        /**
+         * Appends the cached separating axes to a snapshot.
+         */
+        void save(SnapshotWriter& writer) const;
+
+        /**
+         * Restores the state that was saved to a snapshot.
+         */
+        void restore(SnapshotReader& reader);
+
+    private:
+        struct CachedAxis
+        {
+            std::size_t body_a{};
+            std::size_t body_b{};
+            GjkCache cache;
+        };
+
+        std::vector<PairManifold> m_manifolds;
+        /**
+         * Manifolds found by each thread, reused between updates.
+         */
+        std::vector<std::vector<PairManifold>> m_thread_manifolds;
+
+        /**
+         * Separating axes of the previous update, sorted by pair like the candidate pairs.
+         */
+        std::vector<CachedAxis> m_previous_axes;
+        std::vector<CachedAxis> m_axes;
+        std::vector<std::vector<CachedAxis>> m_thread_axes;
+
+        void collide(std::span<const Broadphase::CandidatePair> pairs,
+                     const std::function<const Collider&(std::size_t)>& collider,
+                     std::vector<PairManifold>& manifolds, std::vector<CachedAxis>& axes) const;
+    };
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace yage::physics3d
+{
+    /**
+     * Whether the simulation collects step statistics, which is set by the YAGE_PHYSICS3D_PROFILING build option.
+     * Without it, statistics cost nothing and stay zero.
+     */
+#ifdef YAGE_PHYSICS3D_PROFILING
+    constexpr bool profiling_enabled = true;
+#else
+    constexpr bool profiling_enabled = false;
+#endif
+
+    /**
+     * Counters and wall times of the phases of one simulation step.
+     */
+    struct StepStatistics
+    {
+        std::chrono::nanoseconds step_time{};
+        std::chrono::nanoseconds integrate_forces_time{};
+        std::chrono::nanoseconds detect_collisions_time{};
+        /**
+         * Time of warm starting and solving the constraints.
+         */
+        std::chrono::nanoseconds resolve_collisions_time{};
+        /**
+         * Time of integrating positions, including continuous collision detection and updating the broad phase.
+         */
+        std::chrono::nanoseconds integrate_positions_time{};
+        std::chrono::nanoseconds update_islands_time{};
+
+        /**
+         * Pairs of colliders with overlapping bounds.
+         */
+        std::size_t candidate_pairs{};
+
+        /**
+         * Candidate pairs that are tested by the narrow phase, i.e. that don't only consist of unmovable bodies.
+         */
+        std::size_t narrowphase_pairs{};
+
+        /**
+         * Pairs that the narrow phase found to be colliding.
+         */
+        std::size_t narrowphase_hits{};
+
+        std::size_t contacts{};
+
+        /**
+         * Penetration, friction, and rolling friction rows of all contacts.
+         */
+        std::size_t constraint_rows{};
+
+        /**
+         * Solver iterations over all constraints, summed over all substeps.
+         */
+        int solver_iterations{};
+
+        /**
+         * The largest change of an accumulated penetration or friction impulse that another solver iteration would
+         * apply, which approaches zero as the solver converges.
+         */
+        double residual{};
+    };
+
+    /**
+     * Adds the wall time of its own lifetime to a duration if profiling is enabled.
+     */
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(std::chrono::nanoseconds& duration)
+            : m_duration(duration)
+        {
+            if constexpr (profiling_enabled) {
+                m_start = std::chrono::steady_clock::now();
+            }
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        ~ScopedTimer()
+        {
+            if constexpr (profiling_enabled) {
+                m_duration += std::chrono::steady_clock::now() - m_start;
+            }
+        }
+
+    private:
+        std::chrono::nanoseconds& m_duration;
+        std::chrono::steady_clock::time_point m_start{};
+    };
+}
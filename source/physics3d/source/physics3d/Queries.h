@@ -0,0 +1,49 @@
+#pragma once
+
+#include <math/vector.h>
+
+#include "RigidBody.h"
+
+namespace yage::physics3d
+{
+    /**
+     * A ray or the path of a swept shape for scene queries.
+     */
+    struct Ray
+    {
+        math::Vec3d origin{};
+
+        /**
+         * The direction of the ray, which doesn't need to be normalized.
+         */
+        math::Vec3d direction{0, 0, -1};
+
+        /**
+         * The length of the ray in meters.
+         */
+        double max_distance{1};
+    };
+
+    /**
+     * The closest hit of a ray or swept shape on the colliders of a simulation.
+     */
+    struct QueryHit
+    {
+        RigidBodyHandle body;
+
+        /**
+         * The point on the collider that is hit, in world space.
+         */
+        math::Vec3d point{};
+
+        /**
+         * The surface normal of the collider at the hit point, pointing towards the origin of the ray.
+         */
+        math::Vec3d normal{};
+
+        /**
+         * The distance along the ray from its origin to the hit, in meters.
+         */
+        double distance{};
+    };
+}
@@ -3,86 +3,169 @@
 
 namespace yage::physics3d
 {
-    RigidBody::RigidBody(const InertiaShape& inertia_shape,
-                         const Collider& bounding_volume,
-                         const Material& material,
-                         const math::Vec3d& initial_position,
-                         const math::Quatd& initial_orientation,
-                         const math::Vec3d& bounding_volume_offset)
+    template<typename Scalar>
+    BasicRigidBody<Scalar>::BasicRigidBody(BasicBodyStore<Scalar>& store,
+                                           const std::size_t id,
+                                           const InertiaShape& inertia_shape,
+                                           const Collider& bounding_volume,
+                                           const Material& material,
+                                           const math::Vec3d& initial_position,
+                                           const math::Quatd& initial_orientation,
+                                           const math::Vec3d& bounding_volume_offset)
             : material(material),
-              m_position(initial_position),
-              m_orientation(initial_orientation),
-              m_inertia_shape(inertia_shape),
+              m_store(&store),
+              m_id(id),
               m_collider(bounding_volume),
               m_collider_offset(bounding_volume_offset)
     {
+        store.reset(id, inertia_shape, initial_position, initial_orientation);
         update_collider();
     }
 
-    void RigidBody::apply_force(const math::Vec3d& force, const math::Vec3d& point)
+    template<typename Scalar>
+    void BasicRigidBody<Scalar>::apply_force(const math::Vec3d& force, const math::Vec3d& point)
     {
-        m_force += force;
-        m_torque += cross(force, math::Vec3d(point - m_position));
+        m_store->apply_force(m_id, force, cross(force, math::Vec3d(point - position())));
+        wake_up();
     }
 
-    void RigidBody::update_collider()
+    template<typename Scalar>
+    void BasicRigidBody<Scalar>::update_collider()
     {
         if (!m_collider.has_value())
             return;
 
+        const math::Vec3d position = m_store->position(m_id);
+        const math::Quatd orientation = m_store->orientation(m_id);
         std::visit(utils::overload{
-                [this](colliders::Sphere& sphere) {
-                    sphere.center = m_position + m_collider_offset;
+                [this, &position](colliders::Sphere& sphere) {
+                    sphere.center = position + m_collider_offset;
                 },
-                [this](colliders::OrientedPlane& plane) {
-                    plane.support = m_position + m_collider_offset;
-                    plane.normal = m_orientation * plane.original_normal;
+                [this, &position, &orientation](colliders::OrientedPlane& plane) {
+                    plane.support = position + m_collider_offset;
+                    plane.normal = orientation * plane.original_normal;
                 },
-                [this](colliders::OrientedBox& box) {
-                    box.center = m_position + m_collider_offset;
-                    box.orientation = m_orientation;
+                [this, &position, &orientation](colliders::OrientedBox& box) {
+                    box.center = position + m_collider_offset;
+                    box.orientation = orientation;
                     box.update_computed_values();
                 },
+                [this, &position, &orientation](colliders::Convex& convex) {
+                    convex.center = position + m_collider_offset;
+                    convex.orientation = orientation;
+                },
+                [this, &position, &orientation](colliders::Mesh& mesh) {
+                    mesh.center = position + m_collider_offset;
+                    mesh.orientation = orientation;
+                },
+                [this, &position, &orientation](colliders::Heightfield& heightfield) {
+                    heightfield.center = position + m_collider_offset;
+                    heightfield.orientation = orientation;
+                },
+                [this, &position, &orientation](colliders::Compound& compound) {
+                    compound.center = position + m_collider_offset;
+                    compound.orientation = orientation;
+                },
         }, m_collider.value());
     }
 
-    math::Vec3d RigidBody::position() const
+    template<typename Scalar>
+    math::Vec3d BasicRigidBody<Scalar>::position() const
+    {
+        return m_store->position(m_id);
+    }
+
+    template<typename Scalar>
+    math::Quatd BasicRigidBody<Scalar>::orientation() const
+    {
+        return m_store->orientation(m_id);
+    }
+
+    template<typename Scalar>
+    math::Vec3d BasicRigidBody<Scalar>::velocity() const
+    {
+        return m_store->velocity(m_id);
+    }
+
+    template<typename Scalar>
+    math::Vec3d BasicRigidBody<Scalar>::angular_velocity() const
     {
-        return m_position;
+        return m_store->angular_velocity(m_id);
     }
 
-    math::Quatd RigidBody::orientation() const
+    template<typename Scalar>
+    math::Vec3d BasicRigidBody<Scalar>::force() const
     {
-        return m_orientation;
+        return m_store->force(m_id);
     }
 
-    math::Vec3d RigidBody::velocity() const
+    template<typename Scalar>
+    math::Vec3d BasicRigidBody<Scalar>::torque() const
     {
-        return m_velocity;
+        return m_store->torque(m_id);
     }
 
-    math::Vec3d RigidBody::angular_velocity() const
+    template<typename Scalar>
+    bool BasicRigidBody<Scalar>::should_ignore() const
     {
-        return m_angular_velocity;
+        return m_destruction_pending;
     }
 
-    math::Vec3d RigidBody::force() const
+    template<typename Scalar>
+    void BasicRigidBody<Scalar>::destroy()
     {
-        return m_force;
+        if (!m_destruction_pending) {
+            m_destruction_pending = true;
+            m_destruction_queue->push_back(m_handle);
+        }
     }
 
-    math::Vec3d RigidBody::torque() const
+    template<typename Scalar>
+    void BasicRigidBody<Scalar>::wake_up()
     {
-        return m_torque;
+        m_sleep_timer = 0;
+        if (m_sleeping_island.has_value()) {
+            m_wake_up_pending = true;
+        }
     }
 
-    bool RigidBody::should_ignore() const
+    template<typename Scalar>
+    bool BasicRigidBody<Scalar>::is_sleeping() const
     {
-        return m_destroyed || m_destruction_pending;
+        return m_sleeping_island.has_value() && !m_wake_up_pending;
     }
 
-    void RigidBody::destroy()
+    template<typename Scalar>
+    void BasicRigidBody<Scalar>::enable_ccd()
     {
-        m_destruction_pending = true;
+        m_ccd = true;
     }
+
+    template<typename Scalar>
+    void BasicRigidBody<Scalar>::disable_ccd()
+    {
+        m_ccd = false;
+    }
+
+    template<typename Scalar>
+    bool BasicRigidBody<Scalar>::is_ccd_enabled() const
+    {
+        return m_ccd;
+    }
+
+    template<typename Scalar>
+    void BasicRigidBody<Scalar>::set_collision_filter(const CollisionFilter& filter)
+    {
+        m_collision_filter = filter;
+        m_collision_filter_pending = true;
+    }
+
+    template<typename Scalar>
+    const CollisionFilter& BasicRigidBody<Scalar>::collision_filter() const
+    {
+        return m_collision_filter;
+    }
+
+    template class BasicRigidBody<float>;
+    template class BasicRigidBody<double>;
 }
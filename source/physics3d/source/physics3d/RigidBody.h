@@ -1,19 +1,37 @@
 #pragma once
 
+#include <cstdint>
+#include <vector>
+
 #include <math/vector.h>
 #include <math/quaternion.h>
 
 #include "InertiaShape.h"
+#include "BodyStore.h"
 #include "BoundingShape.h"
+#include "Broadphase.h"
 
 namespace yage::physics3d
 {
+    template<typename Scalar>
+    class BasicSimulation;
+
+    /**
+     * Refers to a rigid body in a simulation. Handles consist of a slot that maps to the current position of the body
+     * in the simulation, and the generation of the slot when the body was created. Once the body has been removed,
+     * the slot is reused with a new generation, so that the simulation can tell stale handles apart.
+     */
     class RigidBodyHandle
     {
+    public:
+        bool operator==(const RigidBodyHandle&) const = default;
+
     private:
-        std::size_t id = 0;
+        std::uint32_t index = 0;
+        std::uint32_t generation = 0;
 
-        friend class Simulation;
+        template<typename>
+        friend class BasicSimulation;
     };
 
     /**
@@ -26,17 +44,30 @@ namespace yage::physics3d
         double rolling_friction{};
     };
 
-    class RigidBody
+    /**
+     * A rigid body in a simulation. The kinematic state of the body lives in the body store of the simulation, while
+     * the body itself only keeps data that is not needed during integration. The scalar type is the precision of the
+     * body store.
+     */
+    template<typename Scalar>
+    class BasicRigidBody
     {
     public:
         Material material;
 
-        RigidBody(const InertiaShape& inertia_shape,
-                  const Collider& bounding_volume,
-                  const Material& material,
-                  const math::Vec3d& initial_position,
-                  const math::Quatd& initial_orientation,
-                  const math::Vec3d& bounding_volume_offset = {});
+        /**
+         * Creates a rigid body and initializes its state in a body store.
+         * @param store The store that holds the kinematic state of the body. It must outlive the body.
+         * @param id The id of the body in the store.
+         */
+        BasicRigidBody(BasicBodyStore<Scalar>& store,
+                       std::size_t id,
+                       const InertiaShape& inertia_shape,
+                       const Collider& bounding_volume,
+                       const Material& material,
+                       const math::Vec3d& initial_position,
+                       const math::Quatd& initial_orientation,
+                       const math::Vec3d& bounding_volume_offset = {});
 
         /**
          * Applies a force at a given point.
@@ -46,11 +77,42 @@ namespace yage::physics3d
         void apply_force(const math::Vec3d& force, const math::Vec3d& point);
 
         /**
-         * Marks this rigid body for destruction before the next simulation step. While the object itself is not
-         * destroyed, it does get removed from the simulation.
+         * Marks this rigid body for destruction before the next simulation step, which removes it from the simulation
+         * and invalidates its handle as well as references to it. Sleeping bodies around it are woken up.
          */
         void destroy();
 
+        /**
+         * Wakes this body and all bodies of its island before the next simulation step.
+         */
+        void wake_up();
+
+        /**
+         * Enables continuous collision detection for this body, such that it doesn't tunnel through other colliders
+         * when it moves farther than the radius of its inner sphere in one step. The body stops at the time of
+         * impact instead, while the collision response follows in the next step.
+         */
+        void enable_ccd();
+
+        void disable_ccd();
+
+        [[nodiscard]]
+        bool is_ccd_enabled() const;
+
+        /**
+         * Changes which other bodies this body collides with, which takes effect in the next simulation step.
+         */
+        void set_collision_filter(const CollisionFilter& filter);
+
+        [[nodiscard]]
+        const CollisionFilter& collision_filter() const;
+
+        /**
+         * @return Whether this body is part of a resting island that is excluded from simulation until it is woken.
+         */
+        [[nodiscard]]
+        bool is_sleeping() const;
+
         [[nodiscard]]
         math::Vec3d position() const;
 
@@ -73,25 +135,46 @@ namespace yage::physics3d
         bool should_ignore() const;
 
     private:
-        math::Vec3d m_position;
-        math::Quatd m_orientation;
+        BasicBodyStore<Scalar>* m_store;
+        /**
+         * Position of the body in the dense arrays of the simulation, which changes when other bodies are removed.
+         */
+        std::size_t m_id;
+        RigidBodyHandle m_handle;
 
-        math::Vec3d m_velocity;
-        math::Vec3d m_angular_velocity;
+        std::optional<Collider> m_collider;
+        math::Vec3d m_collider_offset;
 
-        math::Vec3d m_force;
-        math::Vec3d m_torque;
+        std::uint32_t m_broadphase_proxy = Broadphase::null_proxy;
+        bool m_ccd = false;
 
-        InertiaShape m_inertia_shape;
+        CollisionFilter m_collision_filter;
+        bool m_collision_filter_pending = false;
 
-        std::optional<Collider> m_collider;
-        math::Vec3d m_collider_offset;
+        /**
+         * The sleeping island this body belongs to, or empty if the body is awake.
+         */
+        std::optional<std::size_t> m_sleeping_island;
+        bool m_wake_up_pending = false;
+        /**
+         * Time in seconds that this body has been resting.
+         */
+        double m_sleep_timer = 0;
 
         bool m_destruction_pending = false;
-        bool m_destroyed = false;
+        /**
+         * Handles of destroyed bodies that the simulation removes before the next step.
+         */
+        std::vector<RigidBodyHandle>* m_destruction_queue = nullptr;
 
         void update_collider();
 
-        friend class Simulation;
+        template<typename>
+        friend class BasicSimulation;
     };
+
+    extern template class BasicRigidBody<float>;
+    extern template class BasicRigidBody<double>;
+
+    using RigidBody = BasicRigidBody<double>;
 }
@@ -1,54 +1,25 @@
 #include "Simulation.h"
 #include "core/gl/color.h"
+#include <math/matrix.h>
 #include <math/quaternion.h>
 
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <memory>
+#include <numeric>
 #include <utility>
 
 namespace yage::physics3d
 {
-    Simulation::Simulation(Visualizer visualizer)
+    template<typename Scalar>
+    BasicSimulation<Scalar>::BasicSimulation(Visualizer visualizer)
     {
         m_visualizer = std::make_unique<Visualizer>(std::move(visualizer));
     }
 
-    math::Matd<12, 12> Simulation::inverse_mass_matrix(const RigidBody& a, const RigidBody& b)
-    {
-        // TODO: instead of this sparse matrix multiplication, use the direct formula for the effective mass matrix
-        math::Matd<12, 12> m_inv;
-        m_inv(0, 0) = a.m_inertia_shape.inverse_mass();
-        m_inv(1, 1) = a.m_inertia_shape.inverse_mass();
-        m_inv(2, 2) = a.m_inertia_shape.inverse_mass();
-        m_inv(3, 3) = b.m_inertia_shape.inverse_mass();
-        m_inv(4, 4) = b.m_inertia_shape.inverse_mass();
-        m_inv(5, 5) = b.m_inertia_shape.inverse_mass();
-
-        auto inv_inertia_a = a.m_inertia_shape.inverse_inertia_tensor();
-        m_inv(6, 6) = inv_inertia_a(0, 0);
-        m_inv(6, 7) = inv_inertia_a(0, 1);
-        m_inv(6, 8) = inv_inertia_a(0, 2);
-        m_inv(7, 6) = inv_inertia_a(1, 0);
-        m_inv(7, 7) = inv_inertia_a(1, 1);
-        m_inv(7, 8) = inv_inertia_a(1, 2);
-        m_inv(8, 6) = inv_inertia_a(2, 0);
-        m_inv(8, 7) = inv_inertia_a(2, 1);
-        m_inv(8, 8) = inv_inertia_a(2, 2);
-
-        auto inv_inertia_b = b.m_inertia_shape.inverse_inertia_tensor();
-        m_inv(9, 9) = inv_inertia_b(0, 0);
-        m_inv(9, 10) = inv_inertia_b(0, 1);
-        m_inv(9, 11) = inv_inertia_b(0, 2);
-        m_inv(10, 9) = inv_inertia_b(1, 0);
-        m_inv(10, 10) = inv_inertia_b(1, 1);
-        m_inv(10, 11) = inv_inertia_b(1, 2);
-        m_inv(11, 9) = inv_inertia_b(2, 0);
-        m_inv(11, 10) = inv_inertia_b(2, 1);
-        m_inv(11, 11) = inv_inertia_b(2, 2);
-
-        return m_inv;
-    }
-
-    std::tuple<math::Vec3d, math::Vec3d> Simulation::tangent_plane(const math::Vec3d& n)
+    template<typename Scalar>
+    std::tuple<math::Vec3d, math::Vec3d> BasicSimulation<Scalar>::tangent_plane(const math::Vec3d& n)
     {
         // TODO: this can be optimized if we simplify the formulas and assume |n| = 1
 
@@ -78,396 +49,1303 @@ namespace yage::physics3d
         return {u1, u2};
     }
 
-    double Simulation::solve_constraint(const Constraint& constraint)
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::update(const double dt)
     {
-        auto& a = constraint.rb_a;
-        auto& b = constraint.rb_b;
-
-        const math::Matd<12, 1> q_pre{
-                a.m_velocity.x(), a.m_velocity.y(), a.m_velocity.z(),
-                b.m_velocity.x(), b.m_velocity.y(), b.m_velocity.z(),
-                a.m_angular_velocity.x(), a.m_angular_velocity.y(), a.m_angular_velocity.z(),
-                b.m_angular_velocity.x(), b.m_angular_velocity.y(), b.m_angular_velocity.z(),
-        };
-
-        math::Matd<1, 1> nominator = -(constraint.j * q_pre + math::Matd<1, 1>(constraint.bias));
-        math::Matd<1, 1> denominator = constraint.j * constraint.m_inv * constraint.j_t;
-        const double delta_lambda = nominator(0, 0) / denominator(0, 0);
-
-        return delta_lambda;
-    }
+        if (m_substeps > 1) {
+            update_substepped(dt);
+            return;
+        }
 
-    void Simulation::update(const double dt)
-    {
+        if constexpr (profiling_enabled) {
+            m_statistics = {};
+        }
+        const ScopedTimer timer(m_statistics.step_time);
         remove_destroyed_bodies();
+        wake_up_bodies();
+        update_collision_filters();
         integrate_forces(dt);
         detect_collisions(dt);
         resolve_collisions(dt);
         integrate_positions(dt);
+        update_islands(dt);
         clear_forces();
+        // the constraints are rebuilt in the next step, so snapshots don't need to contain them
+        clear_constraints();
     }
 
-    void Simulation::update_staggered(const double dt)
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::update_staggered(const double dt)
     {
-        remove_destroyed_bodies();
+        if constexpr (profiling_enabled) {
+            m_statistics = {};
+        }
+        const ScopedTimer timer(m_statistics.step_time);
         resolve_collisions(dt);
         integrate_positions(dt);
+        update_islands(dt);
 
+        // the constraints of the previous collision detection refer to the bodies by id, so bodies can only be moved
+        // once they are resolved
+        remove_destroyed_bodies();
+        wake_up_bodies();
+        update_collision_filters();
         integrate_forces(dt);
         detect_collisions(dt);
         clear_forces();
     }
 
-    RigidBody& Simulation::lookup(const RigidBodyHandle handle)
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::update_substepped(const double dt)
+    {
+        if constexpr (profiling_enabled) {
+            m_statistics = {};
+        }
+        const ScopedTimer timer(m_statistics.step_time);
+        remove_destroyed_bodies();
+        wake_up_bodies();
+        update_collision_filters();
+
+        // the biases are computed for the full step, such that penetration is corrected at the same rate as without
+        // sub-stepping
+        const double substep_dt = dt / m_substeps;
+        detect_collisions(dt);
+        {
+            const ScopedTimer resolve_timer(m_statistics.resolve_collisions_time);
+            if (m_thread_pool) {
+                partition_contacts();
+            }
+            // the impulses accumulate over all substeps, so they are the impulses of the full step like without
+            // sub-stepping
+            if (m_warm_starting) {
+                warm_start();
+            }
+        }
+
+        begin_continuous_motion();
+        for (int i = 0; i < m_substeps; ++i) {
+            integrate_forces(substep_dt);
+            {
+                const ScopedTimer resolve_timer(m_statistics.resolve_collisions_time);
+                if (i > 0) {
+                    refresh_penetration_biases(substep_dt, true);
+                }
+                solve(1);
+            }
+            {
+                const ScopedTimer integrate_timer(m_statistics.integrate_positions_time);
+                m_body_store->integrate_positions(substep_dt);
+            }
+            // relax without position correction, which removes the velocity that the correction has added
+            const ScopedTimer resolve_timer(m_statistics.resolve_collisions_time);
+            refresh_penetration_biases(substep_dt, false);
+            solve(1);
+        }
+        {
+            const ScopedTimer resolve_timer(m_statistics.resolve_collisions_time);
+            if constexpr (profiling_enabled) {
+                m_statistics.residual = solver_residual();
+            }
+            if (m_warm_starting) {
+                store_contact_impulses();
+            }
+        }
+        {
+            const ScopedTimer integrate_timer(m_statistics.integrate_positions_time);
+            clamp_continuous_motion();
+            update_colliders(dt);
+        }
+
+        update_islands(dt);
+        clear_forces();
+        // the constraints are rebuilt in the next step, so snapshots don't need to contain them
+        clear_constraints();
+    }
+
+    template<typename Scalar>
+    bool BasicSimulation<Scalar>::contains(const RigidBodyHandle handle) const
     {
-        return m_bodies[handle.id];
+        return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation;
     }
 
-    void Simulation::enable_gravity()
+    template<typename Scalar>
+    typename BasicSimulation<Scalar>::RigidBody& BasicSimulation<Scalar>::lookup(const RigidBodyHandle handle)
+    {
+        assert(contains(handle));
+        return m_bodies[m_slots[handle.index].body];
+    }
+
+    template<typename Scalar>
+    const typename BasicSimulation<Scalar>::RigidBody&
+    BasicSimulation<Scalar>::lookup(const RigidBodyHandle handle) const
+    {
+        assert(contains(handle));
+        return m_bodies[m_slots[handle.index].body];
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::enable_gravity()
     {
         m_external_acceleration = {0, -9.81, 0};
     }
 
-    void Simulation::disable_gravity()
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::disable_gravity()
     {
         m_external_acceleration = {0, 0, 0};
     }
 
-    Constraint
-    Simulation::prepare_penetration_constraint(RigidBody& rb_a, RigidBody& rb_b, const ContactManifold& manifold,
-                                               const ContactPoint& contact, const double dt) const
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::set_solver_iterations(const int iterations)
     {
-        math::Vec3d temp_1 = cross(contact.r_a, manifold.normal);
-        math::Vec3d temp_2 = cross(contact.r_b, manifold.normal);
-        const math::Matd<1, 12> j{
-                -manifold.normal.x(), -manifold.normal.y(), -manifold.normal.z(),
-                manifold.normal.x(), manifold.normal.y(), manifold.normal.z(),
-                -temp_1.x(), -temp_1.y(), -temp_1.z(),
-                temp_2.x(), temp_2.y(), temp_2.z(),
-        };
+        m_solver_iterations = iterations;
+    }
 
-        const double baumgarte_bias = -m_baumgarte_factor / dt * std::max(contact.depth - m_penetration_slop, 0.0);
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::enable_substepping(const int substeps)
+    {
+        m_substeps = std::max(substeps, 1);
+    }
 
-        // TODO: maybe we can scale the restitution slop with something
-        const double restitution = std::min(rb_a.material.restitution, rb_b.material.restitution);
-        const double restitution_bias = restitution * std::min(contact.rel_v_n + m_restitution_slop, 0.0);
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::disable_substepping()
+    {
+        m_substeps = 1;
+    }
 
-        return {
-                .m_inv = inverse_mass_matrix(rb_a, rb_b),
-                .j = j,
-                .j_t = transpose(j),
-                // don't add the biases, since the baumgarte bias is already satisfied if there's enough restitution
-                .bias = std::min(baumgarte_bias, restitution_bias),
-                .rb_a = rb_a,
-                .rb_b = rb_b,
-        };
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::enable_warm_starting()
+    {
+        m_warm_starting = true;
     }
 
-    std::tuple<Constraint, Constraint>
-    Simulation::prepare_friction_constraints(RigidBody& rb_a, RigidBody& rb_b, const ContactManifold& manifold,
-                                             const ContactPoint& contact)
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::disable_warm_starting()
     {
-        // friction along first tangent
-        math::Vec3d temp_1 = cross(contact.r_a, manifold.tangent_1);
-        math::Vec3d temp_2 = cross(contact.r_b, manifold.tangent_1);
-        const math::Matd<1, 12> j_1{
-                -manifold.tangent_1.x(), -manifold.tangent_1.y(), -manifold.tangent_1.z(),
-                manifold.tangent_1.x(), manifold.tangent_1.y(), manifold.tangent_1.z(),
-                -temp_1.x(), -temp_1.y(), -temp_1.z(),
-                temp_2.x(), temp_2.y(), temp_2.z(),
-        };
+        m_warm_starting = false;
+        m_contact_cache.clear();
+    }
 
-        // friction along second tangent
-        temp_1 = cross(contact.r_a, manifold.tangent_2);
-        temp_2 = cross(contact.r_b, manifold.tangent_2);
-        const math::Matd<1, 12> j_2{
-                -manifold.tangent_2.x(), -manifold.tangent_2.y(), -manifold.tangent_2.z(),
-                manifold.tangent_2.x(), manifold.tangent_2.y(), manifold.tangent_2.z(),
-                -temp_1.x(), -temp_1.y(), -temp_1.z(),
-                temp_2.x(), temp_2.y(), temp_2.z(),
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::enable_block_solver()
+    {
+        m_block_solver = true;
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::disable_block_solver()
+    {
+        m_block_solver = false;
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::set_thread_count(const std::size_t threads)
+    {
+        if (threads <= 1) {
+            m_thread_pool.reset();
+        } else {
+            m_thread_pool = std::make_unique<ThreadPool>(threads);
+        }
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::enable_sleeping()
+    {
+        m_sleeping = true;
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::disable_sleeping()
+    {
+        m_sleeping = false;
+        for (std::size_t island = 0; island < m_sleeping_islands.size(); ++island) {
+            if (!m_sleeping_islands[island].empty()) {
+                wake_up_island(island);
+            }
+        }
+    }
+
+    template<typename Scalar>
+    std::size_t BasicSimulation<Scalar>::body_count() const
+    {
+        return m_bodies.size();
+    }
+
+    template<typename Scalar>
+    std::size_t BasicSimulation<Scalar>::awake_body_count() const
+    {
+        return m_awake_body_count;
+    }
+
+    template<typename Scalar>
+    std::size_t BasicSimulation<Scalar>::island_count() const
+    {
+        return m_island_count;
+    }
+
+    template<typename Scalar>
+    const StepStatistics& BasicSimulation<Scalar>::statistics() const
+    {
+        return m_statistics;
+    }
+
+    template<typename Scalar>
+    std::optional<QueryHit> BasicSimulation<Scalar>::raycast(const Ray& ray) const
+    {
+        return cast(colliders::Sphere{.center = ray.origin, .radius = 0}, ray);
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::raycast(const std::span<const Ray> rays,
+                                          const std::span<std::optional<QueryHit>> hits) const
+    {
+        assert(rays.size() == hits.size());
+        auto cast_rays = [this, rays, hits](const std::size_t begin, const std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                hits[i] = raycast(rays[i]);
+            }
         };
+        if (m_thread_pool) {
+            m_thread_pool->parallel_for(rays.size(), [&cast_rays](const std::size_t begin, const std::size_t end,
+                                                                   std::size_t) {
+                cast_rays(begin, end);
+            });
+        } else {
+            cast_rays(0, rays.size());
+        }
+    }
 
-        const auto m_inv = inverse_mass_matrix(rb_a, rb_b);
-        return {
-                {
-                        .m_inv = m_inv,
-                        .j = j_1,
-                        .j_t = transpose(j_1),
-                        .rb_a = rb_a,
-                        .rb_b = rb_b,
-                },
-                {
-                        .m_inv = m_inv,
-                        .j = j_2,
-                        .j_t = transpose(j_2),
-                        .rb_a = rb_a,
-                        .rb_b = rb_b,
-                }
+    template<typename Scalar>
+    std::optional<QueryHit> BasicSimulation<Scalar>::sphere_cast(const Ray& ray, const double radius) const
+    {
+        return cast(colliders::Sphere{.center = ray.origin, .radius = radius}, ray);
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::overlap(const geometry::AABB& aabb, std::vector<RigidBodyHandle>& bodies) const
+    {
+        bodies.clear();
+        auto report = [this, &aabb, &bodies](const std::size_t id) {
+            const RigidBody& rb = m_bodies[id];
+            if (!rb.should_ignore() && geometry::overlaps(world_bounds(rb.m_collider.value()), aabb)) {
+                bodies.push_back(make_handle(id));
+            }
         };
+        m_broadphase.query(aabb, report);
+        m_broadphase.query_unbounded(aabb, report);
     }
 
-    std::tuple<Constraint, Constraint, Constraint>
-    Simulation::prepare_rolling_friction_constraints(RigidBody& rb_a, RigidBody& rb_b, const ContactManifold& manifold)
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::overlap(const Collider& shape, std::vector<RigidBodyHandle>& bodies) const
     {
-        const math::Matd<1, 12> j_0{
-                0, 0, 0,
-                0, 0, 0,
-                -manifold.normal.x(), -manifold.normal.y(), -manifold.normal.z(),
-                manifold.normal.x(), manifold.normal.y(), manifold.normal.z(),
+        bodies.clear();
+        auto report = [this, &shape, &bodies](const std::size_t id) {
+            const RigidBody& rb = m_bodies[id];
+            if (!rb.should_ignore() && std::visit(m_collision_visitor, shape, rb.m_collider.value()).has_value()) {
+                bodies.push_back(make_handle(id));
+            }
         };
+        const geometry::AABB aabb = world_bounds(shape);
+        m_broadphase.query(aabb, report);
+        m_broadphase.query_unbounded(aabb, report);
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::save(Snapshot& snapshot) const
+    {
+        SnapshotWriter writer(snapshot);
+        writer.write(m_external_acceleration);
+        writer.write(m_slots);
+        writer.write(m_free_slots.size());
+        for (const std::uint32_t slot: m_free_slots) {
+            writer.write(slot);
+        }
+        writer.write(m_bodies);
+        writer.write(*m_destruction_queue);
+        m_body_store->save(writer);
+        m_broadphase.save(writer);
+        m_narrowphase.save(writer);
+
+        // constraints are only kept between steps by update_staggered, which resolves them in the next step
+        m_penetration_constraints.save(writer);
+        m_friction_constraints.save(writer);
+        m_rolling_friction_constraints.save(writer);
+        writer.write(m_contact_keys);
+        writer.write(m_manifold_rows);
+        m_contact_cache.save(writer);
+        // the staggered update groups bodies into islands before it detects the collisions of the next step
+        writer.write(m_island_parent);
+
+        writer.write(m_sleeping_islands.size());
+        for (const std::vector<std::size_t>& island: m_sleeping_islands) {
+            writer.write(island);
+        }
+        writer.write(m_free_sleeping_islands);
+        writer.write(m_awake_body_count);
+        writer.write(m_island_count);
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::restore(const Snapshot& snapshot)
+    {
+        SnapshotReader reader(snapshot);
+        reader.read(m_external_acceleration);
+        reader.read(m_slots);
+        std::size_t free_slots;
+        reader.read(free_slots);
+        m_free_slots.clear();
+        for (std::size_t i = 0; i < free_slots; ++i) {
+            reader.read(m_free_slots.emplace_back());
+        }
+        reader.read(m_bodies);
+        reader.read(*m_destruction_queue);
+        for (RigidBody& rb: m_bodies) {
+            rb.m_store = m_body_store.get();
+            rb.m_destruction_queue = m_destruction_queue.get();
+        }
+        m_body_store->restore(reader);
+        m_broadphase.restore(reader);
+        m_narrowphase.restore(reader);
 
-        const math::Matd<1, 12> j_1{
-                0, 0, 0,
-                0, 0, 0,
-                -manifold.tangent_1.x(), -manifold.tangent_1.y(), -manifold.tangent_1.z(),
-                manifold.tangent_1.x(), manifold.tangent_1.y(), manifold.tangent_1.z(),
+        m_penetration_constraints.restore(reader);
+        m_friction_constraints.restore(reader);
+        m_rolling_friction_constraints.restore(reader);
+        reader.read(m_contact_keys);
+        reader.read(m_manifold_rows);
+        m_contact_cache.restore(reader);
+        reader.read(m_island_parent);
+
+        std::size_t sleeping_islands;
+        reader.read(sleeping_islands);
+        m_sleeping_islands.resize(sleeping_islands);
+        for (std::vector<std::size_t>& island: m_sleeping_islands) {
+            reader.read(island);
+        }
+        reader.read(m_free_sleeping_islands);
+        reader.read(m_awake_body_count);
+        reader.read(m_island_count);
+        assert(reader.at_end());
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::prepare_penetration_constraint(RigidBody& rb_a, RigidBody& rb_b,
+                                                                 const ContactManifold& manifold,
+                                                                 const ContactPoint& contact, const double dt)
+    {
+        const Jacobian j{
+                .linear_a = -manifold.normal,
+                .linear_b = manifold.normal,
+                .angular_a = -cross(contact.r_a, manifold.normal),
+                .angular_b = cross(contact.r_b, manifold.normal),
         };
 
-        const math::Matd<1, 12> j_2{
-                0, 0, 0,
-                0, 0, 0,
-                -manifold.tangent_2.x(), -manifold.tangent_2.y(), -manifold.tangent_2.z(),
-                manifold.tangent_2.x(), manifold.tangent_2.y(), manifold.tangent_2.z(),
+        const double baumgarte_bias = -m_baumgarte_factor / dt * std::max(contact.depth - m_penetration_slop, 0.0);
+
+        // TODO: maybe we can scale the restitution slop with something
+        const double restitution = std::min(rb_a.material.restitution, rb_b.material.restitution);
+        const double restitution_bias = restitution * std::min(contact.rel_v_n + m_restitution_slop, 0.0);
+
+        // don't add the biases, since the baumgarte bias is already satisfied if there's enough restitution
+        m_penetration_constraints.add(*m_body_store, rb_a.m_id, rb_b.m_id, j, std::min(baumgarte_bias, restitution_bias));
+
+        if (m_substeps > 1) {
+            m_contact_anchors.push_back({
+                    .local_a = conjugate(m_body_store->orientation(rb_a.m_id)) *
+                               (contact.p_a - m_body_store->position(rb_a.m_id)),
+                    .local_b = conjugate(m_body_store->orientation(rb_b.m_id)) *
+                               (contact.p_b - m_body_store->position(rb_b.m_id)),
+                    .normal = manifold.normal,
+                    .restitution_bias = restitution_bias,
+            });
+        }
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::prepare_friction_constraints(RigidBody& rb_a, RigidBody& rb_b,
+                                                               const ContactManifold& manifold,
+                                                               const ContactPoint& contact)
+    {
+        // friction along first tangent
+        const Jacobian j_1{
+                .linear_a = -manifold.tangent_1,
+                .linear_b = manifold.tangent_1,
+                .angular_a = -cross(contact.r_a, manifold.tangent_1),
+                .angular_b = cross(contact.r_b, manifold.tangent_1),
         };
 
-        const auto m_inv = inverse_mass_matrix(rb_a, rb_b);
-        return {
-                {
-                        .m_inv = m_inv,
-                        .j = j_0,
-                        .j_t = transpose(j_0),
-                        .rb_a = rb_a,
-                        .rb_b = rb_b,
-                },
-                {
-                        .m_inv = m_inv,
-                        .j = j_1,
-                        .j_t = transpose(j_1),
-                        .rb_a = rb_a,
-                        .rb_b = rb_b,
-                },
-                {
-                        .m_inv = m_inv,
-                        .j = j_2,
-                        .j_t = transpose(j_2),
-                        .rb_a = rb_a,
-                        .rb_b = rb_b,
-                }
+        // friction along second tangent
+        const Jacobian j_2{
+                .linear_a = -manifold.tangent_2,
+                .linear_b = manifold.tangent_2,
+                .angular_a = -cross(contact.r_a, manifold.tangent_2),
+                .angular_b = cross(contact.r_b, manifold.tangent_2),
         };
+
+        m_friction_constraints.add(*m_body_store, rb_a.m_id, rb_b.m_id, j_1, 0);
+        m_friction_constraints.add(*m_body_store, rb_a.m_id, rb_b.m_id, j_2, 0);
     }
 
-    void Simulation::apply_impulse(const Constraint& constraint, const math::Matd<12, 1>& impulse)
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::prepare_rolling_friction_constraints(RigidBody& rb_a, RigidBody& rb_b,
+                                                                       const ContactManifold& manifold)
     {
-        auto delta_q = constraint.m_inv * impulse;
-        constraint.rb_a.m_velocity += {delta_q(0, 0), delta_q(1, 0), delta_q(2, 0)};
-        constraint.rb_b.m_velocity += {delta_q(3, 0), delta_q(4, 0), delta_q(5, 0)};
-        constraint.rb_a.m_angular_velocity += {delta_q(6, 0), delta_q(7, 0), delta_q(8, 0)};
-        constraint.rb_b.m_angular_velocity += {delta_q(9, 0), delta_q(10, 0), delta_q(11, 0)};
+        for (const math::Vec3d& axis: {manifold.normal, manifold.tangent_1, manifold.tangent_2}) {
+            const Jacobian j{
+                    .linear_a = math::Vec3d(),
+                    .linear_b = math::Vec3d(),
+                    .angular_a = -axis,
+                    .angular_b = axis,
+            };
+            m_rolling_friction_constraints.add(*m_body_store, rb_a.m_id, rb_b.m_id, j, 0);
+        }
     }
 
-    void Simulation::resolve_penetration_constraint(Constraint& constraint)
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::resolve_penetration_constraint(const std::size_t row)
     {
         // accumulate impulses
-        const double old_lambda = constraint.accumulated_lambda;
-        double delta_lambda = solve_constraint(constraint);
+        Scalar& accumulated_lambda = m_penetration_constraints.accumulated_lambda(row);
+        const Scalar old_lambda = accumulated_lambda;
+        const Scalar delta_lambda = m_penetration_constraints.solve(*m_body_store, row);
         // clamp to prevent objects pulling together for negative lambdas
-        constraint.accumulated_lambda = std::max(0.0, constraint.accumulated_lambda + delta_lambda);
+        accumulated_lambda = std::max(Scalar(0), accumulated_lambda + delta_lambda);
         // restore delta lambda after clamping
-        delta_lambda = constraint.accumulated_lambda - old_lambda;
-        const auto delta_impulse = delta_lambda * constraint.j_t;
-        apply_impulse(constraint, delta_impulse);
+        m_penetration_constraints.apply_impulse(*m_body_store, row, accumulated_lambda - old_lambda);
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::resolve_penetration_block(const ManifoldRows& manifold)
+    {
+        constexpr std::size_t max_contacts = 4;
+        if (manifold.count == 1 || manifold.count > max_contacts) {
+            for (std::size_t row = manifold.begin; row < manifold.begin + manifold.count; ++row) {
+                resolve_penetration_constraint(row);
+            }
+            return;
+        }
+
+        // The accumulated impulses x of the contacts have to satisfy the complementarity conditions x >= 0,
+        // w = A * x + b >= 0, and x_i * w_i = 0, where w are the relative normal velocities after applying the
+        // impulses. Unused contacts of the fixed-size system are decoupled through identity rows.
+        using Matrix = math::Matrix<Scalar, max_contacts, max_contacts>;
+        using Vector = math::Vector<Scalar, max_contacts>;
+        Matrix a = math::matrix::Id<Scalar, max_contacts>;
+        Vector b;
+        Vector old_lambda;
+        for (std::size_t i = 0; i < manifold.count; ++i) {
+            const std::size_t row = manifold.begin + i;
+            for (std::size_t j = 0; j <= i; ++j) {
+                a(i, j) = a(j, i) = m_penetration_constraints.coupling(row, manifold.begin + j);
+            }
+            b(i) = m_penetration_constraints.velocity_error(*m_body_store, row);
+            old_lambda(i) = m_penetration_constraints.accumulated_lambda(row);
+        }
+        // remove the accumulated impulses from the velocities, which are already part of them
+        b -= a * old_lambda;
+
+        // Enumerate which contacts are active, i.e. push the bodies apart, starting with all of them. The rows of four
+        // coplanar contacts are linearly dependent, so the decomposition rejects them and three contacts are tried.
+        constexpr std::array<unsigned, 16> active_sets{
+                0b1111, 0b0111, 0b1011, 0b1101, 0b1110, 0b0011, 0b0101, 0b0110, 0b1001, 0b1010, 0b1100,
+                0b0001, 0b0010, 0b0100, 0b1000, 0b0000,
+        };
+        // contacts that are almost dependent on the others, e.g. two nearby points of an edge, are rejected as well
+        constexpr Scalar pivot_tolerance = 1e-4;
+        // the velocity at an inactive contact whose row depends on the active rows is only zero up to rounding
+        constexpr Scalar tolerance = 1e-6;
+        for (const unsigned active: active_sets) {
+            if (active >> manifold.count != 0) {
+                continue;
+            }
+
+            Matrix a_active = a;
+            Vector rhs;
+            for (std::size_t i = 0; i < max_contacts; ++i) {
+                if (active & (1u << i)) {
+                    rhs(i) = -b(i);
+                    continue;
+                }
+                for (std::size_t j = 0; j < max_contacts; ++j) {
+                    a_active(i, j) = a_active(j, i) = 0;
+                }
+                a_active(i, i) = 1;
+            }
+
+            const std::optional<math::LdltDecomposition<Scalar, max_contacts>> decomposition =
+                    math::ldlt(a_active, pivot_tolerance);
+            if (!decomposition) {
+                continue;
+            }
+            const Vector lambda = math::solve(decomposition.value(), rhs);
+            const Vector velocity = a * lambda + b;
+
+            bool solved = true;
+            for (std::size_t i = 0; i < manifold.count; ++i) {
+                solved = solved && ((active & (1u << i)) != 0 ? lambda(i) : velocity(i)) >= -tolerance;
+            }
+            if (!solved) {
+                continue;
+            }
+
+            for (std::size_t i = 0; i < manifold.count; ++i) {
+                const std::size_t row = manifold.begin + i;
+                const Scalar accumulated_lambda = std::max(Scalar(0), lambda(i));
+                m_penetration_constraints.accumulated_lambda(row) = accumulated_lambda;
+                m_penetration_constraints.apply_impulse(*m_body_store, row, accumulated_lambda - old_lambda(i));
+            }
+            return;
+        }
+
+        for (std::size_t row = manifold.begin; row < manifold.begin + manifold.count; ++row) {
+            resolve_penetration_constraint(row);
+        }
     }
 
-    void Simulation::resolve_friction_constraint(Constraint& constraint)
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::resolve_friction_constraint(const std::size_t row)
     {
         // accumulate impulses
-        const double old_lambda = constraint.accumulated_lambda;
-        double delta_lambda = solve_constraint(constraint);
+        Scalar& accumulated_lambda = m_friction_constraints.accumulated_lambda(row);
+        const Scalar old_lambda = accumulated_lambda;
+        const Scalar delta_lambda = m_friction_constraints.solve(*m_body_store, row);
         // clamp with accumulated normal impulse for the Coulomb friction model
-        const double friction_coefficient =
-                constraint.rb_a.material.kinetic_friction *
-                constraint.rb_b.material.kinetic_friction;
-        const double lambda_n = constraint.dependent_constraint.value()->accumulated_lambda;
-        constraint.accumulated_lambda = math::clamp(
-                constraint.accumulated_lambda + delta_lambda,
-                -friction_coefficient * lambda_n,
-                friction_coefficient * lambda_n);
+        const Scalar limit = friction_limit(row);
+        accumulated_lambda = math::clamp(accumulated_lambda + delta_lambda, -limit, limit);
         // restore delta lambda after clamping
-        delta_lambda = constraint.accumulated_lambda - old_lambda;
-        const auto delta_impulse = delta_lambda * constraint.j_t;
-        apply_impulse(constraint, delta_impulse);
+        m_friction_constraints.apply_impulse(*m_body_store, row, accumulated_lambda - old_lambda);
     }
 
-    void Simulation::resolve_rolling_friction_constraint(Constraint& constraint)
+    template<typename Scalar>
+    Scalar BasicSimulation<Scalar>::friction_limit(const std::size_t row) const
+    {
+        const Scalar friction_coefficient =
+                m_bodies[m_friction_constraints.body_a(row)].material.kinetic_friction *
+                m_bodies[m_friction_constraints.body_b(row)].material.kinetic_friction;
+        return friction_coefficient * m_penetration_constraints.accumulated_lambda(row / 2);
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::resolve_rolling_friction_constraint(const std::size_t row)
     {
-        solve_constraint(constraint);
         // accumulate impulses TODO: is clamping necessary?
-        const double delta_lambda = solve_constraint(constraint);
-        constraint.accumulated_lambda += delta_lambda;
+        const Scalar delta_lambda = m_rolling_friction_constraints.solve(*m_body_store, row);
+        m_rolling_friction_constraints.accumulated_lambda(row) += delta_lambda;
 
-        const double friction_coefficient =
-                constraint.rb_a.material.rolling_friction *
-                constraint.rb_b.material.rolling_friction;
+        const Scalar friction_coefficient =
+                m_bodies[m_rolling_friction_constraints.body_a(row)].material.rolling_friction *
+                m_bodies[m_rolling_friction_constraints.body_b(row)].material.rolling_friction;
         // TODO: can we do something more physically accurate?
-        const auto delta_impulse = friction_coefficient * delta_lambda * constraint.j_t;
-        apply_impulse(constraint, delta_impulse);
+        m_rolling_friction_constraints.apply_impulse(*m_body_store, row, friction_coefficient * delta_lambda);
     }
 
-    void Simulation::visualize_collisions(const math::Mat4d& projection, const math::Mat4d& view) const
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::visualize_collisions(const math::Mat4d& projection, const math::Mat4d& view) const
     {
         if (m_visualizer) {
             m_visualizer->draw(projection, view);
         }
     }
 
-    void Simulation::integrate_forces(const double dt)
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::integrate_forces(const double dt)
+    {
+        const ScopedTimer timer(m_statistics.integrate_forces_time);
+        m_body_store->integrate_forces(m_external_acceleration, dt);
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::integrate_positions(const double dt)
+    {
+        const ScopedTimer timer(m_statistics.integrate_positions_time);
+        begin_continuous_motion();
+        m_body_store->integrate_positions(dt);
+        clamp_continuous_motion();
+        update_colliders(dt);
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::update_colliders(const double dt)
     {
-        for (RigidBody& rb : m_bodies) {
-            if (rb.should_ignore()) {
+        for (RigidBody& rb: m_bodies) {
+            if (rb.should_ignore() || rb.m_sleeping_island.has_value()) {
                 continue;
             }
 
-            // external forces
-            if (rb.m_inertia_shape.inverse_mass() > 0) {
-                rb.m_velocity += m_external_acceleration * dt;
+            rb.update_collider();
+            if (rb.m_broadphase_proxy != Broadphase::null_proxy) {
+                m_broadphase.move_proxy(rb.m_broadphase_proxy, rb.m_collider.value(),
+                                        m_body_store->velocity(rb.m_id) * dt);
             }
+        }
+    }
 
-            // linear component
-            rb.m_velocity += rb.m_inertia_shape.inverse_mass() * rb.m_force * dt;
-
-            // angular component
-            rb.m_angular_velocity += rb.m_inertia_shape.inverse_inertia_tensor() * rb.m_torque * dt;
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::begin_continuous_motion()
+    {
+        m_ccd_positions.clear();
+        for (const RigidBody& rb: m_bodies) {
+            if (rb.m_ccd && !rb.should_ignore() && is_simulated(rb) && rb.m_collider.has_value()) {
+                m_ccd_positions.emplace_back(rb.m_id, m_body_store->position(rb.m_id));
+            }
         }
     }
 
-    void Simulation::integrate_positions(const double dt)
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::clamp_continuous_motion()
     {
-        for (RigidBody& rb: m_bodies) {
-            if (rb.should_ignore()) {
+        for (const auto& [id, start]: m_ccd_positions) {
+            // the collider has not been moved yet, so it is still at the start of the motion
+            const std::optional<colliders::Sphere> sphere = inner_sphere(m_bodies[id].m_collider.value());
+            if (!sphere.has_value()) {
                 continue;
             }
 
-            // linear component
-            rb.m_position += rb.m_velocity * dt;
+            // slower bodies can't tunnel, since they overlap with a collider before they can pass its center
+            const math::Vec3d displacement = m_body_store->position(id) - start;
+            const double distance = length(displacement);
+            if (distance <= sphere->radius) {
+                continue;
+            }
 
-            // angular component
-            rb.m_orientation += 0.5 * math::Quatd(rb.m_angular_velocity) * rb.m_orientation * dt;
-            rb.m_orientation.normalize();
+            // other bodies are treated as stationary at their positions at the start of the step
+            double time_of_impact = 1;
+            auto sweep = [this, id, &sphere, &displacement, &time_of_impact](const std::size_t other_id) {
+                const RigidBody& other = m_bodies[other_id];
+                if (other_id == id || other.should_ignore() || !other.m_collider.has_value() ||
+                    !m_bodies[id].m_collision_filter.collides_with(other.m_collision_filter)) {
+                    return;
+                }
+                if (const std::optional<double> t = physics3d::time_of_impact(
+                            sphere.value(), displacement, other.m_collider.value())) {
+                    time_of_impact = std::min(time_of_impact, t.value());
+                }
+            };
+            const geometry::AABB swept_bounds = geometry::merge(
+                    world_bounds(sphere.value()),
+                    world_bounds(colliders::Sphere{.center = sphere->center + displacement, .radius = sphere->radius}));
+            m_broadphase.query(swept_bounds, sweep);
+            m_broadphase.query_unbounded(swept_bounds, sweep);
 
-            rb.update_collider();
+            if (time_of_impact < 1) {
+                // the velocity is kept, so that the collision is resolved in the next step with the correct normal
+                const double travel = std::min(time_of_impact * distance + m_ccd_overlap, distance);
+                m_body_store->set_position(id, start + displacement * (travel / distance));
+            }
         }
     }
 
-    void Simulation::detect_collisions(const double dt)
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::detect_collisions(const double dt)
     {
-        m_penetration_constraints.clear();
-        m_friction_constraints.clear();
-        m_rolling_friction_constraints.clear();
+        const ScopedTimer timer(m_statistics.detect_collisions_time);
+        clear_constraints();
 
         if (m_visualizer) {
             m_visualizer->points.clear();
             m_visualizer->vectors.clear();
         }
 
-        // collision detection narrow phase
-        if (m_bodies.size() < 2) {
-            return;
+        m_island_parent.resize(m_bodies.size());
+        std::iota(m_island_parent.begin(), m_island_parent.end(), 0);
+
+        // collision detection broad phase, which leaves out pairs of static or sleeping bodies and filtered pairs
+        const std::vector<Broadphase::CandidatePair>* pairs = &m_broadphase.update_pairs();
+        if (m_sleeping && wake_up_touched_islands(*pairs)) {
+            // the pairs of the woken bodies with static bodies were left out
+            pairs = &m_broadphase.update_pairs();
         }
-        // bodies must be at least of size 2 for this to work (unsigned index)
-        for (std::size_t i = 0; i < m_bodies.size() - 1; ++i) {
-            RigidBody& rb_a = m_bodies[i];
-            if (rb_a.should_ignore() || !rb_a.m_collider.has_value()) {
+
+        m_narrowphase_pairs.clear();
+        for (const auto& [id_a, id_b]: *pairs) {
+            const RigidBody& rb_a = m_bodies[id_a];
+            const RigidBody& rb_b = m_bodies[id_b];
+            if (rb_a.should_ignore() || rb_b.should_ignore()) {
                 continue;
             }
+            assert(is_simulated(rb_a) || is_simulated(rb_b));
+            m_narrowphase_pairs.emplace_back(id_a, id_b);
+        }
 
-            for (std::size_t j = i + 1; j < m_bodies.size(); ++j) {
-                RigidBody& rb_b = m_bodies[j];
-                if (rb_b.should_ignore() || !rb_b.m_collider.has_value()) {
-                    continue;
+        // collision detection narrow phase, which yields the manifolds in the order of the pairs for any thread count
+        std::vector<Narrowphase::PairManifold>& manifolds = m_narrowphase.update(
+                m_narrowphase_pairs,
+                [this](const std::size_t id) -> const Collider& { return m_bodies[id].m_collider.value(); },
+                m_thread_pool.get());
+
+        for (auto& [id_a, id_b, manifold]: manifolds) {
+            RigidBody& rb_a = m_bodies[id_a];
+            RigidBody& rb_b = m_bodies[id_b];
+            if (is_simulated(rb_a) && is_simulated(rb_b)) {
+                merge_islands(id_a, id_b);
+            }
+            m_manifold_rows.push_back({.begin = m_penetration_constraints.size(), .count = manifold.contacts.size()});
+
+            for (ContactPoint& contact: manifold.contacts) {
+                math::Vec3d v_abs_p_a = m_body_store->velocity(id_a) +
+                                        cross(m_body_store->angular_velocity(id_a), contact.r_a);
+                math::Vec3d v_abs_p_b = m_body_store->velocity(id_b) +
+                                        cross(m_body_store->angular_velocity(id_b), contact.r_b);
+                contact.rel_v = v_abs_p_b - v_abs_p_a;
+                contact.rel_v_n = dot(contact.rel_v, manifold.normal);
+
+                // Gram-Schmidt method using the relative velocity as the initial vector for the projection
+                // don't normalize tangent here, since it might be zero-length
+                manifold.tangent_1 = contact.rel_v - manifold.normal * dot(contact.rel_v, manifold.normal);
+                if (length_sqr(manifold.tangent_1) < 0.0000001) {
+                    // tangent is parallel to n, so we need another approach
+                    std::tie(manifold.tangent_1, manifold.tangent_2) = tangent_plane(manifold.normal);
+                } else {
+                    manifold.tangent_1.normalize();
+                    // normalization not necessary, since tangent and normal are already normalized
+                    manifold.tangent_2 = cross(manifold.tangent_1, manifold.normal);
                 }
 
-                std::optional<ContactManifold> result = std::visit(m_collision_visitor,
-                                                                   rb_a.m_collider.value(),
-                                                                   rb_b.m_collider.value());
-                if (result.has_value()) {
-                    ContactManifold& manifold = result.value();
-                    for (ContactPoint& contact: manifold.contacts) {
-                        math::Vec3d v_abs_p_a = rb_a.m_velocity + cross(rb_a.m_angular_velocity, contact.r_a);
-                        math::Vec3d v_abs_p_b = rb_b.m_velocity + cross(rb_b.m_angular_velocity, contact.r_b);
-                        contact.rel_v = v_abs_p_b - v_abs_p_a;
-                        contact.rel_v_n = dot(contact.rel_v, manifold.normal);
-
-                        // Gram-Schmidt method using the relative velocity as the initial vector for the projection
-                        // don't normalize tangent here, since it might be zero-length
-                        manifold.tangent_1 = contact.rel_v - manifold.normal * dot(contact.rel_v, manifold.normal);
-                        if (length_sqr(manifold.tangent_1) < 0.0000001) {
-                            // tangent is parallel to n, so we need another approach
-                            std::tie(manifold.tangent_1, manifold.tangent_2) = tangent_plane(manifold.normal);
-                        } else {
-                            manifold.tangent_1.normalize();
-                            // normalization not necessary, since tangent and normal are already normalized
-                            manifold.tangent_2 = cross(manifold.tangent_1, manifold.normal);
-                        }
+                prepare_penetration_constraint(rb_a, rb_b, manifold, contact, dt);
+                prepare_friction_constraints(rb_a, rb_b, manifold, contact);
+                prepare_rolling_friction_constraints(rb_a, rb_b, manifold);
+
+                const ContactCache::Key key{.body_a = id_a, .body_b = id_b, .feature_id = contact.feature_id};
+                m_contact_keys.push_back(key);
+                if (m_warm_starting) {
+                    // project the previous impulses onto the new contact frame
+                    const ContactCache::Impulse impulse = m_contact_cache.find(persistent_key(key));
+                    const std::size_t n = m_penetration_constraints.size();
+                    m_penetration_constraints.accumulated_lambda(n - 1) = impulse.normal;
+                    m_friction_constraints.accumulated_lambda(2 * n - 2) =
+                            dot(impulse.friction, manifold.tangent_1);
+                    m_friction_constraints.accumulated_lambda(2 * n - 1) =
+                            dot(impulse.friction, manifold.tangent_2);
+                    m_rolling_friction_constraints.accumulated_lambda(3 * n - 3) =
+                            dot(impulse.rolling_friction, manifold.normal);
+                    m_rolling_friction_constraints.accumulated_lambda(3 * n - 2) =
+                            dot(impulse.rolling_friction, manifold.tangent_1);
+                    m_rolling_friction_constraints.accumulated_lambda(3 * n - 1) =
+                            dot(impulse.rolling_friction, manifold.tangent_2);
+                }
+
+                if (m_visualizer) {
+                    m_visualizer->points.emplace_back(contact.p_a, gl::Color::GREEN);
+                    m_visualizer->points.emplace_back(contact.p_b, gl::Color::BLUE);
+                }
+            }
+        }
+
+        if constexpr (profiling_enabled) {
+            m_statistics.candidate_pairs = pairs->size();
+            m_statistics.narrowphase_pairs = m_narrowphase_pairs.size();
+            m_statistics.narrowphase_hits = manifolds.size();
+            m_statistics.contacts = m_penetration_constraints.size();
+            m_statistics.constraint_rows = m_penetration_constraints.size() + m_friction_constraints.size() +
+                                           m_rolling_friction_constraints.size();
+        }
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::resolve_collisions(double)
+    {
+        const ScopedTimer timer(m_statistics.resolve_collisions_time);
+        if (m_warm_starting) {
+            warm_start();
+        }
+
+        if (m_thread_pool) {
+            partition_contacts();
+        }
+        solve(m_solver_iterations);
+        if constexpr (profiling_enabled) {
+            m_statistics.residual = solver_residual();
+        }
+
+        if (m_warm_starting) {
+            store_contact_impulses();
+        }
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::solve(const int iterations)
+    {
+        if constexpr (profiling_enabled) {
+            m_statistics.solver_iterations += iterations;
+        }
+
+        if (m_thread_pool) {
+            solve_batches(iterations);
+            return;
+        }
 
-                        m_penetration_constraints.push_back(
-                                prepare_penetration_constraint(rb_a, rb_b, manifold, contact, dt));
+        for (int i = 0; i < iterations; ++i) {
+            // don't interleave constraints, since the friction impulse depends on the normal impulse
+            if (m_block_solver) {
+                for (const ManifoldRows& manifold: m_manifold_rows) {
+                    resolve_penetration_block(manifold);
+                }
+            } else {
+                for (std::size_t row = 0; row < m_penetration_constraints.size(); ++row) {
+                    resolve_penetration_constraint(row);
+                }
+            }
+            for (std::size_t row = 0; row < m_friction_constraints.size(); ++row) {
+                resolve_friction_constraint(row);
+            }
+            for (std::size_t row = 0; row < m_rolling_friction_constraints.size(); ++row) {
+                resolve_rolling_friction_constraint(row);
+            }
+        }
+    }
 
-                        auto [cf_0, cf_1] = prepare_friction_constraints(rb_a, rb_b, manifold, contact);
-                        m_friction_constraints.push_back(cf_0);
-                        m_friction_constraints.push_back(cf_1);
+    template<typename Scalar>
+    double BasicSimulation<Scalar>::solver_residual() const
+    {
+        double residual = 0;
+        for (std::size_t row = 0; row < m_penetration_constraints.size(); ++row) {
+            const double lambda = m_penetration_constraints.accumulated_lambda(row);
+            const double delta_lambda = m_penetration_constraints.solve(*m_body_store, row);
+            residual = std::max(residual, std::abs(std::max(0.0, lambda + delta_lambda) - lambda));
+        }
+        for (std::size_t row = 0; row < m_friction_constraints.size(); ++row) {
+            const double lambda = m_friction_constraints.accumulated_lambda(row);
+            const double delta_lambda = m_friction_constraints.solve(*m_body_store, row);
+            const double limit = friction_limit(row);
+            residual = std::max(residual, std::abs(math::clamp(lambda + delta_lambda, -limit, limit) - lambda));
+        }
+        return residual;
+    }
 
-                        auto [crf_0, crf_1, crf_2] = prepare_rolling_friction_constraints(rb_a, rb_b, manifold);
-                        m_rolling_friction_constraints.push_back(crf_0);
-                        m_rolling_friction_constraints.push_back(crf_1);
-                        m_rolling_friction_constraints.push_back(crf_2);
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::refresh_penetration_biases(const double dt, const bool correct_positions)
+    {
+        for (std::size_t row = 0; row < m_penetration_constraints.size(); ++row) {
+            const ContactAnchor& anchor = m_contact_anchors[row];
+            const std::size_t a = m_penetration_constraints.body_a(row);
+            const std::size_t b = m_penetration_constraints.body_b(row);
+            const math::Vec3d p_a = m_body_store->position(a) + m_body_store->orientation(a) * anchor.local_a;
+            const math::Vec3d p_b = m_body_store->position(b) + m_body_store->orientation(b) * anchor.local_b;
+            const double depth = dot(p_a - p_b, anchor.normal);
 
-                        if (m_visualizer) {
-                            m_visualizer->points.emplace_back(contact.p_a, gl::Color::GREEN);
-                            m_visualizer->points.emplace_back(contact.p_b, gl::Color::BLUE);
+            if (depth < 0) {
+                // the bodies have separated, so they may approach each other until they touch again
+                m_penetration_constraints.bias(row) = -depth / dt;
+                continue;
+            }
+            const double step_dt = dt * m_substeps;
+            const double baumgarte_bias = correct_positions
+                                          ? -m_baumgarte_factor / step_dt * std::max(depth - m_penetration_slop, 0.0)
+                                          : 0;
+            m_penetration_constraints.bias(row) = std::min(baumgarte_bias, anchor.restitution_bias);
+        }
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::warm_start()
+    {
+        for (std::size_t row = 0; row < m_penetration_constraints.size(); ++row) {
+            m_penetration_constraints.apply_impulse(*m_body_store, row, m_penetration_constraints.accumulated_lambda(row));
+        }
+        for (std::size_t row = 0; row < m_friction_constraints.size(); ++row) {
+            m_friction_constraints.apply_impulse(*m_body_store, row, m_friction_constraints.accumulated_lambda(row));
+        }
+        for (std::size_t row = 0; row < m_rolling_friction_constraints.size(); ++row) {
+            const double friction_coefficient =
+                    m_bodies[m_rolling_friction_constraints.body_a(row)].material.rolling_friction *
+                    m_bodies[m_rolling_friction_constraints.body_b(row)].material.rolling_friction;
+            m_rolling_friction_constraints.apply_impulse(
+                    *m_body_store, row, friction_coefficient * m_rolling_friction_constraints.accumulated_lambda(row));
+        }
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::partition_contacts()
+    {
+        auto movable = [this](const std::size_t id) {
+            return m_body_store->inverse_mass(id) > 0 ? id : ConstraintBatches::no_body;
+        };
+        m_contact_bodies.clear();
+        if (m_block_solver) {
+            // the contacts of a manifold are solved together, so the manifolds are partitioned instead
+            for (const ManifoldRows& manifold: m_manifold_rows) {
+                const ContactCache::Key& key = m_contact_keys[manifold.begin];
+                m_contact_bodies.emplace_back(movable(key.body_a), movable(key.body_b));
+            }
+        } else {
+            for (const ContactCache::Key& key: m_contact_keys) {
+                m_contact_bodies.emplace_back(movable(key.body_a), movable(key.body_b));
+            }
+        }
+        m_constraint_batches.build(m_contact_bodies, m_bodies.size());
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::solve_batches(const int iterations)
+    {
+        m_thread_pool->run([this, iterations](const std::size_t thread) {
+            // the rows of a contact are only ever solved by the same thread, so the friction rows can safely read the
+            // normal impulse
+            auto for_each_contact = [this, thread](auto&& resolve) {
+                for (std::size_t b = 0; b < m_constraint_batches.size(); ++b) {
+                    const std::span<const std::size_t> batch = m_constraint_batches.batch(b);
+                    if (m_constraint_batches.is_conflicting(b)) {
+                        if (thread == 0) {
+                            std::ranges::for_each(batch, resolve);
                         }
+                    } else {
+                        const auto [begin, end] = m_thread_pool->chunk(batch.size(), thread);
+                        std::for_each(batch.begin() + begin, batch.begin() + end, resolve);
+                    }
+                    m_thread_pool->arrive_and_wait();
+                }
+            };
+
+            for (int i = 0; i < iterations; ++i) {
+                // don't interleave constraints, since the friction impulse depends on the normal impulse
+                for_each_contact([this](const std::size_t item) {
+                    if (m_block_solver) {
+                        resolve_penetration_block(m_manifold_rows[item]);
+                    } else {
+                        resolve_penetration_constraint(item);
+                    }
+                });
+                for_each_contact([this](const std::size_t item) {
+                    const auto [begin, end] = batch_item_contacts(item);
+                    for (std::size_t contact = begin; contact < end; ++contact) {
+                        resolve_friction_constraint(2 * contact);
+                        resolve_friction_constraint(2 * contact + 1);
+                    }
+                });
+                for_each_contact([this](const std::size_t item) {
+                    const auto [begin, end] = batch_item_contacts(item);
+                    for (std::size_t contact = begin; contact < end; ++contact) {
+                        resolve_rolling_friction_constraint(3 * contact);
+                        resolve_rolling_friction_constraint(3 * contact + 1);
+                        resolve_rolling_friction_constraint(3 * contact + 2);
+                    }
+                });
+            }
+        });
+    }
+
+    template<typename Scalar>
+    std::pair<std::size_t, std::size_t> BasicSimulation<Scalar>::batch_item_contacts(const std::size_t item) const
+    {
+        if (m_block_solver) {
+            const ManifoldRows& manifold = m_manifold_rows[item];
+            return {manifold.begin, manifold.begin + manifold.count};
+        }
+        return {item, item + 1};
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::clear_constraints()
+    {
+        m_penetration_constraints.clear();
+        m_friction_constraints.clear();
+        m_rolling_friction_constraints.clear();
+        m_contact_keys.clear();
+        m_contact_anchors.clear();
+        m_manifold_rows.clear();
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::store_contact_impulses()
+    {
+        // the directions of the constraints are the linear and angular parts of body B's Jacobian
+        auto linear_impulse = [](const ConstraintRows& rows, const std::size_t row) {
+            return static_cast<double>(rows.accumulated_lambda(row)) * rows.jacobian(row).linear_b;
+        };
+        auto angular_impulse = [](const ConstraintRows& rows, const std::size_t row) {
+            return static_cast<double>(rows.accumulated_lambda(row)) * rows.jacobian(row).angular_b;
+        };
+
+        for (std::size_t i = 0; i < m_contact_keys.size(); ++i) {
+            m_contact_cache.insert(persistent_key(m_contact_keys[i]), {
+                    .normal = m_penetration_constraints.accumulated_lambda(i),
+                    .friction = linear_impulse(m_friction_constraints, 2 * i) +
+                                linear_impulse(m_friction_constraints, 2 * i + 1),
+                    .rolling_friction = angular_impulse(m_rolling_friction_constraints, 3 * i) +
+                                        angular_impulse(m_rolling_friction_constraints, 3 * i + 1) +
+                                        angular_impulse(m_rolling_friction_constraints, 3 * i + 2),
+            });
+        }
+        m_contact_cache.advance();
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::remove_destroyed_bodies()
+    {
+        for (const RigidBodyHandle handle: *m_destruction_queue) {
+            const std::size_t i = m_slots[handle.index].body;
+            RigidBody& rb = m_bodies[i];
+
+            if (rb.m_sleeping_island.has_value()) {
+                wake_up_island(rb.m_sleeping_island.value());
+            }
+            if (rb.m_collider.has_value()) {
+                // bodies resting on this one lose their support, which wakes everything around unbounded bodies
+                m_broadphase.query(world_bounds(rb.m_collider.value()), [this](const std::size_t id) {
+                    if (m_bodies[id].m_sleeping_island.has_value()) {
+                        wake_up_island(m_bodies[id].m_sleeping_island.value());
                     }
+                });
+            }
+            if (rb.m_broadphase_proxy != Broadphase::null_proxy) {
+                m_broadphase.destroy_proxy(rb.m_broadphase_proxy);
+            }
+            // the new generation invalidates all handles to the body
+            Slot& slot = m_slots[rb.m_handle.index];
+            ++slot.generation;
+            m_free_slots.push_back(rb.m_handle.index);
+
+            // the last body takes over the id, which keeps the bodies dense
+            const std::size_t last = m_bodies.size() - 1;
+            if (i != last) {
+                rb = std::move(m_bodies[last]);
+                rb.m_id = i;
+                m_slots[rb.m_handle.index].body = i;
+                if (rb.m_broadphase_proxy != Broadphase::null_proxy) {
+                    m_broadphase.set_user_id(rb.m_broadphase_proxy, i);
+                }
+                if (rb.m_sleeping_island.has_value()) {
+                    std::ranges::replace(m_sleeping_islands[rb.m_sleeping_island.value()], last, i);
                 }
             }
+            m_bodies.pop_back();
+            m_body_store->remove(i);
         }
+        m_destruction_queue->clear();
+    }
 
-        // once all constraints are created, we can construct the dependencies
-        for (std::size_t i = 0; i < m_friction_constraints.size(); ++i) {
-            m_friction_constraints.at(i).dependent_constraint = {&m_penetration_constraints.at(i / 2)};
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::wake_up_bodies()
+    {
+        for (const RigidBody& rb: m_bodies) {
+            if (rb.m_wake_up_pending && rb.m_sleeping_island.has_value()) {
+                wake_up_island(rb.m_sleeping_island.value());
+            }
         }
     }
 
-    void Simulation::resolve_collisions(double)
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::update_collision_filters()
     {
-        for (int i = 0; i < m_solver_iterations; ++i) {
-            // don't interleave constraints, since the friction impulse depends on the normal impulse
-            for (Constraint& constraint: m_penetration_constraints) {
-                resolve_penetration_constraint(constraint);
+        for (RigidBody& rb: m_bodies) {
+            if (rb.m_collision_filter_pending && !rb.should_ignore()) {
+                if (rb.m_broadphase_proxy != Broadphase::null_proxy) {
+                    m_broadphase.set_filter(rb.m_broadphase_proxy, rb.m_collision_filter);
+                }
+                rb.m_collision_filter_pending = false;
+            }
+        }
+    }
+
+    template<typename Scalar>
+    bool BasicSimulation<Scalar>::wake_up_touched_islands(const std::vector<Broadphase::CandidatePair>& pairs)
+    {
+        bool woken = false;
+        for (const auto& [id_a, id_b]: pairs) {
+            RigidBody& rb_a = m_bodies[id_a];
+            RigidBody& rb_b = m_bodies[id_b];
+            if (rb_a.should_ignore() || rb_b.should_ignore()) {
+                continue;
+            }
+
+            std::optional<std::size_t> island;
+            if (rb_a.m_sleeping_island.has_value() && is_simulated(rb_b)) {
+                island = rb_a.m_sleeping_island;
+            } else if (rb_b.m_sleeping_island.has_value() && is_simulated(rb_a)) {
+                island = rb_b.m_sleeping_island;
+            } else {
+                continue;
+            }
+
+            if (std::visit(m_collision_visitor, rb_a.m_collider.value(), rb_b.m_collider.value()).has_value()) {
+                wake_up_island(island.value());
+                woken = true;
+            }
+        }
+        return woken;
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::wake_up_island(const std::size_t island)
+    {
+        for (const std::size_t id: m_sleeping_islands[island]) {
+            RigidBody& rb = m_bodies[id];
+            rb.m_sleeping_island.reset();
+            rb.m_wake_up_pending = false;
+            rb.m_sleep_timer = 0;
+            m_body_store->set_simulated(id, true);
+            if (rb.m_broadphase_proxy != Broadphase::null_proxy) {
+                m_broadphase.set_frozen(rb.m_broadphase_proxy, false);
             }
-            for (Constraint& constraint: m_friction_constraints) {
-                resolve_friction_constraint(constraint);
+        }
+        m_sleeping_islands[island].clear();
+        m_free_sleeping_islands.push_back(island);
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::update_islands(const double dt)
+    {
+        const ScopedTimer timer(m_statistics.update_islands_time);
+        // group awake bodies by island
+        m_island_members.clear();
+        for (std::size_t id = 0; id < m_bodies.size(); ++id) {
+            RigidBody& rb = m_bodies[id];
+            if (rb.should_ignore() || !is_simulated(rb)) {
+                continue;
             }
-            for (Constraint& constraint: m_rolling_friction_constraints) {
-                resolve_rolling_friction_constraint(constraint);
+
+            const double linear_velocity = length_sqr(m_body_store->velocity(id));
+            const double angular_velocity = length_sqr(m_body_store->angular_velocity(id));
+            const bool resting = linear_velocity < m_sleep_linear_velocity * m_sleep_linear_velocity &&
+                                 angular_velocity < m_sleep_angular_velocity * m_sleep_angular_velocity;
+            rb.m_sleep_timer = resting ? rb.m_sleep_timer + dt : 0;
+
+            // bodies that were created after collision detection are not part of any island yet
+            const std::size_t root = id < m_island_parent.size() ? find_island(id) : id;
+            m_island_members.emplace_back(root, id);
+        }
+        std::ranges::sort(m_island_members);
+
+        m_awake_body_count = 0;
+        m_island_count = 0;
+        for (auto begin = m_island_members.begin(); begin != m_island_members.end();) {
+            const auto end = std::find_if(begin, m_island_members.end(), [begin](const auto& member) {
+                return member.first != begin->first;
+            });
+            const bool resting = std::all_of(begin, end, [this](const auto& member) {
+                return m_bodies[member.second].m_sleep_timer >= m_time_to_sleep;
+            });
+
+            if (m_sleeping && resting) {
+                std::size_t island;
+                if (m_free_sleeping_islands.empty()) {
+                    island = m_sleeping_islands.size();
+                    m_sleeping_islands.emplace_back();
+                } else {
+                    island = m_free_sleeping_islands.back();
+                    m_free_sleeping_islands.pop_back();
+                }
+
+                for (auto it = begin; it != end; ++it) {
+                    m_bodies[it->second].m_sleeping_island = island;
+                    m_body_store->set_simulated(it->second, false);
+                    if (m_bodies[it->second].m_broadphase_proxy != Broadphase::null_proxy) {
+                        m_broadphase.set_frozen(m_bodies[it->second].m_broadphase_proxy, true);
+                    }
+                    m_body_store->set_velocity(it->second, math::Vec3d());
+                    m_body_store->set_angular_velocity(it->second, math::Vec3d());
+                    m_sleeping_islands[island].push_back(it->second);
+                }
+            } else {
+                m_awake_body_count += end - begin;
+                ++m_island_count;
             }
+
+            begin = end;
         }
     }
 
-    void Simulation::remove_destroyed_bodies()
+    template<typename Scalar>
+    std::size_t BasicSimulation<Scalar>::find_island(std::size_t id)
+    {
+        while (m_island_parent[id] != id) {
+            // path halving
+            m_island_parent[id] = m_island_parent[m_island_parent[id]];
+            id = m_island_parent[id];
+        }
+        return id;
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::merge_islands(const std::size_t id_a, const std::size_t id_b)
+    {
+        m_island_parent[find_island(id_a)] = find_island(id_b);
+    }
+
+    template<typename Scalar>
+    bool BasicSimulation<Scalar>::is_simulated(const RigidBody& rb)
     {
-        for (std::size_t i = 0; i < m_bodies.size(); ++i) {
-            if (m_bodies[i].m_destruction_pending) {
-                m_free_ids.push(i);
-                m_bodies[i].m_destruction_pending = false;
-                m_bodies[i].m_destroyed = true;
+        return rb.m_store->inverse_mass(rb.m_id) > 0 && !rb.m_sleeping_island.has_value();
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::add_to_broadphase(const std::size_t id)
+    {
+        RigidBody& rb = m_bodies[id];
+        if (rb.m_collider.has_value()) {
+            rb.m_broadphase_proxy = m_broadphase.create_proxy(rb.m_collider.value(), id, rb.m_collision_filter,
+                                                              !is_simulated(rb));
+        }
+    }
+
+    template<typename Scalar>
+    std::optional<QueryHit> BasicSimulation<Scalar>::cast(const colliders::Sphere& sphere, const Ray& ray) const
+    {
+        const math::Vec3d displacement = normalize(ray.direction) * ray.max_distance;
+        std::optional<SweepHit> closest;
+        std::size_t closest_id = 0;
+        m_broadphase.sweep(sphere.center, displacement, sphere.radius, [&](const std::size_t id) {
+            const RigidBody& rb = m_bodies[id];
+            if (!rb.should_ignore()) {
+                const std::optional<SweepHit> hit = sweep(sphere, displacement, rb.m_collider.value());
+                if (hit.has_value() && (!closest.has_value() || hit->fraction < closest->fraction)) {
+                    closest = hit;
+                    closest_id = id;
+                }
             }
+            return closest.has_value() ? closest->fraction : 1.0;
+        });
+
+        if (!closest.has_value()) {
+            return {};
         }
+        const math::Vec3d center = sphere.center + closest->fraction * displacement;
+        return QueryHit{
+                .body = make_handle(closest_id),
+                .point = center - sphere.radius * closest->normal,
+                .normal = closest->normal,
+                .distance = closest->fraction * ray.max_distance,
+        };
     }
 
-    void Simulation::clear_forces()
+    template<typename Scalar>
+    RigidBodyHandle BasicSimulation<Scalar>::allocate_handle(const std::size_t id)
     {
-        for (RigidBody& rb : m_bodies) {
-            rb.m_force = math::Vec3d();
-            rb.m_torque = math::Vec3d();
+        RigidBodyHandle handle;
+        if (m_free_slots.empty()) {
+            handle.index = static_cast<std::uint32_t>(m_slots.size());
+            m_slots.emplace_back();
+        } else {
+            handle.index = m_free_slots.front();
+            m_free_slots.pop_front();
         }
+        m_slots[handle.index].body = id;
+        handle.generation = m_slots[handle.index].generation;
+        return handle;
     }
+
+    template<typename Scalar>
+    RigidBodyHandle BasicSimulation<Scalar>::make_handle(const std::size_t id) const
+    {
+        return m_bodies[id].m_handle;
+    }
+
+    template<typename Scalar>
+    ContactCache::Key BasicSimulation<Scalar>::persistent_key(const ContactCache::Key& key) const
+    {
+        auto persistent_id = [this](const std::size_t id) {
+            const RigidBodyHandle& handle = m_bodies[id].m_handle;
+            return std::size_t{handle.generation} << 32 | handle.index;
+        };
+        return {.body_a = persistent_id(key.body_a), .body_b = persistent_id(key.body_b),
+                .feature_id = key.feature_id};
+    }
+
+    template<typename Scalar>
+    void BasicSimulation<Scalar>::clear_forces()
+    {
+        m_body_store->clear_forces();
+    }
+
+    template class BasicSimulation<float>;
+    template class BasicSimulation<double>;
 }
@@ -1,12 +1,25 @@
 #pragma once
 
+#include <deque>
 #include <memory>
-#include <queue>
+#include <optional>
+#include <span>
 #include <tuple>
 #include <vector>
 
+#include "BodyStore.h"
+#include "Broadphase.h"
 #include "Collision.h"
+#include "CompoundShape.h"
+#include "ConstraintRows.h"
+#include "ContactCache.h"
+#include "ConstraintBatches.h"
+#include "Narrowphase.h"
+#include "Profiling.h"
+#include "Queries.h"
 #include "RigidBody.h"
+#include "Snapshot.h"
+#include "ThreadPool.h"
 #include "Visualizer.h"
 
 namespace yage::physics3d
@@ -14,13 +27,19 @@ namespace yage::physics3d
     /**
      * Performs a discrete physics simulation on a set of rigid bodies. Implements a Sequential Impulses approach with
      * support for penetration, friction, rolling friction, and restitution.
+     *
+     * The kinematic state of the bodies and the constraint solver use the given scalar type, which is float or double.
+     * Collision detection, scene queries and the interface of the simulation use double precision regardless.
      */
-    class Simulation
+    template<typename Scalar>
+    class BasicSimulation
     {
     public:
-        Simulation() = default;
+        using RigidBody = BasicRigidBody<Scalar>;
 
-        explicit Simulation(Visualizer visualizer);
+        BasicSimulation() = default;
+
+        explicit BasicSimulation(Visualizer visualizer);
 
         /**
          * Performs one full simulation step. The order of operation is:
@@ -28,6 +47,10 @@ namespace yage::physics3d
          *  2. Collision detection
          *  3. Collision resolution
          *  4. Integration of positions
+         *
+         * With sub-stepping enabled, collisions are detected first, followed by the substeps, which each integrate
+         * forces, resolve collisions with a single solver iteration, integrate positions, and relax the velocities with
+         * another solver iteration.
          * @param dt Simulation delta time for this step in seconds.
          */
         void update(double dt);
@@ -51,30 +74,182 @@ namespace yage::physics3d
         template<typename... Args>
         RigidBodyHandle create_rigid_body(Args&&... args)
         {
-            std::size_t id;
-            if (m_free_ids.empty()) {
-                id = m_bodies.size();
-                m_bodies.push_back(RigidBody(args...));
-            } else {
-                id = m_free_ids.front();
-                m_free_ids.pop();
-                m_bodies[id] = RigidBody(args...);
-            }
-
-            RigidBodyHandle handle;
-            handle.id = id;
-            return handle;
+            const std::size_t id = m_bodies.size();
+            m_bodies.push_back(RigidBody(*m_body_store, id, args...));
+            m_bodies.back().m_handle = allocate_handle(id);
+            m_bodies.back().m_destruction_queue = m_destruction_queue.get();
+            add_to_broadphase(id);
+            return m_bodies.back().m_handle;
         }
 
+        /**
+         * @return Whether a handle refers to a body of this simulation that has not been removed yet.
+         */
+        [[nodiscard]]
+        bool contains(RigidBodyHandle handle) const;
+
+        /**
+         * The returned reference is only valid until the next simulation step that removes a destroyed body.
+         * @param handle A handle that this simulation contains.
+         */
         RigidBody& lookup(RigidBodyHandle handle);
 
+        const RigidBody& lookup(RigidBodyHandle handle) const;
+
         void enable_gravity();
 
         void disable_gravity();
 
+        /**
+         * Sets the number of iterations per frame for the Sequential Impulses solver. With warm starting, a few
+         * iterations are usually enough for stable stacking.
+         */
+        void set_solver_iterations(int iterations);
+
+        /**
+         * Enables sub-stepping, where collisions are detected once per step, but the step is split into substeps that
+         * each run a single solver iteration on the contacts, whose penetration is recomputed from the contact points
+         * before each substep. This converges better than many iterations on a single step, e.g. for stacks and large
+         * mass ratios. The number of solver iterations is ignored while sub-stepping. Only affects update, not
+         * update_staggered.
+         * @param substeps The number of substeps per step.
+         */
+        void enable_substepping(int substeps);
+
+        /**
+         * Disables sub-stepping, such that each step runs the configured number of solver iterations. Disabled by
+         * default.
+         */
+        void disable_substepping();
+
+        /**
+         * Enables warm starting, where the solver starts from the impulses that were applied to persistent contacts in
+         * the previous step. Enabled by default.
+         */
+        void enable_warm_starting();
+
+        /**
+         * Disables warm starting, such that the solver starts from zero impulses for every contact.
+         */
+        void disable_warm_starting();
+
+        /**
+         * Enables the block solver, which solves the penetration rows of each contact manifold with up to four contacts
+         * together, such that the impulses of all contacts satisfy the manifold at once. Resting boxes converge in far
+         * fewer solver iterations this way, since the contacts don't push against each other one after the other.
+         */
+        void enable_block_solver();
+
+        /**
+         * Disables the block solver, such that each penetration row is solved on its own. Disabled by default.
+         */
+        void disable_block_solver();
+
+        /**
+         * Sets the number of threads for the narrow phase and the constraint solver. The narrow phase yields the same
+         * contacts in the same order for any thread count. With a single thread (the default), all constraints are
+         * solved in order. With more threads, contacts are solved in batches of contacts that don't share any movable
+         * body, which is deterministic for any thread count, but visits constraints in a different order than the
+         * single-threaded solver.
+         */
+        void set_thread_count(std::size_t threads);
+
+        /**
+         * Enables sleeping, where islands of bodies in contact that have been resting for a while are excluded from
+         * the simulation until they are touched by a moving body, a force is applied to them, or a neighbour is
+         * destroyed. Enabled by default.
+         */
+        void enable_sleeping();
+
+        /**
+         * Disables sleeping and wakes all sleeping bodies.
+         */
+        void disable_sleeping();
+
+        /**
+         * @return The number of bodies in the simulation, including destroyed bodies until the next step removes them.
+         */
+        [[nodiscard]]
+        std::size_t body_count() const;
+
+        /**
+         * @return The number of movable bodies that were simulated in the last step and are still awake.
+         */
+        [[nodiscard]]
+        std::size_t awake_body_count() const;
+
+        /**
+         * @return The number of islands of awake bodies that are connected through contacts in the last step.
+         */
+        [[nodiscard]]
+        std::size_t island_count() const;
+
+        /**
+         * @return Counters and phase times of the last step, which are only collected if the library is built with
+         * YAGE_PHYSICS3D_PROFILING, and are zero otherwise.
+         */
+        [[nodiscard]]
+        const StepStatistics& statistics() const;
+
+        /**
+         * Finds the closest collider that a ray hits. Colliders that contain the origin of the ray are ignored, such
+         * that rays can be cast from within a body. Queries must not run concurrently with a simulation step.
+         * @return The closest hit, or empty if the ray doesn't hit any collider.
+         */
+        [[nodiscard]]
+        std::optional<QueryHit> raycast(const Ray& ray) const;
+
+        /**
+         * Casts a batch of rays, which are distributed over the threads of the simulation.
+         * @param rays The rays to cast.
+         * @param hits Receives the closest hit of each ray, must have the same size as the rays.
+         */
+        void raycast(std::span<const Ray> rays, std::span<std::optional<QueryHit>> hits) const;
+
+        /**
+         * Finds the closest collider that a sphere hits when it moves along a ray. Colliders that the sphere touches
+         * at its origin are ignored. Boxes are inflated by the sphere radius, which makes hits around their edges
+         * conservative.
+         * @return The closest hit, where the distance is the distance that the sphere can move until it touches the
+         * collider, or empty if the sphere doesn't hit any collider.
+         */
+        [[nodiscard]]
+        std::optional<QueryHit> sphere_cast(const Ray& ray, double radius) const;
+
+        /**
+         * Finds the bodies whose collider bounds overlap a box.
+         * @param aabb The box in world space.
+         * @param bodies Receives the overlapping bodies, is cleared first.
+         */
+        void overlap(const geometry::AABB& aabb, std::vector<RigidBodyHandle>& bodies) const;
+
+        /**
+         * Finds the bodies whose collider intersects a shape.
+         * @param shape The shape in world space. Boxes need their computed values to be up-to-date.
+         * @param bodies Receives the intersecting bodies, is cleared first.
+         */
+        void overlap(const Collider& shape, std::vector<RigidBodyHandle>& bodies) const;
+
+        /**
+         * Saves the state of the bodies, the broad phase, the contacts, the sleeping islands, and gravity to a
+         * snapshot. Other settings are not part of the snapshot. Saving to a reused snapshot doesn't allocate once the
+         * snapshot has grown large enough.
+         */
+        void save(Snapshot& snapshot) const;
+
+        /**
+         * Restores the state that was saved to a snapshot, possibly by another simulation. Continuing from a restored
+         * state yields the same results as continuing from the saved state, given that both use the same settings.
+         * Handles of bodies that were created after the snapshot was saved are invalid after restoring.
+         */
+        void restore(const Snapshot& snapshot);
+
         void visualize_collisions(const math::Mat4d& projection, const math::Mat4d& view) const;
 
     private:
+        using BodyStore = BasicBodyStore<Scalar>;
+        using ConstraintRows = BasicConstraintRows<Scalar>;
+
         /**
          * Baumgarte stabilisation factor. Should be within [0.1, 0.3].
          */
@@ -91,53 +266,312 @@ namespace yage::physics3d
          * Maximum number of iterations per frame for the Sequential Impulses solver.
          */
         int m_solver_iterations = 10;
+        /**
+         * Number of substeps per step, where 1 disables sub-stepping.
+         */
+        int m_substeps = 1;
+        bool m_warm_starting = true;
+        bool m_block_solver = false;
+        /**
+         * Bodies with a smaller linear velocity in meters/second are considered resting.
+         */
+        double m_sleep_linear_velocity = 0.05;
+        /**
+         * Bodies with a smaller angular velocity in radians/second are considered resting.
+         */
+        double m_sleep_angular_velocity = 0.05;
+        /**
+         * Time in seconds that all bodies of an island need to be resting before the island falls asleep.
+         */
+        double m_time_to_sleep = 0.5;
+        bool m_sleeping = true;
+
+        /**
+         * Maps the slot of a handle to the current id of its body.
+         */
+        struct Slot
+        {
+            std::size_t body{};
+            std::uint32_t generation{};
+        };
 
-        std::queue<std::size_t> m_free_ids;
+        std::vector<Slot> m_slots;
+        /**
+         * Slots of removed bodies in the order they are reused.
+         */
+        std::deque<std::uint32_t> m_free_slots;
+        /**
+         * Kinematic state of all bodies, indexed by body id. Bodies keep a pointer to the store, so it is allocated
+         * separately to keep its address stable when the simulation is moved.
+         */
+        std::unique_ptr<BodyStore> m_body_store = std::make_unique<BodyStore>();
+        /**
+         * All bodies in the simulation without gaps, such that removing a body moves the last body into its place.
+         */
         std::vector<RigidBody> m_bodies;
+        /**
+         * Handles of bodies whose destruction is pending. Bodies keep a pointer to the queue, so it is allocated
+         * separately like the body store.
+         */
+        std::unique_ptr<std::vector<RigidBodyHandle>> m_destruction_queue =
+                std::make_unique<std::vector<RigidBodyHandle>>();
 
+        Broadphase m_broadphase;
+        /**
+         * Candidate pairs that need resolution, reused between steps.
+         */
+        std::vector<Broadphase::CandidatePair> m_narrowphase_pairs;
+        Narrowphase m_narrowphase;
         CollisionVisitor m_collision_visitor{};
         math::Vec3d m_external_acceleration{};
+        /**
+         * Overlap in meters that continuous collision detection leaves at the time of impact, such that the discrete
+         * collision detection picks up the contact in the next step.
+         */
+        double m_ccd_overlap = 0.001;
+        /**
+         * Positions of the bodies with continuous collision detection at the start of their current motion.
+         */
+        std::vector<std::pair<std::size_t, math::Vec3d>> m_ccd_positions;
 
-        std::vector<Constraint> m_penetration_constraints;
-        std::vector<Constraint> m_friction_constraints;
-        std::vector<Constraint> m_rolling_friction_constraints;
+        ConstraintRows m_penetration_constraints;
+        /**
+         * Two rows per contact, in the order of the penetration constraints.
+         */
+        ConstraintRows m_friction_constraints;
+        /**
+         * Three rows per contact, in the order of the penetration constraints.
+         */
+        ConstraintRows m_rolling_friction_constraints;
+
+        /**
+         * The contact points of a penetration constraint relative to the body positions in body space, from which the
+         * penetration is recomputed between substeps.
+         */
+        struct ContactAnchor
+        {
+            math::Vec3d local_a;
+            math::Vec3d local_b;
+            math::Vec3d normal;
+            double restitution_bias{};
+        };
+
+        /**
+         * Anchors of the penetration constraints, which are only recorded when sub-stepping.
+         */
+        std::vector<ContactAnchor> m_contact_anchors;
+
+        /**
+         * The consecutive penetration constraints of a contact manifold.
+         */
+        struct ManifoldRows
+        {
+            std::size_t begin{};
+            std::size_t count{};
+        };
+
+        std::vector<ManifoldRows> m_manifold_rows;
+
+        /**
+         * Cache keys of the contacts that the penetration constraints were created for.
+         */
+        std::vector<ContactCache::Key> m_contact_keys;
+        ContactCache m_contact_cache;
+
+        /**
+         * Union-find forest over body ids that links awake bodies which are in contact.
+         */
+        std::vector<std::size_t> m_island_parent;
+        /**
+         * Pairs of island root and body id of all awake bodies, reused between steps.
+         */
+        std::vector<std::pair<std::size_t, std::size_t>> m_island_members;
+        /**
+         * Bodies of the islands that are asleep, indexed by the island id that is stored in each sleeping body.
+         */
+        std::vector<std::vector<std::size_t>> m_sleeping_islands;
+        std::vector<std::size_t> m_free_sleeping_islands;
+        std::size_t m_awake_body_count = 0;
+        std::size_t m_island_count = 0;
+
+        std::unique_ptr<ThreadPool> m_thread_pool;
+        /**
+         * Ids of the movable bodies of each contact, or of each manifold with the block solver, for partitioning them
+         * into independent batches.
+         */
+        std::vector<std::pair<std::size_t, std::size_t>> m_contact_bodies;
+        ConstraintBatches m_constraint_batches;
 
         std::unique_ptr<Visualizer> m_visualizer;
 
+        StepStatistics m_statistics;
+
         void integrate_forces(double dt);
 
+        void update_substepped(double dt);
+
         void integrate_positions(double dt);
 
+        /**
+         * Updates the colliders and broad phase proxies of all moving bodies after their positions were integrated.
+         */
+        void update_colliders(double dt);
+
+        /**
+         * Records the positions of the bodies with continuous collision detection before they are moved.
+         */
+        void begin_continuous_motion();
+
+        /**
+         * Sweeps the inner spheres of fast bodies with continuous collision detection from their recorded positions
+         * against the colliders around them, and stops bodies that would hit a collider at the time of impact.
+         */
+        void clamp_continuous_motion();
+
         void detect_collisions(double dt);
 
         void resolve_collisions(double dt);
 
+        void warm_start();
+
+        /**
+         * Runs the given number of solver iterations on all constraints.
+         */
+        void solve(int iterations);
+
+        /**
+         * Partitions the contacts into independent batches for the multi-threaded solver.
+         */
+        void partition_contacts();
+
+        /**
+         * Runs solver iterations on all threads, where each thread solves a part of every independent batch.
+         */
+        void solve_batches(int iterations);
+
+        /**
+         * Recomputes the biases of the penetration constraints from the current body positions.
+         * @param dt The time of a substep.
+         * @param correct_positions Whether to push penetrating bodies apart, or only to keep them from approaching.
+         */
+        void refresh_penetration_biases(double dt, bool correct_positions);
+
+        /**
+         * @return The largest change of an accumulated penetration or friction impulse that another solver iteration
+         * would apply.
+         */
+        [[nodiscard]]
+        double solver_residual() const;
+
+        void store_contact_impulses();
+
+        void clear_constraints();
+
+        /**
+         * Removes bodies that are pending destruction, which moves other bodies to the freed ids.
+         */
         void remove_destroyed_bodies();
 
+        /**
+         * Wakes the islands of bodies that requested to be woken up.
+         */
+        void wake_up_bodies();
+
+        /**
+         * Passes changed collision filters of bodies on to the broad phase.
+         */
+        void update_collision_filters();
+
+        /**
+         * Wakes sleeping islands that are touched by a moving body.
+         * @return Whether any island was woken.
+         */
+        bool wake_up_touched_islands(const std::vector<Broadphase::CandidatePair>& pairs);
+
+        void wake_up_island(std::size_t island);
+
+        /**
+         * Advances the sleep timers of awake bodies and puts islands to sleep whose bodies have all been resting long
+         * enough.
+         */
+        void update_islands(double dt);
+
+        std::size_t find_island(std::size_t id);
+
+        void merge_islands(std::size_t id_a, std::size_t id_b);
+
+        /**
+         * @return Whether a body is moved by the simulation, i.e. it is neither static nor sleeping.
+         */
+        static bool is_simulated(const RigidBody& rb);
+
+        void add_to_broadphase(std::size_t id);
+
+        /**
+         * Finds the closest collider that a sphere hits when it moves along a ray.
+         */
+        [[nodiscard]]
+        std::optional<QueryHit> cast(const colliders::Sphere& sphere, const Ray& ray) const;
+
+        RigidBodyHandle allocate_handle(std::size_t id);
+
+        [[nodiscard]]
+        RigidBodyHandle make_handle(std::size_t id) const;
+
+        /**
+         * @return A contact key whose body ids don't change when other bodies are removed.
+         */
+        [[nodiscard]]
+        ContactCache::Key persistent_key(const ContactCache::Key& key) const;
+
         void clear_forces();
 
-        static double solve_constraint(const Constraint& constraint);
+        void prepare_penetration_constraint(RigidBody& rb_a, RigidBody& rb_b, const ContactManifold& manifold,
+                                            const ContactPoint& contact, double dt);
 
-        static void apply_impulse(const Constraint& constraint, const math::Matd<12, 1>& impulse);
+        void prepare_friction_constraints(RigidBody& rb_a, RigidBody& rb_b, const ContactManifold& manifold,
+                                          const ContactPoint& contact);
 
-        Constraint prepare_penetration_constraint(RigidBody& rb_a, RigidBody& rb_b, const ContactManifold& manifold,
-                                                  const ContactPoint& contact, double dt) const;
+        void prepare_rolling_friction_constraints(RigidBody& rb_a, RigidBody& rb_b, const ContactManifold& manifold);
 
-        static std::tuple<Constraint, Constraint> prepare_friction_constraints(RigidBody& rb_a, RigidBody& rb_b,
-                                                                               const ContactManifold& manifold,
-                                                                               const ContactPoint& contact);
+        void resolve_penetration_constraint(std::size_t row);
 
-        static std::tuple<Constraint, Constraint, Constraint>
-        prepare_rolling_friction_constraints(RigidBody& rb_a, RigidBody& rb_b, const ContactManifold& manifold);
+        /**
+         * Solves the penetration rows of a manifold together as a linear complementarity problem, by trying which of
+         * the contacts push the bodies apart. Falls back to solving the rows one after the other for manifolds with
+         * more than four contacts, or if no combination of contacts is solvable.
+         */
+        void resolve_penetration_block(const ManifoldRows& manifold);
 
-        static void resolve_penetration_constraint(Constraint& constraint);
+        /**
+         * @return The range of contacts that the multi-threaded solver handles together as an item of a batch, which
+         * is a single contact, or a manifold with the block solver.
+         */
+        [[nodiscard]]
+        std::pair<std::size_t, std::size_t> batch_item_contacts(std::size_t item) const;
 
-        static void resolve_friction_constraint(Constraint& constraint);
+        void resolve_friction_constraint(std::size_t row);
 
-        static void resolve_rolling_friction_constraint(Constraint& constraint);
+        void resolve_rolling_friction_constraint(std::size_t row);
 
-        static math::Matd<12, 12> inverse_mass_matrix(const RigidBody& a, const RigidBody& b);
+        /**
+         * @return The largest magnitude of the accumulated impulse of a friction row, which is proportional to the
+         * accumulated normal impulse of its contact.
+         */
+        [[nodiscard]]
+        Scalar friction_limit(std::size_t row) const;
 
         static std::tuple<math::Vec3d, math::Vec3d> tangent_plane(const math::Vec3d& n);
     };
+
+    extern template class BasicSimulation<float>;
+    extern template class BasicSimulation<double>;
+
+    using Simulation = BasicSimulation<double>;
+
+    /**
+     * A simulation with single-precision body state and constraint rows, which are smaller and faster to solve, but
+     * drift further from the double-precision results over time, especially far away from the origin.
+     */
+    using FloatSimulation = BasicSimulation<float>;
 }
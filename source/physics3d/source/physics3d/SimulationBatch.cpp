@@ -0,0 +1,135 @@
+#include <cassert>
+
+#include "SimulationBatch.h"
+
+namespace yage::physics3d
+{
+    template<typename Scalar>
+    BasicSimulationBatch<Scalar>::BasicSimulationBatch(const std::size_t worlds, const std::size_t threads)
+    {
+        m_worlds.reserve(worlds);
+        for (std::size_t i = 0; i < worlds; ++i) {
+            m_worlds.push_back(std::make_unique<Simulation>());
+        }
+        set_thread_count(threads);
+    }
+
+    template<typename Scalar>
+    std::size_t BasicSimulationBatch<Scalar>::size() const
+    {
+        return m_worlds.size();
+    }
+
+    template<typename Scalar>
+    typename BasicSimulationBatch<Scalar>::Simulation& BasicSimulationBatch<Scalar>::world(const std::size_t index)
+    {
+        assert(index < m_worlds.size());
+        return *m_worlds[index];
+    }
+
+    template<typename Scalar>
+    const typename BasicSimulationBatch<Scalar>::Simulation&
+    BasicSimulationBatch<Scalar>::world(const std::size_t index) const
+    {
+        assert(index < m_worlds.size());
+        return *m_worlds[index];
+    }
+
+    template<typename Scalar>
+    void BasicSimulationBatch<Scalar>::set_thread_count(const std::size_t threads)
+    {
+        if (threads <= 1) {
+            m_thread_pool.reset();
+        } else {
+            m_thread_pool = std::make_unique<ThreadPool>(threads);
+        }
+    }
+
+    template<typename Scalar>
+    void BasicSimulationBatch<Scalar>::update(const double dt)
+    {
+        update(dt, 1);
+    }
+
+    template<typename Scalar>
+    void BasicSimulationBatch<Scalar>::update(const double dt, const int steps)
+    {
+        for_each_world([dt, steps](Simulation& simulation) {
+            for (int i = 0; i < steps; ++i) {
+                simulation.update(dt);
+            }
+        });
+    }
+
+    template<typename Scalar>
+    void BasicSimulationBatch<Scalar>::read_states(const std::span<const RigidBodyHandle> bodies,
+                                                   const std::span<BodyState> states) const
+    {
+        assert(states.size() == m_worlds.size() * bodies.size());
+        std::size_t index = 0;
+        for (const std::unique_ptr<Simulation>& simulation: m_worlds) {
+            for (const RigidBodyHandle body: bodies) {
+                const typename Simulation::RigidBody& rigid_body = simulation->lookup(body);
+                states[index++] = {
+                        .position = rigid_body.position(),
+                        .orientation = rigid_body.orientation(),
+                        .velocity = rigid_body.velocity(),
+                        .angular_velocity = rigid_body.angular_velocity(),
+                };
+            }
+        }
+    }
+
+    template<typename Scalar>
+    void BasicSimulationBatch<Scalar>::read_states(const std::span<const RigidBodyHandle> bodies,
+                                                   const BodyStateArrays& arrays) const
+    {
+        [[maybe_unused]] const std::size_t count = m_worlds.size() * bodies.size();
+        assert(arrays.positions.empty() || arrays.positions.size() == count);
+        assert(arrays.orientations.empty() || arrays.orientations.size() == count);
+        assert(arrays.velocities.empty() || arrays.velocities.size() == count);
+        assert(arrays.angular_velocities.empty() || arrays.angular_velocities.size() == count);
+
+        // fill one array at a time, such that each loop only writes to one array
+        auto fill = [this, bodies](const auto& span, const auto& get) {
+            if (span.empty()) {
+                return;
+            }
+            std::size_t index = 0;
+            for (const std::unique_ptr<Simulation>& simulation: m_worlds) {
+                for (const RigidBodyHandle body: bodies) {
+                    span[index++] = get(simulation->lookup(body));
+                }
+            }
+        };
+        using RigidBody = typename Simulation::RigidBody;
+        fill(arrays.positions, [](const RigidBody& body) { return body.position(); });
+        fill(arrays.orientations, [](const RigidBody& body) { return body.orientation(); });
+        fill(arrays.velocities, [](const RigidBody& body) { return body.velocity(); });
+        fill(arrays.angular_velocities, [](const RigidBody& body) { return body.angular_velocity(); });
+    }
+
+    template<typename Scalar>
+    template<typename Function>
+    void BasicSimulationBatch<Scalar>::for_each_world(Function&& function)
+    {
+        if (!m_thread_pool) {
+            for (const std::unique_ptr<Simulation>& simulation: m_worlds) {
+                function(*simulation);
+            }
+            return;
+        }
+
+        // the threads take the next world until all are done, which balances worlds of different cost
+        m_next_world.store(0, std::memory_order_relaxed);
+        m_thread_pool->run([this, &function](std::size_t) {
+            for (std::size_t world = m_next_world.fetch_add(1, std::memory_order_relaxed); world < m_worlds.size();
+                 world = m_next_world.fetch_add(1, std::memory_order_relaxed)) {
+                function(*m_worlds[world]);
+            }
+        });
+    }
+
+    template class BasicSimulationBatch<float>;
+    template class BasicSimulationBatch<double>;
+}
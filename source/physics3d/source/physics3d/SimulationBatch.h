@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <math/quaternion.h>
+#include <math/vector.h>
+
+#include "Simulation.h"
+#include "ThreadPool.h"
+
+namespace yage::physics3d
+{
+    /**
+     * Kinematic state of a body that is read back from a batch of simulations.
+     */
+    struct BodyState
+    {
+        math::Vec3d position{};
+        math::Quatd orientation{};
+        math::Vec3d velocity{};
+        math::Vec3d angular_velocity{};
+    };
+
+    /**
+     * Separate arrays for each part of the body state, e.g. to pass positions to a learning framework without
+     * copying them again. Empty arrays are not written.
+     */
+    struct BodyStateArrays
+    {
+        std::span<math::Vec3d> positions{};
+        std::span<math::Quatd> orientations{};
+        std::span<math::Vec3d> velocities{};
+        std::span<math::Vec3d> angular_velocities{};
+    };
+
+    /**
+     * Owns many small, independent simulations, e.g. the worlds of a parameter sweep or of reinforcement learning
+     * environments, and steps them in parallel. Each simulation is stepped by a single thread, so worlds that take
+     * different times to step are balanced over the threads. A world yields the same results as when it is stepped on
+     * its own.
+     *
+     * The simulations don't have a visualizer, so a batch runs without any graphics context.
+     */
+    template<typename Scalar>
+    class BasicSimulationBatch
+    {
+    public:
+        using Simulation = BasicSimulation<Scalar>;
+
+        /**
+         * @param worlds The number of empty simulations to create.
+         * @param threads The number of threads that step the simulations, including the calling thread.
+         */
+        explicit BasicSimulationBatch(std::size_t worlds, std::size_t threads = 1);
+
+        /**
+         * @return The number of simulations.
+         */
+        [[nodiscard]]
+        std::size_t size() const;
+
+        /**
+         * Gives access to a simulation to create bodies and to change its settings. Simulations of a batch should
+         * not use threads of their own.
+         */
+        Simulation& world(std::size_t index);
+
+        [[nodiscard]]
+        const Simulation& world(std::size_t index) const;
+
+        /**
+         * Sets the number of threads that step the simulations, including the calling thread.
+         */
+        void set_thread_count(std::size_t threads);
+
+        /**
+         * Steps all simulations once.
+         * @param dt Simulation delta time for this step in seconds.
+         */
+        void update(double dt);
+
+        /**
+         * Steps all simulations several times, where each thread steps its simulations to the end before taking the
+         * next ones, which synchronizes the threads only once.
+         * @param dt Simulation delta time for each step in seconds.
+         * @param steps The number of steps.
+         */
+        void update(double dt, int steps);
+
+        /**
+         * Copies the state of the same bodies of every simulation into an array, ordered by simulation first, such
+         * that the state of body i of simulation w is at w * bodies.size() + i. Simulations that were set up by the
+         * same sequence of calls hand out the same handles, so a single list of handles addresses all of them.
+         * @param bodies Handles that every simulation contains.
+         * @param states Receives the states, must have a size of size() * bodies.size().
+         */
+        void read_states(std::span<const RigidBodyHandle> bodies, std::span<BodyState> states) const;
+
+        /**
+         * Copies the state of the same bodies of every simulation into separate arrays, in the same order as for a
+         * single array of states.
+         * @param bodies Handles that every simulation contains.
+         * @param arrays Receives the states, where each array is either empty or has a size of
+         * size() * bodies.size().
+         */
+        void read_states(std::span<const RigidBodyHandle> bodies, const BodyStateArrays& arrays) const;
+
+    private:
+        /**
+         * The simulations are allocated separately, such that threads stepping neighbouring worlds don't write to the
+         * same cache lines.
+         */
+        std::vector<std::unique_ptr<Simulation>> m_worlds;
+
+        std::unique_ptr<ThreadPool> m_thread_pool;
+
+        /**
+         * Index of the next simulation that a thread takes during an update.
+         */
+        std::atomic<std::size_t> m_next_world = 0;
+
+        template<typename Function>
+        void for_each_world(Function&& function);
+    };
+
+    using SimulationBatch = BasicSimulationBatch<double>;
+
+    using FloatSimulationBatch = BasicSimulationBatch<float>;
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace yage::physics3d
+{
+    /**
+     * Whether values of a type are stored in snapshots by copying their bytes. Pairs are not trivially copyable due to
+     * their assignment operators, but their bytes can be copied if those of their members can.
+     */
+    template<typename T>
+    constexpr bool is_bytewise_copyable = std::is_trivially_copyable_v<T>;
+
+    template<typename A, typename B>
+    constexpr bool is_bytewise_copyable<std::pair<A, B>> = is_bytewise_copyable<A> && is_bytewise_copyable<B>;
+
+    /**
+     * The state of a simulation in a single contiguous buffer of trivially copyable data, from which the simulation
+     * can be restored, e.g. to re-simulate steps for rollback or replays. A snapshot can be reused, such that saving
+     * into it doesn't allocate once it has grown to the size of the state. Snapshots are only valid for the build of
+     * the library that created them.
+     */
+    class Snapshot
+    {
+    public:
+        /**
+         * @return The size of the snapshot in bytes.
+         */
+        [[nodiscard]]
+        std::size_t size() const
+        {
+            return m_data.size();
+        }
+
+        [[nodiscard]]
+        const std::byte* data() const
+        {
+            return m_data.data();
+        }
+
+    private:
+        std::vector<std::byte> m_data;
+
+        friend class SnapshotWriter;
+        friend class SnapshotReader;
+    };
+
+    /**
+     * Appends values to a snapshot.
+     */
+    class SnapshotWriter
+    {
+    public:
+        /**
+         * Clears the snapshot, but keeps its memory.
+         */
+        explicit SnapshotWriter(Snapshot& snapshot)
+            : m_data(snapshot.m_data)
+        {
+            m_data.clear();
+        }
+
+        template<typename T>
+        void write(const T& value)
+        {
+            static_assert(is_bytewise_copyable<T>);
+            write_bytes(&value, sizeof(T));
+        }
+
+        /**
+         * Writes the size of a vector followed by its elements.
+         */
+        template<typename T>
+        void write(const std::vector<T>& values)
+        {
+            static_assert(is_bytewise_copyable<T>);
+            write(values.size());
+            write_bytes(values.data(), values.size() * sizeof(T));
+        }
+
+    private:
+        std::vector<std::byte>& m_data;
+
+        void write_bytes(const void* bytes, const std::size_t count)
+        {
+            const auto* begin = static_cast<const std::byte*>(bytes);
+            m_data.insert(m_data.end(), begin, begin + count);
+        }
+    };
+
+    /**
+     * Reads values from a snapshot in the order they were written.
+     */
+    class SnapshotReader
+    {
+    public:
+        explicit SnapshotReader(const Snapshot& snapshot)
+            : m_data(snapshot.m_data)
+        {
+        }
+
+        template<typename T>
+        void read(T& value)
+        {
+            static_assert(is_bytewise_copyable<T>);
+            read_bytes(&value, sizeof(T));
+        }
+
+        /**
+         * Reads a vector that was written along with its size, reusing the memory of the given vector.
+         */
+        template<typename T>
+        void read(std::vector<T>& values)
+        {
+            static_assert(is_bytewise_copyable<T>);
+            std::size_t size;
+            read(size);
+            if constexpr (std::is_default_constructible_v<T>) {
+                values.resize(size);
+            } else {
+                // missing elements can't be value-initialized, so they are created as copies from the snapshot
+                values.erase(values.begin() + static_cast<std::ptrdiff_t>(std::min(size, values.size())),
+                             values.end());
+                while (values.size() < size) {
+                    values.push_back(peek<T>(values.size() * sizeof(T)));
+                }
+            }
+            read_bytes(values.data(), size * sizeof(T));
+        }
+
+        /**
+         * @return Whether all values of the snapshot have been read.
+         */
+        [[nodiscard]]
+        bool at_end() const
+        {
+            return m_offset == m_data.size();
+        }
+
+    private:
+        const std::vector<std::byte>& m_data;
+        std::size_t m_offset = 0;
+
+        void read_bytes(void* bytes, const std::size_t count)
+        {
+            assert(m_offset + count <= m_data.size());
+            if (count > 0) {
+                std::memcpy(bytes, m_data.data() + m_offset, count);
+            }
+            m_offset += count;
+        }
+
+        template<typename T>
+        [[nodiscard]]
+        T peek(const std::size_t offset) const
+        {
+            assert(m_offset + offset + sizeof(T) <= m_data.size());
+            std::array<std::byte, sizeof(T)> bytes;
+            std::memcpy(bytes.data(), m_data.data() + m_offset + offset, sizeof(T));
+            return std::bit_cast<T>(bytes);
+        }
+    };
+}
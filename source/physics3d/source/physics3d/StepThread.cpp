@@ -0,0 +1,63 @@
+#include "StepThread.h"
+
+namespace yage::physics3d
+{
+    StepThread::StepThread()
+            : m_worker([this] { work(); })
+    {
+    }
+
+    StepThread::~StepThread()
+    {
+        {
+            std::unique_lock lock(m_mutex);
+            m_task_done.wait(lock, [this] { return m_task == nullptr; });
+            m_stop = true;
+        }
+        m_task_available.notify_one();
+        m_worker.join();
+    }
+
+    void StepThread::wait()
+    {
+        std::unique_lock lock(m_mutex);
+        m_task_done.wait(lock, [this] { return m_task == nullptr; });
+    }
+
+    void StepThread::start_erased(void* task, const TaskFunction function)
+    {
+        {
+            std::unique_lock lock(m_mutex);
+            m_task_done.wait(lock, [this] { return m_task == nullptr; });
+            m_task = task;
+            m_task_function = function;
+        }
+        m_task_available.notify_one();
+    }
+
+    void StepThread::work()
+    {
+        while (true) {
+            void* task;
+            TaskFunction function;
+            {
+                std::unique_lock lock(m_mutex);
+                m_task_available.wait(lock, [this] { return m_stop || m_task != nullptr; });
+                if (m_stop) {
+                    return;
+                }
+                task = m_task;
+                function = m_task_function;
+            }
+
+            function(task);
+
+            {
+                std::lock_guard lock(m_mutex);
+                m_task = nullptr;
+                m_task_function = nullptr;
+            }
+            m_task_done.notify_all();
+        }
+    }
+}
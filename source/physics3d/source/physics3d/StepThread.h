@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+namespace yage::physics3d
+{
+    /**
+     * A worker thread that runs one task at a time in the background, e.g. the simulation steps of a frame while the
+     * calling thread renders the previous one.
+     */
+    class StepThread
+    {
+    public:
+        StepThread();
+
+        StepThread(const StepThread&) = delete;
+
+        StepThread& operator=(const StepThread&) = delete;
+
+        /**
+         * Waits for a running task before stopping the thread.
+         */
+        ~StepThread();
+
+        /**
+         * Starts a task on the worker thread and returns without waiting for it. The task is passed by reference, so
+         * it must stay alive until the task is done, while starting it doesn't allocate memory.
+         * @param task Called without arguments. A previously started task is waited for first.
+         */
+        template<typename Task>
+        void start(Task& task)
+        {
+            using TaskType = std::remove_reference_t<Task>;
+            start_erased(const_cast<void*>(static_cast<const void*>(std::addressof(task))),
+                         [](void* erased) { (*static_cast<TaskType*>(erased))(); });
+        }
+
+        /**
+         * Blocks until the last started task is done, which makes everything the task has written visible to the
+         * calling thread. Returns immediately if no task is running.
+         */
+        void wait();
+
+    private:
+        using TaskFunction = void (*)(void* task);
+
+        std::mutex m_mutex;
+        std::condition_variable m_task_available;
+        std::condition_variable m_task_done;
+        void* m_task = nullptr;
+        TaskFunction m_task_function = nullptr;
+        bool m_stop = false;
+
+        /**
+         * Started last, such that the worker only sees initialized members.
+         */
+        std::thread m_worker;
+
+        void start_erased(void* task, TaskFunction function);
+
+        void work();
+    };
+}
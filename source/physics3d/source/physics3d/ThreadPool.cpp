@@ -0,0 +1,99 @@
+#include <algorithm>
+
+#include "ThreadPool.h"
+
+namespace yage::physics3d
+{
+    ThreadPool::ThreadPool(const std::size_t threads)
+            : m_barrier(static_cast<std::ptrdiff_t>(std::max<std::size_t>(threads, 1)))
+    {
+        for (std::size_t i = 1; i < threads; ++i) {
+            m_workers.emplace_back([this, i] { work(i); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stop = true;
+        }
+        m_task_available.notify_all();
+        for (std::thread& worker: m_workers) {
+            worker.join();
+        }
+    }
+
+    std::size_t ThreadPool::size() const
+    {
+        return m_workers.size() + 1;
+    }
+
+    void ThreadPool::arrive_and_wait()
+    {
+        m_barrier.arrive_and_wait();
+    }
+
+    void ThreadPool::run_erased(void* task, const TaskFunction function)
+    {
+        if (m_workers.empty()) {
+            function(task, 0);
+            return;
+        }
+
+        {
+            std::lock_guard lock(m_mutex);
+            m_task = task;
+            m_task_function = function;
+            m_pending = m_workers.size();
+            ++m_generation;
+        }
+        m_task_available.notify_all();
+
+        function(task, 0);
+
+        std::unique_lock lock(m_mutex);
+        m_task_done.wait(lock, [this] { return m_pending == 0; });
+        m_task = nullptr;
+        m_task_function = nullptr;
+    }
+
+    std::pair<std::size_t, std::size_t> ThreadPool::chunk(const std::size_t count, const std::size_t thread) const
+    {
+        // the first (count % threads) chunks get one additional element
+        const std::size_t threads = size();
+        const std::size_t base = count / threads;
+        const std::size_t remainder = count % threads;
+        const std::size_t begin = thread * base + std::min(thread, remainder);
+        return {begin, begin + base + (thread < remainder ? 1 : 0)};
+    }
+
+    void ThreadPool::work(const std::size_t thread)
+    {
+        std::uint64_t generation = 0;
+        while (true) {
+            void* task;
+            TaskFunction function;
+            {
+                std::unique_lock lock(m_mutex);
+                m_task_available.wait(lock, [this, generation] { return m_stop || m_generation != generation; });
+                if (m_stop) {
+                    return;
+                }
+                generation = m_generation;
+                task = m_task;
+                function = m_task_function;
+            }
+
+            function(task, thread);
+
+            {
+                std::lock_guard lock(m_mutex);
+                --m_pending;
+                if (m_pending == 0) {
+                    m_task_done.notify_one();
+                }
+            }
+        }
+    }
+}
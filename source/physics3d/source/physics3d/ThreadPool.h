@@ -0,0 +1,100 @@
+#pragma once
+
+#include <barrier>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace yage::physics3d
+{
+    /**
+     * A fixed set of worker threads that execute the same task in parallel, with the calling thread taking part as
+     * the first thread.
+     */
+    class ThreadPool
+    {
+    public:
+        /**
+         * @param threads The total number of threads, including the calling thread.
+         */
+        explicit ThreadPool(std::size_t threads);
+
+        ThreadPool(const ThreadPool&) = delete;
+
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool();
+
+        /**
+         * @return The total number of threads, including the calling thread.
+         */
+        [[nodiscard]]
+        std::size_t size() const;
+
+        /**
+         * Executes a task once on every thread and blocks until all threads are done. The task is passed by reference
+         * to the workers, so running a task doesn't allocate memory.
+         * @param task Called with the index of the executing thread in [0, size()), where 0 is the calling thread.
+         */
+        template<typename Task>
+        void run(Task&& task)
+        {
+            using TaskType = std::remove_reference_t<Task>;
+            run_erased(const_cast<void*>(static_cast<const void*>(std::addressof(task))),
+                       [](void* erased, const std::size_t thread) { (*static_cast<TaskType*>(erased))(thread); });
+        }
+
+        /**
+         * Blocks until all threads have reached this point. Can only be called from within a task that is being run,
+         * where every thread must call it equally often.
+         */
+        void arrive_and_wait();
+
+        /**
+         * Splits the range [0, count) into contiguous chunks, one per thread, and processes them in parallel. The split
+         * only depends on the count and the number of threads.
+         * @param function Called with the begin and end of a chunk and the index of the executing thread.
+         */
+        template<typename Function>
+        void parallel_for(const std::size_t count, Function&& function)
+        {
+            run([this, count, &function](const std::size_t thread) {
+                const auto [begin, end] = chunk(count, thread);
+                if (begin < end) {
+                    function(begin, end, thread);
+                }
+            });
+        }
+
+        /**
+         * @return The chunk of the range [0, count) that is assigned to a thread by parallel_for.
+         */
+        [[nodiscard]]
+        std::pair<std::size_t, std::size_t> chunk(std::size_t count, std::size_t thread) const;
+
+    private:
+        using TaskFunction = void (*)(void* task, std::size_t thread);
+
+        std::vector<std::thread> m_workers;
+
+        std::mutex m_mutex;
+        std::condition_variable m_task_available;
+        std::condition_variable m_task_done;
+        void* m_task = nullptr;
+        TaskFunction m_task_function = nullptr;
+        std::uint64_t m_generation = 0;
+        std::size_t m_pending = 0;
+        bool m_stop = false;
+
+        std::barrier<> m_barrier;
+
+        void run_erased(void* task, TaskFunction function);
+
+        void work(std::size_t thread);
+    };
+}
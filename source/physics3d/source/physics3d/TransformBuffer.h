@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include <math/quaternion.h>
+#include <math/vector.h>
+
+namespace yage::physics3d
+{
+    struct BodyPose
+    {
+        math::Vec3d position{};
+        math::Quatd orientation{};
+    };
+
+    /**
+     * Passes the poses of rigid bodies from a thread that steps the simulation to a thread that renders them. The
+     * stepping thread writes the poses of a frame into the back buffer and publishes them at once, while the rendering
+     * thread reads the front buffer without locking. Each pose is kept for the last two steps, such that the reader
+     * can interpolate between them.
+     *
+     * Publishing flips the buffers, so the writer must not write the back buffer again before the reader is done with
+     * the previous front buffer, e.g. by waiting for each other once per frame.
+     * @tparam Target Identifies what a pose is applied to, e.g. a scene node.
+     */
+    template<typename Target>
+    class TransformBuffer
+    {
+    public:
+        struct Transform
+        {
+            Target target{};
+            BodyPose previous{};
+            BodyPose current{};
+        };
+
+        struct Frame
+        {
+            std::vector<Transform> transforms;
+
+            /**
+             * How far the reader should blend from the previous to the current poses, in [0, 1].
+             */
+            double alpha = 1;
+        };
+
+        /**
+         * @return The frame that is published next, which only the writer may access.
+         */
+        Frame& back()
+        {
+            return m_frames[1 - m_front.load(std::memory_order_relaxed)];
+        }
+
+        /**
+         * @return The last published frame, which the writer may only read, e.g. to carry poses over to its next frame.
+         */
+        [[nodiscard]]
+        const Frame& front() const
+        {
+            return m_frames[m_front.load(std::memory_order_acquire)];
+        }
+
+        /**
+         * Makes the back buffer the front buffer, such that the reader sees all poses of the frame at once.
+         */
+        void publish()
+        {
+            m_front.store(1 - m_front.load(std::memory_order_relaxed), std::memory_order_release);
+        }
+
+        /**
+         * Blends two poses, where the orientation is interpolated along the shorter arc.
+         */
+        [[nodiscard]]
+        static BodyPose interpolate(const BodyPose& previous, const BodyPose& current, const double alpha)
+        {
+            const math::Quatd& a = previous.orientation;
+            const math::Quatd& b = current.orientation;
+            const double cos = a.w() * b.w() + a.x() * b.x() + a.y() * b.y() + a.z() * b.z();
+
+            math::Quatd orientation = a * (1 - alpha);
+            orientation += b * (cos < 0 ? -alpha : alpha);
+            return {
+                    .position = previous.position + (current.position - previous.position) * alpha,
+                    .orientation = normalize(orientation),
+            };
+        }
+
+    private:
+        std::array<Frame, 2> m_frames;
+        std::atomic<std::size_t> m_front = 0;
+    };
+}
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+#include <tuple>
+
+#include "TriangleMesh.h"
+
+namespace yage::physics3d
+{
+    namespace
+    {
+        constexpr std::uint32_t max_leaf_size = 4;
+
+        /**
+         * Neighbouring triangles whose normals differ by less than about five degrees are considered coplanar.
+         */
+        constexpr double coplanar_cosine = 0.996;
+    }
+
+    TriangleMesh::TriangleMesh(const std::span<const math::Vec3d> vertices, const std::span<const std::uint32_t> indices)
+        : m_vertices(vertices.begin(), vertices.end())
+    {
+        assert(!indices.empty() && indices.size() % 3 == 0);
+
+        const std::size_t count = indices.size() / 3;
+        std::vector<std::array<std::uint32_t, 3>> triangles(count);
+        std::vector<geometry::AABB> bounds(count);
+        std::vector<math::Vec3d> centroids(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            triangles[i] = {indices[3 * i], indices[3 * i + 1], indices[3 * i + 2]};
+            const math::Vec3d& a = m_vertices[triangles[i][0]];
+            const math::Vec3d& b = m_vertices[triangles[i][1]];
+            const math::Vec3d& c = m_vertices[triangles[i][2]];
+            bounds[i] = geometry::merge({.min = a, .max = a}, geometry::merge({.min = b, .max = b}, {.min = c, .max = c}));
+            centroids[i] = (a + b + c) / 3.0;
+        }
+
+        std::vector<std::uint32_t> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        m_nodes.reserve(2 * count / max_leaf_size + 1);
+        build(order, 0, centroids, bounds);
+
+        // store the triangles in the order of the leaves, such that each leaf refers to a range of triangles
+        m_triangles.reserve(count);
+        m_triangle_bounds.reserve(count);
+        for (const std::uint32_t index: order) {
+            m_triangles.push_back(triangles[index]);
+            m_triangle_bounds.push_back(bounds[index]);
+        }
+        find_active_edges();
+    }
+
+    std::size_t TriangleMesh::size() const
+    {
+        return m_triangles.size();
+    }
+
+    TriangleMesh::Triangle TriangleMesh::triangle(const std::uint32_t index) const
+    {
+        const std::array<std::uint32_t, 3>& triangle = m_triangles[index];
+        return {m_vertices[triangle[0]], m_vertices[triangle[1]], m_vertices[triangle[2]]};
+    }
+
+    bool TriangleMesh::is_active_edge(const std::uint32_t index, const int edge) const
+    {
+        return (m_active_edges[index] >> edge & 1) != 0;
+    }
+
+    const geometry::AABB& TriangleMesh::bounds() const
+    {
+        return m_nodes.front().aabb;
+    }
+
+    void TriangleMesh::build(const std::span<std::uint32_t> order, const std::uint32_t first,
+                             const std::span<const math::Vec3d> centroids,
+                             const std::span<const geometry::AABB> bounds)
+    {
+        const std::size_t index = m_nodes.size();
+        m_nodes.emplace_back();
+
+        geometry::AABB aabb = bounds[order.front()];
+        geometry::AABB centroid_bounds{.min = centroids[order.front()], .max = centroids[order.front()]};
+        for (const std::uint32_t triangle: order) {
+            aabb = geometry::merge(aabb, bounds[triangle]);
+            centroid_bounds = geometry::merge(centroid_bounds,
+                                              {.min = centroids[triangle], .max = centroids[triangle]});
+        }
+        m_nodes[index].aabb = aabb;
+
+        if (order.size() <= max_leaf_size) {
+            m_nodes[index].first = first;
+            m_nodes[index].count = static_cast<std::uint32_t>(order.size());
+            return;
+        }
+
+        // split at the median of the centroids along the axis in which they are spread the most
+        const math::Vec3d extent = centroid_bounds.max - centroid_bounds.min;
+        const int axis = extent.x() >= extent.y() && extent.x() >= extent.z() ? 0 : extent.y() >= extent.z() ? 1 : 2;
+        const std::size_t half = order.size() / 2;
+        std::ranges::nth_element(order, order.begin() + static_cast<std::ptrdiff_t>(half), {},
+                                 [&centroids, axis](const std::uint32_t triangle) {
+                                     return centroids[triangle](axis);
+                                 });
+
+        build(order.first(half), first, centroids, bounds);
+        m_nodes[index].first = static_cast<std::uint32_t>(m_nodes.size());
+        build(order.subspan(half), first + static_cast<std::uint32_t>(half), centroids, bounds);
+    }
+
+    void TriangleMesh::find_active_edges()
+    {
+        // vertices with equal positions share the smallest index among them
+        std::vector<std::uint32_t> sorted(m_vertices.size());
+        std::iota(sorted.begin(), sorted.end(), 0);
+        auto position = [this](const std::uint32_t vertex) {
+            const math::Vec3d& p = m_vertices[vertex];
+            return std::tuple(p.x(), p.y(), p.z());
+        };
+        std::ranges::sort(sorted, {}, position);
+        std::vector<std::uint32_t> shared(m_vertices.size());
+        for (std::size_t i = 0; i < sorted.size(); ++i) {
+            const bool same = i > 0 && position(sorted[i]) == position(sorted[i - 1]);
+            shared[sorted[i]] = same ? shared[sorted[i - 1]] : sorted[i];
+        }
+
+        struct Edge
+        {
+            std::uint32_t vertex_a;
+            std::uint32_t vertex_b;
+            std::uint32_t triangle;
+            int edge;
+        };
+        std::vector<Edge> edges;
+        edges.reserve(3 * m_triangles.size());
+        for (std::uint32_t i = 0; i < m_triangles.size(); ++i) {
+            for (int j = 0; j < 3; ++j) {
+                const std::uint32_t a = shared[m_triangles[i][j]];
+                const std::uint32_t b = shared[m_triangles[i][(j + 1) % 3]];
+                edges.push_back({std::min(a, b), std::max(a, b), i, j});
+            }
+        }
+        std::ranges::sort(edges, {}, [](const Edge& edge) { return std::pair(edge.vertex_a, edge.vertex_b); });
+
+        auto normal = [this](const std::uint32_t triangle) {
+            const Triangle vertices = this->triangle(triangle);
+            return cross(vertices[1] - vertices[0], vertices[2] - vertices[0]);
+        };
+
+        // boundary edges and edges with more than two triangles are always active
+        m_active_edges.assign(m_triangles.size(), 0b111);
+        for (std::size_t begin = 0, end; begin < edges.size(); begin = end) {
+            end = begin + 1;
+            while (end < edges.size() && edges[end].vertex_a == edges[begin].vertex_a &&
+                   edges[end].vertex_b == edges[begin].vertex_b) {
+                ++end;
+            }
+            if (end - begin != 2) {
+                continue;
+            }
+
+            const Edge& first = edges[begin];
+            const Edge& second = edges[begin + 1];
+            const math::Vec3d opposite = triangle(second.triangle)[(second.edge + 2) % 3];
+            if (!physics3d::is_active_edge(normal(first.triangle), triangle(first.triangle)[first.edge],
+                                           normal(second.triangle), opposite)) {
+                m_active_edges[first.triangle] &= static_cast<std::uint8_t>(~(1u << first.edge));
+                m_active_edges[second.triangle] &= static_cast<std::uint8_t>(~(1u << second.edge));
+            }
+        }
+    }
+
+    bool is_active_edge(const math::Vec3d& normal_first, const math::Vec3d& on_edge, const math::Vec3d& normal_second,
+                        const math::Vec3d& opposite)
+    {
+        if (length_sqr(normal_first) == 0 || length_sqr(normal_second) == 0) {
+            return true;
+        }
+
+        // the edge is convex if the opposite vertex of the second triangle lies below the first triangle
+        const bool convex = dot(opposite - on_edge, normal_first) < 0;
+        const bool coplanar = dot(normalize(normal_first), normalize(normal_second)) >= coplanar_cosine;
+        return convex && !coplanar;
+    }
+}
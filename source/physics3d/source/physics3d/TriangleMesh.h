@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <math/vector.h>
+
+#include "Algorithms.h"
+
+namespace yage::physics3d
+{
+    /**
+     * An indexed triangle mesh in the local space of a static body, such as the level geometry of a gl3d mesh. The
+     * triangles are kept in a bounding volume hierarchy that is built once, such that collisions only test the few
+     * triangles near a body.
+     *
+     * Edges between two triangles that are nearly coplanar, or that form a valley, are marked as inactive. Bodies that
+     * slide over such an edge would otherwise catch on it, since the contact normal of an edge points sideways.
+     *
+     * Meshes are immutable and meant to be shared by all colliders with the same geometry, which refer to the mesh and
+     * must not outlive it.
+     */
+    class TriangleMesh
+    {
+    public:
+        using Triangle = std::array<math::Vec3d, 3>;
+
+        /**
+         * @param vertices Vertex positions in the local space of the body.
+         * @param indices Three vertex indices per triangle, in counter-clockwise winding order like the index buffers
+         * of gl3d meshes. Vertices with equal positions are treated as shared, so meshes that were split for normals
+         * or texture coordinates don't need to be welded.
+         */
+        TriangleMesh(std::span<const math::Vec3d> vertices, std::span<const std::uint32_t> indices);
+
+        [[nodiscard]]
+        std::size_t size() const;
+
+        /**
+         * @return The vertices of a triangle in local space. Triangles are reordered during construction, so their
+         * indices don't match the order of the index buffer.
+         */
+        [[nodiscard]]
+        Triangle triangle(std::uint32_t index) const;
+
+        /**
+         * @return Whether contacts may use the normal of an edge of a triangle, where edge i runs from vertex i to
+         * vertex i + 1. Otherwise, they use the normal of the triangle.
+         */
+        [[nodiscard]]
+        bool is_active_edge(std::uint32_t index, int edge) const;
+
+        /**
+         * @return The local-space bounds of all triangles.
+         */
+        [[nodiscard]]
+        const geometry::AABB& bounds() const;
+
+        /**
+         * Finds all triangles whose bounds overlap a local-space box.
+         * @param callback Invoked with the index of each overlapping triangle.
+         */
+        template<typename Callback>
+        void query(const geometry::AABB& aabb, Callback&& callback) const
+        {
+            NodeStack stack;
+            std::size_t top = 0;
+            stack[top++] = 0;
+            while (top > 0) {
+                const Node& node = m_nodes[stack[--top]];
+                if (!geometry::overlaps(node.aabb, aabb)) {
+                    continue;
+                }
+
+                if (node.count > 0) {
+                    for (std::uint32_t i = node.first; i < node.first + node.count; ++i) {
+                        if (geometry::overlaps(m_triangle_bounds[i], aabb)) {
+                            callback(i);
+                        }
+                    }
+                } else {
+                    // the left child directly follows its parent
+                    stack[top++] = node.first;
+                    stack[top++] = static_cast<std::uint32_t>(&node - m_nodes.data()) + 1;
+                }
+            }
+        }
+
+        /**
+         * Reports all triangles whose bounds, grown by a radius, are hit by a local-space line segment, like
+         * DynamicAabbTree::sweep.
+         * @param callback Invoked with the index of each hit triangle. Returns the fraction of the segment that is
+         * searched further.
+         */
+        template<typename Callback>
+        void sweep(const math::Vec3d& start, const math::Vec3d& displacement, const double radius,
+                   double max_fraction, Callback&& callback) const
+        {
+            auto hits = [&](const geometry::AABB& aabb) {
+                const geometry::AABB bounds{
+                        .min = aabb.min - math::Vec3d(radius),
+                        .max = aabb.max + math::Vec3d(radius),
+                };
+                return geometry::intersects(bounds, start, max_fraction * displacement);
+            };
+
+            NodeStack stack;
+            std::size_t top = 0;
+            stack[top++] = 0;
+            while (top > 0 && max_fraction > 0) {
+                const Node& node = m_nodes[stack[--top]];
+                if (!hits(node.aabb)) {
+                    continue;
+                }
+
+                if (node.count > 0) {
+                    for (std::uint32_t i = node.first; i < node.first + node.count; ++i) {
+                        if (hits(m_triangle_bounds[i])) {
+                            max_fraction = std::min(max_fraction, callback(i));
+                        }
+                    }
+                } else {
+                    stack[top++] = node.first;
+                    stack[top++] = static_cast<std::uint32_t>(&node - m_nodes.data()) + 1;
+                }
+            }
+        }
+
+    private:
+        /**
+         * A node of the hierarchy, stored in depth-first order.
+         */
+        struct Node
+        {
+            geometry::AABB aabb;
+
+            /**
+             * The first triangle of leaves, or the right child of inner nodes.
+             */
+            std::uint32_t first{};
+
+            /**
+             * The number of triangles of leaves, or zero for inner nodes.
+             */
+            std::uint32_t count{};
+        };
+
+        /**
+         * Splitting at the median bounds the depth of the hierarchy by the logarithm of the triangle count, so the
+         * traversal stack never overflows.
+         */
+        using NodeStack = std::array<std::uint32_t, 64>;
+
+        std::vector<math::Vec3d> m_vertices;
+        std::vector<std::array<std::uint32_t, 3>> m_triangles;
+        std::vector<geometry::AABB> m_triangle_bounds;
+        /**
+         * One bit per edge of each triangle.
+         */
+        std::vector<std::uint8_t> m_active_edges;
+        std::vector<Node> m_nodes;
+
+        /**
+         * Builds the subtree of a range of triangles.
+         * @param order The triangles of the subtree, which are reordered such that each leaf refers to a range.
+         * @param first The position of the first triangle of the range in the final order.
+         */
+        void build(std::span<std::uint32_t> order, std::uint32_t first, std::span<const math::Vec3d> centroids,
+                   std::span<const geometry::AABB> bounds);
+
+        void find_active_edges();
+    };
+
+    /**
+     * Decides whether contacts may use the normal of an edge that is shared by two triangles, which is not the case if
+     * the triangles are nearly coplanar or form a valley at the edge.
+     * @param normal_first The normal of the first triangle, which need not be normalized.
+     * @param on_edge A vertex of the edge.
+     * @param normal_second The normal of the second triangle, which need not be normalized.
+     * @param opposite The vertex of the second triangle that does not lie on the edge.
+     * @return Whether the edge is active, which includes edges of degenerate triangles.
+     */
+    bool is_active_edge(const math::Vec3d& normal_first, const math::Vec3d& on_edge, const math::Vec3d& normal_second,
+                        const math::Vec3d& opposite);
+}
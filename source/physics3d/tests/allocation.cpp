@@ -0,0 +1,166 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/Simulation.h>
+
+using namespace yage::physics3d;
+using namespace yage::math;
+
+namespace
+{
+    std::atomic<bool> counting = false;
+    std::atomic<std::size_t> allocations = 0;
+
+    void* allocate(const std::size_t size)
+    {
+        if (counting) {
+            ++allocations;
+        }
+        if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+            return pointer;
+        }
+        throw std::bad_alloc();
+    }
+
+    void* allocate_aligned(const std::size_t size, const std::align_val_t alignment)
+    {
+        if (counting) {
+            ++allocations;
+        }
+        const auto align = static_cast<std::size_t>(alignment);
+        // aligned_alloc requires the size to be a multiple of the alignment
+        if (void* pointer = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+            return pointer;
+        }
+        throw std::bad_alloc();
+    }
+
+    /**
+     * Counts the heap allocations of all threads while the object is alive.
+     */
+    class AllocationCounter
+    {
+    public:
+        AllocationCounter()
+        {
+            allocations = 0;
+            counting = true;
+        }
+
+        ~AllocationCounter()
+        {
+            counting = false;
+        }
+
+        [[nodiscard]]
+        std::size_t count() const
+        {
+            return allocations;
+        }
+    };
+
+    const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+
+    void create_scene(Simulation& simulation)
+    {
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedPlane{.original_normal = Vec3d(0, 1, 0)}, material,
+                                     Vec3d(), Quatd());
+        for (int x = 0; x < 3; ++x) {
+            for (int y = 0; y < 3; ++y) {
+                simulation.create_rigid_body(InertiaShape::cube(1, 1), colliders::OrientedBox{.half_size = Vec3d(0.5)},
+                                             material, Vec3d(1.5 * x, 0.5 + 1.01 * y, 0), Quatd());
+            }
+        }
+    }
+}
+
+void* operator new(const std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](const std::size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new(const std::size_t size, const std::align_val_t alignment)
+{
+    return allocate_aligned(size, alignment);
+}
+
+void* operator new[](const std::size_t size, const std::align_val_t alignment)
+{
+    return allocate_aligned(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept
+{
+    std::free(pointer);
+}
+
+TEST_CASE("Steady state steps don't allocate")
+{
+    const std::size_t threads = GENERATE(1, 3);
+    CAPTURE(threads);
+
+    Simulation simulation;
+    simulation.enable_gravity();
+    simulation.disable_sleeping();
+    simulation.set_thread_count(threads);
+    create_scene(simulation);
+
+    // let the stacks settle, such that all buffers have reached their final size
+    for (int i = 0; i < 120; ++i) {
+        simulation.update(1. / 60.);
+    }
+
+    std::size_t count;
+    {
+        const AllocationCounter counter;
+        for (int i = 0; i < 60; ++i) {
+            simulation.update(1. / 60.);
+        }
+        count = counter.count();
+    }
+    CHECK(count == 0);
+}
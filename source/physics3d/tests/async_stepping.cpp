@@ -0,0 +1,129 @@
+#include <atomic>
+#include <cmath>
+#include <numbers>
+#include <semaphore>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/Simulation.h>
+#include <physics3d/StepThread.h>
+#include <physics3d/TransformBuffer.h>
+
+using namespace yage::physics3d;
+using namespace yage::math;
+
+TEST_CASE("Transform buffer")
+{
+    TransformBuffer<int> buffer;
+
+    SECTION("publishing swaps the buffers") {
+        buffer.back().transforms.push_back({.target = 1, .current = {.position = Vec3d(1, 2, 3)}});
+        buffer.back().alpha = 0.25;
+        CHECK(buffer.front().transforms.empty());
+
+        buffer.publish();
+        REQUIRE(buffer.front().transforms.size() == 1);
+        CHECK(buffer.front().transforms[0].target == 1);
+        CHECK(buffer.front().transforms[0].current.position == Vec3d(1, 2, 3));
+        CHECK(buffer.front().alpha == 0.25);
+        CHECK(buffer.back().transforms.empty());
+    }
+
+    SECTION("interpolation blends positions linearly") {
+        const BodyPose previous{.position = Vec3d(0, 0, 0)};
+        const BodyPose current{.position = Vec3d(2, -4, 1)};
+        CHECK(TransformBuffer<int>::interpolate(previous, current, 0).position == Vec3d(0, 0, 0));
+        CHECK(TransformBuffer<int>::interpolate(previous, current, 0.5).position == Vec3d(1, -2, 0.5));
+        CHECK(TransformBuffer<int>::interpolate(previous, current, 1).position == Vec3d(2, -4, 1));
+    }
+
+    SECTION("interpolation rotates along the shorter arc") {
+        // a rotation of 90 degrees about the y-axis, given as the equivalent negated quaternion
+        const double half = std::sqrt(0.5);
+        const BodyPose previous{.orientation = Quatd()};
+        const BodyPose current{.orientation = Quatd(-half, 0, -half, 0)};
+
+        const Quatd orientation = TransformBuffer<int>::interpolate(previous, current, 0.5).orientation;
+        const double angle = std::numbers::pi / 8;
+        CHECK(orientation.w() == Catch::Approx(std::cos(angle)));
+        CHECK(orientation.x() == Catch::Approx(0).margin(1e-12));
+        CHECK(orientation.y() == Catch::Approx(std::sin(angle)));
+        CHECK(orientation.z() == Catch::Approx(0).margin(1e-12));
+    }
+}
+
+TEST_CASE("Step thread")
+{
+    SECTION("tasks run in the background until waited for") {
+        StepThread thread;
+        std::atomic<bool> release = false;
+        int runs = 0;
+        auto task = [&] {
+            release.wait(false);
+            ++runs;
+        };
+
+        thread.start(task);
+        release = true;
+        release.notify_one();
+        thread.wait();
+        CHECK(runs == 1);
+
+        // starting again waits for nothing, since the previous task is done
+        thread.start(task);
+        thread.wait();
+        thread.wait();
+        CHECK(runs == 2);
+    }
+
+    SECTION("poses are published one frame ahead of the reader") {
+        const Material material{.restitution = 0, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+        auto create_scene = [&material](Simulation& simulation) {
+            simulation.enable_gravity();
+            simulation.create_rigid_body(InertiaShape::static_shape(),
+                                         colliders::OrientedPlane{.original_normal = Vec3d(0, 1, 0)}, material,
+                                         Vec3d(), Quatd());
+            return simulation.create_rigid_body(InertiaShape::sphere(0.5, 1), colliders::Sphere{.radius = 0.5},
+                                                material, Vec3d(0, 3, 0), Quatd());
+        };
+
+        Simulation reference;
+        const RigidBodyHandle reference_ball = create_scene(reference);
+        std::vector<Vec3d> expected;
+        for (int i = 0; i < 60; ++i) {
+            reference.update(1. / 60.);
+            expected.push_back(reference.lookup(reference_ball).position());
+        }
+
+        Simulation simulation;
+        const RigidBodyHandle ball = create_scene(simulation);
+        TransformBuffer<int> transforms;
+        std::binary_semaphore checked(0);
+        auto step = [&] {
+            // stay in flight until the reader has checked the published frame
+            checked.acquire();
+            TransformBuffer<int>::Frame& frame = transforms.back();
+            frame.transforms.resize(1);
+            frame.transforms[0].previous = {simulation.lookup(ball).position(), simulation.lookup(ball).orientation()};
+            simulation.update(1. / 60.);
+            frame.transforms[0].current = {simulation.lookup(ball).position(), simulation.lookup(ball).orientation()};
+            transforms.publish();
+        };
+
+        StepThread thread;
+        for (int i = 0; i < 60; ++i) {
+            thread.start(step);
+            // a failed REQUIRE would leave the worker waiting, so only CHECK before releasing it
+            const std::vector<TransformBuffer<int>::Transform>& published = transforms.front().transforms;
+            if (i > 0 && published.size() == 1) {
+                CHECK(published[0].current.position == expected[i - 1]);
+            } else {
+                CHECK(published.size() == (i > 0 ? 1u : 0u));
+            }
+            checked.release();
+            thread.wait();
+        }
+        CHECK(transforms.front().transforms[0].current.position == expected.back());
+    }
+}
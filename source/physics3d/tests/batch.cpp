@@ -0,0 +1,103 @@
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/SimulationBatch.h>
+
+using namespace yage::physics3d;
+using namespace yage::math;
+
+namespace
+{
+    const Material material{.restitution = 0.5, .kinetic_friction = 0.3, .rolling_friction = 0.05};
+
+    /**
+     * A ball that is pushed towards a box on the ground, where the push depends on the world.
+     */
+    std::vector<RigidBodyHandle> create_shot(Simulation& simulation, const std::size_t world)
+    {
+        simulation.enable_gravity();
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedPlane{.original_normal = Vec3d(0, 1, 0)}, material, Vec3d(),
+                                     Quatd());
+        const RigidBodyHandle ball = simulation.create_rigid_body(
+                InertiaShape::sphere(0.25, 1), colliders::Sphere{.radius = 0.25}, material, Vec3d(0, 0.25, 0),
+                Quatd());
+        const RigidBodyHandle box = simulation.create_rigid_body(
+                InertiaShape::cube(1, 1), colliders::OrientedBox{.half_size = Vec3d(0.5)}, material,
+                Vec3d(2, 0.5, 0), Quatd());
+
+        RigidBody& body = simulation.lookup(ball);
+        body.apply_force(Vec3d(60 * (1 + static_cast<double>(world)), 0, 10 * static_cast<double>(world)),
+                         body.position());
+        return {ball, box};
+    }
+}
+
+TEST_CASE("Simulation batch")
+{
+    constexpr std::size_t worlds = 7;
+    SimulationBatch batch(worlds, 3);
+    REQUIRE(batch.size() == worlds);
+
+    std::vector<RigidBodyHandle> bodies;
+    for (std::size_t world = 0; world < worlds; ++world) {
+        bodies = create_shot(batch.world(world), world);
+    }
+
+    SECTION("worlds match simulations stepped on their own") {
+        batch.update(1. / 60., 90);
+        batch.update(1. / 60.);
+
+        std::vector<BodyState> states(worlds * bodies.size());
+        batch.read_states(bodies, states);
+        for (std::size_t world = 0; world < worlds; ++world) {
+            Simulation simulation;
+            create_shot(simulation, world);
+            for (int i = 0; i < 91; ++i) {
+                simulation.update(1. / 60.);
+            }
+
+            for (std::size_t i = 0; i < bodies.size(); ++i) {
+                const BodyState& state = states[world * bodies.size() + i];
+                CHECK(state.position == simulation.lookup(bodies[i]).position());
+                CHECK(state.orientation == simulation.lookup(bodies[i]).orientation());
+                CHECK(state.velocity == simulation.lookup(bodies[i]).velocity());
+                CHECK(state.angular_velocity == simulation.lookup(bodies[i]).angular_velocity());
+            }
+        }
+
+        // the pushes differ between the worlds
+        CHECK(states[0].position != states[bodies.size()].position);
+    }
+
+    SECTION("separate arrays hold the same states") {
+        batch.update(1. / 60., 30);
+
+        std::vector<BodyState> states(worlds * bodies.size());
+        batch.read_states(bodies, states);
+
+        std::vector<Vec3d> positions(states.size());
+        std::vector<Vec3d> angular_velocities(states.size());
+        batch.read_states(bodies, BodyStateArrays{.positions = positions, .angular_velocities = angular_velocities});
+        for (std::size_t i = 0; i < states.size(); ++i) {
+            CHECK(positions[i] == states[i].position);
+            CHECK(angular_velocities[i] == states[i].angular_velocity);
+        }
+    }
+
+    SECTION("the thread count doesn't change the results") {
+        SimulationBatch serial(worlds);
+        for (std::size_t world = 0; world < worlds; ++world) {
+            create_shot(serial.world(world), world);
+        }
+        batch.update(1. / 60., 60);
+        serial.update(1. / 60., 60);
+
+        std::vector<Vec3d> positions(worlds * bodies.size());
+        std::vector<Vec3d> serial_positions(worlds * bodies.size());
+        batch.read_states(bodies, BodyStateArrays{.positions = positions});
+        serial.read_states(bodies, BodyStateArrays{.positions = serial_positions});
+        CHECK(positions == serial_positions);
+    }
+}
@@ -0,0 +1,107 @@
+#include <cmath>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/Simulation.h>
+
+#include "fixtures.h"
+
+using namespace yage::physics3d;
+using namespace yage::math;
+using namespace yage::physics3d::fixtures;
+
+namespace
+{
+    std::vector<RigidBodyHandle> create_stack(Simulation& simulation, const int height)
+    {
+        create_ground(simulation);
+        std::vector<RigidBodyHandle> boxes;
+        for (int i = 0; i < height; ++i) {
+            boxes.push_back(create_box(simulation, Vec3d(0, 0.5 + i * 1.01, 0)));
+        }
+        return boxes;
+    }
+}
+
+TEST_CASE("Block solver")
+{
+    Simulation simulation;
+    simulation.enable_gravity();
+    simulation.disable_sleeping();
+    simulation.enable_block_solver();
+
+    SECTION("a resting box is supported by all contacts at once") {
+        // a single iteration solves the four contacts with the ground exactly, so the box neither sinks nor tilts
+        simulation.set_solver_iterations(1);
+        const std::vector<RigidBodyHandle> boxes = create_stack(simulation, 1);
+        run(simulation, 120);
+
+        const RigidBody& box = simulation.lookup(boxes[0]);
+        CHECK(box.position().y() == Catch::Approx(0.5).margin(1e-3));
+        CHECK(length(box.velocity()) < 1e-9);
+        CHECK(length(box.angular_velocity()) < 1e-9);
+    }
+
+    SECTION("a stack settles with few iterations") {
+        const std::size_t threads = GENERATE(1, 3);
+        CAPTURE(threads);
+        simulation.set_thread_count(threads);
+        simulation.set_solver_iterations(4);
+
+        const std::vector<RigidBodyHandle> boxes = create_stack(simulation, 4);
+        run(simulation, 300);
+        for (std::size_t i = 0; i < boxes.size(); ++i) {
+            const RigidBody& box = simulation.lookup(boxes[i]);
+            CHECK(box.position().y() == Catch::Approx(0.5 + static_cast<double>(i)).margin(0.05));
+            CHECK(std::hypot(box.position().x(), box.position().z()) < 0.1);
+        }
+    }
+
+    SECTION("manifolds with a single contact are solved as before") {
+        const RigidBodyHandle sphere = simulation.create_rigid_body(
+                InertiaShape::sphere(0.5, 1), colliders::Sphere{.radius = 0.5}, material, Vec3d(0, 2, 0), Quatd());
+        create_ground(simulation);
+
+        Simulation reference;
+        reference.enable_gravity();
+        reference.disable_sleeping();
+        const RigidBodyHandle reference_sphere = reference.create_rigid_body(
+                InertiaShape::sphere(0.5, 1), colliders::Sphere{.radius = 0.5}, material, Vec3d(0, 2, 0), Quatd());
+        create_ground(reference);
+
+        run(simulation, 120);
+        run(reference, 120);
+        CHECK(simulation.lookup(sphere).position() == reference.lookup(reference_sphere).position());
+    }
+}
+
+TEST_CASE("Parallel block solver is deterministic")
+{
+    auto simulate = [](const std::size_t threads) {
+        Simulation simulation;
+        simulation.enable_gravity();
+        simulation.disable_sleeping();
+        simulation.enable_block_solver();
+        simulation.set_thread_count(threads);
+
+        create_ground(simulation);
+        std::vector<RigidBodyHandle> boxes;
+        for (int x = 0; x < 4; ++x) {
+            for (int y = 0; y < 4; ++y) {
+                boxes.push_back(create_box(simulation, Vec3d(x * 0.9, 0.5 + y * 1.05, 0.1 * y)));
+            }
+        }
+        run(simulation, 120);
+
+        std::vector<Vec3d> positions;
+        for (const RigidBodyHandle& box: boxes) {
+            positions.push_back(simulation.lookup(box).position());
+        }
+        return positions;
+    };
+
+    const std::vector<Vec3d> two_threads = simulate(2);
+    CHECK(simulate(3) == two_threads);
+    CHECK(simulate(4) == two_threads);
+}
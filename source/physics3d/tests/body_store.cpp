@@ -0,0 +1,59 @@
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/BodyStore.h>
+
+using namespace yage::physics3d;
+using namespace yage::math;
+
+TEST_CASE("BodyStore integration matches per-body integration")
+{
+    const double dt = 1. / 60.;
+    const Vec3d gravity(0, -9.81, 0);
+    const InertiaShape shape = InertiaShape::cuboid(1, 2, 3, 2);
+
+    BodyStore bodies;
+    bodies.reset(0, shape, Vec3d(1, 2, 3), normalize(Quatd(0.9, 0.1, -0.3, 0.2)));
+    bodies.reset(1, InertiaShape::static_shape(), Vec3d(0), Quatd());
+    bodies.reset(2, shape, Vec3d(-1, 0, 4), Quatd());
+    bodies.set_simulated(2, false);
+
+    for (const std::size_t id: {0, 2}) {
+        bodies.set_velocity(id, Vec3d(0.5, -1, 2));
+        bodies.set_angular_velocity(id, Vec3d(-0.7, 1.3, 0.4));
+        bodies.apply_force(id, Vec3d(3, 1, -2), Vec3d(0.2, -0.5, 1));
+    }
+
+    // reference integration as done on individual bodies
+    Vec3d velocity = bodies.velocity(0);
+    Vec3d angular_velocity = bodies.angular_velocity(0);
+    Vec3d position = bodies.position(0);
+    Quatd orientation = bodies.orientation(0);
+    velocity += gravity * dt;
+    velocity += shape.inverse_mass() * bodies.force(0) * dt;
+    angular_velocity += shape.inverse_inertia_tensor() * bodies.torque(0) * dt;
+    position += velocity * dt;
+    orientation += 0.5 * Quatd(angular_velocity) * orientation * dt;
+    orientation.normalize();
+
+    bodies.integrate_forces(gravity, dt);
+    bodies.integrate_positions(dt);
+    bodies.clear_forces();
+
+    CHECK(bodies.velocity(0) == velocity);
+    CHECK(bodies.angular_velocity(0) == angular_velocity);
+    CHECK(bodies.position(0) == position);
+    CHECK(bodies.orientation(0) == orientation);
+    CHECK(bodies.force(0) == Vec3d());
+    CHECK(bodies.torque(0) == Vec3d());
+
+    // static bodies are not affected by gravity
+    CHECK(bodies.velocity(1) == Vec3d());
+    CHECK(bodies.position(1) == Vec3d(0));
+    CHECK(bodies.orientation(1) == Quatd());
+
+    // bodies that are not simulated keep their state
+    CHECK(bodies.velocity(2) == Vec3d(0.5, -1, 2));
+    CHECK(bodies.angular_velocity(2) == Vec3d(-0.7, 1.3, 0.4));
+    CHECK(bodies.position(2) == Vec3d(-1, 0, 4));
+    CHECK(bodies.orientation(2) == Quatd());
+}
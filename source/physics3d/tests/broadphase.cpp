@@ -0,0 +1,139 @@
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/Broadphase.h>
+
+using namespace yage::physics3d;
+using namespace yage::math;
+
+namespace
+{
+    Collider sphere(const Vec3d& center, const double radius = 0.5)
+    {
+        return colliders::Sphere{.center = center, .radius = radius};
+    }
+}
+
+TEST_CASE("DynamicAabbTree")
+{
+    DynamicAabbTree tree(0.0, 0.0);
+
+    SECTION("query finds overlapping leaves") {
+        const auto p0 = tree.create_proxy({.min = Vec3d(0), .max = Vec3d(1)}, 0);
+        tree.create_proxy({.min = Vec3d(5), .max = Vec3d(6)}, 1);
+        const auto p2 = tree.create_proxy({.min = Vec3d(0.5), .max = Vec3d(2)}, 2);
+
+        std::vector<std::uint32_t> hits;
+        tree.query({.min = Vec3d(0.8), .max = Vec3d(0.9)}, [&](const std::uint32_t proxy) {
+            hits.push_back(tree.user_data(proxy));
+            return true;
+        });
+        std::ranges::sort(hits);
+
+        CHECK(hits == std::vector<std::uint32_t>{0, 2});
+
+        tree.destroy_proxy(p0);
+        tree.destroy_proxy(p2);
+        hits.clear();
+        tree.query({.min = Vec3d(0.8), .max = Vec3d(0.9)}, [&](const std::uint32_t proxy) {
+            hits.push_back(tree.user_data(proxy));
+            return true;
+        });
+
+        CHECK(hits.empty());
+    }
+
+    SECTION("tree stays balanced for sorted insertion") {
+        for (std::uint32_t i = 0; i < 1024; ++i) {
+            const Vec3d min(static_cast<double>(i), 0, 0);
+            tree.create_proxy({.min = min, .max = min + Vec3d(0.5)}, i);
+        }
+
+        // a perfectly balanced tree would have height 10
+        CHECK(tree.height() <= 15);
+    }
+}
+
+TEST_CASE("Broadphase")
+{
+    Broadphase broadphase;
+
+    SECTION("reports overlapping pairs in sorted order") {
+        const auto p0 = broadphase.create_proxy(sphere(Vec3d(0, 0, 0)), 0);
+        broadphase.create_proxy(sphere(Vec3d(10, 0, 0)), 1);
+        broadphase.create_proxy(sphere(Vec3d(0.8, 0, 0)), 2);
+        broadphase.create_proxy(sphere(Vec3d(10.5, 0, 0)), 3);
+
+        CHECK(broadphase.update_pairs() == std::vector<Broadphase::CandidatePair>{{0, 2}, {1, 3}});
+
+        // moving a proxy away removes its pair
+        broadphase.move_proxy(p0, sphere(Vec3d(-5, 0, 0)), Vec3d(0));
+        CHECK(broadphase.update_pairs() == std::vector<Broadphase::CandidatePair>{{1, 3}});
+
+        // moving it back restores it
+        broadphase.move_proxy(p0, sphere(Vec3d(0, 0, 0)), Vec3d(0));
+        CHECK(broadphase.update_pairs() == std::vector<Broadphase::CandidatePair>{{0, 2}, {1, 3}});
+    }
+
+    SECTION("pairs of destroyed proxies are removed") {
+        broadphase.create_proxy(sphere(Vec3d(0, 0, 0)), 0);
+        const auto p1 = broadphase.create_proxy(sphere(Vec3d(0.5, 0, 0)), 1);
+        CHECK(broadphase.update_pairs().size() == 1);
+
+        broadphase.destroy_proxy(p1);
+        CHECK(broadphase.update_pairs().empty());
+
+        // the proxy id may be reused for a new collider elsewhere
+        broadphase.create_proxy(sphere(Vec3d(20, 0, 0)), 1);
+        CHECK(broadphase.update_pairs().empty());
+    }
+
+    SECTION("planes pair with bounded colliders that cross them") {
+        colliders::OrientedPlane ground{.original_normal = Vec3d(0, 1, 0)};
+        ground.normal = ground.original_normal;
+        const auto p0 = broadphase.create_proxy(ground, 0);
+        broadphase.create_proxy(sphere(Vec3d(0, 0.2, 0)), 1);
+        const auto p2 = broadphase.create_proxy(sphere(Vec3d(0, 5, 0)), 2);
+
+        CHECK(broadphase.update_pairs() == std::vector<Broadphase::CandidatePair>{{0, 1}});
+        CHECK(broadphase.update_pairs() == std::vector<Broadphase::CandidatePair>{{0, 1}});
+
+        // a proxy that moves onto the plane gains a pair, one that moves away loses it
+        broadphase.move_proxy(p2, sphere(Vec3d(3, 0.2, 0)), Vec3d(0));
+        CHECK(broadphase.update_pairs() == std::vector<Broadphase::CandidatePair>{{0, 1}, {0, 2}});
+        broadphase.move_proxy(p2, sphere(Vec3d(3, 5, 0)), Vec3d(0));
+        CHECK(broadphase.update_pairs() == std::vector<Broadphase::CandidatePair>{{0, 1}});
+
+        // a moving plane is tested against the proxies that stay in place
+        ground.support = Vec3d(0, 5, 0);
+        broadphase.move_proxy(p0, ground, Vec3d(0));
+        CHECK(broadphase.update_pairs() == std::vector<Broadphase::CandidatePair>{{0, 2}});
+    }
+
+    SECTION("pairs of frozen proxies are not reported") {
+        colliders::OrientedPlane ground{.original_normal = Vec3d(0, 1, 0)};
+        ground.normal = ground.original_normal;
+        broadphase.create_proxy(ground, 0, {}, true);
+        broadphase.create_proxy(sphere(Vec3d(0, 0.2, 0)), 1, {}, true);
+        const auto p2 = broadphase.create_proxy(sphere(Vec3d(0.5, 0.2, 0)), 2);
+        CHECK(broadphase.update_pairs() == std::vector<Broadphase::CandidatePair>{{0, 2}, {1, 2}});
+
+        // falling asleep drops the pairs with frozen proxies, waking up restores them without moving
+        broadphase.set_frozen(p2, true);
+        CHECK(broadphase.update_pairs().empty());
+        broadphase.set_frozen(p2, false);
+        CHECK(broadphase.update_pairs() == std::vector<Broadphase::CandidatePair>{{0, 2}, {1, 2}});
+    }
+
+    SECTION("pairs are only reported if both filters accept each other") {
+        const CollisionFilter debris{.layers = 0b10, .mask = 0b01};
+        broadphase.create_proxy(sphere(Vec3d(0, 0, 0)), 0);
+        const auto p1 = broadphase.create_proxy(sphere(Vec3d(0.5, 0, 0)), 1, debris);
+        broadphase.create_proxy(sphere(Vec3d(1, 0, 0)), 2, debris);
+        CHECK(broadphase.update_pairs() == std::vector<Broadphase::CandidatePair>{{0, 1}, {0, 2}});
+
+        broadphase.set_filter(p1, {});
+        CHECK(broadphase.update_pairs() == std::vector<Broadphase::CandidatePair>{{0, 1}, {0, 2}, {1, 2}});
+        broadphase.set_filter(p1, {.layers = 0b100});
+        CHECK(broadphase.update_pairs() == std::vector<Broadphase::CandidatePair>{{0, 1}, {0, 2}});
+    }
+}
@@ -0,0 +1,97 @@
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/Simulation.h>
+
+#include "fixtures.h"
+
+using namespace yage::physics3d;
+using namespace yage::math;
+using namespace yage::physics3d::fixtures;
+
+namespace
+{
+    const Material bouncy{.restitution = 0.5, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+
+    RigidBodyHandle create_sphere(Simulation& simulation, const Vec3d& position, const double radius)
+    {
+        return simulation.create_rigid_body(InertiaShape::sphere(radius, 1), colliders::Sphere{.radius = radius},
+                                            bouncy, position, Quatd());
+    }
+
+    void launch(Simulation& simulation, const RigidBodyHandle handle, const Vec3d& velocity, const bool ccd)
+    {
+        RigidBody& body = simulation.lookup(handle);
+        if (ccd) {
+            body.enable_ccd();
+        }
+        // a force over a single step of 1/60 seconds on a body of mass 1
+        body.apply_force(velocity * 60., body.position());
+    }
+}
+
+TEST_CASE("Swept sphere time of impact")
+{
+    const colliders::Sphere sphere{.center = Vec3d(0, 2, 0), .radius = 0.5};
+
+    SECTION("plane") {
+        const colliders::OrientedPlane plane{.normal = Vec3d(0, 1, 0)};
+        CHECK(time_of_impact(sphere, Vec3d(0, -3, 0), plane) == Catch::Approx(0.5));
+        CHECK_FALSE(time_of_impact(sphere, Vec3d(0, -1, 0), plane).has_value());
+        CHECK_FALSE(time_of_impact(sphere, Vec3d(3, 0, 0), plane).has_value());
+    }
+
+    SECTION("sphere") {
+        const colliders::Sphere other{.center = Vec3d(5, 2, 0), .radius = 1};
+        CHECK(time_of_impact(sphere, Vec3d(10, 0, 0), other) == Catch::Approx(0.35));
+        CHECK_FALSE(time_of_impact(sphere, Vec3d(-10, 0, 0), other).has_value());
+        CHECK_FALSE(time_of_impact(sphere, Vec3d(10, 5, 0), other).has_value());
+    }
+
+    SECTION("box") {
+        colliders::OrientedBox box{.half_size = Vec3d(1), .center = Vec3d(5, 2, 0)};
+        box.update_computed_values();
+        CHECK(time_of_impact(sphere, Vec3d(10, 0, 0), box) == Catch::Approx(0.35));
+        CHECK_FALSE(time_of_impact(sphere, Vec3d(2, 0, 0), box).has_value());
+        CHECK_FALSE(time_of_impact(sphere, Vec3d(10, 5, 0), box).has_value());
+    }
+}
+
+TEST_CASE("Continuous collision detection")
+{
+    const bool ccd = GENERATE(false, true);
+    CAPTURE(ccd);
+
+    Simulation simulation;
+
+    SECTION("fast sphere hits a plane") {
+        create_ground(simulation, bouncy);
+        const RigidBodyHandle sphere = create_sphere(simulation, Vec3d(0, 2.3, 0), 0.1);
+        launch(simulation, sphere, Vec3d(0, -60, 0), ccd);
+        run(simulation, 30);
+
+        // without continuous collision detection, the sphere overshoots the plane and is pushed out the wrong way
+        CHECK((simulation.lookup(sphere).position().y() > 0) == ccd);
+        CHECK((simulation.lookup(sphere).velocity().y() > 0) == ccd);
+    }
+
+    SECTION("fast sphere hits a thin wall") {
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedBox{.half_size = Vec3d(0.05, 2, 2)}, bouncy,
+                                     Vec3d(5, 0, 0), Quatd());
+        const RigidBodyHandle sphere = create_sphere(simulation, Vec3d(), 0.1);
+        launch(simulation, sphere, Vec3d(120, 0, 0), ccd);
+        run(simulation, 30);
+
+        CHECK((simulation.lookup(sphere).position().x() < 5) == ccd);
+    }
+
+    SECTION("fast ball hits a resting ball") {
+        const RigidBodyHandle cue_ball = create_sphere(simulation, Vec3d(), 0.03);
+        const RigidBodyHandle ball = create_sphere(simulation, Vec3d(0.5, 0, 0), 0.03);
+        launch(simulation, cue_ball, Vec3d(20, 0, 0), ccd);
+        run(simulation, 10);
+
+        CHECK((simulation.lookup(ball).velocity().x() > 1) == ccd);
+        CHECK((simulation.lookup(cue_ball).position().x() < simulation.lookup(ball).position().x()) == ccd);
+    }
+}
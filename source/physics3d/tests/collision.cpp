@@ -1,24 +1,138 @@
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
 #include <catch2/catch_all.hpp>
 
+#include <math/generators.h>
 #include <physics3d/BoundingShape.h>
+#include <physics3d/Gjk.h>
 
 using namespace yage::physics3d;
-using namespace gml;
+using namespace yage::math;
 
-TEST_CASE("RadDegConversion")
+namespace
 {
-    BVOrientedBox b1{
-            .min = Vec3d(-1, 0, 0),
-            .max = Vec3d(0.1, 1, 1),
+    colliders::OrientedBox make_box(const Vec3d& half_size, const Vec3d& center, const Quatd& orientation = Quatd())
+    {
+        colliders::OrientedBox box{.half_size = half_size, .center = center, .orientation = orientation};
+        box.update_computed_values();
+        return box;
+    }
+
+    double max_depth(const ContactManifold& manifold)
+    {
+        return std::ranges::max(manifold.contacts, {}, &ContactPoint::depth).depth;
+    }
+}
+
+TEST_CASE("OrientedBox collision")
+{
+    colliders::OrientedBox b1{
+            .half_size = Vec3d(0.55, 0.5, 0.5),
+            .center = Vec3d(-0.45, 0.5, 0.5),
     };
+    b1.update_computed_values();
 
-    BVOrientedBox b2{
-            .min = Vec3d(0, 0, 0),
-            .max = Vec3d(1, 1, 1),
+    colliders::OrientedBox b2{
+            .half_size = Vec3d(0.5, 0.5, 0.5),
+            .center = Vec3d(0.5, 0.5, 0.5),
     };
+    b2.update_computed_values();
 
     CollisionVisitor v;
     std::optional<ContactManifold> manifold = v(b1, b2);
 
     CHECK(manifold.has_value());
 }
+
+TEST_CASE("OrientedBox manifolds")
+{
+    CollisionVisitor v;
+
+    SECTION("rotated faces are reduced to four contacts") {
+        // the rotated top box overlaps the face of the lower box in an octagon
+        const colliders::OrientedBox lower = make_box(Vec3d(0.5), Vec3d(0, 0.5, 0));
+        const colliders::OrientedBox upper = make_box(Vec3d(0.5), Vec3d(0, 1.49, 0),
+                                                      quaternion::axis_angle(Vec3d(0, 1, 0), std::numbers::pi / 4));
+
+        const std::optional<ContactManifold> manifold = v(upper, lower);
+        REQUIRE(manifold.has_value());
+        CHECK(manifold->contacts.size() == 4);
+        CHECK(max_depth(manifold.value()) == Catch::Approx(0.01));
+        CHECK(std::abs(manifold->normal.y()) == Catch::Approx(1));
+    }
+
+    SECTION("touching faces have a valid normal") {
+        const colliders::OrientedBox a = make_box(Vec3d(0.5), Vec3d(0, 0.5, 0));
+        const colliders::OrientedBox b = make_box(Vec3d(0.5), Vec3d(0, 1.5, 0));
+
+        const std::optional<ContactManifold> manifold = v(a, b);
+        REQUIRE(manifold.has_value());
+        CHECK(length(manifold->normal) == Catch::Approx(1));
+        CHECK(std::abs(manifold->normal.y()) == Catch::Approx(1));
+    }
+
+    SECTION("the depth is found for boxes at negative coordinates") {
+        const colliders::OrientedBox a = make_box(Vec3d(0.5), Vec3d(-10, -10, -10));
+        const colliders::OrientedBox b = make_box(Vec3d(0.5), Vec3d(-10, -10.9, -10));
+
+        const std::optional<ContactManifold> manifold = v(a, b);
+        REQUIRE(manifold.has_value());
+        CHECK(max_depth(manifold.value()) == Catch::Approx(0.1));
+    }
+}
+
+TEST_CASE("Spheres with their center inside another shape")
+{
+    CollisionVisitor v;
+    const colliders::OrientedBox box = make_box(Vec3d(1, 0.5, 0.5), Vec3d(2, 0, 0),
+                                                quaternion::axis_angle(Vec3d(0, 0, 1), std::numbers::pi / 2));
+    // the sphere is closest to the face of the box that points along negative x after the rotation
+    const colliders::Sphere sphere{.center = Vec3d(1.7, 0.1, 0), .radius = 0.2};
+
+    SECTION("box and sphere are pushed apart through the closest face") {
+        const std::optional<ContactManifold> manifold = v(box, sphere);
+        REQUIRE(manifold.has_value());
+        CHECK(manifold->normal.x() == Catch::Approx(-1));
+        CHECK(max_depth(manifold.value()) == Catch::Approx(0.4));
+
+        const std::optional<ContactManifold> reversed = v(sphere, box);
+        REQUIRE(reversed.has_value());
+        CHECK(reversed->normal.x() == Catch::Approx(1));
+        CHECK(max_depth(reversed.value()) == Catch::Approx(0.4));
+    }
+
+    SECTION("concentric spheres") {
+        const std::optional<ContactManifold> manifold = v(sphere, sphere);
+        REQUIRE(manifold.has_value());
+        CHECK(length(manifold->normal) == Catch::Approx(1));
+        CHECK(max_depth(manifold.value()) == Catch::Approx(0.4));
+    }
+}
+
+TEST_CASE("OrientedBox axis cache")
+{
+    const colliders::OrientedBox a = make_box(Vec3d(0.5), Vec3d(0, 0.5, 0));
+
+    SECTION("a cached separating axis is kept") {
+        const colliders::OrientedBox b = make_box(Vec3d(0.5), Vec3d(2, 0.5, 0));
+        GjkCache cache{.axis = Vec3d(1, 0, 0)};
+        CHECK(!CollisionVisitor(&cache)(a, b).has_value());
+        CHECK(std::abs(cache.axis.x()) == Catch::Approx(1));
+    }
+
+    SECTION("a separating axis is found and cached") {
+        const colliders::OrientedBox b = make_box(Vec3d(0.5), Vec3d(0, 0.5, 2));
+        GjkCache cache;
+        CHECK(!CollisionVisitor(&cache)(a, b).has_value());
+        CHECK(std::abs(cache.axis.z()) == Catch::Approx(1));
+
+        // the cached axis doesn't separate the boxes anymore once they overlap
+        const colliders::OrientedBox moved = make_box(Vec3d(0.5), Vec3d(0.9, 0.5, 0));
+        const std::optional<ContactManifold> manifold = CollisionVisitor(&cache)(a, moved);
+        REQUIRE(manifold.has_value());
+        CHECK(max_depth(manifold.value()) == Catch::Approx(0.1));
+        CHECK(std::abs(cache.axis.x()) == Catch::Approx(1));
+    }
+}
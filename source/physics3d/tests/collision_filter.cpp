@@ -0,0 +1,81 @@
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/Simulation.h>
+
+#include "fixtures.h"
+
+using namespace yage::physics3d;
+using namespace yage::math;
+using namespace yage::physics3d::fixtures;
+
+namespace
+{
+    const Material inelastic{.restitution = 0, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+
+    constexpr std::uint32_t world_layer = 0b01;
+    constexpr std::uint32_t debris_layer = 0b10;
+    const CollisionFilter debris{.layers = debris_layer, .mask = world_layer};
+
+}
+
+TEST_CASE("Collision filters")
+{
+    Simulation simulation;
+    simulation.enable_gravity();
+    create_ground(simulation, inelastic);
+
+    SECTION("debris falls through debris, but not through the world") {
+        const RigidBodyHandle bottom = create_box(simulation, Vec3d(0, 0.5, 0), inelastic);
+        const RigidBodyHandle top = create_box(simulation, Vec3d(0, 2, 0), inelastic);
+        simulation.lookup(bottom).set_collision_filter(debris);
+        simulation.lookup(top).set_collision_filter(debris);
+        run(simulation, 120);
+        CHECK(simulation.lookup(bottom).position().y() == Catch::Approx(0.5).margin(0.01));
+        CHECK(simulation.lookup(top).position().y() == Catch::Approx(0.5).margin(0.01));
+
+        // boxes of the world layer still land on debris
+        const RigidBodyHandle box = create_box(simulation, Vec3d(0, 2, 0), inelastic);
+        run(simulation, 120);
+        CHECK(simulation.lookup(box).position().y() == Catch::Approx(1.5).margin(0.02));
+    }
+
+    SECTION("continuous collision detection ignores filtered bodies") {
+        const RigidBodyHandle wall = simulation.create_rigid_body(
+                InertiaShape::static_shape(), colliders::OrientedBox{.half_size = Vec3d(0.1, 2, 2)}, inelastic,
+                Vec3d(5, 2, 0), Quatd());
+        simulation.lookup(wall).set_collision_filter(debris);
+        const RigidBodyHandle bullet = simulation.create_rigid_body(
+                InertiaShape::sphere(0.1, 1), colliders::Sphere{.radius = 0.1}, inelastic, Vec3d(0, 2, 0), Quatd());
+        simulation.lookup(bullet).enable_ccd();
+        simulation.lookup(bullet).set_collision_filter(debris);
+        simulation.lookup(bullet).apply_force(Vec3d(600, 0, 0) * 60., simulation.lookup(bullet).position());
+        run(simulation, 2);
+        CHECK(simulation.lookup(bullet).position().x() > 10);
+    }
+
+    SECTION("bodies woken on static ground don't sink in") {
+        const RigidBodyHandle box = create_box(simulation, Vec3d(0, 0.5, 0), inelastic);
+        run(simulation, 300);
+        REQUIRE(simulation.lookup(box).is_sleeping());
+
+        // the ground is only paired with the box again after it wakes
+        simulation.lookup(box).wake_up();
+        for (int i = 0; i < 10; ++i) {
+            simulation.update(1. / 60.);
+            CHECK(simulation.lookup(box).position().y() == Catch::Approx(0.5).margin(0.005));
+        }
+    }
+
+    SECTION("bodies touching a moving body wake up on static ground") {
+        const RigidBodyHandle box = create_box(simulation, Vec3d(0, 0.5, 0), inelastic);
+        run(simulation, 300);
+        REQUIRE(simulation.lookup(box).is_sleeping());
+
+        const RigidBodyHandle falling = create_box(simulation, Vec3d(0, 1.6, 0), inelastic);
+        for (int i = 0; i < 120; ++i) {
+            simulation.update(1. / 60.);
+            CHECK(simulation.lookup(box).position().y() == Catch::Approx(0.5).margin(0.005));
+        }
+        CHECK(simulation.lookup(falling).position().y() == Catch::Approx(1.5).margin(0.01));
+    }
+}
@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/Simulation.h>
+
+using namespace yage::physics3d;
+using namespace yage::math;
+
+namespace
+{
+    const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+
+    /**
+     * A table with a top of 2 x 0.2 x 1.2 and four legs, whose feet are 0.45 below the center.
+     */
+    std::vector<Collider> table_children()
+    {
+        std::vector<Collider> children{
+                colliders::OrientedBox{.half_size = Vec3d(1, 0.1, 0.6), .center = Vec3d(0, 0.45, 0)},
+        };
+        for (const double x: {-0.85, 0.85}) {
+            for (const double z: {-0.45, 0.45}) {
+                children.emplace_back(colliders::OrientedBox{.half_size = Vec3d(0.1, 0.4, 0.1),
+                                                             .center = Vec3d(x, -0.05, z)});
+            }
+        }
+        return children;
+    }
+
+    /**
+     * Two spheres on a capsule along the x-axis.
+     */
+    std::vector<Collider> dumbbell_children()
+    {
+        return {
+                colliders::Sphere{.center = Vec3d(-0.6, 0, 0), .radius = 0.3},
+                colliders::Sphere{.center = Vec3d(0.6, 0, 0), .radius = 0.3},
+                colliders::Convex{.shape = shapes::Capsule{.radius = 0.1, .half_height = 0.6},
+                                  .orientation = normalize(Quatd(1, 0, 0, 1))},
+        };
+    }
+}
+
+TEST_CASE("Compound shape")
+{
+    const CompoundShape table(table_children());
+
+    SECTION("children keep their own bounds") {
+        CHECK(table.size() == 5);
+        CHECK(table.bounds().min.x() == Catch::Approx(-1));
+        CHECK(table.bounds().min.y() == Catch::Approx(-0.45));
+        CHECK(table.bounds().max.y() == Catch::Approx(0.55));
+
+        // the foot of a single leg
+        std::set<std::uint32_t> found;
+        table.query({.min = Vec3d(0.8, -0.5, 0.4), .max = Vec3d(0.9, -0.4, 0.5)},
+                    [&found](const std::uint32_t index) { found.insert(index); });
+        CHECK(found == std::set<std::uint32_t>{4});
+
+        // between the legs, below the top
+        found.clear();
+        table.query({.min = Vec3d(-0.5, -0.4, -0.2), .max = Vec3d(0.5, 0.2, 0.2)},
+                    [&found](const std::uint32_t index) { found.insert(index); });
+        CHECK(found.empty());
+    }
+
+    SECTION("children are moved with the compound") {
+        const Quatd orientation = normalize(Quatd(1, 0, 1, 0));
+        const Collider child = table.child(0, Vec3d(1, 2, 3), orientation);
+        const auto& top = std::get<colliders::OrientedBox>(child);
+        const Vec3d center = Vec3d(1, 2, 3) + orientation * Vec3d(0, 0.45, 0);
+        CHECK(length(top.center - center) == Catch::Approx(0).margin(1e-12));
+        CHECK(std::abs(dot(top.oriented_face_normals[1], orientation * Vec3d(1, 0, 0))) ==
+              Catch::Approx(1).margin(1e-12));
+    }
+
+    SECTION("each touching child yields a manifold with distinct contacts") {
+        const colliders::Compound compound{.shape = &table, .center = Vec3d(0, 0.44, 0)};
+        const colliders::OrientedPlane ground{.original_normal = Vec3d(0, 1, 0), .normal = Vec3d(0, 1, 0)};
+        std::vector<std::uint64_t> feature_ids;
+        std::size_t manifolds = 0;
+        collide(compound, ground, true, [&](const ContactManifold& manifold) {
+            ++manifolds;
+            CHECK(manifold.normal.y() == Catch::Approx(-1));
+            for (const ContactPoint& contact: manifold.contacts) {
+                CHECK(contact.depth == Catch::Approx(0.01));
+                CHECK(length(contact.r_a - (contact.p_a - compound.center)) == Catch::Approx(0).margin(1e-12));
+                feature_ids.push_back(contact.feature_id);
+            }
+        });
+        // only the legs touch the ground
+        CHECK(manifolds == 4);
+        CHECK(feature_ids.size() == 16);
+        std::ranges::sort(feature_ids);
+        CHECK(std::ranges::adjacent_find(feature_ids) == feature_ids.end());
+    }
+}
+
+TEST_CASE("Compound collisions")
+{
+    const CompoundShape table_shape(table_children());
+    const CompoundShape dumbbell_shape(dumbbell_children());
+    Simulation simulation;
+    simulation.enable_gravity();
+
+    SECTION("compounds come to rest on their children") {
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedPlane{.original_normal = Vec3d(0, 1, 0)}, material, Vec3d(),
+                                     Quatd());
+        const RigidBodyHandle table = simulation.create_rigid_body(
+                InertiaShape::cuboid(2, 1, 1.2, 10), colliders::Compound{.shape = &table_shape}, material,
+                Vec3d(0, 0.6, 0), Quatd());
+        // falls onto the table top, across the gap between two legs
+        const RigidBodyHandle dumbbell = simulation.create_rigid_body(
+                InertiaShape::cuboid(1.8, 0.6, 0.6, 1), colliders::Compound{.shape = &dumbbell_shape}, material,
+                Vec3d(0.1, 1.6, 0), normalize(Quatd(1, 0, 0.3, 0)));
+        for (int i = 0; i < 300; ++i) {
+            simulation.update(1. / 60.);
+        }
+        CHECK(simulation.lookup(table).position().y() == Catch::Approx(0.45).margin(0.01));
+        CHECK(std::abs(simulation.lookup(table).orientation().w()) > 0.99);
+        CHECK(simulation.lookup(dumbbell).position().y() == Catch::Approx(1.3).margin(0.02));
+        for (const RigidBodyHandle body: {table, dumbbell}) {
+            CHECK(length(simulation.lookup(body).velocity()) < 0.01);
+        }
+    }
+
+    SECTION("compounds come to rest on meshes and heightfields") {
+        const std::vector<Vec3d> vertices{Vec3d(-5, 0, -5), Vec3d(-5, 0, 5), Vec3d(5, 0, -5), Vec3d(5, 0, 5)};
+        const std::vector<std::uint32_t> indices{0, 1, 2, 2, 1, 3};
+        const TriangleMesh mesh(vertices, indices);
+        const Heightfield heightfield(3, 3, std::vector<double>(9, 0), 5);
+        simulation.create_rigid_body(InertiaShape::static_shape(), colliders::Mesh{.mesh = &mesh}, material,
+                                     Vec3d(), Quatd());
+        simulation.create_rigid_body(InertiaShape::static_shape(), colliders::Heightfield{.heightfield = &heightfield},
+                                     material, Vec3d(10, 0, -5), Quatd());
+        const RigidBodyHandle on_mesh = simulation.create_rigid_body(
+                InertiaShape::cuboid(2, 1, 1.2, 10), colliders::Compound{.shape = &table_shape}, material,
+                Vec3d(0, 0.6, 0), Quatd());
+        const RigidBodyHandle on_heightfield = simulation.create_rigid_body(
+                InertiaShape::cuboid(2, 1, 1.2, 10), colliders::Compound{.shape = &table_shape}, material,
+                Vec3d(15, 0.6, 0), Quatd());
+        for (int i = 0; i < 300; ++i) {
+            simulation.update(1. / 60.);
+        }
+        for (const RigidBodyHandle body: {on_mesh, on_heightfield}) {
+            CHECK(simulation.lookup(body).position().y() == Catch::Approx(0.45).margin(0.01));
+            CHECK(std::abs(simulation.lookup(body).orientation().w()) > 0.99);
+            CHECK(length(simulation.lookup(body).velocity()) < 0.01);
+        }
+    }
+
+    SECTION("scene queries hit the children, but not the gaps between them") {
+        const Quatd orientation = normalize(Quatd(1, 0, 0.2, 0));
+        const RigidBodyHandle table = simulation.create_rigid_body(
+                InertiaShape::static_shape(), colliders::Compound{.shape = &table_shape}, material, Vec3d(0, 0.45, 0),
+                orientation);
+        std::optional<QueryHit> hit = simulation.raycast(
+                {.origin = Vec3d(0, 5, 0), .direction = Vec3d(0, -1, 0), .max_distance = 20});
+        REQUIRE(hit.has_value());
+        CHECK(hit->body == table);
+        CHECK(hit->distance == Catch::Approx(4).margin(1e-6));
+
+        // below the top, through the gap between the legs
+        hit = simulation.raycast({.origin = Vec3d(0, 0.1, 0) - orientation * Vec3d(5, 0, 0),
+                                  .direction = orientation * Vec3d(1, 0, 0), .max_distance = 20});
+        CHECK(!hit.has_value());
+
+        // into the side of a leg
+        hit = simulation.sphere_cast({.origin = Vec3d(0, 0.1, 0) + orientation * Vec3d(0.85, 0, -5),
+                                      .direction = orientation * Vec3d(0, 0, 1), .max_distance = 20}, 0.3);
+        REQUIRE(hit.has_value());
+        CHECK(hit->distance == Catch::Approx(4.15).margin(1e-6));
+        CHECK(dot(hit->normal, orientation * Vec3d(0, 0, -1)) == Catch::Approx(1).margin(1e-6));
+
+        std::vector<RigidBodyHandle> bodies;
+        simulation.overlap(colliders::Sphere{.center = Vec3d(0, 0.1, 0), .radius = 0.2}, bodies);
+        CHECK(bodies.empty());
+        simulation.overlap(colliders::Sphere{.center = Vec3d(0, 1.1, 0), .radius = 0.2}, bodies);
+        CHECK(bodies.size() == 1);
+    }
+}
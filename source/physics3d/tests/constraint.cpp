@@ -0,0 +1,179 @@
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/BodyStore.h>
+#include <physics3d/ConstraintBatches.h>
+#include <physics3d/ConstraintRows.h>
+#include <physics3d/Simulation.h>
+
+using namespace yage::physics3d;
+using namespace yage::math;
+
+namespace
+{
+    /**
+     * Reference implementation of the constraint rows with the full 12x12 inverse mass matrix.
+     */
+    struct DenseRow
+    {
+        Matd<12, 12> m_inv;
+        Matd<1, 12> j;
+        double bias{};
+
+        DenseRow(const InertiaShape& a, const InertiaShape& b, const Jacobian& jacobian, const double bias)
+            : bias(bias)
+        {
+            for (std::size_t i = 0; i < 3; ++i) {
+                m_inv(i, i) = a.inverse_mass();
+                m_inv(3 + i, 3 + i) = b.inverse_mass();
+                for (std::size_t k = 0; k < 3; ++k) {
+                    m_inv(6 + i, 6 + k) = a.inverse_inertia_tensor()(i, k);
+                    m_inv(9 + i, 9 + k) = b.inverse_inertia_tensor()(i, k);
+                }
+
+                j(0, i) = jacobian.linear_a(i);
+                j(0, 3 + i) = jacobian.linear_b(i);
+                j(0, 6 + i) = jacobian.angular_a(i);
+                j(0, 9 + i) = jacobian.angular_b(i);
+            }
+        }
+
+        [[nodiscard]]
+        double solve(const Matd<12, 1>& q) const
+        {
+            return -(j * q + Matd<1, 1>(bias))(0, 0) / (j * m_inv * transpose(j))(0, 0);
+        }
+
+        void apply_impulse(Matd<12, 1>& q, const double lambda) const
+        {
+            q += m_inv * (lambda * transpose(j));
+        }
+    };
+
+    void check_velocities(const Matd<12, 1>& q, const BodyStore& bodies)
+    {
+        for (std::size_t i = 0; i < 3; ++i) {
+            CHECK(bodies.velocity(0)(i) == Catch::Approx(q(i, 0)).margin(1e-12));
+            CHECK(bodies.velocity(1)(i) == Catch::Approx(q(3 + i, 0)).margin(1e-12));
+            CHECK(bodies.angular_velocity(0)(i) == Catch::Approx(q(6 + i, 0)).margin(1e-12));
+            CHECK(bodies.angular_velocity(1)(i) == Catch::Approx(q(9 + i, 0)).margin(1e-12));
+        }
+    }
+}
+
+TEST_CASE("Compact constraint rows match the dense formulation")
+{
+    const InertiaShape shape_a = InertiaShape::cuboid(1, 2, 3, 2);
+    const InertiaShape shape_b = InertiaShape::sphere(0.5, 3);
+    BodyStore bodies;
+    bodies.reset(0, shape_a, Vec3d(0), Quatd());
+    bodies.reset(1, shape_b, Vec3d(1, 0, 0), Quatd());
+
+    const Vec3d n = normalize(Vec3d(1, 0.2, -0.1));
+    const Vec3d t = normalize(cross(n, Vec3d(0, 1, 0)));
+    const Vec3d r_a(0.5, -0.3, 0.2);
+    const Vec3d r_b(-0.4, 0.1, -0.3);
+    const std::array<Jacobian, 3> jacobians{
+            // penetration
+            Jacobian{.linear_a = -n, .linear_b = n, .angular_a = -cross(r_a, n), .angular_b = cross(r_b, n)},
+            // friction
+            Jacobian{.linear_a = -t, .linear_b = t, .angular_a = -cross(r_a, t), .angular_b = cross(r_b, t)},
+            // rolling friction
+            Jacobian{.linear_a = Vec3d(), .linear_b = Vec3d(), .angular_a = -n, .angular_b = n},
+    };
+    const std::array<double, 3> biases{-0.3, 0.1, 0.05};
+
+    ConstraintRows rows;
+    std::vector<DenseRow> dense_rows;
+    for (std::size_t i = 0; i < jacobians.size(); ++i) {
+        rows.add(bodies, 0, 1, jacobians[i], biases[i]);
+        dense_rows.emplace_back(shape_a, shape_b, jacobians[i], biases[i]);
+    }
+    REQUIRE(rows.size() == 3);
+
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const DenseRow& dense = dense_rows[i];
+        CHECK(rows.effective_mass(i) ==
+              Catch::Approx(1 / (dense.j * dense.m_inv * transpose(dense.j))(0, 0)).epsilon(1e-12));
+    }
+
+    Matd<12, 1> q;
+    for (int iteration = 0; iteration < 5; ++iteration) {
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            const double expected = dense_rows[i].solve(q);
+            const double delta_lambda = rows.solve(bodies, i);
+            CHECK(delta_lambda == Catch::Approx(expected).margin(1e-12));
+
+            dense_rows[i].apply_impulse(q, expected);
+            rows.apply_impulse(bodies, i, delta_lambda);
+            check_velocities(q, bodies);
+        }
+    }
+}
+
+TEST_CASE("ConstraintBatches")
+{
+    constexpr std::size_t none = ConstraintBatches::no_body;
+    const std::vector<std::pair<std::size_t, std::size_t>> contacts{
+            {0, 1}, {1, 2}, {2, none}, {0, none}, {3, 4}, {1, 3}, {4, none}, {0, 2},
+    };
+
+    ConstraintBatches batches;
+    batches.build(contacts, 5);
+
+    std::vector<std::size_t> all;
+    for (std::size_t b = 0; b < batches.size(); ++b) {
+        CHECK(!batches.is_conflicting(b));
+
+        std::vector<std::size_t> bodies;
+        for (const std::size_t contact: batches.batch(b)) {
+            all.push_back(contact);
+            for (const std::size_t body: {contacts[contact].first, contacts[contact].second}) {
+                if (body != none) {
+                    bodies.push_back(body);
+                }
+            }
+        }
+        std::ranges::sort(bodies);
+        CHECK(std::ranges::adjacent_find(bodies) == bodies.end());
+    }
+
+    std::ranges::sort(all);
+    CHECK(all == std::vector<std::size_t>{0, 1, 2, 3, 4, 5, 6, 7});
+}
+
+TEST_CASE("Parallel solver is deterministic")
+{
+    auto simulate = [](const std::size_t threads) {
+        Simulation simulation;
+        simulation.enable_gravity();
+        simulation.disable_sleeping();
+        simulation.set_thread_count(threads);
+
+        const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedPlane{.original_normal = Vec3d(0, 1, 0)}, material,
+                                     Vec3d(), Quatd());
+        std::vector<RigidBodyHandle> boxes;
+        for (int x = 0; x < 4; ++x) {
+            for (int y = 0; y < 4; ++y) {
+                boxes.push_back(simulation.create_rigid_body(InertiaShape::cube(1, 1),
+                                                             colliders::OrientedBox{.half_size = Vec3d(0.5)}, material,
+                                                             Vec3d(x * 0.9, 0.5 + y * 1.05, 0.1 * y), Quatd()));
+            }
+        }
+        for (int i = 0; i < 120; ++i) {
+            simulation.update(1. / 60.);
+        }
+
+        std::vector<Vec3d> positions;
+        for (const RigidBodyHandle& box: boxes) {
+            positions.push_back(simulation.lookup(box).position());
+        }
+        return positions;
+    };
+
+    const std::vector<Vec3d> two_threads = simulate(2);
+    CHECK(simulate(2) == two_threads);
+    CHECK(simulate(4) == two_threads);
+    CHECK(simulate(3) == two_threads);
+}
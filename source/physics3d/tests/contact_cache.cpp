@@ -0,0 +1,114 @@
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/ContactCache.h>
+#include <physics3d/Simulation.h>
+
+using namespace yage::physics3d;
+using namespace yage::math;
+
+TEST_CASE("ContactCache")
+{
+    ContactCache cache;
+    const ContactCache::Key key{.body_a = 1, .body_b = 2, .feature_id = 3};
+
+    SECTION("contacts are found in the next step only") {
+        cache.insert(key, {.normal = 5});
+        CHECK(cache.find(key).normal == 0);
+
+        cache.advance();
+        CHECK(cache.find(key).normal == 5);
+        CHECK(cache.find({.body_a = 1, .body_b = 2, .feature_id = 4}).normal == 0);
+
+        cache.advance();
+        CHECK(cache.find(key).normal == 0);
+    }
+
+    SECTION("contacts inserted out of order are found") {
+        cache.insert({.body_a = 4, .body_b = 5}, {.normal = 1});
+        cache.insert(key, {.normal = 2});
+        cache.insert({.body_a = 0, .body_b = 9}, {.normal = 3});
+        cache.advance();
+
+        CHECK(cache.size() == 3);
+        CHECK(cache.find({.body_a = 4, .body_b = 5}).normal == 1);
+        CHECK(cache.find(key).normal == 2);
+        CHECK(cache.find({.body_a = 0, .body_b = 9}).normal == 3);
+    }
+}
+
+TEST_CASE("Contact feature ids")
+{
+    colliders::OrientedPlane ground{.original_normal = Vec3d(0, 1, 0)};
+    ground.normal = ground.original_normal;
+
+    colliders::OrientedBox box{
+            .half_size = Vec3d(0.5),
+            .center = Vec3d(0, 0.45, 0),
+    };
+    box.update_computed_values();
+
+    colliders::OrientedBox top{
+            .half_size = Vec3d(0.5),
+            .center = Vec3d(0.2, 1.4, 0.1),
+    };
+    top.update_computed_values();
+
+    const CollisionVisitor visitor;
+    auto feature_ids = [](const ContactManifold& manifold) {
+        std::vector<std::uint64_t> ids;
+        for (const ContactPoint& contact: manifold.contacts) {
+            ids.push_back(contact.feature_id);
+        }
+        std::ranges::sort(ids);
+        return ids;
+    };
+
+    SECTION("are unique within a manifold") {
+        for (const ContactManifold& manifold: {visitor(ground, box).value(), visitor(box, top).value()}) {
+            CHECK(manifold.contacts.size() == 4);
+            std::vector<std::uint64_t> ids = feature_ids(manifold);
+            CHECK(std::ranges::adjacent_find(ids) == ids.end());
+        }
+    }
+
+    SECTION("persist under small movements") {
+        const std::vector<std::uint64_t> ids = feature_ids(visitor(box, top).value());
+
+        top.center += Vec3d(0.01, -0.005, 0.02);
+        top.update_computed_values();
+        CHECK(feature_ids(visitor(box, top).value()) == ids);
+    }
+}
+
+TEST_CASE("Warm starting")
+{
+    auto settle = [](Simulation& simulation) {
+        simulation.enable_gravity();
+        const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedPlane{.original_normal = Vec3d(0, 1, 0)}, material,
+                                     Vec3d(), Quatd());
+        std::vector<RigidBodyHandle> boxes;
+        for (int i = 0; i < 5; ++i) {
+            boxes.push_back(simulation.create_rigid_body(InertiaShape::cube(1, 0.5),
+                                                         colliders::OrientedBox{.half_size = Vec3d(0.5)}, material,
+                                                         Vec3d(0, 0.5 + i * 1.05, 0), Quatd()));
+        }
+        for (int i = 0; i < 120; ++i) {
+            simulation.update(1. / 60.);
+        }
+        return simulation.lookup(boxes.back()).position();
+    };
+
+    // a few iterations without warm starting let the stack sink into the ground
+    Simulation warm;
+    warm.set_solver_iterations(4);
+    Simulation cold;
+    cold.set_solver_iterations(4);
+    cold.disable_warm_starting();
+
+    const Vec3d top_warm = settle(warm);
+    const Vec3d top_cold = settle(cold);
+    CHECK(std::abs(top_warm.y() - 4.5) < std::abs(top_cold.y() - 4.5));
+    CHECK(std::abs(top_warm.y() - 4.5) < 0.05);
+}
@@ -0,0 +1,337 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/Gjk.h>
+#include <physics3d/Simulation.h>
+
+using namespace yage::physics3d;
+using namespace yage::math;
+
+namespace
+{
+    const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+
+    std::vector<Vec3d> cube_points(const double half_size)
+    {
+        std::vector<Vec3d> points;
+        for (int i = 0; i < 8; ++i) {
+            points.emplace_back(i & 1 ? half_size : -half_size, i & 2 ? half_size : -half_size,
+                                i & 4 ? half_size : -half_size);
+        }
+        return points;
+    }
+
+    /**
+     * Points on a sphere, spread by the golden angle.
+     */
+    std::vector<Vec3d> sphere_points(const double radius, const int count)
+    {
+        std::vector<Vec3d> points;
+        for (int i = 0; i < count; ++i) {
+            const double y = 1 - 2 * (i + 0.5) / count;
+            const double r = std::sqrt(1 - y * y);
+            const double angle = i * std::numbers::pi * (3 - std::sqrt(5.));
+            points.emplace_back(radius * r * std::cos(angle), radius * y, radius * r * std::sin(angle));
+        }
+        return points;
+    }
+
+    Quatd rotation(const Vec3d& axis, const double angle)
+    {
+        const Vec3d v = std::sin(angle / 2) * normalize(axis);
+        return {std::cos(angle / 2), v.x(), v.y(), v.z()};
+    }
+
+    colliders::OrientedBox make_box(const Vec3d& half_size, const Vec3d& center, const Quatd& orientation)
+    {
+        colliders::OrientedBox box{.half_size = half_size, .center = center, .orientation = orientation};
+        box.update_computed_values();
+        return box;
+    }
+
+    /**
+     * @return The overlap of the projections of two boxes onto an axis.
+     */
+    double overlap(const colliders::OrientedBox& a, const colliders::OrientedBox& b, const Vec3d& axis)
+    {
+        const auto [min_a, max_a] = std::ranges::minmax(a.oriented_vertices | std::views::transform(
+                [&axis](const Vec3d& vertex) { return dot(vertex, axis); }));
+        const auto [min_b, max_b] = std::ranges::minmax(b.oriented_vertices | std::views::transform(
+                [&axis](const Vec3d& vertex) { return dot(vertex, axis); }));
+        return std::min(max_a - min_b, max_b - min_a);
+    }
+}
+
+TEST_CASE("GJK and EPA")
+{
+    SECTION("distance of separated shapes") {
+        const colliders::Convex capsule{
+                .shape = shapes::Capsule{.radius = 0.5, .half_height = 1},
+                .center = Vec3d(0, 0, 0),
+        };
+        const colliders::Sphere sphere{.center = Vec3d(3, 0.5, 0), .radius = 1};
+        const std::optional<ClosestPoints> closest = distance(capsule, sphere);
+        REQUIRE(closest.has_value());
+        CHECK(closest->distance == Catch::Approx(1.5));
+        CHECK(closest->point_a.x() == Catch::Approx(0.5));
+        CHECK(closest->point_a.y() == Catch::Approx(0.5));
+        CHECK(closest->point_b.x() == Catch::Approx(2));
+        CHECK(!intersects(capsule, sphere));
+
+        const colliders::Sphere touching{.center = Vec3d(1.4, 0.5, 0), .radius = 1};
+        CHECK(!distance(capsule, touching).has_value());
+        CHECK(intersects(capsule, touching));
+    }
+
+    SECTION("the cached axis doesn't change the result") {
+        const ConvexHull hull(sphere_points(1, 200));
+        const colliders::Convex a{.shape = shapes::Hull{.hull = &hull}};
+        GjkCache cache;
+        for (int i = 0; i < 10; ++i) {
+            const colliders::Convex b{
+                    .shape = shapes::Cylinder{.radius = 0.5, .half_height = 1},
+                    .center = Vec3d(2.5 - 0.01 * i, 0.3, 0.1 * i),
+                    .orientation = normalize(Quatd(1, 0.1 * i, 0, 0.2)),
+            };
+            const std::optional<ClosestPoints> cold = distance(a, b);
+            const std::optional<ClosestPoints> warm = distance(a, b, &cache);
+            REQUIRE(cold.has_value());
+            REQUIRE(warm.has_value());
+            CHECK(warm->distance == Catch::Approx(cold->distance).margin(1e-9));
+            CHECK(length(cache.axis) > 0);
+        }
+    }
+
+    SECTION("penetration of hulls matches the separating axes of boxes") {
+        const ConvexHull hull(cube_points(1));
+        std::mt19937 random(GENERATE(1, 2, 3, 4, 5, 6, 7, 8));
+        std::uniform_real_distribution<double> offset(-1.5, 1.5);
+        std::uniform_real_distribution<double> component(-1, 1);
+        const Quatd orientation_a = normalize(Quatd(component(random), component(random), component(random), 1));
+        const Quatd orientation_b = normalize(Quatd(component(random), component(random), component(random), 1));
+        const Vec3d center_b(offset(random), offset(random), offset(random));
+
+        const colliders::OrientedBox box_a = make_box(Vec3d(1), Vec3d(), orientation_a);
+        const colliders::OrientedBox box_b = make_box(Vec3d(1), center_b, orientation_b);
+
+        // the minimum translation of two boxes lies along one of their face normals or edge pairs
+        std::vector<Vec3d> axes(box_a.oriented_face_normals.begin(), box_a.oriented_face_normals.end());
+        axes.insert(axes.end(), box_b.oriented_face_normals.begin(), box_b.oriented_face_normals.end());
+        for (const Vec3d& edge_a: box_a.oriented_face_normals) {
+            for (const Vec3d& edge_b: box_b.oriented_face_normals) {
+                if (length(cross(edge_a, edge_b)) > 1e-9) {
+                    axes.push_back(normalize(cross(edge_a, edge_b)));
+                }
+            }
+        }
+        double depth = std::numeric_limits<double>::infinity();
+        for (const Vec3d& axis: axes) {
+            depth = std::min(depth, overlap(box_a, box_b, axis));
+        }
+
+        const std::optional<Penetration> penetration = yage::physics3d::penetration(
+                colliders::Convex{.shape = shapes::Hull{.hull = &hull}, .orientation = orientation_a}, box_b);
+        REQUIRE(penetration.has_value() == (depth > 0));
+        if (penetration.has_value()) {
+            CHECK(penetration->depth == Catch::Approx(depth).margin(1e-4));
+            CHECK(overlap(box_a, box_b, penetration->normal) == Catch::Approx(depth).margin(1e-4));
+            CHECK(dot(penetration->point_a - penetration->point_b, penetration->normal) ==
+                  Catch::Approx(penetration->depth).margin(1e-4));
+        }
+    }
+
+    SECTION("penetration of rounded shapes") {
+        const ConvexHull hull(sphere_points(1, 400));
+        const colliders::Convex a{.shape = shapes::Hull{.hull = &hull}};
+        const colliders::Sphere b{.center = Vec3d(0.6, 1.2, 0), .radius = 0.5};
+        const std::optional<Penetration> penetration = yage::physics3d::penetration(a, b);
+        REQUIRE(penetration.has_value());
+        // the hull is slightly smaller than the sphere it samples
+        CHECK(penetration->depth == Catch::Approx(1.5 - length(b.center)).margin(0.02));
+        CHECK(dot(penetration->normal, normalize(b.center)) == Catch::Approx(1).margin(5e-3));
+
+        const colliders::Convex capsule{
+                .shape = shapes::Capsule{.radius = 0.25, .half_height = 1},
+                .center = Vec3d(1.1, 0, 0),
+        };
+        const std::optional<Penetration> side = yage::physics3d::penetration(a, capsule);
+        REQUIRE(side.has_value());
+        CHECK(side->depth == Catch::Approx(0.15).margin(0.02));
+        CHECK(side->normal.x() == Catch::Approx(1).margin(1e-3));
+    }
+
+    SECTION("penetration of hulls with many vertices") {
+        // the polytope of EPA can have more faces than a closed polytope, which must not overflow its buffers
+        std::mt19937 random(GENERATE(1, 2, 3, 4));
+        std::uniform_real_distribution<double> component(-1, 1);
+        for (int i = 0; i < 2000; ++i) {
+            std::vector<Vec3d> points(4 + random() % 200);
+            for (Vec3d& point: points) {
+                point = Vec3d(component(random), component(random), component(random));
+            }
+            const ConvexHull hull(points);
+            const colliders::Convex a{
+                    .shape = shapes::Hull{.hull = &hull},
+                    .orientation = normalize(Quatd(component(random), component(random), component(random), 1)),
+            };
+            const Vec3d center(component(random), component(random), component(random));
+            const Quatd orientation = normalize(Quatd(component(random), component(random), component(random), 1));
+            const std::array<colliders::Convex, 3> others{
+                    colliders::Convex{.shape = shapes::Capsule{.radius = 0.3, .half_height = 0.8}},
+                    colliders::Convex{.shape = shapes::Cylinder{.radius = 0.5, .half_height = 0.6}},
+                    colliders::Convex{.shape = shapes::Hull{.hull = &hull}},
+            };
+            colliders::Convex b = others[random() % others.size()];
+            b.center = center;
+            b.orientation = orientation;
+
+            const std::optional<Penetration> penetration = yage::physics3d::penetration(a, b);
+            if (penetration.has_value()) {
+                REQUIRE(std::isfinite(penetration->depth));
+                REQUIRE(length(penetration->normal) == Catch::Approx(1));
+            }
+        }
+    }
+
+    SECTION("inner radius of a hull") {
+        const ConvexHull cube(cube_points(1));
+        CHECK(cube.inner_radius() == Catch::Approx(1).margin(1e-6));
+        const ConvexHull outside(std::vector<Vec3d>{Vec3d(1, 1, 1), Vec3d(2, 1, 1), Vec3d(1, 2, 1), Vec3d(1, 1, 2)});
+        CHECK(outside.inner_radius() == 0);
+    }
+}
+
+TEST_CASE("Convex contact manifolds")
+{
+    SECTION("cylinder standing on a plane") {
+        colliders::OrientedPlane plane{.original_normal = Vec3d(0, 1, 0)};
+        plane.normal = plane.original_normal;
+        const colliders::Convex cylinder{
+                .shape = shapes::Cylinder{.radius = 0.5, .half_height = 1},
+                .center = Vec3d(0, 0.99, 0),
+        };
+        const std::optional<ContactManifold> manifold = CollisionVisitor()(cylinder, plane);
+        REQUIRE(manifold.has_value());
+        CHECK(manifold->normal.y() == Catch::Approx(-1));
+        CHECK(manifold->contacts.size() == 4);
+        for (const ContactPoint& contact: manifold->contacts) {
+            CHECK(contact.depth == Catch::Approx(0.01));
+            CHECK(contact.p_a.y() == Catch::Approx(-0.01));
+            CHECK(length(contact.r_a - (contact.p_a - cylinder.center)) == Catch::Approx(0).margin(1e-12));
+        }
+    }
+
+    SECTION("hull resting on a box") {
+        const ConvexHull hull(cube_points(0.5));
+        const colliders::Convex convex{.shape = shapes::Hull{.hull = &hull}, .center = Vec3d(0.2, 0.99, 0.1)};
+        const colliders::OrientedBox box = make_box(Vec3d(2, 0.5, 2), Vec3d(), Quatd());
+        const std::optional<ContactManifold> manifold = CollisionVisitor()(box, convex);
+        REQUIRE(manifold.has_value());
+        CHECK(manifold->normal.y() == Catch::Approx(1));
+        CHECK(manifold->contacts.size() == 4);
+        for (const ContactPoint& contact: manifold->contacts) {
+            CHECK(contact.depth == Catch::Approx(0.01).margin(1e-6));
+        }
+    }
+
+    SECTION("capsule lying across a box edge") {
+        const colliders::OrientedBox box = make_box(Vec3d(1), Vec3d(), Quatd());
+        const colliders::Convex capsule{
+                .shape = shapes::Capsule{.radius = 0.5, .half_height = 1},
+                .center = Vec3d(1, 1.45, 0),
+                .orientation = rotation(Vec3d(0, 0, 1), std::numbers::pi / 2),
+        };
+        const std::optional<ContactManifold> manifold = CollisionVisitor()(capsule, box);
+        REQUIRE(manifold.has_value());
+        CHECK(manifold->normal.y() == Catch::Approx(-1).margin(1e-6));
+        // the capsule touches the top face along a line from its lower end to the edge of the box
+        REQUIRE(manifold->contacts.size() == 2);
+        for (const ContactPoint& contact: manifold->contacts) {
+            CHECK(contact.depth == Catch::Approx(0.05).margin(1e-6));
+        }
+        CHECK(std::abs(manifold->contacts[0].p_b.x() - manifold->contacts[1].p_b.x()) == Catch::Approx(1));
+    }
+}
+
+TEST_CASE("Convex bodies")
+{
+    Simulation simulation;
+    simulation.enable_gravity();
+    simulation.create_rigid_body(InertiaShape::static_shape(),
+                                 colliders::OrientedPlane{.original_normal = Vec3d(0, 1, 0)}, material,
+                                 Vec3d(), Quatd());
+
+    SECTION("shapes come to rest") {
+        const ConvexHull hull(sphere_points(0.5, 60));
+        const ConvexHull cube(cube_points(0.5));
+        const RigidBodyHandle capsule = simulation.create_rigid_body(
+                InertiaShape::sphere(0.5, 1), colliders::Convex{.shape = shapes::Capsule{.radius = 0.25}}, material,
+                Vec3d(0, 2, 0), rotation(Vec3d(1, 0, 0), 1.2));
+        const RigidBodyHandle cylinder = simulation.create_rigid_body(
+                InertiaShape::cuboid(1, 2, 1, 1), colliders::Convex{.shape = shapes::Cylinder{.half_height = 1}},
+                material, Vec3d(3, 1.1, 0), Quatd());
+        const RigidBodyHandle ball = simulation.create_rigid_body(
+                InertiaShape::sphere(0.5, 1), colliders::Convex{.shape = shapes::Hull{.hull = &hull}}, material,
+                Vec3d(-3, 1, 0), Quatd());
+        const RigidBodyHandle box = simulation.create_rigid_body(
+                InertiaShape::cube(1, 1), colliders::Convex{.shape = shapes::Hull{.hull = &cube}}, material,
+                Vec3d(3, 2.7, 0), Quatd());
+
+        for (int i = 0; i < 300; ++i) {
+            simulation.update(1. / 60.);
+        }
+
+        // the capsule lies on its side
+        CHECK(simulation.lookup(capsule).position().y() == Catch::Approx(0.25).margin(0.01));
+        CHECK(simulation.lookup(cylinder).position().y() == Catch::Approx(1).margin(0.01));
+        CHECK(simulation.lookup(cylinder).position().x() == Catch::Approx(3).margin(0.01));
+        // the ball rests on one of the facets of its hull
+        CHECK(simulation.lookup(ball).position().y() >= hull.inner_radius() - 0.01);
+        CHECK(simulation.lookup(ball).position().y() <= 0.5);
+        // the box stands on the cylinder
+        CHECK(simulation.lookup(box).position().y() == Catch::Approx(2.5).margin(0.02));
+        CHECK(simulation.lookup(box).position().x() == Catch::Approx(3).margin(0.02));
+        for (const RigidBodyHandle body: {capsule, cylinder, ball, box}) {
+            CHECK(length(simulation.lookup(body).velocity()) < 0.01);
+        }
+    }
+
+    SECTION("scene queries hit convex shapes") {
+        const ConvexHull hull(sphere_points(1, 100));
+        const RigidBodyHandle ball = simulation.create_rigid_body(
+                InertiaShape::sphere(1, 1), colliders::Convex{.shape = shapes::Hull{.hull = &hull}}, material,
+                Vec3d(0, 1, 0), Quatd());
+        const RigidBodyHandle capsule = simulation.create_rigid_body(
+                InertiaShape::sphere(1, 1), colliders::Convex{.shape = shapes::Capsule{.radius = 0.5}}, material,
+                Vec3d(5, 1, 0), Quatd());
+        simulation.update(1. / 60.);
+
+        std::optional<QueryHit> hit = simulation.raycast(
+                {.origin = Vec3d(0, 1, -10), .direction = Vec3d(0, 0, 1), .max_distance = 20});
+        REQUIRE(hit.has_value());
+        CHECK(hit->body == ball);
+        CHECK(hit->distance == Catch::Approx(9).margin(0.05));
+        CHECK(hit->normal.z() == Catch::Approx(-1).margin(0.05));
+
+        hit = simulation.sphere_cast({.origin = Vec3d(5, 10, 0), .direction = Vec3d(0, -1, 0), .max_distance = 20},
+                                     0.5);
+        REQUIRE(hit.has_value());
+        CHECK(hit->body == capsule);
+        CHECK(hit->distance == Catch::Approx(10 - 2.5).margin(1e-3));
+        CHECK(hit->normal.y() == Catch::Approx(1).margin(1e-3));
+
+        std::vector<RigidBodyHandle> bodies;
+        simulation.overlap(colliders::Sphere{.center = Vec3d(5.6, 1.6, 0), .radius = 0.3}, bodies);
+        REQUIRE(bodies.size() == 1);
+        CHECK(bodies[0] == capsule);
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <physics3d/Simulation.h>
+
+/**
+ * Scene building blocks that are shared between the simulation tests.
+ */
+namespace yage::physics3d::fixtures
+{
+    inline const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+
+    /**
+     * Creates a static ground plane through the origin, facing up.
+     */
+    inline RigidBodyHandle create_ground(Simulation& simulation, const Material& ground_material = material)
+    {
+        return simulation.create_rigid_body(InertiaShape::static_shape(),
+                                            colliders::OrientedPlane{.original_normal = math::Vec3d(0, 1, 0)},
+                                            ground_material, math::Vec3d(), math::Quatd());
+    }
+
+    /**
+     * Creates a unit box of mass 1.
+     */
+    inline RigidBodyHandle create_box(Simulation& simulation, const math::Vec3d& position,
+                                      const Material& box_material = material)
+    {
+        return simulation.create_rigid_body(InertiaShape::cube(1, 1),
+                                            colliders::OrientedBox{.half_size = math::Vec3d(0.5)}, box_material,
+                                            position, math::Quatd());
+    }
+
+    /**
+     * Steps the simulation at 60 Hz.
+     */
+    inline void run(Simulation& simulation, const int steps)
+    {
+        for (int i = 0; i < steps; ++i) {
+            simulation.update(1. / 60.);
+        }
+    }
+}
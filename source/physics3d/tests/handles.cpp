@@ -0,0 +1,85 @@
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/Simulation.h>
+
+#include "fixtures.h"
+
+using namespace yage::physics3d;
+using namespace yage::math;
+using namespace yage::physics3d::fixtures;
+
+namespace
+{
+    const Material inelastic{.restitution = 0, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+
+}
+
+TEST_CASE("Rigid body handles")
+{
+    Simulation simulation;
+    simulation.enable_gravity();
+    create_ground(simulation, inelastic);
+    std::vector<RigidBodyHandle> boxes;
+    for (int i = 0; i < 4; ++i) {
+        boxes.push_back(create_box(simulation, Vec3d(2 * i, 0.5, 0), inelastic));
+    }
+    run(simulation, 10);
+
+    SECTION("destroyed bodies invalidate their handles") {
+        simulation.lookup(boxes[1]).destroy();
+        CHECK(simulation.contains(boxes[1]));
+
+        simulation.update(1. / 60.);
+        CHECK(!simulation.contains(boxes[1]));
+        CHECK(simulation.body_count() == 4);
+        for (const int i: {0, 2, 3}) {
+            REQUIRE(simulation.contains(boxes[i]));
+            CHECK(simulation.lookup(boxes[i]).position().x() == Catch::Approx(2 * i).margin(0.01));
+        }
+    }
+
+    SECTION("reused slots get a new generation") {
+        simulation.lookup(boxes[1]).destroy();
+        simulation.update(1. / 60.);
+        const RigidBodyHandle box = create_box(simulation, Vec3d(10, 0.5, 0), inelastic);
+        CHECK(box != boxes[1]);
+        CHECK(!simulation.contains(boxes[1]));
+        CHECK(simulation.lookup(box).position() == Vec3d(10, 0.5, 0));
+    }
+
+    SECTION("moved bodies keep their collisions and sleep state") {
+        run(simulation, 60);
+        REQUIRE(simulation.lookup(boxes[3]).is_sleeping());
+
+        // the last box moves into the place of the first one
+        simulation.lookup(boxes[0]).destroy();
+        simulation.update(1. / 60.);
+        CHECK(simulation.lookup(boxes[3]).is_sleeping());
+
+        std::vector<RigidBodyHandle> overlapping;
+        simulation.overlap(geometry::AABB{.min = Vec3d(5.9, 0.4, -0.1), .max = Vec3d(6.1, 0.6, 0.1)}, overlapping);
+        CHECK(overlapping == std::vector{boxes[3]});
+
+        const RigidBodyHandle falling = create_box(simulation, Vec3d(6, 1.6, 0), inelastic);
+        run(simulation, 60);
+        CHECK(simulation.lookup(boxes[3]).position().y() == Catch::Approx(0.5).margin(0.05));
+        CHECK(simulation.lookup(falling).position().y() == Catch::Approx(1.5).margin(0.05));
+    }
+
+    SECTION("spawning and despawning reuses the storage") {
+        for (int i = 0; i < 100; ++i) {
+            const RigidBodyHandle sphere = simulation.create_rigid_body(
+                    InertiaShape::sphere(0.25, 1), colliders::Sphere{.radius = 0.25}, inelastic,
+                    Vec3d(0.1 * (i % 10), 1.5, 0), Quatd());
+            simulation.update(1. / 60.);
+            simulation.lookup(sphere).destroy();
+        }
+        simulation.update(1. / 60.);
+        CHECK(simulation.body_count() == 5);
+        for (int i = 0; i < 4; ++i) {
+            CHECK(simulation.lookup(boxes[i]).position().x() == Catch::Approx(2 * i).margin(0.1));
+        }
+    }
+}
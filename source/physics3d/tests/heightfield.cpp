@@ -0,0 +1,231 @@
+#include <array>
+#include <cmath>
+#include <map>
+#include <optional>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/Simulation.h>
+
+using namespace yage::physics3d;
+using namespace yage::math;
+
+namespace
+{
+    const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+
+    /**
+     * Rolling hills with a few sharp steps, which have ridges as well as valleys.
+     */
+    std::vector<double> bumpy_heights(const std::size_t rows, const std::size_t columns)
+    {
+        std::vector<double> heights;
+        for (std::size_t row = 0; row < rows; ++row) {
+            for (std::size_t column = 0; column < columns; ++column) {
+                const auto x = static_cast<double>(column);
+                const auto z = static_cast<double>(row);
+                heights.push_back(std::sin(0.7 * x) * std::cos(0.4 * z) + (column % 5 == 0 ? 0.5 : 0));
+            }
+        }
+        return heights;
+    }
+
+    /**
+     * The triangles of a heightfield as a triangle mesh, which serves as the reference.
+     */
+    TriangleMesh to_mesh(const Heightfield& heightfield)
+    {
+        std::vector<Vec3d> vertices;
+        std::vector<std::uint32_t> indices;
+        for (std::uint32_t i = 0; i < heightfield.size(); ++i) {
+            for (const Vec3d& vertex: heightfield.triangle(i)) {
+                indices.push_back(static_cast<std::uint32_t>(vertices.size()));
+                vertices.push_back(vertex);
+            }
+        }
+        return {vertices, indices};
+    }
+
+    using EdgeKey = std::tuple<double, double, double, double>;
+
+    EdgeKey edge_key(const Vec3d& a, const Vec3d& b)
+    {
+        return std::min(std::tuple(a.x(), a.z(), b.x(), b.z()), std::tuple(b.x(), b.z(), a.x(), a.z()));
+    }
+}
+
+TEST_CASE("Heightfield grid")
+{
+    const std::size_t rows = 12;
+    const std::size_t columns = 17;
+    const std::vector<double> heights = bumpy_heights(rows, columns);
+    const Heightfield heightfield(rows, columns, heights, 0.5);
+
+    SECTION("heights are quantized to 16 bits") {
+        const double range = heightfield.bounds().max.y() - heightfield.bounds().min.y();
+        for (std::size_t row = 0; row < rows; ++row) {
+            for (std::size_t column = 0; column < columns; ++column) {
+                CHECK(heightfield.height(row, column) ==
+                      Catch::Approx(heights[row * columns + column]).margin(range / 65535));
+            }
+        }
+        CHECK(heightfield.size() == 2 * (rows - 1) * (columns - 1));
+        CHECK(heightfield.bounds().max.x() == Catch::Approx(8));
+        CHECK(heightfield.bounds().max.z() == Catch::Approx(5.5));
+    }
+
+    SECTION("triangles face upwards") {
+        for (std::uint32_t i = 0; i < heightfield.size(); ++i) {
+            const Heightfield::Triangle triangle = heightfield.triangle(i);
+            CHECK(cross(triangle[1] - triangle[0], triangle[2] - triangle[0]).y() > 0);
+        }
+    }
+
+    SECTION("queries find the same triangles as a brute force search") {
+        std::mt19937 random(GENERATE(1, 2, 3));
+        std::uniform_real_distribution<double> position(-1, 9);
+        std::uniform_real_distribution<double> size(0, 2);
+        for (int i = 0; i < 20; ++i) {
+            const Vec3d min(position(random), position(random) / 5 - 0.5, position(random) * 0.7);
+            const geometry::AABB aabb{.min = min, .max = min + Vec3d(size(random), size(random), size(random))};
+
+            std::set<std::uint32_t> found;
+            heightfield.query(aabb, [&found](const std::uint32_t index) { found.insert(index); });
+            std::set<std::uint32_t> expected;
+            for (std::uint32_t j = 0; j < heightfield.size(); ++j) {
+                const Heightfield::Triangle triangle = heightfield.triangle(j);
+                geometry::AABB bounds{.min = triangle[0], .max = triangle[0]};
+                for (const Vec3d& vertex: triangle) {
+                    bounds = geometry::merge(bounds, {.min = vertex, .max = vertex});
+                }
+                if (geometry::overlaps(bounds, aabb)) {
+                    expected.insert(j);
+                }
+            }
+            CHECK(found == expected);
+        }
+    }
+
+    SECTION("active edges match those of the same triangles as a mesh") {
+        const TriangleMesh mesh = to_mesh(heightfield);
+        std::map<EdgeKey, bool> mesh_edges;
+        for (std::uint32_t i = 0; i < mesh.size(); ++i) {
+            const TriangleMesh::Triangle triangle = mesh.triangle(i);
+            for (int edge = 0; edge < 3; ++edge) {
+                mesh_edges[edge_key(triangle[edge], triangle[(edge + 1) % 3])] = mesh.is_active_edge(i, edge);
+            }
+        }
+
+        int active = 0;
+        for (std::uint32_t i = 0; i < heightfield.size(); ++i) {
+            const Heightfield::Triangle triangle = heightfield.triangle(i);
+            for (int edge = 0; edge < 3; ++edge) {
+                const EdgeKey key = edge_key(triangle[edge], triangle[(edge + 1) % 3]);
+                REQUIRE(mesh_edges.contains(key));
+                CHECK(heightfield.is_active_edge(i, edge) == mesh_edges[key]);
+                active += heightfield.is_active_edge(i, edge);
+            }
+        }
+        // the boundary and some of the ridges
+        CHECK(active > static_cast<int>(2 * (rows - 1 + columns - 1)));
+    }
+
+    SECTION("rays and sphere casts hit the same triangles as with a mesh") {
+        const TriangleMesh mesh = to_mesh(heightfield);
+        const colliders::Heightfield terrain{.heightfield = &heightfield, .center = Vec3d(1, 2, 3),
+                                             .orientation = normalize(Quatd(1, 0.1, 0.2, 0))};
+        const colliders::Mesh reference{.mesh = &mesh, .center = terrain.center, .orientation = terrain.orientation};
+
+        std::mt19937 random(GENERATE(4, 5));
+        std::uniform_real_distribution<double> position(-2, 12);
+        std::uniform_real_distribution<double> height(2, 6);
+        int hits = 0;
+        for (int i = 0; i < 50; ++i) {
+            const colliders::Sphere sphere{
+                    .center = Vec3d(position(random), height(random), position(random)),
+                    .radius = i % 2 == 0 ? 0 : 0.3,
+            };
+            const Vec3d displacement = Vec3d(position(random), -height(random) - 4, position(random)) - sphere.center;
+            const std::optional<SweepHit> hit = sweep(sphere, displacement, terrain);
+            const std::optional<SweepHit> expected = sweep(sphere, displacement, reference);
+            REQUIRE(hit.has_value() == expected.has_value());
+            if (hit.has_value()) {
+                CHECK(hit->fraction == Catch::Approx(expected->fraction).margin(1e-6));
+                CHECK(dot(hit->normal, expected->normal) == Catch::Approx(1).margin(1e-6));
+                ++hits;
+            }
+        }
+        CHECK(hits > 10);
+    }
+}
+
+TEST_CASE("Heightfield collisions")
+{
+    const Heightfield flat(9, 9, std::vector<double>(81, 1), 1);
+    Simulation simulation;
+    simulation.enable_gravity();
+    const RigidBodyHandle ground = simulation.create_rigid_body(
+            InertiaShape::static_shape(), colliders::Heightfield{.heightfield = &flat}, material, Vec3d(-4, -1, -4),
+            Quatd());
+
+    SECTION("bodies come to rest on a heightfield") {
+        const RigidBodyHandle box = simulation.create_rigid_body(
+                InertiaShape::cube(1, 1), colliders::OrientedBox{.half_size = Vec3d(0.5)}, material,
+                Vec3d(0.3, 1, 0.2), Quatd());
+        const RigidBodyHandle sphere = simulation.create_rigid_body(
+                InertiaShape::sphere(0.5, 1), colliders::Sphere{.radius = 0.5}, material, Vec3d(3, 1, 0), Quatd());
+        const RigidBodyHandle capsule = simulation.create_rigid_body(
+                InertiaShape::sphere(0.5, 1), colliders::Convex{.shape = shapes::Capsule{.radius = 0.25}}, material,
+                Vec3d(-3, 1, 0), normalize(Quatd(1, 0, 0, 1)));
+        for (int i = 0; i < 300; ++i) {
+            simulation.update(1. / 60.);
+        }
+        CHECK(simulation.lookup(box).position().y() == Catch::Approx(0.5).margin(0.01));
+        CHECK(simulation.lookup(sphere).position().y() == Catch::Approx(0.5).margin(0.01));
+        CHECK(simulation.lookup(capsule).position().y() == Catch::Approx(0.25).margin(0.01));
+        for (const RigidBodyHandle body: {box, sphere, capsule}) {
+            CHECK(length(simulation.lookup(body).velocity()) < 0.01);
+        }
+    }
+
+    SECTION("spheres roll down slopes") {
+        // a valley along the x-axis, with the lowest row in the middle
+        std::vector<double> heights;
+        for (int row = 0; row < 9; ++row) {
+            for (int column = 0; column < 9; ++column) {
+                heights.push_back(0.5 * std::abs(row - 4));
+            }
+        }
+        const Heightfield valley(9, 9, heights, 1);
+        simulation.create_rigid_body(InertiaShape::static_shape(), colliders::Heightfield{.heightfield = &valley},
+                                     material, Vec3d(-4, 5, -4), Quatd());
+        const RigidBodyHandle sphere = simulation.create_rigid_body(
+                InertiaShape::sphere(0.3, 1), colliders::Sphere{.radius = 0.3}, material, Vec3d(0, 7.2, -2.5),
+                Quatd());
+        for (int i = 0; i < 600; ++i) {
+            simulation.update(1. / 60.);
+        }
+        CHECK(std::abs(simulation.lookup(sphere).position().z()) < 0.5);
+        CHECK(simulation.lookup(sphere).position().y() < 5.6);
+    }
+
+    SECTION("scene queries hit the heightfield") {
+        std::optional<QueryHit> hit = simulation.raycast(
+                {.origin = Vec3d(1.3, 5, -2.7), .direction = Vec3d(0.1, -1, 0), .max_distance = 20});
+        REQUIRE(hit.has_value());
+        CHECK(hit->body == ground);
+        CHECK(hit->distance == Catch::Approx(std::sqrt(25.25)).margin(1e-6));
+        CHECK(hit->normal.y() == Catch::Approx(1).margin(1e-6));
+
+        hit = simulation.raycast({.origin = Vec3d(5, 5, 0), .direction = Vec3d(0, -1, 0), .max_distance = 20});
+        CHECK(!hit.has_value());
+
+        std::vector<RigidBodyHandle> bodies;
+        simulation.overlap(colliders::Sphere{.center = Vec3d(2, 0.2, 2), .radius = 0.3}, bodies);
+        CHECK(bodies.size() == 1);
+    }
+}
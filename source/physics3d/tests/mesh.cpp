@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/Simulation.h>
+
+using namespace yage::physics3d;
+using namespace yage::math;
+
+namespace
+{
+    const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+
+    /**
+     * A flat grid of quads in the xz-plane, facing up, with vertices shared between quads.
+     */
+    TriangleMesh make_grid(const int cells, const double cell_size)
+    {
+        std::vector<Vec3d> vertices;
+        for (int i = 0; i <= cells; ++i) {
+            for (int j = 0; j <= cells; ++j) {
+                vertices.emplace_back(cell_size * (i - cells / 2.0), 0, cell_size * (j - cells / 2.0));
+            }
+        }
+        auto vertex = [cells](const int i, const int j) {
+            return static_cast<std::uint32_t>(i * (cells + 1) + j);
+        };
+        std::vector<std::uint32_t> indices;
+        for (int i = 0; i < cells; ++i) {
+            for (int j = 0; j < cells; ++j) {
+                indices.insert(indices.end(), {vertex(i, j), vertex(i, j + 1), vertex(i + 1, j)});
+                indices.insert(indices.end(), {vertex(i + 1, j), vertex(i, j + 1), vertex(i + 1, j + 1)});
+            }
+        }
+        return {vertices, indices};
+    }
+}
+
+TEST_CASE("Triangle mesh hierarchy")
+{
+    SECTION("queries find the same triangles as a brute force search") {
+        const TriangleMesh mesh = make_grid(20, 1);
+        std::mt19937 random(GENERATE(1, 2, 3));
+        std::uniform_real_distribution<double> position(-11, 11);
+        std::uniform_real_distribution<double> size(0, 3);
+        for (int i = 0; i < 20; ++i) {
+            const Vec3d min(position(random), position(random) / 10, position(random));
+            const geometry::AABB aabb{.min = min, .max = min + Vec3d(size(random), size(random), size(random))};
+
+            std::set<std::uint32_t> found;
+            mesh.query(aabb, [&found](const std::uint32_t index) { found.insert(index); });
+            std::set<std::uint32_t> expected;
+            for (std::uint32_t j = 0; j < mesh.size(); ++j) {
+                const TriangleMesh::Triangle triangle = mesh.triangle(j);
+                geometry::AABB bounds{.min = triangle[0], .max = triangle[0]};
+                for (const Vec3d& vertex: triangle) {
+                    bounds = geometry::merge(bounds, {.min = vertex, .max = vertex});
+                }
+                if (geometry::overlaps(bounds, aabb)) {
+                    expected.insert(j);
+                }
+            }
+            CHECK(found == expected);
+        }
+    }
+
+    SECTION("only boundary edges of a flat grid are active") {
+        const TriangleMesh mesh = make_grid(4, 1);
+        int active = 0;
+        for (std::uint32_t i = 0; i < mesh.size(); ++i) {
+            for (int edge = 0; edge < 3; ++edge) {
+                active += mesh.is_active_edge(i, edge);
+            }
+        }
+        CHECK(active == 16);
+    }
+
+    SECTION("ridges are active, valleys are not") {
+        // two quads that meet at x = 0, folded up or down by 45 degrees
+        auto fold = [](const double height) {
+            const std::vector<Vec3d> vertices{
+                    Vec3d(-1, height, 0), Vec3d(-1, height, 1), Vec3d(0, 0, 0), Vec3d(0, 0, 1),
+                    Vec3d(1, height, 0), Vec3d(1, height, 1),
+            };
+            const std::vector<std::uint32_t> indices{0, 1, 2, 2, 1, 3, 2, 3, 4, 4, 3, 5};
+            const TriangleMesh mesh(vertices, indices);
+            int active = 0;
+            for (std::uint32_t i = 0; i < mesh.size(); ++i) {
+                for (int edge = 0; edge < 3; ++edge) {
+                    active += mesh.is_active_edge(i, edge);
+                }
+            }
+            return active;
+        };
+        // the boundary of both quads has six edges, the fold is shared by two triangles
+        CHECK(fold(-1) == 8);
+        CHECK(fold(1) == 6);
+    }
+}
+
+TEST_CASE("Mesh collisions")
+{
+    const TriangleMesh grid = make_grid(20, 1);
+    Simulation simulation;
+    simulation.enable_gravity();
+    const RigidBodyHandle ground = simulation.create_rigid_body(
+            InertiaShape::static_shape(), colliders::Mesh{.mesh = &grid}, material, Vec3d(), Quatd());
+
+    SECTION("bodies come to rest on a mesh") {
+        const RigidBodyHandle box = simulation.create_rigid_body(
+                InertiaShape::cube(1, 1), colliders::OrientedBox{.half_size = Vec3d(0.5)}, material,
+                Vec3d(0.3, 1, 0.2), Quatd());
+        const RigidBodyHandle sphere = simulation.create_rigid_body(
+                InertiaShape::sphere(0.5, 1), colliders::Sphere{.radius = 0.5}, material, Vec3d(3, 1, 0), Quatd());
+        const RigidBodyHandle capsule = simulation.create_rigid_body(
+                InertiaShape::sphere(0.5, 1), colliders::Convex{.shape = shapes::Capsule{.radius = 0.25}}, material,
+                Vec3d(-3, 1, 0), normalize(Quatd(1, 0, 0, 1)));
+        for (int i = 0; i < 300; ++i) {
+            simulation.update(1. / 60.);
+        }
+        CHECK(simulation.lookup(box).position().y() == Catch::Approx(0.5).margin(0.01));
+        CHECK(simulation.lookup(sphere).position().y() == Catch::Approx(0.5).margin(0.01));
+        CHECK(simulation.lookup(capsule).position().y() == Catch::Approx(0.25).margin(0.01));
+        for (const RigidBodyHandle body: {box, sphere, capsule}) {
+            CHECK(length(simulation.lookup(body).velocity()) < 0.01);
+        }
+    }
+
+    SECTION("boxes slide over internal edges without bumping") {
+        simulation.disable_sleeping();
+        const RigidBodyHandle box = simulation.create_rigid_body(
+                InertiaShape::cube(1, 1), colliders::OrientedBox{.half_size = Vec3d(0.5)},
+                Material{.restitution = 0, .kinetic_friction = 0.1, .rolling_friction = 0}, Vec3d(-6, 0.5, 0.3),
+                Quatd());
+        // a force over a single step of 1/60 seconds on a body of mass 1
+        simulation.lookup(box).apply_force(Vec3d(6, 0, 2) * 60., simulation.lookup(box).position());
+        for (int i = 0; i < 60; ++i) {
+            simulation.update(1. / 60.);
+            CHECK(std::abs(simulation.lookup(box).velocity().y()) < 0.1);
+            CHECK(simulation.lookup(box).position().y() == Catch::Approx(0.5).margin(0.02));
+        }
+        // the box crossed many triangles without tipping over
+        CHECK(simulation.lookup(box).position().x() > -3);
+        CHECK(std::abs(simulation.lookup(box).orientation().w()) > 0.99);
+    }
+
+    SECTION("contacts with triangles use the normal of the mesh surface") {
+        // The box reaches over the edge of the next quad by less than its depth, so the minimum translation out of
+        // the triangles of that quad points sideways.
+        colliders::OrientedBox box{.half_size = Vec3d(0.5), .center = Vec3d(0.505, 0.49, 0.3)};
+        box.update_computed_values();
+        std::vector<std::uint64_t> feature_ids;
+        std::size_t manifolds = 0;
+        collide(colliders::Mesh{.mesh = &grid}, box, true, [&](const ContactManifold& manifold) {
+            ++manifolds;
+            CHECK(manifold.normal.y() == Catch::Approx(1));
+            for (const ContactPoint& contact: manifold.contacts) {
+                CHECK(contact.depth == Catch::Approx(0.01));
+                feature_ids.push_back(contact.feature_id);
+            }
+        });
+        // the box overlaps four quads of the grid, whose contacts are distinct
+        CHECK(manifolds >= 4);
+        std::ranges::sort(feature_ids);
+        CHECK(std::ranges::adjacent_find(feature_ids) == feature_ids.end());
+    }
+
+    SECTION("scene queries hit the mesh") {
+        std::optional<QueryHit> hit = simulation.raycast(
+                {.origin = Vec3d(1.3, 5, -2.7), .direction = Vec3d(0.1, -1, 0), .max_distance = 20});
+        REQUIRE(hit.has_value());
+        CHECK(hit->body == ground);
+        CHECK(hit->distance == Catch::Approx(std::sqrt(25.25)).margin(1e-6));
+        CHECK(hit->normal.y() == Catch::Approx(1).margin(1e-6));
+
+        hit = simulation.sphere_cast({.origin = Vec3d(-2, 5, 4), .direction = Vec3d(0, -1, 0), .max_distance = 20},
+                                     0.5);
+        REQUIRE(hit.has_value());
+        CHECK(hit->distance == Catch::Approx(4.5).margin(1e-6));
+
+        std::vector<RigidBodyHandle> bodies;
+        simulation.overlap(colliders::Sphere{.center = Vec3d(2, 0.2, 2), .radius = 0.3}, bodies);
+        CHECK(bodies.size() == 1);
+        bodies.clear();
+        simulation.overlap(colliders::Sphere{.center = Vec3d(2, 0.4, 2), .radius = 0.3}, bodies);
+        CHECK(bodies.empty());
+    }
+
+    SECTION("meshes can be moved and rotated") {
+        const TriangleMesh ramp = make_grid(4, 1);
+        simulation.create_rigid_body(InertiaShape::static_shape(), colliders::Mesh{.mesh = &ramp}, material,
+                                     Vec3d(0, 3, 0), normalize(Quatd(1, 0, 0, 0.1)));
+        const std::optional<QueryHit> hit = simulation.raycast(
+                {.origin = Vec3d(0, 10, 0), .direction = Vec3d(0, -1, 0), .max_distance = 20});
+        REQUIRE(hit.has_value());
+        CHECK(hit->distance == Catch::Approx(7).margin(1e-6));
+        const Vec3d normal = normalize(Quatd(1, 0, 0, 0.1)) * Vec3d(0, 1, 0);
+        CHECK(dot(hit->normal, normal) == Catch::Approx(1).margin(1e-6));
+    }
+}
@@ -0,0 +1,65 @@
+#include <catch2/catch_all.hpp>
+
+#include <math/generators.h>
+#include <physics3d/Narrowphase.h>
+
+using namespace yage::physics3d;
+using namespace yage::math;
+
+TEST_CASE("Parallel narrow phase matches serial narrow phase")
+{
+    // a jumble of overlapping boxes and spheres on a plane
+    std::vector<Collider> colliders{colliders::OrientedPlane{.normal = Vec3d(0, 1, 0)}};
+    for (int i = 0; i < 100; ++i) {
+        const Vec3d center(0.8 * (i % 10), 0.4 + 0.3 * (i % 3), 0.8 * (i / 10));
+        if (i % 4 == 0) {
+            colliders.emplace_back(colliders::Sphere{.center = center, .radius = 0.5});
+        } else {
+            colliders::OrientedBox box{
+                    .half_size = Vec3d(0.5),
+                    .center = center,
+                    .orientation = quaternion::euler_angle<double>(0.1 * i, 0.2 * i, 0.3 * i),
+            };
+            box.update_computed_values();
+            colliders.emplace_back(box);
+        }
+    }
+
+    Broadphase broadphase;
+    for (std::size_t i = 0; i < colliders.size(); ++i) {
+        broadphase.create_proxy(colliders[i], i);
+    }
+    const std::vector<Broadphase::CandidatePair> pairs = broadphase.update_pairs();
+    auto collider = [&colliders](const std::size_t id) -> const Collider& {
+        return colliders[id];
+    };
+
+    Narrowphase serial;
+    const std::vector<Narrowphase::PairManifold> expected = serial.update(pairs, collider, nullptr);
+    REQUIRE(expected.size() > 100);
+
+    for (const std::size_t threads: {2, 3, 8}) {
+        ThreadPool thread_pool(threads);
+        Narrowphase parallel;
+
+        // the second update reuses the buffers of the first
+        for (int update = 0; update < 2; ++update) {
+            const std::vector<Narrowphase::PairManifold>& manifolds = parallel.update(pairs, collider, &thread_pool);
+            REQUIRE(manifolds.size() == expected.size());
+            for (std::size_t i = 0; i < manifolds.size(); ++i) {
+                CHECK(manifolds[i].body_a == expected[i].body_a);
+                CHECK(manifolds[i].body_b == expected[i].body_b);
+                CHECK(manifolds[i].manifold.normal == expected[i].manifold.normal);
+                REQUIRE(manifolds[i].manifold.contacts.size() == expected[i].manifold.contacts.size());
+                for (std::size_t k = 0; k < manifolds[i].manifold.contacts.size(); ++k) {
+                    const ContactPoint& contact = manifolds[i].manifold.contacts[k];
+                    const ContactPoint& expected_contact = expected[i].manifold.contacts[k];
+                    CHECK(contact.p_a == expected_contact.p_a);
+                    CHECK(contact.p_b == expected_contact.p_b);
+                    CHECK(contact.depth == expected_contact.depth);
+                    CHECK(contact.feature_id == expected_contact.feature_id);
+                }
+            }
+        }
+    }
+}
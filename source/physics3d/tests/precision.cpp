@@ -0,0 +1,116 @@
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/Simulation.h>
+
+using namespace yage::physics3d;
+using namespace yage::math;
+
+namespace
+{
+    const Material material{.restitution = 0, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+
+    /**
+     * Drops a stack of unit cubes and a sphere onto the ground, and returns their positions after they came to rest.
+     */
+    template<typename Scalar>
+    std::vector<Vec3d> rest_positions()
+    {
+        BasicSimulation<Scalar> simulation;
+        simulation.enable_gravity();
+        simulation.create_rigid_body(InertiaShape::static_shape(),
+                                     colliders::OrientedPlane{.original_normal = Vec3d(0, 1, 0)}, material, Vec3d(),
+                                     Quatd());
+
+        std::vector<RigidBodyHandle> bodies;
+        for (int i = 0; i < 3; ++i) {
+            bodies.push_back(simulation.create_rigid_body(
+                    InertiaShape::cube(1, 1), colliders::OrientedBox{.half_size = Vec3d(0.5)}, material,
+                    Vec3d(0, 0.5 + 1.01 * i, 0), Quatd()));
+        }
+        bodies.push_back(simulation.create_rigid_body(InertiaShape::sphere(0.5, 1), colliders::Sphere{.radius = 0.5},
+                                                      material, Vec3d(3, 2, 0), Quatd()));
+        for (int i = 0; i < 300; ++i) {
+            simulation.update(1. / 60.);
+        }
+
+        std::vector<Vec3d> positions;
+        for (const RigidBodyHandle body: bodies) {
+            CHECK(length(simulation.lookup(body).velocity()) < 0.01);
+            positions.push_back(simulation.lookup(body).position());
+        }
+        return positions;
+    }
+}
+
+TEST_CASE("Single-precision body store")
+{
+    const double dt = 1. / 60.;
+    const InertiaShape shape = InertiaShape::cuboid(1, 2, 3, 2);
+
+    BasicBodyStore<float> float_store;
+    BodyStore double_store;
+    for (const std::size_t id: {0, 1}) {
+        float_store.reset(id, shape, Vec3d(1, 2, 3), normalize(Quatd(0.9, 0.1, -0.3, 0.2)));
+        double_store.reset(id, shape, Vec3d(1, 2, 3), normalize(Quatd(0.9, 0.1, -0.3, 0.2)));
+    }
+    float_store.set_simulated(1, false);
+
+    SECTION("accessors convert to double precision") {
+        float_store.set_velocity(0, Vec3d(0.5, -1, 2));
+        CHECK(float_store.velocity(0) == Vec3d(0.5, -1, 2));
+        CHECK(float_store.stored_velocity(0) == Vec3f(0.5, -1, 2));
+        float_store.add_angular_velocity(0, Vec3f(0.25, 0, 0));
+        CHECK(float_store.angular_velocity(0) == Vec3d(0.25, 0, 0));
+        CHECK(float_store.inverse_mass(0) == Catch::Approx(0.5));
+    }
+
+    SECTION("integration follows double precision closely") {
+        double_store.set_velocity(0, Vec3d(0.5, -1, 2));
+        double_store.set_angular_velocity(0, Vec3d(-0.7, 1.3, 0.4));
+        float_store.set_velocity(0, Vec3d(0.5, -1, 2));
+        float_store.set_angular_velocity(0, Vec3d(-0.7, 1.3, 0.4));
+
+        for (int i = 0; i < 60; ++i) {
+            for (const std::size_t id: {0, 1}) {
+                double_store.apply_force(id, Vec3d(3, 1, -2), Vec3d(0.2, -0.5, 1));
+                float_store.apply_force(id, Vec3d(3, 1, -2), Vec3d(0.2, -0.5, 1));
+            }
+            double_store.integrate_forces(Vec3d(0, -9.81, 0), dt);
+            double_store.integrate_positions(dt);
+            double_store.clear_forces();
+            float_store.integrate_forces(Vec3d(0, -9.81, 0), dt);
+            float_store.integrate_positions(dt);
+            float_store.clear_forces();
+        }
+
+        CHECK(length(float_store.position(0) - double_store.position(0)) < 1e-5);
+        CHECK(length(float_store.velocity(0) - double_store.velocity(0)) < 1e-5);
+        CHECK(length(float_store.angular_velocity(0) - double_store.angular_velocity(0)) < 1e-5);
+        const Quatd float_orientation = float_store.orientation(0);
+        const Quatd double_orientation = double_store.orientation(0);
+        CHECK(float_orientation.w() == Catch::Approx(double_orientation.w()).margin(1e-5));
+        CHECK(float_orientation.x() == Catch::Approx(double_orientation.x()).margin(1e-5));
+        CHECK(float_orientation.y() == Catch::Approx(double_orientation.y()).margin(1e-5));
+        CHECK(float_orientation.z() == Catch::Approx(double_orientation.z()).margin(1e-5));
+
+        // bodies that are not simulated keep their state exactly
+        CHECK(float_store.position(1) == Vec3d(1, 2, 3));
+        CHECK(float_store.velocity(1) == Vec3d());
+    }
+}
+
+TEST_CASE("Single-precision simulation")
+{
+    const std::vector<Vec3d> double_positions = rest_positions<double>();
+    const std::vector<Vec3d> float_positions = rest_positions<float>();
+
+    for (int i = 0; i < 3; ++i) {
+        CHECK(float_positions[i].y() == Catch::Approx(0.5 + i).margin(0.01));
+    }
+    CHECK(float_positions[3].y() == Catch::Approx(0.5).margin(0.01));
+    for (std::size_t i = 0; i < double_positions.size(); ++i) {
+        CHECK(length(float_positions[i] - double_positions[i]) < 0.01);
+    }
+}
@@ -0,0 +1,50 @@
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/Simulation.h>
+
+#include "fixtures.h"
+
+using namespace yage::physics3d;
+using namespace yage::math;
+using namespace yage::physics3d::fixtures;
+
+TEST_CASE("Step statistics")
+{
+    Simulation simulation;
+    simulation.enable_gravity();
+    simulation.disable_sleeping();
+    create_ground(simulation);
+    create_box(simulation, Vec3d(0, 0.5, 0));
+    simulation.create_rigid_body(InertiaShape::static_shape(), colliders::OrientedBox{.half_size = Vec3d(0.5)},
+                                 material, Vec3d(5, 0.5, 0), Quatd());
+
+    const int substeps = GENERATE(1, 4);
+    CAPTURE(substeps);
+    if (substeps > 1) {
+        simulation.enable_substepping(substeps);
+    }
+    run(simulation, 30);
+    const StepStatistics& statistics = simulation.statistics();
+
+    if constexpr (!profiling_enabled) {
+        CHECK(statistics.step_time.count() == 0);
+        CHECK(statistics.contacts == 0);
+        return;
+    }
+
+    // the static box touches the ground plane, but the broad phase leaves out pairs of bodies that can't move
+    CHECK(statistics.candidate_pairs == 1);
+    CHECK(statistics.narrowphase_pairs == 1);
+    CHECK(statistics.narrowphase_hits == 1);
+    CHECK(statistics.contacts == 4);
+    CHECK(statistics.constraint_rows == 24);
+    CHECK(statistics.solver_iterations == (substeps > 1 ? 2 * substeps : 10));
+    CHECK(statistics.residual < 0.01);
+
+    CHECK(statistics.step_time.count() > 0);
+    CHECK(statistics.detect_collisions_time.count() > 0);
+    CHECK(statistics.resolve_collisions_time.count() > 0);
+    CHECK(statistics.step_time >= statistics.integrate_forces_time + statistics.detect_collisions_time +
+                                  statistics.resolve_collisions_time + statistics.integrate_positions_time +
+                                  statistics.update_islands_time);
+}
@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <optional>
+#include <random>
+
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/Simulation.h>
+
+using namespace yage::physics3d;
+using namespace yage::math;
+
+namespace
+{
+    const Material material{.restitution = 0.2, .kinetic_friction = 0.5, .rolling_friction = 0.1};
+
+    bool contains(const std::vector<RigidBodyHandle>& bodies, const RigidBodyHandle body)
+    {
+        return std::ranges::find(bodies, body) != bodies.end();
+    }
+}
+
+TEST_CASE("Scene queries")
+{
+    Simulation simulation;
+    const RigidBodyHandle ground = simulation.create_rigid_body(
+            InertiaShape::static_shape(), colliders::OrientedPlane{.original_normal = Vec3d(0, 1, 0)}, material,
+            Vec3d(), Quatd());
+    const RigidBodyHandle box = simulation.create_rigid_body(
+            InertiaShape::cube(2, 1), colliders::OrientedBox{.half_size = Vec3d(1)}, material, Vec3d(0, 1, 0),
+            Quatd());
+    const RigidBodyHandle sphere = simulation.create_rigid_body(
+            InertiaShape::sphere(1, 1), colliders::Sphere{.radius = 1}, material, Vec3d(5, 1, 0), Quatd());
+    const RigidBodyHandle tilted = simulation.create_rigid_body(
+            InertiaShape::cube(2, 1), colliders::OrientedBox{.half_size = Vec3d(1)}, material, Vec3d(-5, 1, 0),
+            normalize(Quatd(0.9, 0.2, 0.3, -0.1)));
+    simulation.update(1. / 60.);
+
+    SECTION("ray hits the closest collider") {
+        const std::optional<QueryHit> hit = simulation.raycast(
+                {.origin = Vec3d(0.5, 10, 0.5), .direction = Vec3d(0, -2, 0), .max_distance = 20});
+        REQUIRE(hit.has_value());
+        CHECK(hit->body == box);
+        CHECK(hit->distance == Catch::Approx(8));
+        CHECK(hit->point.x() == Catch::Approx(0.5));
+        CHECK(hit->point.y() == Catch::Approx(2));
+        CHECK(hit->normal.y() == Catch::Approx(1));
+    }
+
+    SECTION("ray hits a plane") {
+        const std::optional<QueryHit> hit = simulation.raycast(
+                {.origin = Vec3d(2.5, 10, 0), .direction = Vec3d(0, -1, 0), .max_distance = 20});
+        REQUIRE(hit.has_value());
+        CHECK(hit->body == ground);
+        CHECK(hit->distance == Catch::Approx(10));
+        CHECK(hit->normal.y() == Catch::Approx(1));
+    }
+
+    SECTION("ray hits a sphere") {
+        const std::optional<QueryHit> hit = simulation.raycast(
+                {.origin = Vec3d(5, 1, -10), .direction = Vec3d(0, 0, 1), .max_distance = 20});
+        REQUIRE(hit.has_value());
+        CHECK(hit->body == sphere);
+        CHECK(hit->distance == Catch::Approx(9));
+        CHECK(hit->normal.z() == Catch::Approx(-1));
+    }
+
+    SECTION("ray ignores colliders that contain its origin") {
+        const std::optional<QueryHit> hit = simulation.raycast(
+                {.origin = Vec3d(0, 1, 0), .direction = Vec3d(0, -1, 0), .max_distance = 20});
+        REQUIRE(hit.has_value());
+        CHECK(hit->body == ground);
+        CHECK(hit->distance == Catch::Approx(1));
+    }
+
+    SECTION("ray that is too short misses") {
+        CHECK(!simulation.raycast({.origin = Vec3d(0, 10, 0), .direction = Vec3d(0, -1, 0), .max_distance = 7.9})
+                .has_value());
+        CHECK(!simulation.raycast({.origin = Vec3d(0, 10, 0), .direction = Vec3d(0, 1, 0), .max_distance = 100})
+                .has_value());
+    }
+
+    SECTION("sphere cast stops where the sphere touches") {
+        std::optional<QueryHit> hit = simulation.sphere_cast(
+                {.origin = Vec3d(0, 10, 0), .direction = Vec3d(0, -1, 0), .max_distance = 20}, 0.5);
+        REQUIRE(hit.has_value());
+        CHECK(hit->body == box);
+        CHECK(hit->distance == Catch::Approx(7.5));
+        CHECK(hit->point.y() == Catch::Approx(2));
+
+        hit = simulation.sphere_cast(
+                {.origin = Vec3d(5, 1, -10), .direction = Vec3d(0, 0, 1), .max_distance = 20}, 1);
+        REQUIRE(hit.has_value());
+        CHECK(hit->body == sphere);
+        CHECK(hit->distance == Catch::Approx(8));
+        CHECK(hit->point.z() == Catch::Approx(-1));
+    }
+
+    SECTION("destroyed bodies are ignored") {
+        simulation.lookup(box).destroy();
+        const std::optional<QueryHit> hit = simulation.raycast(
+                {.origin = Vec3d(0, 10, 0), .direction = Vec3d(0, -1, 0), .max_distance = 20});
+        REQUIRE(hit.has_value());
+        CHECK(hit->body == ground);
+    }
+
+    SECTION("batched rays match single rays") {
+        const std::size_t threads = GENERATE(1, 3);
+        simulation.set_thread_count(threads);
+
+        std::mt19937 random(42);
+        std::uniform_real_distribution<double> position(-8, 8);
+        std::vector<Ray> rays;
+        for (int i = 0; i < 200; ++i) {
+            rays.push_back({
+                    .origin = Vec3d(position(random), 6, position(random)),
+                    .direction = Vec3d(position(random), -8, position(random)),
+                    .max_distance = 20,
+            });
+        }
+        std::vector<std::optional<QueryHit>> hits(rays.size());
+        simulation.raycast(rays, hits);
+
+        int tilted_hits = 0;
+        for (std::size_t i = 0; i < rays.size(); ++i) {
+            const std::optional<QueryHit> expected = simulation.raycast(rays[i]);
+            REQUIRE(hits[i].has_value() == expected.has_value());
+            if (expected.has_value()) {
+                CHECK(hits[i]->body == expected->body);
+                CHECK(hits[i]->distance == expected->distance);
+                CHECK(dot(hits[i]->normal, rays[i].direction) < 0);
+                tilted_hits += hits[i]->body == tilted;
+            }
+        }
+        CHECK(tilted_hits > 0);
+    }
+
+    SECTION("overlapping bounds") {
+        std::vector<RigidBodyHandle> bodies;
+        simulation.overlap(geometry::AABB{.min = Vec3d(4, 0.5, -0.5), .max = Vec3d(6, 1.5, 0.5)}, bodies);
+        CHECK(bodies.size() == 1);
+        CHECK(contains(bodies, sphere));
+
+        simulation.overlap(geometry::AABB{.min = Vec3d(0.5, -0.5, -0.5), .max = Vec3d(4.5, 1.5, 0.5)}, bodies);
+        CHECK(bodies.size() == 3);
+        CHECK(contains(bodies, ground));
+        CHECK(contains(bodies, box));
+        CHECK(contains(bodies, sphere));
+    }
+
+    SECTION("overlapping shapes") {
+        std::vector<RigidBodyHandle> bodies;
+        simulation.overlap(colliders::Sphere{.center = Vec3d(0, 2.2, 0), .radius = 0.1}, bodies);
+        CHECK(bodies.empty());
+
+        simulation.overlap(colliders::Sphere{.center = Vec3d(0, 2.2, 0), .radius = 0.3}, bodies);
+        CHECK(bodies.size() == 1);
+        CHECK(contains(bodies, box));
+
+        colliders::OrientedBox query{.half_size = Vec3d(3, 0.5, 0.5), .center = Vec3d(3, 0.4, 0)};
+        query.update_computed_values();
+        simulation.overlap(query, bodies);
+        CHECK(bodies.size() == 3);
+        CHECK(contains(bodies, ground));
+        CHECK(contains(bodies, box));
+        CHECK(contains(bodies, sphere));
+    }
+
+    SECTION("overlapping shapes centered inside bodies") {
+        std::vector<RigidBodyHandle> bodies;
+        for (const RigidBodyHandle body: {box, sphere, tilted}) {
+            simulation.overlap(colliders::Sphere{.center = simulation.lookup(body).position(), .radius = 0.1}, bodies);
+            CHECK(bodies == std::vector{body});
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/Simulation.h>
+
+#include "fixtures.h"
+
+using namespace yage::physics3d;
+using namespace yage::math;
+using namespace yage::physics3d::fixtures;
+
+TEST_CASE("Sleeping")
+{
+    Simulation simulation;
+    simulation.enable_gravity();
+    const RigidBodyHandle ground = create_ground(simulation);
+    const RigidBodyHandle bottom = create_box(simulation, Vec3d(0, 0.5, 0));
+    const RigidBodyHandle top = create_box(simulation, Vec3d(0, 1.55, 0));
+    const RigidBodyHandle single = create_box(simulation, Vec3d(5, 0.5, 0));
+
+    run(simulation, 30);
+    CHECK(simulation.awake_body_count() == 3);
+    CHECK(simulation.island_count() == 2);
+
+    run(simulation, 300);
+    REQUIRE(simulation.lookup(bottom).is_sleeping());
+    REQUIRE(simulation.lookup(top).is_sleeping());
+    REQUIRE(simulation.lookup(single).is_sleeping());
+    CHECK(simulation.awake_body_count() == 0);
+    CHECK(simulation.island_count() == 0);
+
+    SECTION("sleeping bodies don't move") {
+        const Vec3d position = simulation.lookup(top).position();
+        run(simulation, 60);
+        CHECK(simulation.lookup(top).position() == position);
+    }
+
+    SECTION("forces wake the whole island") {
+        simulation.lookup(top).apply_force(Vec3d(1, 0, 0), simulation.lookup(top).position());
+        CHECK(!simulation.lookup(top).is_sleeping());
+
+        simulation.update(1. / 60.);
+        CHECK(!simulation.lookup(top).is_sleeping());
+        CHECK(!simulation.lookup(bottom).is_sleeping());
+        CHECK(simulation.lookup(single).is_sleeping());
+        CHECK(simulation.awake_body_count() == 2);
+        CHECK(simulation.island_count() == 1);
+    }
+
+    SECTION("touching a moving body wakes the island") {
+        create_box(simulation, Vec3d(5, 1.55, 0));
+        run(simulation, 30);
+        CHECK(!simulation.lookup(single).is_sleeping());
+        CHECK(simulation.lookup(bottom).is_sleeping());
+    }
+
+    SECTION("destroying a neighbour wakes the island") {
+        simulation.lookup(bottom).destroy();
+        simulation.update(1. / 60.);
+        CHECK(!simulation.lookup(top).is_sleeping());
+
+        run(simulation, 60);
+        CHECK(simulation.lookup(top).position().y() == Catch::Approx(0.5).margin(0.05));
+    }
+
+    SECTION("destroying the ground wakes everything") {
+        simulation.lookup(ground).destroy();
+        run(simulation, 30);
+        CHECK(simulation.lookup(single).position().y() < 0);
+    }
+
+    SECTION("disabling sleeping wakes all bodies") {
+        simulation.disable_sleeping();
+        CHECK(!simulation.lookup(single).is_sleeping());
+        run(simulation, 300);
+        CHECK(simulation.awake_body_count() == 3);
+    }
+}
@@ -0,0 +1,136 @@
+#include <algorithm>
+
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/Simulation.h>
+
+#include "fixtures.h"
+
+using namespace yage::physics3d;
+using namespace yage::math;
+using namespace yage::physics3d::fixtures;
+
+namespace
+{
+    /**
+     * A ground plane with a pile of tilted boxes and a sphere dropped onto it.
+     */
+    std::vector<RigidBodyHandle> create_pile(Simulation& simulation)
+    {
+        create_ground(simulation);
+        std::vector<RigidBodyHandle> bodies;
+        for (int i = 0; i < 8; ++i) {
+            bodies.push_back(simulation.create_rigid_body(InertiaShape::cube(1, 1),
+                                                          colliders::OrientedBox{.half_size = Vec3d(0.5)}, material,
+                                                          Vec3d(0.3 * (i % 3), 0.6 + 1.2 * i, 0.2 * (i % 2)),
+                                                          normalize(Quatd(0.9, 0.1 * i, -0.2, 0.1))));
+        }
+        bodies.push_back(simulation.create_rigid_body(InertiaShape::sphere(0.5, 2),
+                                                      colliders::Sphere{.radius = 0.5}, material,
+                                                      Vec3d(0.5, 12, 0.4), Quatd()));
+        return bodies;
+    }
+
+    void run(Simulation& simulation, const int steps, const bool staggered)
+    {
+        for (int i = 0; i < steps; ++i) {
+            if (staggered) {
+                simulation.update_staggered(1. / 60.);
+            } else {
+                simulation.update(1. / 60.);
+            }
+        }
+    }
+
+    std::vector<std::pair<Vec3d, Quatd>> poses(Simulation& simulation, const std::vector<RigidBodyHandle>& bodies)
+    {
+        std::vector<std::pair<Vec3d, Quatd>> result;
+        for (const RigidBodyHandle body: bodies) {
+            result.emplace_back(simulation.lookup(body).position(), simulation.lookup(body).orientation());
+        }
+        return result;
+    }
+}
+
+TEST_CASE("Snapshot")
+{
+    const bool staggered = GENERATE(false, true);
+    CAPTURE(staggered);
+
+    Simulation simulation;
+    simulation.enable_gravity();
+    const std::vector<RigidBodyHandle> bodies = create_pile(simulation);
+    run(simulation, 60, staggered);
+
+    Snapshot snapshot;
+    simulation.save(snapshot);
+    const auto saved = poses(simulation, bodies);
+    run(simulation, 120, staggered);
+    const auto expected = poses(simulation, bodies);
+    REQUIRE(saved != expected);
+
+    SECTION("restoring replays the same steps") {
+        simulation.restore(snapshot);
+        CHECK(poses(simulation, bodies) == saved);
+        run(simulation, 120, staggered);
+        CHECK(poses(simulation, bodies) == expected);
+    }
+
+    SECTION("restoring undoes created and destroyed bodies") {
+        simulation.restore(snapshot);
+        simulation.lookup(bodies[3]).destroy();
+        create_box(simulation, Vec3d(0, 5, 0));
+        simulation.disable_gravity();
+        run(simulation, 30, staggered);
+
+        simulation.restore(snapshot);
+        run(simulation, 120, staggered);
+        CHECK(poses(simulation, bodies) == expected);
+    }
+
+    SECTION("restoring into another simulation") {
+        Simulation other;
+        other.restore(snapshot);
+        CHECK(poses(other, bodies) == saved);
+        run(other, 120, staggered);
+        CHECK(poses(other, bodies) == expected);
+    }
+
+    SECTION("restoring into another simulation while a neighbour keeps an island awake") {
+        // the staggered update groups bodies into islands from the contacts of the previous step, so a restored
+        // simulation would let the resting plank fall asleep without the sphere that rolls across it
+        Simulation rolling;
+        rolling.enable_gravity();
+        create_ground(rolling);
+        const Material smooth{.restitution = 0, .kinetic_friction = 0.5, .rolling_friction = 0};
+        const std::vector<RigidBodyHandle> bodies{
+                rolling.create_rigid_body(InertiaShape::cuboid(6, 0.5, 2, 10),
+                                          colliders::OrientedBox{.half_size = Vec3d(3, 0.25, 1)}, smooth,
+                                          Vec3d(0, 0.25, 0), Quatd()),
+                rolling.create_rigid_body(InertiaShape::sphere(0.25, 1), colliders::Sphere{.radius = 0.25}, smooth,
+                                          Vec3d(-2.5, 0.75, 0), Quatd()),
+        };
+        rolling.lookup(bodies[1]).apply_force(Vec3d(0.3 * 60, 0, 0), rolling.lookup(bodies[1]).position());
+        for (int step = 0; step < 90; ++step) {
+            rolling.save(snapshot);
+            Simulation other;
+            other.restore(snapshot);
+            for (int i = 0; i < 10; ++i) {
+                run(rolling, 1, staggered);
+                run(other, 1, staggered);
+                CHECK(other.island_count() == rolling.island_count());
+                CHECK(poses(other, bodies) == poses(rolling, bodies));
+            }
+            rolling.restore(snapshot);
+            run(rolling, 1, staggered);
+        }
+    }
+
+    SECTION("saving into a used snapshot") {
+        simulation.save(snapshot);
+        Snapshot fresh;
+        simulation.save(fresh);
+        REQUIRE(snapshot.size() == fresh.size());
+        CHECK(std::equal(snapshot.data(), snapshot.data() + snapshot.size(), fresh.data()));
+    }
+}
@@ -0,0 +1,66 @@
+#include <cmath>
+
+#include <catch2/catch_all.hpp>
+
+#include <physics3d/Simulation.h>
+
+#include "fixtures.h"
+
+using namespace yage::physics3d;
+using namespace yage::math;
+using namespace yage::physics3d::fixtures;
+
+namespace
+{
+    const Material inelastic{.restitution = 0.0, .kinetic_friction = 0.5};
+
+    std::vector<RigidBodyHandle> create_stack(Simulation& simulation, const int height, const double top_mass)
+    {
+        create_ground(simulation, inelastic);
+        std::vector<RigidBodyHandle> boxes;
+        for (int i = 0; i < height; ++i) {
+            const double mass = i == height - 1 ? top_mass : 1;
+            boxes.push_back(simulation.create_rigid_body(InertiaShape::cube(2, mass),
+                                                         colliders::OrientedBox{.half_size = Vec3d(1)}, inelastic,
+                                                         Vec3d(0, 1.01 + i * 2.01, 0), Quatd()));
+        }
+        return boxes;
+    }
+
+    void check_standing(Simulation& simulation, const std::vector<RigidBodyHandle>& boxes, const double sink)
+    {
+        for (std::size_t i = 0; i < boxes.size(); ++i) {
+            const RigidBody& box = simulation.lookup(boxes[i]);
+            CHECK(box.position().y() == Catch::Approx(1 + 2. * static_cast<double>(i)).margin(sink));
+            CHECK(std::hypot(box.position().x(), box.position().z()) < 0.1);
+        }
+    }
+}
+
+TEST_CASE("Sub-stepping")
+{
+    Simulation simulation;
+    simulation.enable_gravity();
+    simulation.disable_sleeping();
+    simulation.enable_substepping(4);
+
+    SECTION("stack settles") {
+        const std::size_t threads = GENERATE(1, 3);
+        CAPTURE(threads);
+        simulation.set_thread_count(threads);
+
+        const std::vector<RigidBodyHandle> boxes = create_stack(simulation, 4, 1);
+        for (int i = 0; i < 300; ++i) {
+            simulation.update(1. / 60.);
+        }
+        check_standing(simulation, boxes, 0.05);
+    }
+
+    SECTION("heavy box on a stack") {
+        const std::vector<RigidBodyHandle> boxes = create_stack(simulation, 4, 10);
+        for (int i = 0; i < 300; ++i) {
+            simulation.update(1. / 60.);
+        }
+        check_standing(simulation, boxes, 0.1);
+    }
+}
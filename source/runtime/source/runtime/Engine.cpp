@@ -8,6 +8,8 @@
 
 namespace yage
 {
+    using PhysicsTransforms = physics3d::TransformBuffer<gl3d::SceneObject*>;
+
     Engine::Engine(int width, int height, const std::string& title) :
         m_window(std::make_unique<platform::desktop::GlfwWindow>(width, height, title)),
         m_gl_context(gl::createContext(m_window)),
@@ -32,9 +34,6 @@ namespace yage
         m_window->show();
         m_window->getTimeStep();
 
-        constexpr double physics_dt = 1. / 60.;
-        double physics_dt_accumulator = 0.0;
-
         constexpr double gui_dt = 1. / 60.;
         double gui_dt_accumulator = 0.0;
 
@@ -44,46 +43,56 @@ namespace yage
             scene_renderer.base_renderer().setClearColor(gl::Color::WHITE);
             scene_renderer.base_renderer().clear();
 
-            // simulate physics
-            if (enable_physics_simulation) {
-                physics_dt_accumulator += frame_time;
-                while (physics_dt_accumulator >= physics_dt) {
-                    m_application->pre_physics_update();
-                    if (enable_physics_visualization) {
-                        physics.update_staggered(physics_dt);
-                    } else {
-                        physics.update(physics_dt);
-                    }
-                    physics_dt_accumulator -= physics_dt;
+            if (enable_physics_simulation && enable_async_physics) {
+                // the physics thread is idle until it is started, so the application can still access the simulation
+                scene_renderer.base_renderer().clear();
+                m_application->pre_render_update();
+                if (!m_physics_running_async) {
+                    // nothing has been published yet, so the scene is updated from the simulation directly
+                    update_scene_nodes();
                 }
-            }
 
-            // update scene graph from rigid bodies
-            for (GameObject& game_object : m_game_objects | std::ranges::views::values) {
-                if (!game_object.scene_node || !game_object.rigid_body) {
-                    continue;
+                m_physics_nodes.clear();
+                for (const GameObject& game_object : m_game_objects | std::ranges::views::values) {
+                    if (game_object.scene_node && game_object.rigid_body &&
+                        physics.contains(game_object.rigid_body.value())) {
+                        m_physics_nodes.emplace_back(&game_object.scene_node.value().get(),
+                                                     game_object.rigid_body.value());
+                    }
                 }
+                m_async_frame_time = frame_time;
+                m_physics_thread.start(m_async_physics_task);
 
-                physics3d::RigidBody& rigid_body = physics.lookup(game_object.rigid_body.value());
+                // render the poses of the previous frame while the physics thread steps ahead
+                if (m_physics_running_async) {
+                    update_interpolated_scene_nodes();
+                }
+                m_physics_running_async = true;
+            } else {
+                m_physics_running_async = false;
+                if (enable_physics_simulation) {
+                    step_physics(frame_time);
+                }
+                update_scene_nodes();
 
-                game_object.scene_node.value().get().local_transform =
-                        math::matrix::translate(rigid_body.position()) *
-                        math::matrix::from_quaternion(rigid_body.orientation()) *
-                        math::matrix::scale(game_object.scene_node.value().get().local_transform.scale());
+                scene_renderer.base_renderer().clear();
+                m_application->pre_render_update();
             }
 
             // render scene
-            scene_renderer.base_renderer().clear();
-            m_application->pre_render_update();
             if (enable_physics_visualization) {
                 scene_renderer.base_renderer().enableWireframe();
                 scene_renderer.render_active_scene();
                 scene_renderer.base_renderer().disableWireframe();
+            } else {
+                scene_renderer.render_active_scene();
+            }
 
+            // the simulation must not be accessed on this thread before the physics steps of this frame are done
+            m_physics_thread.wait();
+            if (enable_physics_visualization) {
                 physics.visualize_collisions(static_cast<math::Mat4d>(scene_renderer.projection()),
                                              static_cast<math::Mat4d>(scene_renderer.view()));
-            } else {
-                scene_renderer.render_active_scene();
             }
 
             // update gui
@@ -133,4 +142,101 @@ namespace yage
     {
         return m_window->openFileDialog("");
     }
+
+    void Engine::step_physics(const double frame_time)
+    {
+        m_physics_dt_accumulator += frame_time;
+        while (m_physics_dt_accumulator >= physics_dt) {
+            update_physics();
+        }
+    }
+
+    void Engine::update_physics()
+    {
+        m_application->pre_physics_update();
+        if (enable_physics_visualization) {
+            physics.update_staggered(physics_dt);
+        } else {
+            physics.update(physics_dt);
+        }
+        m_physics_dt_accumulator -= physics_dt;
+    }
+
+    void Engine::step_physics_async()
+    {
+        PhysicsTransforms::Frame& frame = m_physics_transforms.back();
+        const std::vector<PhysicsTransforms::Transform>& published = m_physics_transforms.front().transforms;
+
+        // bodies that are removed during the steps keep their last pose
+        auto capture = [this](const physics3d::RigidBodyHandle body, physics3d::BodyPose& pose) {
+            if (physics.contains(body)) {
+                const physics3d::RigidBody& rigid_body = physics.lookup(body);
+                pose = {.position = rigid_body.position(), .orientation = rigid_body.orientation()};
+            }
+        };
+
+        frame.transforms.resize(m_physics_nodes.size());
+        for (std::size_t i = 0; i < m_physics_nodes.size(); ++i) {
+            const auto& [node, body] = m_physics_nodes[i];
+            PhysicsTransforms::Transform& transform = frame.transforms[i];
+            transform.target = node;
+            capture(body, transform.current);
+            // without a step in this frame, the poses are still blended from the step before
+            const bool was_published = i < published.size() && published[i].target == node;
+            transform.previous = was_published ? published[i].previous : transform.current;
+        }
+
+        m_physics_dt_accumulator += m_async_frame_time;
+        bool stepped = false;
+        while (m_physics_dt_accumulator >= physics_dt) {
+            if (m_physics_dt_accumulator < 2 * physics_dt) {
+                // the poses are blended over the last step of the frame
+                for (std::size_t i = 0; i < m_physics_nodes.size(); ++i) {
+                    capture(m_physics_nodes[i].second, frame.transforms[i].previous);
+                }
+            }
+
+            update_physics();
+            stepped = true;
+        }
+
+        if (stepped) {
+            for (std::size_t i = 0; i < m_physics_nodes.size(); ++i) {
+                capture(m_physics_nodes[i].second, frame.transforms[i].current);
+            }
+        }
+        frame.alpha = m_physics_dt_accumulator / physics_dt;
+        m_physics_transforms.publish();
+    }
+
+    void Engine::update_scene_nodes()
+    {
+        for (GameObject& game_object : m_game_objects | std::ranges::views::values) {
+            if (!game_object.scene_node || !game_object.rigid_body ||
+                !physics.contains(game_object.rigid_body.value())) {
+                continue;
+            }
+
+            physics3d::RigidBody& rigid_body = physics.lookup(game_object.rigid_body.value());
+
+            game_object.scene_node.value().get().local_transform =
+                    math::matrix::translate(rigid_body.position()) *
+                    math::matrix::from_quaternion(rigid_body.orientation()) *
+                    math::matrix::scale(game_object.scene_node.value().get().local_transform.scale());
+        }
+    }
+
+    void Engine::update_interpolated_scene_nodes()
+    {
+        const PhysicsTransforms::Frame& frame = m_physics_transforms.front();
+        for (const PhysicsTransforms::Transform& transform : frame.transforms) {
+            const physics3d::BodyPose pose =
+                    PhysicsTransforms::interpolate(transform.previous, transform.current, frame.alpha);
+
+            gl3d::SceneObject& node = *transform.target;
+            node.local_transform = math::matrix::translate(pose.position) *
+                                   math::matrix::from_quaternion(pose.orientation) *
+                                   math::matrix::scale(node.local_transform.scale());
+        }
+    }
 }
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <functional>
+
 #include <core/platform/Window.h>
 #include <gui/master.h>
 #include <gl3d/sceneRenderer.h>
 #include <physics3d/Simulation.h>
+#include <physics3d/StepThread.h>
+#include <physics3d/TransformBuffer.h>
 #include <resource/Store.h>
 
 #include "Application.h"
@@ -21,6 +25,12 @@ namespace yage
     public:
         bool enable_physics_simulation = true;
         bool enable_physics_visualization = false;
+        /**
+         * Steps the physics on a separate thread while the previous frame is rendered, where scene nodes are
+         * interpolated between the last two steps. The application can access the simulation as usual, except in
+         * pre_physics_update, which then runs on the physics thread and must only access the simulation.
+         */
+        bool enable_async_physics = false;
 
         gl3d::SceneRenderer scene_renderer;
         physics3d::Simulation physics;
@@ -65,5 +75,35 @@ namespace yage
         std::unique_ptr<Application> m_application;
 
         std::unordered_map<std::string, GameObject> m_game_objects;
+
+        static constexpr double physics_dt = 1. / 60.;
+        double m_physics_dt_accumulator = 0.0;
+
+        /**
+         * Scene nodes of game objects with rigid bodies, in the order their poses are published by the physics thread.
+         */
+        std::vector<std::pair<gl3d::SceneObject*, physics3d::RigidBodyHandle>> m_physics_nodes;
+        physics3d::TransformBuffer<gl3d::SceneObject*> m_physics_transforms;
+        bool m_physics_running_async = false;
+        double m_async_frame_time = 0.0;
+        std::function<void()> m_async_physics_task = [this] { step_physics_async(); };
+        // destructed first, so that a running task can't outlive the members it accesses
+        physics3d::StepThread m_physics_thread;
+
+        void step_physics(double frame_time);
+
+        /**
+         * Advances the simulation by one fixed step.
+         */
+        void update_physics();
+
+        /**
+         * Steps the physics for the current frame on the physics thread and publishes the resulting poses.
+         */
+        void step_physics_async();
+
+        void update_scene_nodes();
+
+        void update_interpolated_scene_nodes();
     };
 }